@@ -0,0 +1,541 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Object alias text parser and writer
+//
+// Object alias data returned by get_object_alias() and accepted by create_object_from_alias() is INI-like UTF-8 text:
+//   [Object]
+//   frame=0,99
+//   [Object.0]
+//   effect.name=...
+//   key=value
+// Sections named "<object>.<n>" hold the n-th effect of an object.
+//
+// The parser does not allocate and does not modify the text. Section names, keys and values are returned as views
+// (pointer and length) into the original buffer, which must stay alive while the views are used.
+// aviutl2_alias_index_build() indexes the sections by effect name in caller-provided storage.
+//
+// To modify an alias, collect edits that refer to views of the original text and write the result with
+// aviutl2_alias_apply(); new aliases can be generated with struct aviutl2_alias_writer. Both write into a caller
+// buffer and return the required size, so the same call can be used to measure first.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aviutl2_hash.h"
+
+/**
+ * View into alias text (not null-terminated)
+ */
+struct aviutl2_alias_view {
+  char const *ptr;
+  size_t len;
+};
+
+/**
+ * Compare a view with a null-terminated string
+ * @param v View
+ * @param str String
+ * @return true if equal
+ */
+static inline bool aviutl2_alias_view_eq(struct aviutl2_alias_view v, char const *str) {
+  size_t const len = strlen(str);
+  return v.len == len && memcmp(v.ptr, str, len) == 0;
+}
+
+/**
+ * Token type
+ */
+enum aviutl2_alias_token_type {
+  aviutl2_alias_token_end = 0,     /**< End of text */
+  aviutl2_alias_token_section = 1, /**< "[name]" line */
+  aviutl2_alias_token_entry = 2,   /**< "key=value" line */
+};
+
+/**
+ * Token
+ */
+struct aviutl2_alias_token {
+  enum aviutl2_alias_token_type type;
+  struct aviutl2_alias_view name;  /**< Section name (section token) or key (entry token) */
+  struct aviutl2_alias_view value; /**< Value (entry token) */
+  char const *line;                /**< Start of the line */
+  char const *next;                /**< Start of the next line */
+};
+
+/**
+ * Streaming parser
+ */
+struct aviutl2_alias_parser {
+  char const *p;
+  char const *end;
+};
+
+/**
+ * Initialize a parser
+ * @param parser Parser
+ * @param text Alias text (UTF-8, a leading BOM is skipped)
+ * @param len Length of text in bytes
+ */
+static inline void aviutl2_alias_parser_init(struct aviutl2_alias_parser *parser, char const *text, size_t len) {
+  if (len >= 3 && memcmp(text, "\xef\xbb\xbf", 3) == 0) {
+    text += 3;
+    len -= 3;
+  }
+  parser->p = text;
+  parser->end = text + len;
+}
+
+/**
+ * Read the next section or entry
+ * Empty lines and lines that are neither are skipped
+ * @param parser Parser
+ * @param token Pointer to storage for the token
+ * @return false at the end of the text
+ */
+static inline bool aviutl2_alias_parser_next(struct aviutl2_alias_parser *parser, struct aviutl2_alias_token *token) {
+  while (parser->p < parser->end) {
+    char const *const line = parser->p;
+    char const *eol = (char const *)memchr(line, '\n', (size_t)(parser->end - line));
+    char const *const next = eol ? eol + 1 : parser->end;
+    if (!eol) {
+      eol = parser->end;
+    }
+    if (eol > line && eol[-1] == '\r') {
+      --eol;
+    }
+    parser->p = next;
+    size_t const len = (size_t)(eol - line);
+    if (len >= 2 && line[0] == '[' && eol[-1] == ']') {
+      *token = (struct aviutl2_alias_token){
+          .type = aviutl2_alias_token_section,
+          .name = {line + 1, len - 2},
+          .line = line,
+          .next = next,
+      };
+      return true;
+    }
+    char const *const eq = (char const *)memchr(line, '=', len);
+    if (eq) {
+      *token = (struct aviutl2_alias_token){
+          .type = aviutl2_alias_token_entry,
+          .name = {line, (size_t)(eq - line)},
+          .value = {eq + 1, (size_t)(eol - eq - 1)},
+          .line = line,
+          .next = next,
+      };
+      return true;
+    }
+  }
+  *token = (struct aviutl2_alias_token){.type = aviutl2_alias_token_end, .line = parser->end, .next = parser->end};
+  return false;
+}
+
+/**
+ * Section
+ */
+struct aviutl2_alias_section {
+  struct aviutl2_alias_view name;   /**< Section name */
+  struct aviutl2_alias_view object; /**< Part of the name before the last '.' (the whole name if there is none) */
+  int index;                        /**< Number after the last '.' (-1 if there is none) */
+  struct aviutl2_alias_view effect; /**< Value of effect.name (empty if there is none) */
+  char const *header;               /**< Start of the "[name]" line */
+  char const *body;                 /**< Start of the first line after the header */
+  char const *end;                  /**< Start of the next section or end of the text */
+  uint32_t next_same;               /**< Index + 1 of the next section with the same effect name (set by the index) */
+};
+
+static inline void aviutl2_alias_section_split(struct aviutl2_alias_section *s) {
+  s->object = s->name;
+  s->index = -1;
+  for (size_t i = s->name.len; i > 0; --i) {
+    if (s->name.ptr[i - 1] != '.') {
+      continue;
+    }
+    if (i == s->name.len || s->name.len - i > 9) {
+      return;
+    }
+    int n = 0;
+    for (size_t j = i; j < s->name.len; ++j) {
+      char const c = s->name.ptr[j];
+      if (c < '0' || c > '9') {
+        return;
+      }
+      n = n * 10 + (c - '0');
+    }
+    s->object.len = i - 1;
+    s->index = n;
+    return;
+  }
+}
+
+/**
+ * Split alias text into sections
+ * @param text Alias text
+ * @param len Length of text in bytes
+ * @param sections Destination (may be NULL when cap is 0)
+ * @param cap Number of sections that can be stored
+ * @return Total number of sections in the text (may be larger than cap; only cap sections are stored)
+ */
+static inline size_t
+aviutl2_alias_sections(char const *text, size_t len, struct aviutl2_alias_section *sections, size_t cap) {
+  struct aviutl2_alias_parser parser;
+  struct aviutl2_alias_token token;
+  aviutl2_alias_parser_init(&parser, text, len);
+  size_t n = 0;
+  struct aviutl2_alias_section *cur = NULL;
+  while (aviutl2_alias_parser_next(&parser, &token)) {
+    if (token.type == aviutl2_alias_token_section) {
+      if (cur) {
+        cur->end = token.line;
+      }
+      cur = n < cap ? sections + n : NULL;
+      ++n;
+      if (cur) {
+        *cur = (struct aviutl2_alias_section){
+            .name = token.name,
+            .header = token.line,
+            .body = token.next,
+        };
+        aviutl2_alias_section_split(cur);
+      }
+    } else if (cur && !cur->effect.ptr && aviutl2_alias_view_eq(token.name, "effect.name")) {
+      cur->effect = token.value;
+    }
+  }
+  if (cur) {
+    cur->end = parser.end;
+  }
+  return n;
+}
+
+/**
+ * Get a value in a section
+ * @param section Section
+ * @param key Key name
+ * @param value Pointer to storage for the value view
+ * @return true if the key exists
+ */
+static inline bool aviutl2_alias_section_get(struct aviutl2_alias_section const *section,
+                                             char const *key,
+                                             struct aviutl2_alias_view *value) {
+  struct aviutl2_alias_parser parser = {section->body, section->end};
+  struct aviutl2_alias_token token;
+  while (aviutl2_alias_parser_next(&parser, &token)) {
+    if (token.type == aviutl2_alias_token_entry && aviutl2_alias_view_eq(token.name, key)) {
+      *value = token.value;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Effect name index
+ * Built over caller-provided storage; each slot holds the first section of one effect name and the following
+ * sections with the same name are chained through next_same
+ */
+struct aviutl2_alias_index {
+  struct aviutl2_alias_section const *sections;
+  size_t section_num;
+  uint32_t *slots; /**< Section index + 1 (0 = empty) */
+  size_t slot_num; /**< Power of two, larger than the number of distinct effect names */
+};
+
+static inline uint64_t aviutl2_alias_index_hash(char const *ptr, size_t len) {
+  return aviutl2_hash_u64(aviutl2_hash_bytes(AVIUTL2_HASH_INIT, ptr, len), len);
+}
+
+static inline uint32_t *
+aviutl2_alias_index_slot(struct aviutl2_alias_index const *idx, char const *effect, size_t len) {
+  size_t const mask = idx->slot_num - 1;
+  size_t pos = (size_t)aviutl2_alias_index_hash(effect, len) & mask;
+  for (; idx->slots[pos]; pos = (pos + 1) & mask) {
+    struct aviutl2_alias_view const e = idx->sections[idx->slots[pos] - 1].effect;
+    if (e.len == len && memcmp(e.ptr, effect, len) == 0) {
+      break;
+    }
+  }
+  return idx->slots + pos;
+}
+
+/**
+ * Build an effect name index
+ * @param idx Index
+ * @param sections Sections returned by aviutl2_alias_sections() (next_same is updated)
+ * @param section_num Number of sections
+ * @param slots Slot storage
+ * @param slot_num Number of slots (power of two, larger than section_num is always enough)
+ * @return false if slot_num is not a power of two or there are too many distinct effect names
+ */
+static inline bool aviutl2_alias_index_build(struct aviutl2_alias_index *idx,
+                                             struct aviutl2_alias_section *sections,
+                                             size_t section_num,
+                                             uint32_t *slots,
+                                             size_t slot_num) {
+  if (slot_num == 0 || (slot_num & (slot_num - 1)) != 0 || section_num >= UINT32_MAX) {
+    return false;
+  }
+  memset(slots, 0, slot_num * sizeof(uint32_t));
+  *idx = (struct aviutl2_alias_index){sections, section_num, slots, slot_num};
+  size_t used = 0;
+  // Insert in reverse so that each chain starting at a slot is in text order.
+  for (size_t i = section_num; i > 0; --i) {
+    struct aviutl2_alias_section *s = sections + (i - 1);
+    s->next_same = 0;
+    if (!s->effect.ptr) {
+      continue;
+    }
+    uint32_t *slot = aviutl2_alias_index_slot(idx, s->effect.ptr, s->effect.len);
+    if (!*slot && ++used >= slot_num) {
+      return false;
+    }
+    s->next_same = *slot;
+    *slot = (uint32_t)i;
+  }
+  return true;
+}
+
+/**
+ * Find a section by effect name
+ * @param idx Index
+ * @param effect Effect name (UTF-8)
+ * @param nth Zero-based occurrence among sections with the same effect name, in text order
+ * @return Section, or NULL if not found
+ */
+static inline struct aviutl2_alias_section const *
+aviutl2_alias_index_find(struct aviutl2_alias_index const *idx, char const *effect, size_t nth) {
+  uint32_t i = *aviutl2_alias_index_slot(idx, effect, strlen(effect));
+  for (; i && nth; --nth) {
+    i = idx->sections[i - 1].next_same;
+  }
+  return i ? idx->sections + (i - 1) : NULL;
+}
+
+/**
+ * Edit of alias text
+ * Replaces [at, at + remove) of the original text with insert
+ */
+struct aviutl2_alias_edit {
+  char const *at;     /**< Position in the original text */
+  size_t remove;      /**< Number of bytes to remove */
+  char const *insert; /**< Text to insert */
+  size_t insert_len;  /**< Length of insert in bytes */
+};
+
+/**
+ * Create an edit that replaces a value
+ * @param value View of the value in the original text
+ * @param str New value (null-terminated)
+ * @return Edit
+ */
+static inline struct aviutl2_alias_edit aviutl2_alias_edit_replace(struct aviutl2_alias_view value, char const *str) {
+  return (struct aviutl2_alias_edit){value.ptr, value.len, str, strlen(str)};
+}
+
+/**
+ * Create an edit that inserts text at the end of a section
+ * @param section Section
+ * @param lines Text to insert, one or more complete lines such as "key=value\r\n"
+ * @return Edit
+ */
+static inline struct aviutl2_alias_edit aviutl2_alias_edit_append(struct aviutl2_alias_section const *section,
+                                                                  char const *lines) {
+  return (struct aviutl2_alias_edit){section->end, 0, lines, strlen(lines)};
+}
+
+/**
+ * Write alias text with edits applied
+ * @param dst Destination buffer (may be NULL when cap is 0)
+ * @param cap Size of destination buffer in bytes
+ * @param text Original text
+ * @param len Length of original text in bytes
+ * @param edits Edits sorted by position; ranges must not overlap
+ * @param edit_num Number of edits
+ * @return Length of the result in bytes excluding the null terminator (the result is truncated if this is not less than
+ *         cap), or SIZE_MAX if edits are out of order or out of range
+ */
+static inline size_t aviutl2_alias_apply(char *dst,
+                                         size_t cap,
+                                         char const *text,
+                                         size_t len,
+                                         struct aviutl2_alias_edit const *edits,
+                                         size_t edit_num) {
+  size_t out = 0;
+  char const *src = text;
+  char const *const end = text + len;
+#define AVIUTL2_ALIAS_PUT_(p, n)                                                                                       \
+  do {                                                                                                                 \
+    size_t const n_ = (n);                                                                                             \
+    if (out < cap) {                                                                                                   \
+      memcpy(dst + out, (p), cap - out > n_ ? n_ : cap - out);                                                         \
+    }                                                                                                                  \
+    out += n_;                                                                                                         \
+  } while (0)
+  for (size_t i = 0; i < edit_num; ++i) {
+    struct aviutl2_alias_edit const *e = edits + i;
+    if (e->at < src || e->at > end || e->remove > (size_t)(end - e->at)) {
+      return SIZE_MAX;
+    }
+    AVIUTL2_ALIAS_PUT_(src, (size_t)(e->at - src));
+    AVIUTL2_ALIAS_PUT_(e->insert, e->insert_len);
+    src = e->at + e->remove;
+  }
+  AVIUTL2_ALIAS_PUT_(src, (size_t)(end - src));
+#undef AVIUTL2_ALIAS_PUT_
+  if (cap) {
+    dst[out < cap ? out : cap - 1] = '\0';
+  }
+  return out;
+}
+
+/**
+ * Alias text writer
+ * Writes into a caller buffer; len keeps counting past cap so that the required size is known
+ */
+struct aviutl2_alias_writer {
+  char *buf;
+  size_t cap;
+  size_t len; /**< Length of the text in bytes excluding the null terminator */
+};
+
+/**
+ * Initialize a writer
+ * @param w Writer
+ * @param buf Destination buffer (may be NULL when cap is 0)
+ * @param cap Size of destination buffer in bytes
+ */
+static inline void aviutl2_alias_writer_init(struct aviutl2_alias_writer *w, char *buf, size_t cap) {
+  w->buf = buf;
+  w->cap = cap;
+  w->len = 0;
+  if (cap) {
+    buf[0] = '\0';
+  }
+}
+
+/**
+ * Append raw text
+ * @param w Writer
+ * @param str Text
+ * @param len Length of text in bytes
+ */
+static inline void aviutl2_alias_writer_raw(struct aviutl2_alias_writer *w, char const *str, size_t len) {
+  if (w->len + 1 < w->cap) {
+    size_t const room = w->cap - 1 - w->len;
+    memcpy(w->buf + w->len, str, len < room ? len : room);
+    w->buf[w->len + (len < room ? len : room)] = '\0';
+  }
+  w->len += len;
+}
+
+/**
+ * Append a "[name]" line
+ * @param w Writer
+ * @param name Section name
+ */
+static inline void aviutl2_alias_writer_section(struct aviutl2_alias_writer *w, char const *name) {
+  aviutl2_alias_writer_raw(w, "[", 1);
+  aviutl2_alias_writer_raw(w, name, strlen(name));
+  aviutl2_alias_writer_raw(w, "]\r\n", 3);
+}
+
+/**
+ * Append a "[object.index]" effect section line
+ * @param w Writer
+ * @param object Object section name
+ * @param index Effect index
+ */
+static inline void aviutl2_alias_writer_effect_section(struct aviutl2_alias_writer *w, char const *object, int index) {
+  char num[16];
+  int const n = snprintf(num, sizeof(num), ".%d", index);
+  aviutl2_alias_writer_raw(w, "[", 1);
+  aviutl2_alias_writer_raw(w, object, strlen(object));
+  aviutl2_alias_writer_raw(w, num, (size_t)n);
+  aviutl2_alias_writer_raw(w, "]\r\n", 3);
+}
+
+/**
+ * Append a "key=value" line
+ * @param w Writer
+ * @param key Key
+ * @param value Value
+ */
+static inline void aviutl2_alias_writer_entry(struct aviutl2_alias_writer *w, char const *key, char const *value) {
+  aviutl2_alias_writer_raw(w, key, strlen(key));
+  aviutl2_alias_writer_raw(w, "=", 1);
+  aviutl2_alias_writer_raw(w, value, strlen(value));
+  aviutl2_alias_writer_raw(w, "\r\n", 2);
+}
+
+/**
+ * Format a number with the fewest significant digits that read back as the same value
+ * The decimal separator is always '.', regardless of the current C locale.
+ * @param buf Buffer
+ * @param cap Size of buf in bytes (32 bytes is enough)
+ * @param value Value
+ * @return Number of bytes written, excluding the terminating null
+ */
+static inline int aviutl2_alias_format_number_(char *buf, size_t cap, double value) {
+  int n = 0;
+  for (int prec = 1; prec <= 17; ++prec) {
+    // strtod() uses the same locale as snprintf(), so the round trip check does not depend on it.
+    n = snprintf(buf, cap, "%.*g", prec, value);
+    if (n <= 0 || (size_t)n >= cap || strtod(buf, NULL) == value) {
+      break;
+    }
+  }
+  if (n <= 0 || (size_t)n >= cap) {
+    return 0;
+  }
+  // Replace the locale's decimal separator, which can be longer than one byte, with '.'.
+  // Everything else in the output is a digit, a sign, an exponent marker or inf/nan.
+  int len = 0;
+  bool sep = false;
+  for (int i = 0; i < n; ++i) {
+    unsigned char const c = (unsigned char)buf[i];
+    if ((c >= '0' && c <= '9') || c == '-' || c == '+' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+      buf[len++] = (char)c;
+      sep = false;
+    } else if (!sep) {
+      buf[len++] = '.';
+      sep = true;
+    }
+  }
+  buf[len] = '\0';
+  return len;
+}
+
+/**
+ * Append a "key=value" line with a number
+ * Numbers are written with the shortest representation that reads back as the same double, using '.' as the
+ * decimal separator regardless of the locale. Very large or small magnitudes use exponent notation.
+ * @param w Writer
+ * @param key Key
+ * @param value Value
+ */
+static inline void aviutl2_alias_writer_entry_number(struct aviutl2_alias_writer *w, char const *key, double value) {
+  char num[64];
+  int const n = aviutl2_alias_format_number_(num, sizeof(num), value);
+  aviutl2_alias_writer_raw(w, key, strlen(key));
+  aviutl2_alias_writer_raw(w, "=", 1);
+  aviutl2_alias_writer_raw(w, num, n > 0 ? (size_t)n : 0);
+  aviutl2_alias_writer_raw(w, "\r\n", 2);
+}
+
+/**
+ * Append a "frame=start,end" line
+ * @param w Writer
+ * @param start Start frame
+ * @param end End frame
+ */
+static inline void aviutl2_alias_writer_frame(struct aviutl2_alias_writer *w, int start, int end) {
+  char num[48];
+  int const n = snprintf(num, sizeof(num), "frame=%d,%d\r\n", start, end);
+  aviutl2_alias_writer_raw(w, num, n > 0 ? (size_t)n : 0);
+}
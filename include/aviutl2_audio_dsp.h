@@ -0,0 +1,366 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Audio DSP kernels for planar float buffers
+//
+// Gain ramps, constant-power pan, mix-down, DC removal and soft clipping operating in place on the per-channel
+// buffers returned by aviutl2_filter_proc_audio::get_sample_data(), each aviutl2_object_info::sample_num samples
+// long. Kernels use SSE2 when available and share the same arithmetic as their scalar tails, so both paths produce
+// identical results.
+//
+// A typical audio filter:
+//   unsigned const csr = aviutl2_audio_denormals_begin();
+//   audio->get_sample_data(l, 0);
+//   audio->get_sample_data(r, 1);
+//   aviutl2_audio_gain_process_param(&state->gain, buffers, 2, n, audio->object->sample_index, audio->param);
+//   aviutl2_audio_dc_blocker_process(&state->dc, buffers, 2, n);
+//   audio->set_sample_data(l, 0);
+//   audio->set_sample_data(r, 1);
+//   aviutl2_audio_denormals_end(csr);
+// where state is the filter userdata.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "aviutl2_filter2.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+enum {
+  aviutl2_audio_max_channels = 2,
+};
+
+/**
+ * Enable flush-to-zero and denormals-are-zero for the current thread
+ * Recursive filters decay into denormal numbers on silence, which are orders of magnitude slower on x86.
+ * @return Previous control state to pass to aviutl2_audio_denormals_end()
+ */
+static inline unsigned aviutl2_audio_denormals_begin(void) {
+#if AVIUTL2_HAS_SSE2
+  unsigned const csr = _mm_getcsr();
+  _mm_setcsr(csr | 0x8040); // FTZ | DAZ
+  return csr;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Restore the control state saved by aviutl2_audio_denormals_begin()
+ * @param csr Previous control state
+ */
+static inline void aviutl2_audio_denormals_end(unsigned csr) {
+#if AVIUTL2_HAS_SSE2
+  _mm_setcsr(csr);
+#else
+  (void)csr;
+#endif
+}
+
+/**
+ * Multiply samples by a gain that moves linearly from one value to another
+ * Sample i is multiplied by from + (to - from) * (i + 1) / n, so the last sample reaches the target exactly and
+ * consecutive calls join without steps.
+ * @param buffer Samples
+ * @param n Number of samples
+ * @param from Gain before the first sample
+ * @param to Gain at the last sample
+ */
+static inline void aviutl2_audio_gain_ramp(float *buffer, int n, float from, float to) {
+  if (n <= 0) {
+    return;
+  }
+  if (from == to) {
+    if (to == 1.f) {
+      return;
+    }
+    int i = 0;
+#if AVIUTL2_HAS_SSE2
+    __m128 const g = _mm_set1_ps(to);
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), g));
+    }
+#endif
+    for (; i < n; ++i) {
+      buffer[i] *= to;
+    }
+    return;
+  }
+  float const step = (to - from) / (float)n;
+  int i = 0;
+#if AVIUTL2_HAS_SSE2
+  __m128 const base = _mm_set1_ps(from);
+  __m128 const vstep = _mm_set1_ps(step);
+  __m128i idx = _mm_setr_epi32(1, 2, 3, 4);
+  __m128i const four = _mm_set1_epi32(4);
+  for (; i + 4 <= n; i += 4) {
+    __m128 const g = _mm_add_ps(base, _mm_mul_ps(vstep, _mm_cvtepi32_ps(idx)));
+    _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), g));
+    idx = _mm_add_epi32(idx, four);
+  }
+#endif
+  for (; i < n; ++i) {
+    buffer[i] *= from + step * (float)(i + 1);
+  }
+}
+
+/**
+ * Get constant-power pan gains
+ * The gains satisfy left^2 + right^2 = 2, so the center position has unity gain on both channels.
+ * @param pan Pan position (-1.0 = left, 0.0 = center, 1.0 = right)
+ * @param left Pointer to storage for the left gain
+ * @param right Pointer to storage for the right gain
+ */
+static inline void aviutl2_audio_pan_gains(float pan, float *left, float *right) {
+  if (pan < -1.f) {
+    pan = -1.f;
+  } else if (pan > 1.f) {
+    pan = 1.f;
+  }
+  double const angle = ((double)pan + 1.0) * 3.14159265358979323846 / 4.0;
+  *left = (float)(cos(angle) * 1.41421356237309504880);
+  *right = (float)(sin(angle) * 1.41421356237309504880);
+}
+
+/**
+ * Apply constant-power pan to a stereo pair
+ * The pan gains are interpolated from the previous to the current position over the buffer.
+ * @param left Left samples
+ * @param right Right samples
+ * @param n Number of samples per channel
+ * @param pan_from Pan position before the first sample
+ * @param pan_to Pan position at the last sample
+ */
+static inline void aviutl2_audio_pan(float *left, float *right, int n, float pan_from, float pan_to) {
+  float l0, r0, l1, r1;
+  aviutl2_audio_pan_gains(pan_from, &l0, &r0);
+  aviutl2_audio_pan_gains(pan_to, &l1, &r1);
+  aviutl2_audio_gain_ramp(left, n, l0, l1);
+  aviutl2_audio_gain_ramp(right, n, r0, r1);
+}
+
+/**
+ * Add scaled samples to a buffer
+ * @param dst Destination samples
+ * @param src Source samples
+ * @param n Number of samples
+ * @param gain Source gain
+ */
+static inline void aviutl2_audio_mix(float *dst, float const *src, int n, float gain) {
+  int i = 0;
+#if AVIUTL2_HAS_SSE2
+  __m128 const g = _mm_set1_ps(gain);
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] += src[i] * gain;
+  }
+}
+
+/**
+ * Replace every channel with the average of all channels
+ * @param buffers Channel buffers
+ * @param channel_num Number of channels
+ * @param n Number of samples per channel
+ */
+static inline void aviutl2_audio_mixdown(float *const *buffers, int channel_num, int n) {
+  if (channel_num < 2) {
+    return;
+  }
+  float const scale = 1.f / (float)channel_num;
+  float *const dst = buffers[0];
+  int i = 0;
+#if AVIUTL2_HAS_SSE2
+  __m128 const s = _mm_set1_ps(scale);
+  for (; i + 4 <= n; i += 4) {
+    __m128 sum = _mm_loadu_ps(dst + i);
+    for (int c = 1; c < channel_num; ++c) {
+      sum = _mm_add_ps(sum, _mm_loadu_ps(buffers[c] + i));
+    }
+    _mm_storeu_ps(dst + i, _mm_mul_ps(sum, s));
+  }
+#endif
+  for (; i < n; ++i) {
+    float sum = dst[i];
+    for (int c = 1; c < channel_num; ++c) {
+      sum += buffers[c][i];
+    }
+    dst[i] = sum * scale;
+  }
+  for (int c = 1; c < channel_num; ++c) {
+    memcpy(buffers[c], dst, (size_t)n * sizeof(float));
+  }
+}
+
+/**
+ * Limit samples smoothly towards a ceiling
+ * Uses the rational approximation x * (27 + x^2) / (27 + 9 x^2) of tanh on samples divided by the ceiling; the
+ * curve has unity slope near zero and reaches the ceiling exactly at three times the ceiling, where it is held.
+ * @param buffer Samples
+ * @param n Number of samples
+ * @param ceiling Output limit (greater than zero)
+ */
+static inline void aviutl2_audio_soft_clip(float *buffer, int n, float ceiling) {
+  float const in_scale = 1.f / ceiling;
+  float const out_scale = ceiling;
+  int i = 0;
+#if AVIUTL2_HAS_SSE2
+  __m128 const is = _mm_set1_ps(in_scale), os = _mm_set1_ps(out_scale);
+  __m128 const lo = _mm_set1_ps(-3.f), hi = _mm_set1_ps(3.f);
+  __m128 const c27 = _mm_set1_ps(27.f), c9 = _mm_set1_ps(9.f);
+  for (; i + 4 <= n; i += 4) {
+    __m128 x = _mm_mul_ps(_mm_loadu_ps(buffer + i), is);
+    x = _mm_min_ps(_mm_max_ps(x, lo), hi);
+    __m128 const x2 = _mm_mul_ps(x, x);
+    __m128 const y = _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c27, x2)), _mm_add_ps(c27, _mm_mul_ps(c9, x2)));
+    _mm_storeu_ps(buffer + i, _mm_mul_ps(y, os));
+  }
+#endif
+  for (; i < n; ++i) {
+    float x = buffer[i] * in_scale;
+    x = x < -3.f ? -3.f : (x > 3.f ? 3.f : x);
+    float const x2 = x * x;
+    float const y = (x * (27.f + x2)) / (27.f + 9.f * x2);
+    buffer[i] = y * out_scale;
+  }
+}
+
+//--------------------------------
+
+/**
+ * Click-free gain state
+ * Keep one per effect instance (for example in the filter userdata) and zero-initialize it
+ */
+struct aviutl2_audio_gain {
+  float gain[aviutl2_audio_max_channels];
+  int64_t next_sample_index;
+  bool valid;
+};
+
+/**
+ * Apply per-channel gains, ramping from the gains of the previous call
+ * The ramp is skipped after a discontinuity in sample_index, such as a seek, so that the first buffer uses the
+ * target gain throughout.
+ * @param g Gain state
+ * @param buffers Channel buffers
+ * @param channel_num Number of channels (up to aviutl2_audio_max_channels)
+ * @param n Number of samples per channel
+ * @param sample_index Position of the first sample (aviutl2_object_info::sample_index)
+ * @param gains Target gain of each channel
+ */
+static inline void aviutl2_audio_gain_process(struct aviutl2_audio_gain *g,
+                                              float *const *buffers,
+                                              int channel_num,
+                                              int n,
+                                              int64_t sample_index,
+                                              float const *gains) {
+  if (channel_num > aviutl2_audio_max_channels) {
+    channel_num = aviutl2_audio_max_channels;
+  }
+  bool const ramp = g->valid && g->next_sample_index == sample_index;
+  for (int c = 0; c < channel_num; ++c) {
+    aviutl2_audio_gain_ramp(buffers[c], n, ramp ? g->gain[c] : gains[c], gains[c]);
+    g->gain[c] = gains[c];
+  }
+  g->next_sample_index = sample_index + n;
+  g->valid = true;
+}
+
+/**
+ * Apply the object volume with click-free ramps and reset it to unity
+ * The host applies vol_l and vol_r as a constant per buffer; applying them here instead interpolates between
+ * consecutive buffers. param is set to 1.0 afterwards so that the volume is not applied twice.
+ * @param g Gain state
+ * @param buffers Channel buffers (left, right)
+ * @param channel_num Number of channels (1 uses vol_l only)
+ * @param n Number of samples per channel
+ * @param sample_index Position of the first sample (aviutl2_object_info::sample_index)
+ * @param param Object audio parameters (aviutl2_filter_proc_audio::param)
+ */
+static inline void aviutl2_audio_gain_process_param(struct aviutl2_audio_gain *g,
+                                                    float *const *buffers,
+                                                    int channel_num,
+                                                    int n,
+                                                    int64_t sample_index,
+                                                    struct aviutl2_object_audio_param *param) {
+  float const gains[aviutl2_audio_max_channels] = {param->vol_l, param->vol_r};
+  aviutl2_audio_gain_process(g, buffers, channel_num, n, sample_index, gains);
+  param->vol_l = 1.f;
+  param->vol_r = 1.f;
+}
+
+//--------------------------------
+
+/**
+ * DC blocking filter state
+ * One-pole high-pass y[n] = x[n] - x[n - 1] + r * y[n - 1]. The recursion runs along time, so channels are
+ * processed one by one; enable FTZ/DAZ with aviutl2_audio_denormals_begin() to keep the decay tail fast.
+ */
+struct aviutl2_audio_dc_blocker {
+  float r;
+  float x1[aviutl2_audio_max_channels];
+  float y1[aviutl2_audio_max_channels];
+};
+
+/**
+ * Initialize a DC blocking filter
+ * @param dc Filter state
+ * @param cutoff Cutoff frequency in Hz (around 10 to 30 Hz is typical)
+ * @param sample_rate Sampling rate
+ */
+static inline void aviutl2_audio_dc_blocker_init(struct aviutl2_audio_dc_blocker *dc, float cutoff, int sample_rate) {
+  memset(dc, 0, sizeof(*dc));
+  dc->r = (float)exp(-2.0 * 3.14159265358979323846 * (double)cutoff / (double)sample_rate);
+}
+
+/**
+ * Clear the history of a DC blocking filter, for example after a seek
+ * @param dc Filter state
+ */
+static inline void aviutl2_audio_dc_blocker_reset(struct aviutl2_audio_dc_blocker *dc) {
+  memset(dc->x1, 0, sizeof(dc->x1));
+  memset(dc->y1, 0, sizeof(dc->y1));
+}
+
+/**
+ * Remove DC offset in place
+ * @param dc Filter state
+ * @param buffers Channel buffers
+ * @param channel_num Number of channels (up to aviutl2_audio_max_channels)
+ * @param n Number of samples per channel
+ */
+static inline void
+aviutl2_audio_dc_blocker_process(struct aviutl2_audio_dc_blocker *dc, float *const *buffers, int channel_num, int n) {
+  if (channel_num > aviutl2_audio_max_channels) {
+    channel_num = aviutl2_audio_max_channels;
+  }
+  float const r = dc->r;
+  for (int c = 0; c < channel_num; ++c) {
+    float *const p = buffers[c];
+    float x1 = dc->x1[c], y1 = dc->y1[c];
+    for (int i = 0; i < n; ++i) {
+      float const x = p[i];
+      y1 = x - x1 + r * y1;
+      x1 = x;
+      p[i] = y1;
+    }
+    dc->x1[c] = x1;
+    dc->y1[c] = y1;
+  }
+}
@@ -0,0 +1,771 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Tempo and beat detection for Grid(BPM)
+//
+// Builds an onset envelope from the spectral flux of log-compressed FFT magnitudes (about 100 envelope frames per
+// second), autocorrelates it over sliding 8 second windows as audio is fed in, and turns the per-window tempos into
+// aviutl2_bpm_info entries: tempo changes start a new entry, and each entry's tempo and beat offset are refined with
+// a comb search over the envelope of its whole range.
+//
+// The detector can be fed directly from any audio source; for media files a background job reads the audio through
+// aviutl2_cache_handle::get_audio_file_data() so that the UI stays responsive:
+//   g_job = aviutl2_bpm_detect_job_start(g_cache, path, 0, 60.f, 200.f, 4);
+//   // from a timer: show aviutl2_bpm_detect_job_progress(g_job) until the job is no longer running, then
+//   g_edit->call_edit_section_param(g_job, aviutl2_bpm_detect_job_apply);
+//   aviutl2_bpm_detect_job_destroy(g_job);
+// Destroying a running job cancels it and waits for its thread, which stops within one read of
+// aviutl2_bpm_detect_read_chunk samples; destroy every job before UninitializePlugin() returns.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_cache2.h"
+#include "aviutl2_fft.h"
+#include "aviutl2_plugin2.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+enum {
+  aviutl2_bpm_detect_envelope_rate = 100,
+  aviutl2_bpm_detect_max_frequency = 8000,
+  aviutl2_bpm_detect_window_seconds = 8,
+  aviutl2_bpm_detect_hop_seconds = 2,
+  aviutl2_bpm_detect_median_windows = 5,
+  aviutl2_bpm_detect_min_segment_windows = 4,
+  aviutl2_bpm_detect_read_chunk = 65536,
+  aviutl2_bpm_detect_progress_max = 10000,
+};
+
+/**
+ * Tempo detector state
+ */
+struct aviutl2_bpm_detect {
+  struct aviutl2_fft fft;
+  int sample_rate;    /**< Sampling rate of the input */
+  int hop;            /**< Input samples per envelope frame */
+  double env_rate;    /**< Envelope frames per second */
+  int lag_min;        /**< Shortest beat period searched, in envelope frames */
+  int lag_max;        /**< Longest beat period searched, in envelope frames */
+  int acf_len;        /**< Autocorrelation lags kept per window */
+  int window_len;     /**< Analysis window length in envelope frames */
+  int window_hop;     /**< Distance between analysis windows in envelope frames */
+  int bin_limit;      /**< Number of spectrum bins that contribute to the flux */
+  int fill;           /**< Samples currently held in frame */
+  int64_t sample_num; /**< Samples fed so far */
+  float *frame;
+  float *work;
+  float *magnitude;
+  float *prev;
+  float *centered;
+  float *env; /**< Onset envelope */
+  size_t env_num;
+  size_t env_cap;
+  float *acf; /**< acf_len normalized autocorrelation lags per window */
+  size_t window_num;
+  size_t window_cap;
+  void *block;
+};
+
+/**
+ * Release a tempo detector
+ * @param d Detector
+ */
+static inline void aviutl2_bpm_detect_exit(struct aviutl2_bpm_detect *d) {
+  if (!d) {
+    return;
+  }
+  aviutl2_fft_exit(&d->fft);
+  free(d->block);
+  free(d->env);
+  free(d->acf);
+  memset(d, 0, sizeof(*d));
+}
+
+/**
+ * Initialize a tempo detector
+ * @param d Detector
+ * @param sample_rate Sampling rate of the audio that will be fed
+ * @param min_tempo Slowest tempo to consider (BPM, 40 or more)
+ * @param max_tempo Fastest tempo to consider (BPM)
+ * @return true on success
+ */
+static inline bool
+aviutl2_bpm_detect_init(struct aviutl2_bpm_detect *d, int sample_rate, float min_tempo, float max_tempo) {
+  if (!d) {
+    return false;
+  }
+  memset(d, 0, sizeof(*d));
+  if (sample_rate < 8000 || sample_rate > 768000 || !(min_tempo >= 40.f) || !(max_tempo > min_tempo)) {
+    return false;
+  }
+  // About 40 ms of audio per spectrum, one spectrum per 10 ms
+  int size = aviutl2_fft_min_size;
+  while (size < sample_rate / 25) {
+    size *= 2;
+  }
+  if (!aviutl2_fft_init(&d->fft, size, aviutl2_fft_window_hann)) {
+    return false;
+  }
+  d->sample_rate = sample_rate;
+  d->hop = (sample_rate + aviutl2_bpm_detect_envelope_rate / 2) / aviutl2_bpm_detect_envelope_rate;
+  d->env_rate = (double)sample_rate / (double)d->hop;
+  d->lag_min = (int)floor(60.0 * d->env_rate / (double)max_tempo);
+  if (d->lag_min < 2) {
+    d->lag_min = 2;
+  }
+  d->lag_max = (int)ceil(60.0 * d->env_rate / (double)min_tempo);
+  d->acf_len = d->lag_max * 2 + 2;
+  d->window_len = (int)lround(aviutl2_bpm_detect_window_seconds * d->env_rate);
+  d->window_hop = (int)lround(aviutl2_bpm_detect_hop_seconds * d->env_rate);
+  d->bin_limit = (int)((int64_t)aviutl2_bpm_detect_max_frequency * size / sample_rate) + 1;
+  if (d->bin_limit > d->fft.bin_num) {
+    d->bin_limit = d->fft.bin_num;
+  }
+  size_t const bin_num = (size_t)d->fft.bin_num;
+  d->block = calloc((size_t)size + bin_num * 4 + (size_t)d->window_len, sizeof(float));
+  if (!d->block) {
+    aviutl2_bpm_detect_exit(d);
+    return false;
+  }
+  d->frame = (float *)d->block;
+  d->work = d->frame + size;
+  d->magnitude = d->work + bin_num * 2;
+  d->prev = d->magnitude + bin_num;
+  d->centered = d->prev + bin_num;
+  // Half a frame of leading silence centers envelope frame t on input sample t * hop
+  d->fill = size / 2;
+  return true;
+}
+
+static inline float aviutl2_bpm_detect_log2_(float x) {
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  float const e = (float)((int32_t)(bits >> 23) - 127);
+  bits = (bits & 0x007fffffu) | 0x3f800000u;
+  float m;
+  memcpy(&m, &bits, sizeof(m));
+  return e + ((-0.34484843f * m + 2.02466578f) * m - 0.67487759f);
+}
+
+#if AVIUTL2_HAS_SSE2
+static inline __m128 aviutl2_bpm_detect_log2_ps_(__m128 x) {
+  __m128i const bits = _mm_castps_si128(x);
+  __m128 const e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+  __m128 const m = _mm_castsi128_ps(
+      _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+  __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.34484843f), m), _mm_set1_ps(2.02466578f));
+  p = _mm_sub_ps(_mm_mul_ps(p, m), _mm_set1_ps(0.67487759f));
+  return _mm_add_ps(e, p);
+}
+#endif
+
+static inline float aviutl2_bpm_detect_flux_(struct aviutl2_bpm_detect *d) {
+  aviutl2_fft_magnitude(&d->fft, d->frame, d->work, d->magnitude);
+  float const *const mag = d->magnitude;
+  float *const prev = d->prev;
+  int const n = d->bin_limit;
+  // log2(1 + 1000 * amplitude) keeps quiet instruments visible next to loud ones
+  float const gamma = 1000.f;
+  float sum = 0.f;
+  int k = 1;
+#if AVIUTL2_HAS_SSE2
+  __m128 const one = _mm_set1_ps(1.f), g = _mm_set1_ps(gamma), zero = _mm_setzero_ps();
+  __m128 acc = zero;
+  for (; k + 4 <= n; k += 4) {
+    __m128 const l = aviutl2_bpm_detect_log2_ps_(_mm_add_ps(one, _mm_mul_ps(g, _mm_loadu_ps(mag + k))));
+    acc = _mm_add_ps(acc, _mm_max_ps(_mm_sub_ps(l, _mm_loadu_ps(prev + k)), zero));
+    _mm_storeu_ps(prev + k, l);
+  }
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  sum = _mm_cvtss_f32(acc);
+#endif
+  for (; k < n; ++k) {
+    float const l = aviutl2_bpm_detect_log2_(1.f + gamma * mag[k]);
+    float const diff = l - prev[k];
+    sum += diff > 0.f ? diff : 0.f;
+    prev[k] = l;
+  }
+  return sum;
+}
+
+static inline float aviutl2_bpm_detect_dot_(float const *a, float const *b, int n) {
+  int i = 0;
+  float sum = 0.f;
+#if AVIUTL2_HAS_SSE2
+  __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  acc0 = _mm_add_ps(acc0, acc1);
+  acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+  acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+  sum = _mm_cvtss_f32(acc0);
+#endif
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+/**
+ * Normalized autocorrelation of the envelope in [start, start + len)
+ * A window without variation (silence, constant noise) yields all zeros.
+ */
+static inline void aviutl2_bpm_detect_autocorrelate_(
+    struct aviutl2_bpm_detect const *d, size_t start, int len, float *centered, float *out) {
+  float const *const x = d->env + start;
+  double mean = 0.0;
+  for (int i = 0; i < len; ++i) {
+    mean += x[i];
+  }
+  mean /= (double)len;
+  for (int i = 0; i < len; ++i) {
+    centered[i] = (float)(x[i] - mean);
+  }
+  float const energy = aviutl2_bpm_detect_dot_(centered, centered, len);
+  if (!(energy > 1e-6f * (float)len)) {
+    memset(out, 0, (size_t)d->acf_len * sizeof(float));
+    return;
+  }
+  for (int lag = 0; lag < d->acf_len; ++lag) {
+    int const n = len - lag;
+    out[lag] = aviutl2_bpm_detect_dot_(centered, centered + lag, n) * ((float)len / (float)n) / energy;
+  }
+}
+
+static inline bool aviutl2_bpm_detect_push_(struct aviutl2_bpm_detect *d, float value) {
+  if (d->env_num == d->env_cap) {
+    size_t const cap = d->env_cap ? d->env_cap * 2 : 4096;
+    float *const env = (float *)realloc(d->env, cap * sizeof(float));
+    if (!env) {
+      return false;
+    }
+    d->env = env;
+    d->env_cap = cap;
+  }
+  d->env[d->env_num++] = value;
+  size_t const start = d->window_num * (size_t)d->window_hop;
+  if (d->env_num < start + (size_t)d->window_len) {
+    return true;
+  }
+  if (d->window_num == d->window_cap) {
+    size_t const cap = d->window_cap ? d->window_cap * 2 : 64;
+    float *const acf = (float *)realloc(d->acf, cap * (size_t)d->acf_len * sizeof(float));
+    if (!acf) {
+      return false;
+    }
+    d->acf = acf;
+    d->window_cap = cap;
+  }
+  aviutl2_bpm_detect_autocorrelate_(
+      d, start, d->window_len, d->centered, d->acf + d->window_num * (size_t)d->acf_len);
+  ++d->window_num;
+  return true;
+}
+
+/**
+ * Feed audio
+ * Can be called any number of times with blocks of any size
+ * @param d Detector
+ * @param left Left channel (or the only channel)
+ * @param right Right channel (NULL for mono)
+ * @param sample_num Number of samples per channel
+ * @return false if memory ran out
+ */
+static inline bool aviutl2_bpm_detect_process(struct aviutl2_bpm_detect *d,
+                                              float const *left,
+                                              float const *right,
+                                              int sample_num) {
+  int const size = d->fft.size;
+  while (sample_num > 0) {
+    int n = size - d->fill;
+    if (n > sample_num) {
+      n = sample_num;
+    }
+    float *const dst = d->frame + d->fill;
+    if (right) {
+      for (int i = 0; i < n; ++i) {
+        dst[i] = (left[i] + right[i]) * 0.5f;
+      }
+      right += n;
+    } else {
+      memcpy(dst, left, (size_t)n * sizeof(float));
+    }
+    left += n;
+    sample_num -= n;
+    d->fill += n;
+    d->sample_num += n;
+    if (d->fill == size) {
+      if (!aviutl2_bpm_detect_push_(d, aviutl2_bpm_detect_flux_(d))) {
+        return false;
+      }
+      memmove(d->frame, d->frame + d->hop, (size_t)(size - d->hop) * sizeof(float));
+      d->fill = size - d->hop;
+    }
+  }
+  return true;
+}
+
+/**
+ * Pick the beat period from an autocorrelation, weighted by a log-normal prior around a tempo
+ * @return Tempo in BPM, or 0 if the autocorrelation has no positive peak
+ */
+static inline double aviutl2_bpm_detect_pick_(struct aviutl2_bpm_detect const *d,
+                                              float const *acf,
+                                              double center,
+                                              double sigma,
+                                              float *score) {
+  double const center_lag = 60.0 * d->env_rate / center;
+  int best = -1;
+  for (int lag = d->lag_min; lag <= d->lag_max; ++lag) {
+    // The second harmonic favours the period whose multiples also line up with onsets
+    float const s = acf[lag] + 0.5f * acf[lag * 2];
+    double const octave = log2((double)lag / center_lag) / sigma;
+    score[lag] = s > 0.f ? s * (float)exp(-0.5 * octave * octave) : 0.f;
+    if (best < 0 || score[lag] > score[best]) {
+      best = lag;
+    }
+  }
+  if (best < 0 || !(score[best] > 0.f)) {
+    return 0.0;
+  }
+  double lag = (double)best;
+  if (best > d->lag_min && best < d->lag_max) {
+    double const a = score[best - 1], b = score[best], c = score[best + 1];
+    double const den = a - 2.0 * b + c;
+    if (den < 0.0) {
+      lag += 0.5 * (a - c) / den;
+    }
+  }
+  return 60.0 * d->env_rate / lag;
+}
+
+static inline double aviutl2_bpm_detect_comb_(float const *env, size_t f0, size_t f1, double period, double phase) {
+  double sum = 0.0;
+  int n = 0;
+  for (double pos = (double)f0 + phase; pos + 1.0 < (double)f1; pos += period) {
+    size_t const i = (size_t)pos;
+    double const t = pos - (double)i;
+    sum += (double)env[i] + ((double)env[i + 1] - (double)env[i]) * t;
+    ++n;
+  }
+  return n ? sum / (double)n : 0.0;
+}
+
+/**
+ * Refine the tempo and find the beat phase of [f0, f1) by maximizing the mean envelope on the beat grid
+ * The tempo is searched in three passes of ten times finer steps around the estimate
+ */
+static inline void aviutl2_bpm_detect_refine_(struct aviutl2_bpm_detect const *d,
+                                              size_t f0,
+                                              size_t f1,
+                                              double *tempo,
+                                              double *phase) {
+  double best_tempo = *tempo, best_phase = 0.0, best = -1.0;
+  double range = 0.025;
+  for (int pass = 0; pass < 3; ++pass) {
+    double const center = best_tempo, step = range / 10.0;
+    for (int k = -10; k <= 10; ++k) {
+      double const t = center * (1.0 + step * (double)k);
+      double const period = 60.0 * d->env_rate / t;
+      for (int p = 0; p < (int)ceil(period); ++p) {
+        double const s = aviutl2_bpm_detect_comb_(d->env, f0, f1, period, (double)p);
+        if (s > best) {
+          best = s;
+          best_tempo = t;
+          best_phase = (double)p;
+        }
+      }
+    }
+    range = step;
+  }
+  double const period = 60.0 * d->env_rate / best_tempo;
+  double const a = aviutl2_bpm_detect_comb_(d->env, f0, f1, period, best_phase > 0.0 ? best_phase - 1.0 : period - 1.0);
+  double const c = aviutl2_bpm_detect_comb_(d->env, f0, f1, period, best_phase + 1.0);
+  double const den = a - 2.0 * best + c;
+  if (den < 0.0) {
+    best_phase += 0.5 * (a - c) / den;
+  }
+  *tempo = best_tempo;
+  *phase = fmod(best_phase + period, period);
+}
+
+static inline int aviutl2_bpm_detect_compare_double_(void const *a, void const *b) {
+  double const x = *(double const *)a, y = *(double const *)b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+/**
+ * Build the BPM list from the audio fed so far
+ * Does not change the detector, so it can be called repeatedly while audio is still being fed.
+ * Each entry starts at the beginning of a range with a steady tempo; offset is the position of the first beat of
+ * that range relative to start.
+ * @param d Detector
+ * @param beat Beats per measure stored in each entry
+ * @param bpm_list Destination (may be NULL)
+ * @param bpm_num Number of entries that can be stored
+ * @return Number of detected entries (may exceed bpm_num), 0 if no tempo was found, or -1 if memory ran out
+ */
+static inline int aviutl2_bpm_detect_finish(struct aviutl2_bpm_detect const *d,
+                                            int beat,
+                                            struct aviutl2_bpm_info *bpm_list,
+                                            int bpm_num) {
+  // Audio shorter than one window is analyzed as a single window
+  size_t window_num = d->window_num;
+  int window_len = d->window_len;
+  bool const tail = window_num == 0 && d->env_num >= (size_t)d->acf_len * 2;
+  if (tail) {
+    window_num = 1;
+    window_len = (int)d->env_num;
+  }
+  if (window_num == 0) {
+    return 0;
+  }
+  size_t const acf_len = (size_t)d->acf_len;
+  float *const fbuf = (float *)malloc((acf_len * 2 + (tail ? acf_len + (size_t)window_len : 0)) * sizeof(float));
+  double *const dbuf = (double *)malloc(window_num * 3 * sizeof(double) + (window_num + 1) * sizeof(size_t));
+  if (!fbuf || !dbuf) {
+    free(fbuf);
+    free(dbuf);
+    return -1;
+  }
+  float *const global = fbuf;
+  float *const score = fbuf + acf_len;
+  float const *acf = d->acf;
+  if (tail) {
+    float *const tail_acf = fbuf + acf_len * 2;
+    aviutl2_bpm_detect_autocorrelate_(d, 0, window_len, tail_acf + acf_len, tail_acf);
+    acf = tail_acf;
+  }
+  double *const tempo = dbuf;
+  double *const smooth = dbuf + window_num;
+  double *const sorted = dbuf + window_num * 2;
+  size_t *const seg = (size_t *)(void *)(dbuf + window_num * 3);
+
+  // The sum over all windows only decides whether there is a tempo at all; a prior centered on it would pull real
+  // tempo changes towards the dominant tempo, so each window uses the same broad prior instead
+  memset(global, 0, acf_len * sizeof(float));
+  for (size_t w = 0; w < window_num; ++w) {
+    for (size_t i = 0; i < acf_len; ++i) {
+      global[i] += acf[w * acf_len + i];
+    }
+  }
+  int result = 0;
+  size_t seg_num = 0;
+  double const global_tempo = aviutl2_bpm_detect_pick_(d, global, 120.0, 1.0, score);
+  if (global_tempo <= 0.0) {
+    goto cleanup;
+  }
+  for (size_t w = 0; w < window_num; ++w) {
+    tempo[w] = aviutl2_bpm_detect_pick_(d, acf + w * acf_len, 120.0, 1.0, score);
+  }
+  // Windows without a tempo take the nearest preceding one, or the following one at the beginning
+  for (size_t w = 1; w < window_num; ++w) {
+    if (tempo[w] <= 0.0) {
+      tempo[w] = tempo[w - 1];
+    }
+  }
+  for (size_t w = window_num - 1; w > 0; --w) {
+    if (tempo[w - 1] <= 0.0) {
+      tempo[w - 1] = tempo[w];
+    }
+  }
+  for (size_t w = 0; w < window_num; ++w) {
+    if (tempo[w] <= 0.0) {
+      tempo[w] = global_tempo;
+    }
+  }
+  for (size_t w = 0; w < window_num; ++w) {
+    size_t const half = aviutl2_bpm_detect_median_windows / 2;
+    size_t const lo = w > half ? w - half : 0;
+    size_t const hi = w + half + 1 < window_num ? w + half + 1 : window_num;
+    memcpy(sorted, tempo + lo, (hi - lo) * sizeof(double));
+    qsort(sorted, hi - lo, sizeof(double), aviutl2_bpm_detect_compare_double_);
+    smooth[w] = sorted[(hi - lo) / 2];
+  }
+
+  // Split where the tempo moves more than 3% away from the beginning of the current range
+  seg[seg_num++] = 0;
+  for (size_t w = 1; w < window_num; ++w) {
+    if (fabs(log(smooth[w] / smooth[seg[seg_num - 1]])) > log(1.03)) {
+      seg[seg_num++] = w;
+    }
+  }
+  seg[seg_num] = window_num;
+  // Fold ranges that are too short to be a real tempo change into the neighbour with the closer tempo
+  for (;;) {
+    size_t shortest = 0;
+    for (size_t s = 1; s < seg_num; ++s) {
+      if (seg[s + 1] - seg[s] < seg[shortest + 1] - seg[shortest]) {
+        shortest = s;
+      }
+    }
+    if (seg_num < 2 || seg[shortest + 1] - seg[shortest] >= aviutl2_bpm_detect_min_segment_windows) {
+      break;
+    }
+    size_t remove = shortest;
+    if (shortest == 0) {
+      remove = 1;
+    } else if (shortest + 1 < seg_num) {
+      double const self = smooth[seg[shortest]];
+      double const before = fabs(log(smooth[seg[shortest - 1]] / self));
+      double const after = fabs(log(smooth[seg[shortest + 1]] / self));
+      remove = before <= after ? shortest : shortest + 1;
+    }
+    memmove(seg + remove, seg + remove + 1, (seg_num - remove) * sizeof(size_t));
+    --seg_num;
+  }
+
+  for (size_t s = 0; s < seg_num; ++s) {
+    size_t const n = seg[s + 1] - seg[s];
+    memcpy(sorted, smooth + seg[s], n * sizeof(double));
+    qsort(sorted, n, sizeof(double), aviutl2_bpm_detect_compare_double_);
+    double t = sorted[n / 2], phase = 0.0;
+    // Ranges meet halfway between the centers of their outermost windows
+    size_t const f0 = s ? seg[s] * (size_t)d->window_hop + (size_t)(window_len - d->window_hop) / 2 : 0;
+    size_t const f1 =
+        s + 1 < seg_num ? seg[s + 1] * (size_t)d->window_hop + (size_t)(window_len - d->window_hop) / 2 : d->env_num;
+    aviutl2_bpm_detect_refine_(d, f0, f1, &t, &phase);
+    if ((int)s < bpm_num && bpm_list) {
+      bpm_list[s].tempo = (float)t;
+      bpm_list[s].beat = beat;
+      bpm_list[s].start = (double)f0 / d->env_rate;
+      // The flux rises while an onset enters the analysis frame, so its peak leads the onset by about a fifth of
+      // the frame
+      double const period = 60.0 / t;
+      bpm_list[s].offset = (float)fmod(phase / d->env_rate + (double)d->fft.size * 0.2 / d->sample_rate, period);
+    }
+  }
+  result = (int)seg_num;
+
+cleanup:
+  free(fbuf);
+  free(dbuf);
+  return result;
+}
+
+//--------------------------------
+
+/**
+ * State of a background detection job
+ */
+enum aviutl2_bpm_detect_state {
+  aviutl2_bpm_detect_state_running = 0, /**< Still reading or analyzing */
+  aviutl2_bpm_detect_state_done = 1,    /**< Result is available (it may be empty) */
+  aviutl2_bpm_detect_state_failed = 2,  /**< File could not be read or memory ran out */
+};
+
+/**
+ * Background detection job for a media file
+ */
+struct aviutl2_bpm_detect_job {
+  struct aviutl2_cache_handle *cache;
+  HANDLE thread;
+  LONG cancelled;
+  LONG state;
+  LONG progress;
+  int track;
+  int beat;
+  float min_tempo;
+  float max_tempo;
+  struct aviutl2_bpm_info *result;
+  int result_num;
+  wchar_t path[1];
+};
+
+static inline bool aviutl2_bpm_detect_job_run_(struct aviutl2_bpm_detect_job *job) {
+  struct aviutl2_audio_info info = {0};
+  if (!job->cache->get_audio_file_info(job->path, &info, (int)sizeof(info)) || info.sample_num <= 0) {
+    return false;
+  }
+  struct aviutl2_bpm_detect d;
+  if (!aviutl2_bpm_detect_init(&d, info.rate, job->min_tempo, job->max_tempo)) {
+    return false;
+  }
+  bool ok = false;
+  int num = 0;
+  float *const buf = (float *)malloc((size_t)aviutl2_bpm_detect_read_chunk * 2 * sizeof(float));
+  if (!buf) {
+    goto cleanup;
+  }
+  for (int64_t pos = 0; pos < info.sample_num;) {
+    if (InterlockedCompareExchange(&job->cancelled, 0, 0)) {
+      goto cleanup;
+    }
+    int64_t const rest = info.sample_num - pos;
+    int const n = rest < aviutl2_bpm_detect_read_chunk ? (int)rest : aviutl2_bpm_detect_read_chunk;
+    int const got =
+        job->cache->get_audio_file_data(job->path, job->track, pos, n, buf, buf + aviutl2_bpm_detect_read_chunk);
+    if (got <= 0) {
+      break;
+    }
+    if (!aviutl2_bpm_detect_process(&d, buf, buf + aviutl2_bpm_detect_read_chunk, got)) {
+      goto cleanup;
+    }
+    pos += got;
+    InterlockedExchange(&job->progress, (LONG)(pos * aviutl2_bpm_detect_progress_max / info.sample_num));
+  }
+  if (InterlockedCompareExchange(&job->cancelled, 0, 0)) {
+    goto cleanup;
+  }
+  num = aviutl2_bpm_detect_finish(&d, job->beat, NULL, 0);
+  if (num < 0) {
+    goto cleanup;
+  }
+  if (num > 0) {
+    job->result = (struct aviutl2_bpm_info *)malloc((size_t)num * sizeof(struct aviutl2_bpm_info));
+    if (!job->result) {
+      goto cleanup;
+    }
+    aviutl2_bpm_detect_finish(&d, job->beat, job->result, num);
+  }
+  job->result_num = num;
+  ok = true;
+
+cleanup:
+  free(buf);
+  aviutl2_bpm_detect_exit(&d);
+  return ok;
+}
+
+static inline DWORD WINAPI aviutl2_bpm_detect_job_proc(void *param) {
+  struct aviutl2_bpm_detect_job *job = (struct aviutl2_bpm_detect_job *)param;
+  bool const ok = aviutl2_bpm_detect_job_run_(job);
+  InterlockedExchange(&job->progress, aviutl2_bpm_detect_progress_max);
+  // The interlocked store orders the result before the state change
+  InterlockedExchange(&job->state, ok ? aviutl2_bpm_detect_state_done : aviutl2_bpm_detect_state_failed);
+  return 0;
+}
+
+/**
+ * Start detecting the tempo of a media file on a background thread
+ * @param cache Cache handle passed to InitializeCache()
+ * @param path Path to media file
+ * @param track Audio track number
+ * @param min_tempo Slowest tempo to consider (BPM, 40 or more)
+ * @param max_tempo Fastest tempo to consider (BPM)
+ * @param beat Beats per measure stored in the result
+ * @return Job, or NULL if it could not be started
+ */
+static inline struct aviutl2_bpm_detect_job *aviutl2_bpm_detect_job_start(struct aviutl2_cache_handle *cache,
+                                                                        wchar_t const *path,
+                                                                        int track,
+                                                                        float min_tempo,
+                                                                        float max_tempo,
+                                                                        int beat) {
+  if (!cache || !path || !path[0]) {
+    return NULL;
+  }
+  size_t const len = wcslen(path);
+  struct aviutl2_bpm_detect_job *job =
+      (struct aviutl2_bpm_detect_job *)calloc(1, sizeof(*job) + len * sizeof(wchar_t));
+  if (!job) {
+    return NULL;
+  }
+  memcpy(job->path, path, (len + 1) * sizeof(wchar_t));
+  job->cache = cache;
+  job->track = track;
+  job->beat = beat;
+  job->min_tempo = min_tempo;
+  job->max_tempo = max_tempo;
+  job->thread = CreateThread(NULL, 0, aviutl2_bpm_detect_job_proc, job, 0, NULL);
+  if (!job->thread) {
+    free(job);
+    return NULL;
+  }
+  return job;
+}
+
+/**
+ * Get the state of a job
+ * @param job Job
+ * @return State
+ */
+static inline enum aviutl2_bpm_detect_state aviutl2_bpm_detect_job_state(struct aviutl2_bpm_detect_job *job) {
+  return (enum aviutl2_bpm_detect_state)InterlockedCompareExchange(&job->state, 0, 0);
+}
+
+/**
+ * Get the progress of a job
+ * @param job Job
+ * @return Fraction of the file read so far (0.0 to 1.0)
+ */
+static inline float aviutl2_bpm_detect_job_progress(struct aviutl2_bpm_detect_job *job) {
+  return (float)InterlockedCompareExchange(&job->progress, 0, 0) / (float)aviutl2_bpm_detect_progress_max;
+}
+
+/**
+ * Get the detected BPM list
+ * @param job Job
+ * @param bpm_list Destination (may be NULL)
+ * @param bpm_num Number of entries that can be stored
+ * @return Number of detected entries, or 0 if the job has not finished successfully
+ */
+static inline int
+aviutl2_bpm_detect_job_result(struct aviutl2_bpm_detect_job *job, struct aviutl2_bpm_info *bpm_list, int bpm_num) {
+  if (aviutl2_bpm_detect_job_state(job) != aviutl2_bpm_detect_state_done) {
+    return 0;
+  }
+  if (bpm_list) {
+    memcpy(bpm_list,
+           job->result,
+           (size_t)(bpm_num < job->result_num ? bpm_num : job->result_num) * sizeof(struct aviutl2_bpm_info));
+  }
+  return job->result_num;
+}
+
+/**
+ * Replace the Grid(BPM) settings with the detected list
+ * Pass to aviutl2_edit_handle::call_edit_section_param() with the job as param. Does nothing unless the job has
+ * finished with at least one entry.
+ * @param param Job
+ * @param edit Edit section
+ */
+static inline void aviutl2_bpm_detect_job_apply(void *param, struct aviutl2_edit_section *edit) {
+  struct aviutl2_bpm_detect_job *job = (struct aviutl2_bpm_detect_job *)param;
+  if (aviutl2_bpm_detect_job_state(job) != aviutl2_bpm_detect_state_done || job->result_num == 0) {
+    return;
+  }
+  edit->set_grid_bpm_list(job->result, job->result_num, (int)sizeof(struct aviutl2_bpm_info));
+}
+
+/**
+ * Destroy a job
+ * A running job is cancelled and this waits until its thread has exited, so the cache handle is no longer used
+ * afterwards. Call this for every job before UninitializePlugin() returns.
+ * @param job Job (may be NULL)
+ */
+static inline void aviutl2_bpm_detect_job_destroy(struct aviutl2_bpm_detect_job *job) {
+  if (!job) {
+    return;
+  }
+  InterlockedExchange(&job->cancelled, 1);
+  WaitForSingleObject(job->thread, INFINITE);
+  CloseHandle(job->thread);
+  free(job->result);
+  free(job);
+}
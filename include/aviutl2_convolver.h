@@ -0,0 +1,623 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Partitioned convolution for impulse-response audio filters
+//
+// Uniformly partitioned overlap-save convolution built on aviutl2_fft.h. The impulse response is split into
+// block_size partitions whose spectra are precomputed; each processing call costs one forward and one inverse FFT of
+// 2 * block_size samples per completed or partial block, and the frequency-domain delay line is multiplied against
+// the remaining partitions once per completed block. Partial blocks are convolved immediately, so the output has no
+// latency.
+//
+// One convolver is kept per effect instance through the filter userdata:
+//   static void *func_create(int64_t effect_id) { return aviutl2_convolver_create(g_cache, 512); }
+//   static void func_destroy(int64_t effect_id, void *userdata) { aviutl2_convolver_destroy(userdata); }
+//   static bool func_proc_audio(struct aviutl2_filter_proc_audio *audio) {
+//     return aviutl2_convolver_proc_audio(audio->userdata, audio, ir_file.value,
+//                                         (float)(wet.value / 100.0), (float)(dry.value / 100.0));
+//   }
+// When the file item changes, the impulse response is read through aviutl2_cache_handle::get_audio_file_data() and
+// partitioned on a background thread; the audio thread picks up the finished kernel with an atomic exchange. The
+// state is reset whenever sample_index does not continue from the previous call, such as after a seek.
+// aviutl2_convolver_destroy() cancels and waits for the loader threads, so every convolver must be destroyed before
+// UninitializePlugin() returns.
+
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_cache2.h"
+#include "aviutl2_fft.h"
+#include "aviutl2_filter2.h"
+#include "aviutl2_hash.h"
+
+enum {
+  aviutl2_convolver_max_channels = 2,
+  aviutl2_convolver_min_block_size = 16,
+  aviutl2_convolver_max_block_size = 16384,
+  aviutl2_convolver_max_ir_seconds = 60,
+  aviutl2_convolver_read_chunk = 65536,
+};
+
+/**
+ * Partitioned impulse response with its processing state
+ * Built off the audio thread and owned by the audio thread once published
+ */
+struct aviutl2_convolver_kernel {
+  LONG generation;   /**< Load request that produced this kernel */
+  int block_size;    /**< Partition length in samples */
+  int partition_num; /**< Number of partitions (0 means no impulse response) */
+  int channel_num;   /**< Number of impulse response channels */
+  int stride;        /**< Floats per spectrum (re and im of fft.bin_num bins) */
+  int filled;        /**< Samples of the current block already processed */
+  int position;      /**< Delay line slot of the current block */
+  struct aviutl2_fft fft;
+  float *spectra; /**< channel_num * partition_num spectra */
+  float *input[aviutl2_convolver_max_channels];
+  float *delay_line[aviutl2_convolver_max_channels];
+  float *accum[aviutl2_convolver_max_channels];
+  float *spectrum;
+  float *work;
+  float *time;
+  void *block;
+};
+
+/**
+ * Convolver
+ * All members are private; use the aviutl2_convolver_* functions
+ */
+struct aviutl2_convolver {
+  HANDLE loader;
+  LONG generation;
+  struct aviutl2_cache_handle *cache;
+  int block_size;
+  void *volatile pending;
+  struct aviutl2_convolver_kernel *active;
+  uint64_t ir_key;
+  int64_t next_sample_index;
+  float *buffer;
+  size_t buffer_cap;
+};
+
+static inline bool aviutl2_convolver_block_size_valid_(int block_size) {
+  return block_size >= aviutl2_convolver_min_block_size && block_size <= aviutl2_convolver_max_block_size &&
+         (block_size & (block_size - 1)) == 0;
+}
+
+/**
+ * Destroy a kernel
+ * @param k Kernel (may be NULL)
+ */
+static inline void aviutl2_convolver_kernel_destroy(struct aviutl2_convolver_kernel *k) {
+  if (!k) {
+    return;
+  }
+  aviutl2_fft_exit(&k->fft);
+  free(k->block);
+  free(k);
+}
+
+/**
+ * Clear the processing state of a kernel
+ * @param k Kernel
+ */
+static inline void aviutl2_convolver_kernel_reset(struct aviutl2_convolver_kernel *k) {
+  size_t const b = (size_t)k->block_size;
+  size_t const s = (size_t)k->stride;
+  for (int c = 0; c < aviutl2_convolver_max_channels; ++c) {
+    memset(k->input[c], 0, b * 2 * sizeof(float));
+    memset(k->delay_line[c], 0, (size_t)k->partition_num * s * sizeof(float));
+    memset(k->accum[c], 0, s * sizeof(float));
+  }
+  k->filled = 0;
+  k->position = 0;
+}
+
+/**
+ * Create a kernel from an impulse response
+ * @param ir Impulse response channels
+ * @param channel_num Number of channels (1 or 2; a mono response is used for every channel)
+ * @param length Impulse response length in samples (0 creates a kernel that bypasses processing)
+ * @param block_size Partition length (power of two between aviutl2_convolver_min_block_size and
+ *                   aviutl2_convolver_max_block_size)
+ * @return Kernel, or NULL on failure
+ */
+static inline struct aviutl2_convolver_kernel *aviutl2_convolver_kernel_create(float const *const *ir,
+                                                                               int channel_num,
+                                                                               size_t length,
+                                                                               int block_size) {
+  if (channel_num < 1 || channel_num > aviutl2_convolver_max_channels ||
+      !aviutl2_convolver_block_size_valid_(block_size)) {
+    return NULL;
+  }
+  struct aviutl2_convolver_kernel *k = (struct aviutl2_convolver_kernel *)calloc(1, sizeof(*k));
+  if (!k) {
+    return NULL;
+  }
+  k->block_size = block_size;
+  k->channel_num = channel_num;
+  if (length == 0) {
+    return k;
+  }
+  size_t const b = (size_t)block_size;
+  size_t const partitions = (length + b - 1) / b;
+  if (partitions > INT_MAX || !aviutl2_fft_init(&k->fft, block_size * 2, aviutl2_fft_window_rectangular)) {
+    aviutl2_convolver_kernel_destroy(k);
+    return NULL;
+  }
+  k->partition_num = (int)partitions;
+  k->stride = k->fft.bin_num * 2;
+  size_t const s = (size_t)k->stride;
+  size_t const per_channel = b * 2 + partitions * s + s;
+  size_t const total = (size_t)channel_num * partitions * s + aviutl2_convolver_max_channels * per_channel + s + b * 4;
+  k->block = malloc(total * sizeof(float));
+  if (!k->block) {
+    aviutl2_convolver_kernel_destroy(k);
+    return NULL;
+  }
+  float *p = (float *)k->block;
+  k->spectra = p;
+  p += (size_t)channel_num * partitions * s;
+  for (int c = 0; c < aviutl2_convolver_max_channels; ++c) {
+    k->input[c] = p;
+    k->delay_line[c] = p + b * 2;
+    k->accum[c] = p + b * 2 + partitions * s;
+    p += per_channel;
+  }
+  k->spectrum = p;
+  k->work = p + s;
+  k->time = p + s + b * 2;
+
+  for (int c = 0; c < channel_num; ++c) {
+    for (size_t i = 0; i < partitions; ++i) {
+      size_t const offset = i * b;
+      size_t const n = length - offset < b ? length - offset : b;
+      memcpy(k->time, ir[c] + offset, n * sizeof(float));
+      memset(k->time + n, 0, (b * 2 - n) * sizeof(float));
+      float *const h = k->spectra + ((size_t)c * partitions + i) * s;
+      aviutl2_fft_forward(&k->fft, k->time, h, h + k->fft.bin_num);
+    }
+  }
+  aviutl2_convolver_kernel_reset(k);
+  return k;
+}
+
+static inline void aviutl2_convolver_mac_(float *acc, float const *x, float const *h, int bin_num) {
+  float *const ar = acc, *const ai = acc + bin_num;
+  float const *const xr = x, *const xi = x + bin_num;
+  float const *const hr = h, *const hi = h + bin_num;
+  int i = 0;
+#if AVIUTL2_HAS_SSE2
+  for (; i + 4 <= bin_num; i += 4) {
+    __m128 const a = _mm_loadu_ps(xr + i), b = _mm_loadu_ps(xi + i);
+    __m128 const c = _mm_loadu_ps(hr + i), d = _mm_loadu_ps(hi + i);
+    _mm_storeu_ps(ar + i, _mm_add_ps(_mm_loadu_ps(ar + i), _mm_sub_ps(_mm_mul_ps(a, c), _mm_mul_ps(b, d))));
+    _mm_storeu_ps(ai + i, _mm_add_ps(_mm_loadu_ps(ai + i), _mm_add_ps(_mm_mul_ps(a, d), _mm_mul_ps(b, c))));
+  }
+#endif
+  for (; i < bin_num; ++i) {
+    ar[i] += xr[i] * hr[i] - xi[i] * hi[i];
+    ai[i] += xr[i] * hi[i] + xi[i] * hr[i];
+  }
+}
+
+static inline void aviutl2_convolver_kernel_segment_(struct aviutl2_convolver_kernel *k,
+                                                     int channel,
+                                                     float *buffer,
+                                                     int n,
+                                                     float wet,
+                                                     float dry) {
+  int const b = k->block_size;
+  int const bin_num = k->fft.bin_num;
+  size_t const s = (size_t)k->stride;
+  int const ir_channel = channel < k->channel_num ? channel : k->channel_num - 1;
+  float const *const h = k->spectra + (size_t)ir_channel * (size_t)k->partition_num * s;
+  float *const in = k->input[channel];
+  float *const x = k->delay_line[channel] + (size_t)k->position * s;
+  memcpy(in + b + k->filled, buffer, (size_t)n * sizeof(float));
+  aviutl2_fft_forward(&k->fft, in, x, x + bin_num);
+  memcpy(k->spectrum, k->accum[channel], s * sizeof(float));
+  aviutl2_convolver_mac_(k->spectrum, x, h, bin_num);
+  aviutl2_fft_inverse(&k->fft, k->spectrum, k->spectrum + bin_num, k->work, k->time);
+  float const *const y = k->time + b + k->filled;
+  float const *const src = in + b + k->filled;
+  for (int i = 0; i < n; ++i) {
+    buffer[i] = src[i] * dry + y[i] * wet;
+  }
+}
+
+static inline void aviutl2_convolver_kernel_advance_(struct aviutl2_convolver_kernel *k, int channel_num) {
+  // The completed block becomes the first half of the next overlap-save window, and the contribution of every
+  // older block through partitions 1..P-1 is summed once here instead of on each partial block.
+  int const b = k->block_size;
+  int const p_num = k->partition_num;
+  int const bin_num = k->fft.bin_num;
+  size_t const s = (size_t)k->stride;
+  k->filled = 0;
+  k->position = k->position + 1 == p_num ? 0 : k->position + 1;
+  for (int c = 0; c < channel_num; ++c) {
+    int const ir_channel = c < k->channel_num ? c : k->channel_num - 1;
+    float const *const h = k->spectra + (size_t)ir_channel * (size_t)p_num * s;
+    memcpy(k->input[c], k->input[c] + b, (size_t)b * sizeof(float));
+    memset(k->input[c] + b, 0, (size_t)b * sizeof(float));
+    memset(k->accum[c], 0, s * sizeof(float));
+    for (int p = 1; p < p_num; ++p) {
+      int const slot = k->position >= p ? k->position - p : k->position - p + p_num;
+      aviutl2_convolver_mac_(k->accum[c], k->delay_line[c] + (size_t)slot * s, h + (size_t)p * s, bin_num);
+    }
+  }
+}
+
+/**
+ * Convolve planar buffers in place
+ * @param k Kernel
+ * @param buffers Channel buffers
+ * @param channel_num Number of channels (up to aviutl2_convolver_max_channels)
+ * @param sample_num Number of samples per channel
+ * @param wet Gain of the convolved signal
+ * @param dry Gain of the input signal
+ */
+static inline void aviutl2_convolver_kernel_process(struct aviutl2_convolver_kernel *k,
+                                                    float *const *buffers,
+                                                    int channel_num,
+                                                    int sample_num,
+                                                    float wet,
+                                                    float dry) {
+  if (k->partition_num == 0) {
+    return;
+  }
+  if (channel_num > aviutl2_convolver_max_channels) {
+    channel_num = aviutl2_convolver_max_channels;
+  }
+  int done = 0;
+  while (done < sample_num) {
+    int n = k->block_size - k->filled;
+    if (n > sample_num - done) {
+      n = sample_num - done;
+    }
+    for (int c = 0; c < channel_num; ++c) {
+      aviutl2_convolver_kernel_segment_(k, c, buffers[c] + done, n, wet, dry);
+    }
+    k->filled += n;
+    done += n;
+    if (k->filled == k->block_size) {
+      aviutl2_convolver_kernel_advance_(k, channel_num);
+    }
+  }
+}
+
+//--------------------------------
+
+/**
+ * Create a convolver
+ * Intended to be returned from func_create()
+ * @param cache Cache handle passed to InitializeCache(), used to read impulse response files (may be NULL when only
+ *              aviutl2_convolver_set_ir() is used)
+ * @param block_size Partition length (see aviutl2_convolver_kernel_create()). Smaller blocks cost more CPU
+ * @return Convolver, or NULL on failure
+ */
+static inline struct aviutl2_convolver *aviutl2_convolver_create(struct aviutl2_cache_handle *cache, int block_size) {
+  if (!aviutl2_convolver_block_size_valid_(block_size)) {
+    return NULL;
+  }
+  struct aviutl2_convolver *cv = (struct aviutl2_convolver *)calloc(1, sizeof(*cv));
+  if (!cv) {
+    return NULL;
+  }
+  cv->cache = cache;
+  cv->block_size = block_size;
+  cv->next_sample_index = -1;
+  return cv;
+}
+
+/**
+ * Destroy a convolver
+ * Intended to be called from func_destroy(). Loads in progress are cancelled and this waits until their threads have
+ * exited, which takes at most one read of aviutl2_convolver_read_chunk samples or one kernel build
+ * @param cv Convolver (may be NULL)
+ */
+static inline void aviutl2_convolver_destroy(struct aviutl2_convolver *cv) {
+  if (!cv) {
+    return;
+  }
+  InterlockedIncrement(&cv->generation);
+  if (cv->loader) {
+    // Each loader joins the one started before it, so waiting for the newest waits for all of them
+    WaitForSingleObject(cv->loader, INFINITE);
+    CloseHandle(cv->loader);
+  }
+  aviutl2_convolver_kernel_destroy((struct aviutl2_convolver_kernel *)cv->pending);
+  aviutl2_convolver_kernel_destroy(cv->active);
+  free(cv->buffer);
+  free(cv);
+}
+
+static inline void aviutl2_convolver_publish_(struct aviutl2_convolver *cv, struct aviutl2_convolver_kernel *k) {
+  // A slower load of an older request must not replace the result of a newer one
+  for (;;) {
+    struct aviutl2_convolver_kernel *cur = (struct aviutl2_convolver_kernel *)cv->pending;
+    if (cur && cur->generation > k->generation) {
+      aviutl2_convolver_kernel_destroy(k);
+      return;
+    }
+    if (InterlockedCompareExchangePointer(&cv->pending, k, cur) == cur) {
+      aviutl2_convolver_kernel_destroy(cur);
+      return;
+    }
+  }
+}
+
+/**
+ * Replace the impulse response with in-memory data
+ * The kernel is built on the calling thread and takes effect on the next processing call
+ * @param cv Convolver
+ * @param ir Impulse response channels
+ * @param channel_num Number of channels (1 or 2)
+ * @param length Impulse response length in samples (0 removes the impulse response)
+ * @return true on success
+ */
+static inline bool aviutl2_convolver_set_ir(struct aviutl2_convolver *cv,
+                                            float const *const *ir,
+                                            int channel_num,
+                                            size_t length) {
+  if (!cv) {
+    return false;
+  }
+  struct aviutl2_convolver_kernel *k = aviutl2_convolver_kernel_create(ir, channel_num, length, cv->block_size);
+  if (!k) {
+    return false;
+  }
+  cv->ir_key = 0;
+  k->generation = InterlockedIncrement(&cv->generation);
+  aviutl2_convolver_publish_(cv, k);
+  return true;
+}
+
+struct aviutl2_convolver_loader {
+  struct aviutl2_convolver *cv;
+  HANDLE previous;
+  LONG generation;
+  int sample_rate;
+  wchar_t path[1];
+};
+
+static inline bool aviutl2_convolver_loader_cancelled_(struct aviutl2_convolver_loader const *ld) {
+  return ld->cv->generation != ld->generation;
+}
+
+static inline struct aviutl2_convolver_kernel *
+aviutl2_convolver_loader_read_(struct aviutl2_convolver_loader const *ld) {
+  struct aviutl2_cache_handle *const cache = ld->cv->cache;
+  struct aviutl2_audio_info info = {0};
+  if (!cache->get_audio_file_info(ld->path, &info, (int)sizeof(info)) || info.rate <= 0 || info.sample_num <= 0) {
+    return NULL;
+  }
+  int64_t cap = info.sample_num;
+  if (cap > (int64_t)info.rate * aviutl2_convolver_max_ir_seconds) {
+    cap = (int64_t)info.rate * aviutl2_convolver_max_ir_seconds;
+  }
+  int64_t const out_cap = info.rate != ld->sample_rate ? cap * ld->sample_rate / info.rate + 1 : 0;
+  float *const src = (float *)malloc((size_t)(cap + out_cap) * 2 * sizeof(float));
+  if (!src) {
+    return NULL;
+  }
+  int64_t len = 0;
+  while (len < cap) {
+    if (aviutl2_convolver_loader_cancelled_(ld)) {
+      free(src);
+      return NULL;
+    }
+    int const n = cap - len < aviutl2_convolver_read_chunk ? (int)(cap - len) : aviutl2_convolver_read_chunk;
+    int const got = cache->get_audio_file_data(ld->path, 0, len, n, src + len, src + cap + len);
+    if (got <= 0) {
+      break;
+    }
+    len += got;
+  }
+  float const *ir[2] = {src, src + cap};
+  if (out_cap && len > 0) {
+    // Linear interpolation is enough here because the response is heard through the convolution, not directly
+    double const step = (double)info.rate / (double)ld->sample_rate;
+    int64_t out_len = (int64_t)((double)(len - 1) / step) + 1;
+    if (out_len > out_cap) {
+      out_len = out_cap;
+    }
+    float *const dst = src + cap * 2;
+    for (int c = 0; c < 2; ++c) {
+      float const *const s = src + cap * c;
+      float *const d = dst + out_cap * c;
+      for (int64_t i = 0; i < out_len; ++i) {
+        double const x = (double)i * step;
+        int64_t const i0 = (int64_t)x;
+        int64_t const i1 = i0 + 1 < len ? i0 + 1 : i0;
+        float const t = (float)(x - (double)i0);
+        d[i] = s[i0] + (s[i1] - s[i0]) * t;
+      }
+    }
+    ir[0] = dst;
+    ir[1] = dst + out_cap;
+    len = out_len;
+  }
+  struct aviutl2_convolver_kernel *k =
+      aviutl2_convolver_kernel_create(ir, info.channel >= 2 ? 2 : 1, (size_t)len, ld->cv->block_size);
+  free(src);
+  return k;
+}
+
+static inline DWORD WINAPI aviutl2_convolver_loader_proc(void *param) {
+  struct aviutl2_convolver_loader *ld = (struct aviutl2_convolver_loader *)param;
+  struct aviutl2_convolver_kernel *k = aviutl2_convolver_loader_read_(ld);
+  if (!k && !aviutl2_convolver_loader_cancelled_(ld)) {
+    // An unreadable file behaves like an empty file item
+    k = aviutl2_convolver_kernel_create(NULL, 1, 0, ld->cv->block_size);
+  }
+  if (k) {
+    k->generation = ld->generation;
+    aviutl2_convolver_publish_(ld->cv, k);
+  }
+  if (ld->previous) {
+    WaitForSingleObject(ld->previous, INFINITE);
+    CloseHandle(ld->previous);
+  }
+  free(ld);
+  return 0;
+}
+
+/**
+ * Request an impulse response file
+ * Does nothing if the same file and sample rate were requested last time; otherwise the file is read on a background
+ * thread and the current impulse response stays active until the new one is ready.
+ * @param cv Convolver
+ * @param path Path to audio file (NULL or empty removes the impulse response)
+ * @param sample_rate Sampling rate to convert the impulse response to
+ * @return false if the request could not be started
+ */
+static inline bool aviutl2_convolver_set_ir_file(struct aviutl2_convolver *cv, wchar_t const *path, int sample_rate) {
+  if (!cv || sample_rate <= 0) {
+    return false;
+  }
+  if (!path) {
+    path = L"";
+  }
+  uint64_t const key = aviutl2_hash_u64(aviutl2_hash_wstr(AVIUTL2_HASH_INIT, path), (uint64_t)sample_rate);
+  if (key == cv->ir_key) {
+    return true;
+  }
+  if (path[0] == L'\0' || !cv->cache) {
+    if (!aviutl2_convolver_set_ir(cv, NULL, 1, 0)) {
+      return false;
+    }
+    cv->ir_key = key;
+    return true;
+  }
+  size_t const len = wcslen(path);
+  struct aviutl2_convolver_loader *ld =
+      (struct aviutl2_convolver_loader *)malloc(sizeof(*ld) + len * sizeof(wchar_t));
+  if (!ld) {
+    return false;
+  }
+  memcpy(ld->path, path, (len + 1) * sizeof(wchar_t));
+  ld->cv = cv;
+  ld->sample_rate = sample_rate;
+  ld->previous = cv->loader;
+  ld->generation = InterlockedIncrement(&cv->generation);
+  HANDLE const thread = CreateThread(NULL, 0, aviutl2_convolver_loader_proc, ld, 0, NULL);
+  if (!thread) {
+    free(ld);
+    return false;
+  }
+  // The new loader takes over the handle of the previous one
+  cv->loader = thread;
+  cv->ir_key = key;
+  return true;
+}
+
+/**
+ * Check whether an impulse response is active
+ * Picks up a kernel published by a finished load. Call from the processing thread
+ * @param cv Convolver
+ * @return true if processing would modify the audio
+ */
+static inline bool aviutl2_convolver_ready(struct aviutl2_convolver *cv) {
+  struct aviutl2_convolver_kernel *k =
+      (struct aviutl2_convolver_kernel *)InterlockedExchangePointer(&cv->pending, NULL);
+  if (k) {
+    if (k->generation == cv->generation) {
+      aviutl2_convolver_kernel_destroy(cv->active);
+      cv->active = k;
+      cv->next_sample_index = -1;
+    } else {
+      aviutl2_convolver_kernel_destroy(k);
+    }
+  }
+  return cv->active && cv->active->partition_num > 0;
+}
+
+/**
+ * Convolve planar buffers in place
+ * Without an impulse response the buffers are left unchanged
+ * @param cv Convolver
+ * @param sample_index Position of the first sample; a value that does not continue the previous call resets the state
+ * @param buffers Channel buffers
+ * @param channel_num Number of channels (up to aviutl2_convolver_max_channels)
+ * @param sample_num Number of samples per channel
+ * @param wet Gain of the convolved signal
+ * @param dry Gain of the input signal
+ */
+static inline void aviutl2_convolver_process(struct aviutl2_convolver *cv,
+                                             int64_t sample_index,
+                                             float *const *buffers,
+                                             int channel_num,
+                                             int sample_num,
+                                             float wet,
+                                             float dry) {
+  if (!cv || !aviutl2_convolver_ready(cv)) {
+    return;
+  }
+  if (sample_index != cv->next_sample_index) {
+    aviutl2_convolver_kernel_reset(cv->active);
+  }
+  cv->next_sample_index = sample_index + sample_num;
+  aviutl2_convolver_kernel_process(cv->active, buffers, channel_num, sample_num, wet, dry);
+}
+
+/**
+ * Process the current object audio of an audio filter
+ * @param cv Convolver (the filter userdata)
+ * @param audio Audio filter processing parameters
+ * @param path Impulse response file, normally the value of an aviutl2_filter_item_file
+ * @param wet Gain of the convolved signal
+ * @param dry Gain of the input signal
+ * @return false if memory allocation failed
+ */
+static inline bool aviutl2_convolver_proc_audio(struct aviutl2_convolver *cv,
+                                                struct aviutl2_filter_proc_audio *audio,
+                                                wchar_t const *path,
+                                                float wet,
+                                                float dry) {
+  if (!cv) {
+    return true;
+  }
+  aviutl2_convolver_set_ir_file(cv, path, audio->scene->sample_rate);
+  if (!aviutl2_convolver_ready(cv)) {
+    return true;
+  }
+  int const n = audio->object->sample_num;
+  int channel_num = audio->object->channel_num;
+  if (channel_num > aviutl2_convolver_max_channels) {
+    channel_num = aviutl2_convolver_max_channels;
+  }
+  if (n <= 0 || channel_num <= 0) {
+    return true;
+  }
+  size_t const need = (size_t)n * (size_t)channel_num;
+  if (cv->buffer_cap < need) {
+    float *buf = (float *)realloc(cv->buffer, need * sizeof(float));
+    if (!buf) {
+      return false;
+    }
+    cv->buffer = buf;
+    cv->buffer_cap = need;
+  }
+  float *buffers[aviutl2_convolver_max_channels];
+  for (int c = 0; c < channel_num; ++c) {
+    buffers[c] = cv->buffer + (size_t)c * (size_t)n;
+    audio->get_sample_data(buffers[c], c);
+  }
+  aviutl2_convolver_process(cv, audio->object->sample_index, buffers, channel_num, n, wet, dry);
+  for (int c = 0; c < channel_num; ++c) {
+    audio->set_sample_data(buffers[c], c);
+  }
+  return true;
+}
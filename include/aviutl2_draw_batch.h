@@ -0,0 +1,394 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Draw call batcher for aviutl2_filter_proc_video
+//
+// Collects image draws that share a texture resource, blend mode and sampler mode and submits them as a single
+// draw_poly() call of aviutl2_vertex_type_quad_texture. Sprites are stored as structure of arrays and expanded
+// into quads four at a time with SSE2.
+//
+// Only rotation around the Z axis is batched. aviutl2_draw_batch_draw_image() falls back to draw_image() for draws
+// that rotate around X or Y or scale Z.
+//
+// The host has no way to query its blend and sampler modes, so flushing leaves them set to the batch's modes. Set
+// them again before calling draw_image() or draw_poly() directly after using a batch.
+//
+// Keep one batch per effect instance (for example in the user data returned by func_create()) so that its buffers
+// are reused across frames:
+//   aviutl2_draw_batch_begin(&batch, video, AVIUTL2_RESOURCE_OBJECT, aviutl2_blend_mode_none,
+//                            aviutl2_sampler_mode_clip);
+//   for (...) aviutl2_draw_batch_add(&batch, x, y, z, rz, sx, sy, alpha);
+//   aviutl2_draw_batch_end(&batch);
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "aviutl2_filter2.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+/**
+ * Sprite parameters
+ */
+struct aviutl2_draw_sprite {
+  float x, y, z;          /**< Base coordinates */
+  float rz;               /**< Rotation angle around Z (360.0 is one full rotation) */
+  float sx, sy;           /**< Scale (1.0 = normal size) */
+  float cx, cy;           /**< Center coordinates relative to the image center (rotation and scaling origin) */
+  float alpha;            /**< Opacity (0.0 to 1.0) */
+  float width, height;    /**< Size of the drawn region in pixels before scaling */
+  float u0, v0, u1, v1;   /**< Texture coordinates of the drawn region (normalized) */
+};
+
+/**
+ * Sprite storage (structure of arrays)
+ * Rotation is stored as cosine and sine so that expansion needs no trigonometry
+ */
+struct aviutl2_draw_batch_sprites {
+  float *x, *y, *z;
+  float *cos_r, *sin_r;
+  float *sx, *sy;
+  float *cx, *cy;
+  float *alpha;
+  float *hw, *hh;
+  float *u0, *v0, *u1, *v1;
+};
+
+/**
+ * Draw batch
+ * Initialize with {0} and release with aviutl2_draw_batch_destroy()
+ */
+struct aviutl2_draw_batch {
+  struct aviutl2_filter_proc_video *video;
+  wchar_t const *resource;
+  enum aviutl2_blend_mode blend;
+  enum aviutl2_sampler_mode sampler;
+  float width, height; /**< Size of the current resource */
+
+  struct aviutl2_draw_batch_sprites s;
+  float *storage;
+  size_t num, cap;
+
+  struct aviutl2_vertex_texture *vertices;
+  size_t vertex_cap;
+
+  uint64_t flush_count;  /**< Number of draw_poly() calls issued */
+  uint64_t sprite_count; /**< Number of sprites submitted */
+};
+
+/**
+ * Release buffers owned by a batch
+ * Pending sprites are discarded
+ * @param b Batch
+ */
+static inline void aviutl2_draw_batch_destroy(struct aviutl2_draw_batch *b) {
+  free(b->storage);
+  free(b->vertices);
+  memset(b, 0, sizeof(*b));
+}
+
+static inline bool aviutl2_draw_batch_reserve(struct aviutl2_draw_batch *b, size_t n) {
+  if (n <= b->cap) {
+    return true;
+  }
+  size_t cap = b->cap ? b->cap : 64;
+  while (cap < n) {
+    cap *= 2;
+  }
+  enum { fields = sizeof(struct aviutl2_draw_batch_sprites) / sizeof(float *) };
+  float *storage = (float *)malloc(cap * fields * sizeof(float));
+  if (!storage) {
+    return false;
+  }
+  float **dst = (float **)&b->s;
+  for (size_t i = 0; i < fields; ++i) {
+    float *field = storage + cap * i;
+    if (b->num) {
+      memcpy(field, dst[i], b->num * sizeof(float));
+    }
+    dst[i] = field;
+  }
+  free(b->storage);
+  b->storage = storage;
+  b->cap = cap;
+  return true;
+}
+
+/**
+ * Expand sprites into quads with scalar code
+ * Used for the remainder after SIMD processing and as the reference implementation
+ * @param s Sprite storage
+ * @param first First sprite index
+ * @param last Last sprite index (exclusive)
+ * @param out Destination vertices (4 per sprite, starting at out[first * 4])
+ */
+static inline void aviutl2_draw_batch_expand_scalar(struct aviutl2_draw_batch_sprites const *s,
+                                                    size_t first,
+                                                    size_t last,
+                                                    struct aviutl2_vertex_texture *out) {
+  static float const kx[4] = {-1.f, 1.f, 1.f, -1.f};
+  static float const ky[4] = {-1.f, -1.f, 1.f, 1.f};
+  for (size_t i = first; i < last; ++i) {
+    float const us[4] = {s->u0[i], s->u1[i], s->u1[i], s->u0[i]};
+    float const vs[4] = {s->v0[i], s->v0[i], s->v1[i], s->v1[i]};
+    for (int k = 0; k < 4; ++k) {
+      float const qx = (kx[k] * s->hw[i] - s->cx[i]) * s->sx[i];
+      float const qy = (ky[k] * s->hh[i] - s->cy[i]) * s->sy[i];
+      struct aviutl2_vertex_texture *v = out + i * 4 + (size_t)k;
+      v->x = s->x[i] + qx * s->cos_r[i] - qy * s->sin_r[i];
+      v->y = s->y[i] + qx * s->sin_r[i] + qy * s->cos_r[i];
+      v->z = s->z[i];
+      v->u = us[k];
+      v->v = vs[k];
+      v->a = s->alpha[i];
+    }
+  }
+}
+
+/**
+ * Expand sprites into quads
+ * Corners are emitted in top-left, top-right, bottom-right, bottom-left order
+ * @param s Sprite storage
+ * @param num Number of sprites
+ * @param out Destination vertices (num * 4 elements)
+ */
+static inline void aviutl2_draw_batch_expand(struct aviutl2_draw_batch_sprites const *s,
+                                             size_t num,
+                                             struct aviutl2_vertex_texture *out) {
+  size_t i = 0;
+#if AVIUTL2_HAS_SSE2
+  static float const kx[4] = {-1.f, 1.f, 1.f, -1.f};
+  static float const ky[4] = {-1.f, -1.f, 1.f, 1.f};
+  for (; i + 4 <= num; i += 4) {
+    __m128 const x = _mm_loadu_ps(s->x + i), y = _mm_loadu_ps(s->y + i);
+    __m128 const c = _mm_loadu_ps(s->cos_r + i), sn = _mm_loadu_ps(s->sin_r + i);
+    __m128 const sx = _mm_loadu_ps(s->sx + i), sy = _mm_loadu_ps(s->sy + i);
+    __m128 const cx = _mm_loadu_ps(s->cx + i), cy = _mm_loadu_ps(s->cy + i);
+    __m128 const hw = _mm_loadu_ps(s->hw + i), hh = _mm_loadu_ps(s->hh + i);
+    float px[4][4], py[4][4];
+    for (int k = 0; k < 4; ++k) {
+      __m128 const qx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(kx[k]), hw), cx), sx);
+      __m128 const qy = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(ky[k]), hh), cy), sy);
+      _mm_storeu_ps(px[k], _mm_add_ps(x, _mm_sub_ps(_mm_mul_ps(qx, c), _mm_mul_ps(qy, sn))));
+      _mm_storeu_ps(py[k], _mm_add_ps(y, _mm_add_ps(_mm_mul_ps(qx, sn), _mm_mul_ps(qy, c))));
+    }
+    for (size_t j = 0; j < 4; ++j) {
+      size_t const n = i + j;
+      float const us[4] = {s->u0[n], s->u1[n], s->u1[n], s->u0[n]};
+      float const vs[4] = {s->v0[n], s->v0[n], s->v1[n], s->v1[n]};
+      struct aviutl2_vertex_texture *v = out + n * 4;
+      for (int k = 0; k < 4; ++k) {
+        v[k].x = px[k][j];
+        v[k].y = py[k][j];
+        v[k].z = s->z[n];
+        v[k].u = us[k];
+        v[k].v = vs[k];
+        v[k].a = s->alpha[n];
+      }
+    }
+  }
+#endif
+  aviutl2_draw_batch_expand_scalar(s, i, num, out);
+}
+
+/**
+ * Submit all pending sprites with a single draw_poly() call
+ * The host's blend and sampler modes are left set to the batch's modes
+ * @param b Batch
+ * @return false if draw_poly() failed or memory allocation failed (pending sprites are discarded either way)
+ */
+static inline bool aviutl2_draw_batch_flush(struct aviutl2_draw_batch *b) {
+  if (!b->num) {
+    return true;
+  }
+  size_t const n = b->num;
+  b->num = 0;
+  if (b->vertex_cap < n * 4) {
+    struct aviutl2_vertex_texture *v =
+        (struct aviutl2_vertex_texture *)realloc(b->vertices, n * 4 * sizeof(struct aviutl2_vertex_texture));
+    if (!v) {
+      return false;
+    }
+    b->vertices = v;
+    b->vertex_cap = n * 4;
+  }
+  aviutl2_draw_batch_expand(&b->s, n, b->vertices);
+  b->video->set_blend_mode(b->blend);
+  b->video->set_sampler_mode(b->sampler);
+  ++b->flush_count;
+  return b->video->draw_poly(aviutl2_vertex_type_quad_texture, b->vertices, (int)(n * 4), b->resource);
+}
+
+/**
+ * Submit pending sprites and forget the current drawing state
+ * Call this before func_proc_video() returns; the resource size is queried again on the next
+ * aviutl2_draw_batch_begin() because the image behind a resource name may change between frames
+ * @param b Batch
+ * @return false if flushing failed
+ */
+static inline bool aviutl2_draw_batch_end(struct aviutl2_draw_batch *b) {
+  bool const ok = aviutl2_draw_batch_flush(b);
+  b->video = NULL;
+  b->resource = NULL;
+  b->width = b->height = 0.f;
+  return ok;
+}
+
+/**
+ * Select the texture resource and drawing state for subsequent sprites
+ * Pending sprites are flushed if the state changes
+ * @param b Batch
+ * @param video Video filter processing structure
+ * @param resource Texture image resource name (must stay valid until the batch is flushed)
+ * @param blend Blend mode
+ * @param sampler Sampler mode
+ * @return false if the resource size could not be obtained or flushing failed
+ */
+static inline bool aviutl2_draw_batch_begin(struct aviutl2_draw_batch *b,
+                                            struct aviutl2_filter_proc_video *video,
+                                            wchar_t const *resource,
+                                            enum aviutl2_blend_mode blend,
+                                            enum aviutl2_sampler_mode sampler) {
+  bool const same_video = b->video == video;
+  bool const same_resource =
+      same_video && (b->resource == resource || (b->resource && resource && wcscmp(b->resource, resource) == 0));
+  if (same_resource && b->blend == blend && b->sampler == sampler) {
+    return true;
+  }
+  bool ok = true;
+  if (b->video) {
+    ok = aviutl2_draw_batch_flush(b);
+  }
+  b->video = video;
+  b->blend = blend;
+  b->sampler = sampler;
+  if (!same_resource) {
+    int w = 0, h = 0;
+    if (!video->get_image_resource_size(resource, &w, &h)) {
+      b->resource = NULL;
+      b->width = b->height = 0.f;
+      return false;
+    }
+    b->width = (float)w;
+    b->height = (float)h;
+  }
+  b->resource = resource;
+  return ok;
+}
+
+/**
+ * Add a sprite with full parameters
+ * @param b Batch (aviutl2_draw_batch_begin() must have succeeded)
+ * @param sprite Sprite parameters
+ * @return false if memory allocation failed
+ */
+static inline bool aviutl2_draw_batch_add_sprite(struct aviutl2_draw_batch *b,
+                                                 struct aviutl2_draw_sprite const *sprite) {
+  if (!aviutl2_draw_batch_reserve(b, b->num + 1)) {
+    return false;
+  }
+  size_t const i = b->num++;
+  float const rad = sprite->rz * (float)(3.14159265358979323846 / 180.0);
+  b->s.x[i] = sprite->x;
+  b->s.y[i] = sprite->y;
+  b->s.z[i] = sprite->z;
+  b->s.cos_r[i] = cosf(rad);
+  b->s.sin_r[i] = sinf(rad);
+  b->s.sx[i] = sprite->sx;
+  b->s.sy[i] = sprite->sy;
+  b->s.cx[i] = sprite->cx;
+  b->s.cy[i] = sprite->cy;
+  b->s.alpha[i] = sprite->alpha;
+  b->s.hw[i] = sprite->width * 0.5f;
+  b->s.hh[i] = sprite->height * 0.5f;
+  b->s.u0[i] = sprite->u0;
+  b->s.v0[i] = sprite->v0;
+  b->s.u1[i] = sprite->u1;
+  b->s.v1[i] = sprite->v1;
+  ++b->sprite_count;
+  return true;
+}
+
+/**
+ * Add a sprite that draws the whole resource, equivalent to draw_image() with rx = ry = 0
+ * @param b Batch (aviutl2_draw_batch_begin() must have succeeded)
+ * @param x Base X coordinate
+ * @param y Base Y coordinate
+ * @param z Base Z coordinate
+ * @param rz Rotation angle around Z (360.0 is one full rotation)
+ * @param sx Scale on X (1.0 = normal size)
+ * @param sy Scale on Y (1.0 = normal size)
+ * @param alpha Opacity (0.0 to 1.0)
+ * @return false if memory allocation failed
+ */
+static inline bool aviutl2_draw_batch_add(
+    struct aviutl2_draw_batch *b, float x, float y, float z, float rz, float sx, float sy, float alpha) {
+  struct aviutl2_draw_sprite const sprite = {
+      .x = x,
+      .y = y,
+      .z = z,
+      .rz = rz,
+      .sx = sx,
+      .sy = sy,
+      .alpha = alpha,
+      .width = b->width,
+      .height = b->height,
+      .u1 = 1.f,
+      .v1 = 1.f,
+  };
+  return aviutl2_draw_batch_add_sprite(b, &sprite);
+}
+
+/**
+ * draw_image() with explicit blend and sampler modes
+ * Batches the draw when possible; otherwise flushes pending sprites, sets the modes and calls draw_image() directly.
+ * Either way the host's blend and sampler modes end up set to blend and sampler.
+ * @param b Batch
+ * @param video Video filter processing structure
+ * @param resource Texture image resource name (must stay valid until the batch is flushed)
+ * @param blend Blend mode
+ * @param sampler Sampler mode
+ * @return false on failure
+ */
+static inline bool aviutl2_draw_batch_draw_image(struct aviutl2_draw_batch *b,
+                                                 struct aviutl2_filter_proc_video *video,
+                                                 wchar_t const *resource,
+                                                 enum aviutl2_blend_mode blend,
+                                                 enum aviutl2_sampler_mode sampler,
+                                                 float x,
+                                                 float y,
+                                                 float z,
+                                                 float rx,
+                                                 float ry,
+                                                 float rz,
+                                                 float sx,
+                                                 float sy,
+                                                 float sz,
+                                                 float alpha) {
+  if (rx != 0.f || ry != 0.f || sz != 1.f) {
+    bool const ok = aviutl2_draw_batch_flush(b);
+    video->set_blend_mode(blend);
+    video->set_sampler_mode(sampler);
+    return video->draw_image(resource, x, y, z, rx, ry, rz, sx, sy, sz, alpha) && ok;
+  }
+  if (!aviutl2_draw_batch_begin(b, video, resource, blend, sampler)) {
+    return false;
+  }
+  return aviutl2_draw_batch_add(b, x, y, z, rz, sx, sy, alpha);
+}
@@ -0,0 +1,671 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Effect catalog cache
+//
+// Takes a snapshot of every effect name, type, flag, setting item and item group reported by the edit handle and
+// stores it in a single immutable allocation with a hashed name lookup and a name-sorted order for prefix search.
+// Building the catalog walks the host's module list many times, so keep it in struct aviutl2_effect_catalog_cache
+// and call aviutl2_effect_catalog_cache_refresh() when the module list may have changed; the catalog is rebuilt
+// only when the enum_module_info() fingerprint differs.
+//
+// Catalogs are reference counted, so a catalog obtained from the cache stays valid on any thread until it is
+// released even if the cache is refreshed in the meantime.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_hash.h"
+#include "aviutl2_plugin2.h"
+
+/**
+ * Setting item of an effect
+ */
+struct aviutl2_effect_catalog_item {
+  wchar_t const *name;  /**< Item name (key name in alias file) */
+  int type;             /**< Item type (aviutl2_effect_item_type_*) */
+  uint32_t group;       /**< Index of the group in the catalog (UINT32_MAX if not grouped) */
+  uint32_t group_index; /**< Index within the group */
+};
+
+/**
+ * Item group
+ */
+struct aviutl2_effect_catalog_group {
+  uint32_t const *items; /**< Indices of the member items in the catalog items array */
+  uint32_t item_num;
+};
+
+/**
+ * Effect
+ */
+struct aviutl2_effect_catalog_effect {
+  wchar_t const *name; /**< Effect name (effect.name value in alias file) */
+  size_t name_len;
+  int type; /**< Effect type (aviutl2_effect_type_*) */
+  int flag; /**< Effect flags (aviutl2_effect_flag_*) */
+  struct aviutl2_effect_catalog_item const *items;
+  uint32_t item_num;
+};
+
+/**
+ * Catalog snapshot
+ * All members are read-only and live in one allocation
+ */
+struct aviutl2_effect_catalog {
+  LONG volatile refs;
+  uint64_t fingerprint; /**< enum_module_info() fingerprint the catalog was built for */
+  struct aviutl2_effect_catalog_effect const *effects;
+  size_t effect_num;
+  struct aviutl2_effect_catalog_item const *items;
+  size_t item_num;
+  struct aviutl2_effect_catalog_group const *groups;
+  size_t group_num;
+  uint32_t const *sorted; /**< Effect indices sorted by name */
+  uint32_t const *slots;  /**< Effect index + 1 (0 = empty) */
+  size_t slot_num;
+  size_t bytes; /**< Size of the allocation */
+};
+
+/**
+ * Fuzzy search result
+ */
+struct aviutl2_effect_catalog_match {
+  uint32_t effect; /**< Index in the catalog effects array */
+  int score;       /**< Higher is better */
+};
+
+static inline void aviutl2_effect_catalog_fingerprint_proc(void *param, struct aviutl2_module_info *info) {
+  uint64_t *h = (uint64_t *)param;
+  *h = aviutl2_hash_u64(*h, (uint64_t)(int64_t)info->type);
+  *h = aviutl2_hash_u64(aviutl2_hash_wstr(*h, info->name), 0);
+  *h = aviutl2_hash_u64(aviutl2_hash_wstr(*h, info->information), 1);
+}
+
+/**
+ * Compute the fingerprint of the module list
+ * @param edit Edit handle
+ * @return Fingerprint
+ */
+static inline uint64_t aviutl2_effect_catalog_fingerprint(struct aviutl2_edit_handle *edit) {
+  uint64_t h = AVIUTL2_HASH_INIT;
+  edit->enum_module_info(&h, aviutl2_effect_catalog_fingerprint_proc);
+  return h;
+}
+
+static inline uint64_t aviutl2_effect_catalog_hash(wchar_t const *name, size_t len) {
+  return aviutl2_hash_u64(aviutl2_hash_bytes(AVIUTL2_HASH_INIT, name, len * sizeof(wchar_t)), len);
+}
+
+struct aviutl2_effect_catalog_builder_effect {
+  size_t name; /**< Offset in the string pool */
+  size_t name_len;
+  int type;
+  int flag;
+  uint32_t item_first;
+  uint32_t item_num;
+};
+
+struct aviutl2_effect_catalog_builder_item {
+  size_t name; /**< Offset in the string pool */
+  int type;
+  uint32_t group;
+  uint32_t group_index;
+};
+
+struct aviutl2_effect_catalog_builder {
+  struct aviutl2_effect_catalog_builder_effect *effects;
+  size_t effect_num, effect_cap;
+  struct aviutl2_effect_catalog_builder_item *items;
+  size_t item_num, item_cap;
+  uint32_t *groups; /**< Offset of the first member in group_items, one extra entry at the end */
+  size_t group_num, group_cap;
+  uint32_t *group_items;
+  size_t group_item_num, group_item_cap;
+  wchar_t *strings;
+  size_t string_len, string_cap;
+  bool failed;
+};
+
+static inline bool aviutl2_effect_catalog_grow(void **p, size_t *cap, size_t need, size_t elem) {
+  if (need <= *cap) {
+    return true;
+  }
+  size_t n = *cap ? *cap : 64;
+  while (n < need) {
+    n *= 2;
+  }
+  void *np = realloc(*p, n * elem);
+  if (!np) {
+    return false;
+  }
+  *p = np;
+  *cap = n;
+  return true;
+}
+
+static inline size_t aviutl2_effect_catalog_builder_string(struct aviutl2_effect_catalog_builder *b,
+                                                           wchar_t const *str,
+                                                           size_t len) {
+  if (!aviutl2_effect_catalog_grow(
+          (void **)&b->strings, &b->string_cap, b->string_len + len + 1, sizeof(wchar_t))) {
+    b->failed = true;
+    return 0;
+  }
+  size_t const offset = b->string_len;
+  memcpy(b->strings + offset, str, len * sizeof(wchar_t));
+  b->strings[offset + len] = L'\0';
+  b->string_len += len + 1;
+  return offset;
+}
+
+static inline void aviutl2_effect_catalog_enum_effect_proc(void *param, wchar_t const *name, int type, int flag) {
+  struct aviutl2_effect_catalog_builder *b = (struct aviutl2_effect_catalog_builder *)param;
+  if (b->failed || !name) {
+    return;
+  }
+  if (!aviutl2_effect_catalog_grow((void **)&b->effects, &b->effect_cap, b->effect_num + 1, sizeof(*b->effects))) {
+    b->failed = true;
+    return;
+  }
+  size_t const len = wcslen(name);
+  b->effects[b->effect_num++] = (struct aviutl2_effect_catalog_builder_effect){
+      .name = aviutl2_effect_catalog_builder_string(b, name, len),
+      .name_len = len,
+      .type = type,
+      .flag = flag,
+  };
+}
+
+static inline void aviutl2_effect_catalog_enum_item_proc(void *param, wchar_t const *name, int type) {
+  struct aviutl2_effect_catalog_builder *b = (struct aviutl2_effect_catalog_builder *)param;
+  if (b->failed || !name) {
+    return;
+  }
+  if (!aviutl2_effect_catalog_grow((void **)&b->items, &b->item_cap, b->item_num + 1, sizeof(*b->items))) {
+    b->failed = true;
+    return;
+  }
+  b->items[b->item_num++] = (struct aviutl2_effect_catalog_builder_item){
+      .name = aviutl2_effect_catalog_builder_string(b, name, wcslen(name)),
+      .type = type,
+      .group = UINT32_MAX,
+  };
+}
+
+static inline void aviutl2_effect_catalog_builder_groups(struct aviutl2_effect_catalog_builder *b,
+                                                         struct aviutl2_edit_handle *edit,
+                                                         struct aviutl2_effect_catalog_builder_effect const *e) {
+  wchar_t const *names_buf[64];
+  wchar_t const *const effect = b->strings + e->name;
+  for (uint32_t i = 0; i < e->item_num && !b->failed; ++i) {
+    if (b->items[e->item_first + i].group != UINT32_MAX) {
+      continue;
+    }
+    wchar_t const *const item = b->strings + b->items[e->item_first + i].name;
+    int const n = edit->get_effect_item_group_names(effect, item, NULL, 0, NULL);
+    if (n <= 0) {
+      continue;
+    }
+    wchar_t const **names = n <= 64 ? names_buf : (wchar_t const **)malloc((size_t)n * sizeof(wchar_t const *));
+    if (!names) {
+      b->failed = true;
+      return;
+    }
+    int const got = edit->get_effect_item_group_names(effect, item, names, n, NULL);
+    if (!aviutl2_effect_catalog_grow((void **)&b->groups, &b->group_cap, b->group_num + 2, sizeof(uint32_t)) ||
+        !aviutl2_effect_catalog_grow((void **)&b->group_items,
+                                     &b->group_item_cap,
+                                     b->group_item_num + (size_t)(got > 0 ? got : 0),
+                                     sizeof(uint32_t))) {
+      b->failed = true;
+    } else {
+      uint32_t const group = (uint32_t)b->group_num;
+      b->groups[group] = (uint32_t)b->group_item_num;
+      for (int j = 0; j < got; ++j) {
+        // Map member names back to the items of this effect.
+        for (uint32_t k = 0; k < e->item_num; ++k) {
+          struct aviutl2_effect_catalog_builder_item *it = b->items + e->item_first + k;
+          if (names[j] && wcscmp(b->strings + it->name, names[j]) == 0) {
+            it->group = group;
+            it->group_index = (uint32_t)(b->group_item_num - b->groups[group]);
+            b->group_items[b->group_item_num++] = e->item_first + k;
+            break;
+          }
+        }
+      }
+      if (b->group_item_num > b->groups[group]) {
+        b->groups[++b->group_num] = (uint32_t)b->group_item_num;
+      }
+    }
+    if (names != names_buf) {
+      free(names);
+    }
+  }
+}
+
+static inline void aviutl2_effect_catalog_builder_free(struct aviutl2_effect_catalog_builder *b) {
+  free(b->effects);
+  free(b->items);
+  free(b->groups);
+  free(b->group_items);
+  free(b->strings);
+}
+
+static inline void aviutl2_effect_catalog_sort(uint32_t *idx,
+                                               uint32_t *tmp,
+                                               size_t n,
+                                               struct aviutl2_effect_catalog_effect const *effects) {
+  // Merge sort keeps effects with the same name in enumeration order.
+  if (n < 2) {
+    return;
+  }
+  size_t const h = n / 2;
+  aviutl2_effect_catalog_sort(idx, tmp, h, effects);
+  aviutl2_effect_catalog_sort(idx + h, tmp, n - h, effects);
+  size_t i = 0, j = h, k = 0;
+  while (i < h && j < n) {
+    tmp[k++] = wcscmp(effects[idx[j]].name, effects[idx[i]].name) < 0 ? idx[j++] : idx[i++];
+  }
+  while (i < h) {
+    tmp[k++] = idx[i++];
+  }
+  while (j < n) {
+    tmp[k++] = idx[j++];
+  }
+  memcpy(idx, tmp, n * sizeof(uint32_t));
+}
+
+/**
+ * Build a catalog
+ * Enumerates effects with enum_effect_name(), their items with enum_effect_item() and the item groups with
+ * get_effect_item_group_names()
+ * @param edit Edit handle
+ * @return Catalog with one reference, or NULL on failure; release with aviutl2_effect_catalog_release()
+ */
+static inline struct aviutl2_effect_catalog *aviutl2_effect_catalog_build(struct aviutl2_edit_handle *edit) {
+  struct aviutl2_effect_catalog_builder b = {0};
+  uint64_t const fingerprint = aviutl2_effect_catalog_fingerprint(edit);
+  edit->enum_effect_name(&b, aviutl2_effect_catalog_enum_effect_proc);
+  for (size_t i = 0; i < b.effect_num && !b.failed; ++i) {
+    struct aviutl2_effect_catalog_builder_effect *e = b.effects + i;
+    e->item_first = (uint32_t)b.item_num;
+    // Item names are appended to b.strings during the enumeration and may move it, so pass a copy of the name.
+    wchar_t name_buf[256];
+    wchar_t *const name = e->name_len < 256 ? name_buf : (wchar_t *)malloc((e->name_len + 1) * sizeof(wchar_t));
+    if (!name) {
+      b.failed = true;
+      break;
+    }
+    memcpy(name, b.strings + e->name, (e->name_len + 1) * sizeof(wchar_t));
+    edit->enum_effect_item(name, &b, aviutl2_effect_catalog_enum_item_proc);
+    if (name != name_buf) {
+      free(name);
+    }
+    e->item_num = (uint32_t)(b.item_num - e->item_first);
+    aviutl2_effect_catalog_builder_groups(&b, edit, e);
+  }
+  if (b.failed || b.effect_num >= UINT32_MAX / 2 || b.item_num >= UINT32_MAX) {
+    aviutl2_effect_catalog_builder_free(&b);
+    return NULL;
+  }
+
+  size_t slot_num = 16;
+  while (slot_num < b.effect_num * 2) {
+    slot_num *= 2;
+  }
+  // Everything is placed in one block ordered by alignment.
+  size_t const effects_offset = sizeof(struct aviutl2_effect_catalog);
+  size_t const items_offset = effects_offset + b.effect_num * sizeof(struct aviutl2_effect_catalog_effect);
+  size_t const groups_offset = items_offset + b.item_num * sizeof(struct aviutl2_effect_catalog_item);
+  size_t const group_items_offset = groups_offset + b.group_num * sizeof(struct aviutl2_effect_catalog_group);
+  size_t const sorted_offset = group_items_offset + b.group_item_num * sizeof(uint32_t);
+  size_t const slots_offset = sorted_offset + b.effect_num * sizeof(uint32_t);
+  size_t const strings_offset = slots_offset + slot_num * sizeof(uint32_t);
+  size_t const bytes = strings_offset + b.string_len * sizeof(wchar_t);
+  uint8_t *block = (uint8_t *)malloc(bytes);
+  uint32_t *tmp = (uint32_t *)malloc((b.effect_num ? b.effect_num : 1) * sizeof(uint32_t));
+  if (!block || !tmp) {
+    free(tmp);
+    free(block);
+    aviutl2_effect_catalog_builder_free(&b);
+    return NULL;
+  }
+
+  struct aviutl2_effect_catalog_effect *effects = (struct aviutl2_effect_catalog_effect *)(block + effects_offset);
+  struct aviutl2_effect_catalog_item *items = (struct aviutl2_effect_catalog_item *)(block + items_offset);
+  struct aviutl2_effect_catalog_group *groups = (struct aviutl2_effect_catalog_group *)(block + groups_offset);
+  uint32_t *group_items = (uint32_t *)(block + group_items_offset);
+  uint32_t *sorted = (uint32_t *)(block + sorted_offset);
+  uint32_t *slots = (uint32_t *)(block + slots_offset);
+  wchar_t *strings = (wchar_t *)(block + strings_offset);
+  if (b.string_len) {
+    memcpy(strings, b.strings, b.string_len * sizeof(wchar_t));
+  }
+  if (b.group_item_num) {
+    memcpy(group_items, b.group_items, b.group_item_num * sizeof(uint32_t));
+  }
+  for (size_t i = 0; i < b.item_num; ++i) {
+    items[i] = (struct aviutl2_effect_catalog_item){
+        .name = strings + b.items[i].name,
+        .type = b.items[i].type,
+        .group = b.items[i].group,
+        .group_index = b.items[i].group_index,
+    };
+  }
+  for (size_t i = 0; i < b.group_num; ++i) {
+    groups[i] = (struct aviutl2_effect_catalog_group){
+        .items = group_items + b.groups[i],
+        .item_num = b.groups[i + 1] - b.groups[i],
+    };
+  }
+  memset(slots, 0, slot_num * sizeof(uint32_t));
+  for (size_t i = 0; i < b.effect_num; ++i) {
+    struct aviutl2_effect_catalog_builder_effect const *e = b.effects + i;
+    effects[i] = (struct aviutl2_effect_catalog_effect){
+        .name = strings + e->name,
+        .name_len = e->name_len,
+        .type = e->type,
+        .flag = e->flag,
+        .items = items + e->item_first,
+        .item_num = e->item_num,
+    };
+    sorted[i] = (uint32_t)i;
+    size_t pos = (size_t)aviutl2_effect_catalog_hash(effects[i].name, e->name_len) & (slot_num - 1);
+    bool dup = false;
+    for (; slots[pos]; pos = (pos + 1) & (slot_num - 1)) {
+      struct aviutl2_effect_catalog_effect const *o = effects + (slots[pos] - 1);
+      if (o->name_len == e->name_len && wmemcmp(o->name, effects[i].name, e->name_len) == 0) {
+        dup = true;
+        break;
+      }
+    }
+    if (!dup) {
+      slots[pos] = (uint32_t)(i + 1);
+    }
+  }
+  aviutl2_effect_catalog_sort(sorted, tmp, b.effect_num, effects);
+  free(tmp);
+  aviutl2_effect_catalog_builder_free(&b);
+
+  struct aviutl2_effect_catalog *cat = (struct aviutl2_effect_catalog *)block;
+  *cat = (struct aviutl2_effect_catalog){
+      .refs = 1,
+      .fingerprint = fingerprint,
+      .effects = effects,
+      .effect_num = b.effect_num,
+      .items = items,
+      .item_num = b.item_num,
+      .groups = groups,
+      .group_num = b.group_num,
+      .sorted = sorted,
+      .slots = slots,
+      .slot_num = slot_num,
+      .bytes = bytes,
+  };
+  return cat;
+}
+
+/**
+ * Add a reference to a catalog
+ * @param cat Catalog
+ * @return cat
+ */
+static inline struct aviutl2_effect_catalog *aviutl2_effect_catalog_retain(struct aviutl2_effect_catalog *cat) {
+  if (cat) {
+    InterlockedIncrement(&cat->refs);
+  }
+  return cat;
+}
+
+/**
+ * Release a reference to a catalog
+ * @param cat Catalog (may be NULL)
+ */
+static inline void aviutl2_effect_catalog_release(struct aviutl2_effect_catalog *cat) {
+  if (cat && InterlockedDecrement(&cat->refs) == 0) {
+    free(cat);
+  }
+}
+
+/**
+ * Find an effect by name
+ * @param cat Catalog
+ * @param name Effect name
+ * @return Effect (the first one if the name is duplicated), or NULL if not found
+ */
+static inline struct aviutl2_effect_catalog_effect const *
+aviutl2_effect_catalog_find(struct aviutl2_effect_catalog const *cat, wchar_t const *name) {
+  size_t const len = wcslen(name);
+  size_t const mask = cat->slot_num - 1;
+  for (size_t pos = (size_t)aviutl2_effect_catalog_hash(name, len) & mask; cat->slots[pos]; pos = (pos + 1) & mask) {
+    struct aviutl2_effect_catalog_effect const *e = cat->effects + (cat->slots[pos] - 1);
+    if (e->name_len == len && wmemcmp(e->name, name, len) == 0) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Find a setting item of an effect by name
+ * @param effect Effect
+ * @param name Item name
+ * @return Item, or NULL if not found
+ */
+static inline struct aviutl2_effect_catalog_item const *
+aviutl2_effect_catalog_find_item(struct aviutl2_effect_catalog_effect const *effect, wchar_t const *name) {
+  for (uint32_t i = 0; i < effect->item_num; ++i) {
+    if (wcscmp(effect->items[i].name, name) == 0) {
+      return effect->items + i;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Get the group an item belongs to
+ * @param cat Catalog
+ * @param item Item
+ * @return Group, or NULL if the item is not grouped
+ */
+static inline struct aviutl2_effect_catalog_group const *
+aviutl2_effect_catalog_item_group(struct aviutl2_effect_catalog const *cat,
+                                  struct aviutl2_effect_catalog_item const *item) {
+  return item->group < cat->group_num ? cat->groups + item->group : NULL;
+}
+
+/**
+ * Find effects whose name starts with a prefix
+ * @param cat Catalog
+ * @param prefix Prefix (case-sensitive)
+ * @param effects Destination for indices in the catalog effects array, in name order (may be NULL when cap is 0)
+ * @param cap Number of indices that can be stored
+ * @return Total number of matching effects (only cap indices are stored)
+ */
+static inline size_t aviutl2_effect_catalog_prefix(struct aviutl2_effect_catalog const *cat,
+                                                   wchar_t const *prefix,
+                                                   uint32_t *effects,
+                                                   size_t cap) {
+  size_t const len = wcslen(prefix);
+  size_t lo = 0, hi = cat->effect_num;
+  while (lo < hi) {
+    size_t const mid = lo + (hi - lo) / 2;
+    if (wcscmp(cat->effects[cat->sorted[mid]].name, prefix) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  size_t n = 0;
+  for (size_t i = lo; i < cat->effect_num; ++i, ++n) {
+    struct aviutl2_effect_catalog_effect const *e = cat->effects + cat->sorted[i];
+    if (e->name_len < len || wmemcmp(e->name, prefix, len) != 0) {
+      break;
+    }
+    if (n < cap) {
+      effects[n] = cat->sorted[i];
+    }
+  }
+  return n;
+}
+
+static inline wchar_t aviutl2_effect_catalog_fold(wchar_t c) {
+  if ((c >= L'A' && c <= L'Z') || (c >= 0xff21 && c <= 0xff3a)) {
+    return (wchar_t)(c + 0x20);
+  }
+  return c;
+}
+
+/**
+ * Score a fuzzy subsequence match
+ * Letters A-Z (including full-width) are compared case-insensitively
+ * @param name Name
+ * @param pattern Pattern whose characters must appear in name in order
+ * @return Score (higher is better), or -1 if the pattern does not match
+ */
+static inline int aviutl2_effect_catalog_fuzzy_score(wchar_t const *name, wchar_t const *pattern) {
+  int score = 0;
+  int run = 0;
+  int first = -1;
+  size_t j = 0;
+  for (size_t i = 0; name[i] && pattern[j]; ++i) {
+    if (aviutl2_effect_catalog_fold(name[i]) != aviutl2_effect_catalog_fold(pattern[j])) {
+      run = 0;
+      continue;
+    }
+    if (first < 0) {
+      first = (int)i;
+    }
+    // Consecutive matches and matches at the start of the name rank higher.
+    score += 1 + run * 4 + (i == 0 ? 8 : 0);
+    ++run;
+    ++j;
+  }
+  if (pattern[j]) {
+    return -1;
+  }
+  return score - (first > 0 ? first : 0);
+}
+
+/**
+ * Find effects whose name contains the pattern characters in order
+ * @param cat Catalog
+ * @param pattern Pattern
+ * @param matches Destination sorted by descending score, ties in name order (may be NULL when cap is 0)
+ * @param cap Number of matches that can be stored (the best cap matches are kept)
+ * @return Total number of matching effects
+ */
+static inline size_t aviutl2_effect_catalog_fuzzy(struct aviutl2_effect_catalog const *cat,
+                                                  wchar_t const *pattern,
+                                                  struct aviutl2_effect_catalog_match *matches,
+                                                  size_t cap) {
+  size_t total = 0, n = 0;
+  for (size_t i = 0; i < cat->effect_num; ++i) {
+    uint32_t const idx = cat->sorted[i];
+    int const score = aviutl2_effect_catalog_fuzzy_score(cat->effects[idx].name, pattern);
+    if (score < 0) {
+      continue;
+    }
+    ++total;
+    if (n == cap && (cap == 0 || matches[n - 1].score >= score)) {
+      continue;
+    }
+    size_t pos = n < cap ? n++ : n - 1;
+    while (pos > 0 && matches[pos - 1].score < score) {
+      matches[pos] = matches[pos - 1];
+      --pos;
+    }
+    matches[pos] = (struct aviutl2_effect_catalog_match){idx, score};
+  }
+  return total;
+}
+
+/**
+ * Catalog cache
+ * Initialize with aviutl2_effect_catalog_cache_init() and release with aviutl2_effect_catalog_cache_exit()
+ */
+struct aviutl2_effect_catalog_cache {
+  struct aviutl2_edit_handle *edit;
+  SRWLOCK lock;
+  struct aviutl2_effect_catalog *current;
+  uint64_t builds; /**< Number of times the catalog was built */
+};
+
+/**
+ * Initialize a catalog cache
+ * The catalog is built on first use
+ * @param c Cache
+ * @param edit Edit handle
+ */
+static inline void aviutl2_effect_catalog_cache_init(struct aviutl2_effect_catalog_cache *c,
+                                                     struct aviutl2_edit_handle *edit) {
+  memset(c, 0, sizeof(*c));
+  c->edit = edit;
+  InitializeSRWLock(&c->lock);
+}
+
+/**
+ * Release the cached catalog
+ * Catalogs still retained by callers stay valid until they are released
+ * @param c Cache
+ */
+static inline void aviutl2_effect_catalog_cache_exit(struct aviutl2_effect_catalog_cache *c) {
+  aviutl2_effect_catalog_release(c->current);
+  memset(c, 0, sizeof(*c));
+}
+
+/**
+ * Rebuild the cached catalog if the module list changed
+ * @param c Cache
+ * @return true if the catalog is up to date, false if building failed (the previous catalog is kept)
+ */
+static inline bool aviutl2_effect_catalog_cache_refresh(struct aviutl2_effect_catalog_cache *c) {
+  uint64_t const fingerprint = aviutl2_effect_catalog_fingerprint(c->edit);
+  AcquireSRWLockShared(&c->lock);
+  bool const fresh = c->current && c->current->fingerprint == fingerprint;
+  ReleaseSRWLockShared(&c->lock);
+  if (fresh) {
+    return true;
+  }
+  struct aviutl2_effect_catalog *cat = aviutl2_effect_catalog_build(c->edit);
+  if (!cat) {
+    return false;
+  }
+  AcquireSRWLockExclusive(&c->lock);
+  struct aviutl2_effect_catalog *old = c->current;
+  c->current = cat;
+  ++c->builds;
+  ReleaseSRWLockExclusive(&c->lock);
+  aviutl2_effect_catalog_release(old);
+  return true;
+}
+
+/**
+ * Get the cached catalog
+ * Builds the catalog if there is none yet; does not check whether the module list changed
+ * @param c Cache
+ * @return Catalog with an added reference (release with aviutl2_effect_catalog_release()), or NULL on failure
+ */
+static inline struct aviutl2_effect_catalog *aviutl2_effect_catalog_cache_get(struct aviutl2_effect_catalog_cache *c) {
+  AcquireSRWLockShared(&c->lock);
+  struct aviutl2_effect_catalog *cat = aviutl2_effect_catalog_retain(c->current);
+  ReleaseSRWLockShared(&c->lock);
+  if (cat || !aviutl2_effect_catalog_cache_refresh(c)) {
+    return cat;
+  }
+  AcquireSRWLockShared(&c->lock);
+  cat = aviutl2_effect_catalog_retain(c->current);
+  ReleaseSRWLockShared(&c->lock);
+  return cat;
+}
@@ -0,0 +1,852 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Audio spectrum analysis
+//
+// A real-input FFT with precomputed bit-reversal, twiddle and window tables, plus a spectrum cache that reads media
+// file audio through aviutl2_cache_handle::get_audio_file_data() and keeps magnitude spectra keyed by file, track
+// and frame. Audio-reactive filters can call aviutl2_fft_cache_get() from func_proc_video; the same cache is exposed
+// as a script module:
+//   local bands = fft.spectrum(file, obj.frame, obj.framerate, 1, 32)
+// Call aviutl2_fft_module_init() from InitializeCache() and return aviutl2_fft_module_table() from
+// GetScriptModuleTable(). Both must be called from the same translation unit because the module state is a static
+// local of that unit.
+//
+// The transform packs even and odd samples into an N/2-point complex FFT computed with radix-4 butterflies
+// (one radix-2 pass when log2(N/2) is odd) on split real/imaginary arrays, then separates the real spectrum.
+// Butterflies and the separation step use SSE2 when available.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_cache2.h"
+#include "aviutl2_hash.h"
+#include "aviutl2_module2.h"
+#include "aviutl2_utf.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+enum {
+  aviutl2_fft_min_size = 16,
+  aviutl2_fft_max_size = 65536,
+  aviutl2_fft_cache_ways = 4,
+};
+
+/**
+ * Analysis window
+ */
+enum aviutl2_fft_window {
+  aviutl2_fft_window_rectangular = 0, /**< No window */
+  aviutl2_fft_window_hann = 1,        /**< Hann */
+  aviutl2_fft_window_hamming = 2,     /**< Hamming */
+  aviutl2_fft_window_blackman = 3,    /**< Blackman */
+};
+
+/**
+ * FFT plan
+ * Immutable after aviutl2_fft_init(), so one plan can be shared by any number of threads
+ */
+struct aviutl2_fft {
+  int size;      /**< Number of input samples (power of two) */
+  int bin_num;   /**< Number of output bins (size / 2 + 1) */
+  float scale;   /**< Amplitude scale for bins other than DC and Nyquist (2 / sum of window) */
+  float *window; /**< size coefficients */
+  uint32_t *bitrev;
+  float *stage_twiddle;
+  float *split_twiddle;
+  void *block;
+};
+
+static inline int aviutl2_fft_log2_(int n) {
+  int r = 0;
+  while ((1 << r) < n) {
+    ++r;
+  }
+  return r;
+}
+
+/**
+ * Release the tables of an FFT plan
+ * @param fft FFT plan
+ */
+static inline void aviutl2_fft_exit(struct aviutl2_fft *fft) {
+  if (!fft) {
+    return;
+  }
+  free(fft->block);
+  memset(fft, 0, sizeof(*fft));
+}
+
+/**
+ * Initialize an FFT plan
+ * @param fft FFT plan
+ * @param size Number of input samples (power of two between aviutl2_fft_min_size and aviutl2_fft_max_size)
+ * @param window Analysis window applied to the input
+ * @return true on success
+ */
+static inline bool aviutl2_fft_init(struct aviutl2_fft *fft, int size, enum aviutl2_fft_window window) {
+  if (!fft) {
+    return false;
+  }
+  memset(fft, 0, sizeof(*fft));
+  if (size < aviutl2_fft_min_size || size > aviutl2_fft_max_size || (size & (size - 1)) != 0) {
+    return false;
+  }
+  int const half = size / 2;
+  int const bits = aviutl2_fft_log2_(half);
+  // Radix-4 stages use m, 4m, 16m, ... quarter lengths and need 6 floats (w1, w2, w3) per butterfly, so the stage
+  // table never exceeds 2 * half floats.
+  size_t const window_num = (size_t)size;
+  size_t const stage_num = (size_t)half * 2;
+  size_t const split_num = ((size_t)half / 2 + 1) * 2;
+  fft->block = malloc((window_num + stage_num + split_num) * sizeof(float) + (size_t)half * sizeof(uint32_t));
+  if (!fft->block) {
+    return false;
+  }
+  fft->size = size;
+  fft->bin_num = half + 1;
+  fft->window = (float *)fft->block;
+  fft->stage_twiddle = fft->window + window_num;
+  fft->split_twiddle = fft->stage_twiddle + stage_num;
+  fft->bitrev = (uint32_t *)(void *)(fft->split_twiddle + split_num);
+
+  double const pi = 3.14159265358979323846;
+  double sum = 0.0;
+  for (int i = 0; i < size; ++i) {
+    double const x = 2.0 * pi * (double)i / (double)size;
+    double w = 1.0;
+    switch (window) {
+    case aviutl2_fft_window_hann:
+      w = 0.5 - 0.5 * cos(x);
+      break;
+    case aviutl2_fft_window_hamming:
+      w = 0.54 - 0.46 * cos(x);
+      break;
+    case aviutl2_fft_window_blackman:
+      w = 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+      break;
+    default:
+      break;
+    }
+    fft->window[i] = (float)w;
+    sum += w;
+  }
+  fft->scale = (float)(2.0 / sum);
+
+  for (int i = 0; i < half; ++i) {
+    uint32_t r = 0;
+    for (int b = 0; b < bits; ++b) {
+      r |= (((uint32_t)i >> b) & 1u) << (bits - 1 - b);
+    }
+    fft->bitrev[i] = r;
+  }
+
+  float *tw = fft->stage_twiddle;
+  for (int m = (bits & 1) ? 2 : 1; m < half; m *= 4) {
+    for (int k = 0; k < m; ++k) {
+      double const a = 2.0 * pi * (double)k / (double)(4 * m);
+      tw[k] = (float)cos(a);
+      tw[m + k] = (float)-sin(a);
+      tw[2 * m + k] = (float)cos(2.0 * a);
+      tw[3 * m + k] = (float)-sin(2.0 * a);
+      tw[4 * m + k] = (float)cos(3.0 * a);
+      tw[5 * m + k] = (float)-sin(3.0 * a);
+    }
+    tw += 6 * m;
+  }
+
+  int const quarter = half / 2;
+  for (int k = 0; k <= quarter; ++k) {
+    double const a = 2.0 * pi * (double)k / (double)size;
+    fft->split_twiddle[k] = (float)cos(a);
+    fft->split_twiddle[quarter + 1 + k] = (float)sin(a);
+  }
+  return true;
+}
+
+static inline void aviutl2_fft_radix4_scalar_(float *re, float *im, int m, float const *tw) {
+  float *const r1 = re + m, *const r2 = re + 2 * m, *const r3 = re + 3 * m;
+  float *const i1 = im + m, *const i2 = im + 2 * m, *const i3 = im + 3 * m;
+  for (int k = 0; k < m; ++k) {
+    float const w1r = tw[k], w1i = tw[m + k];
+    float const w2r = tw[2 * m + k], w2i = tw[3 * m + k];
+    float const w3r = tw[4 * m + k], w3i = tw[5 * m + k];
+    float const t1r = r1[k] * w2r - i1[k] * w2i, t1i = r1[k] * w2i + i1[k] * w2r;
+    float const t2r = r2[k] * w1r - i2[k] * w1i, t2i = r2[k] * w1i + i2[k] * w1r;
+    float const t3r = r3[k] * w3r - i3[k] * w3i, t3i = r3[k] * w3i + i3[k] * w3r;
+    float const ar = re[k] + t1r, ai = im[k] + t1i;
+    float const br = re[k] - t1r, bi = im[k] - t1i;
+    float const cr = t2r + t3r, ci = t2i + t3i;
+    float const dr = t2r - t3r, di = t2i - t3i;
+    re[k] = ar + cr;
+    im[k] = ai + ci;
+    r2[k] = ar - cr;
+    i2[k] = ai - ci;
+    r1[k] = br + di;
+    i1[k] = bi - dr;
+    r3[k] = br - di;
+    i3[k] = bi + dr;
+  }
+}
+
+#if AVIUTL2_HAS_SSE2
+static inline void aviutl2_fft_radix4_sse2_(float *re, float *im, int m, float const *tw) {
+  float *const r1 = re + m, *const r2 = re + 2 * m, *const r3 = re + 3 * m;
+  float *const i1 = im + m, *const i2 = im + 2 * m, *const i3 = im + 3 * m;
+  for (int k = 0; k < m; k += 4) {
+    __m128 const w1r = _mm_loadu_ps(tw + k), w1i = _mm_loadu_ps(tw + m + k);
+    __m128 const w2r = _mm_loadu_ps(tw + 2 * m + k), w2i = _mm_loadu_ps(tw + 3 * m + k);
+    __m128 const w3r = _mm_loadu_ps(tw + 4 * m + k), w3i = _mm_loadu_ps(tw + 5 * m + k);
+    __m128 const x0r = _mm_loadu_ps(re + k), x0i = _mm_loadu_ps(im + k);
+    __m128 const x1r = _mm_loadu_ps(r1 + k), x1i = _mm_loadu_ps(i1 + k);
+    __m128 const x2r = _mm_loadu_ps(r2 + k), x2i = _mm_loadu_ps(i2 + k);
+    __m128 const x3r = _mm_loadu_ps(r3 + k), x3i = _mm_loadu_ps(i3 + k);
+    __m128 const t1r = _mm_sub_ps(_mm_mul_ps(x1r, w2r), _mm_mul_ps(x1i, w2i));
+    __m128 const t1i = _mm_add_ps(_mm_mul_ps(x1r, w2i), _mm_mul_ps(x1i, w2r));
+    __m128 const t2r = _mm_sub_ps(_mm_mul_ps(x2r, w1r), _mm_mul_ps(x2i, w1i));
+    __m128 const t2i = _mm_add_ps(_mm_mul_ps(x2r, w1i), _mm_mul_ps(x2i, w1r));
+    __m128 const t3r = _mm_sub_ps(_mm_mul_ps(x3r, w3r), _mm_mul_ps(x3i, w3i));
+    __m128 const t3i = _mm_add_ps(_mm_mul_ps(x3r, w3i), _mm_mul_ps(x3i, w3r));
+    __m128 const ar = _mm_add_ps(x0r, t1r), ai = _mm_add_ps(x0i, t1i);
+    __m128 const br = _mm_sub_ps(x0r, t1r), bi = _mm_sub_ps(x0i, t1i);
+    __m128 const cr = _mm_add_ps(t2r, t3r), ci = _mm_add_ps(t2i, t3i);
+    __m128 const dr = _mm_sub_ps(t2r, t3r), di = _mm_sub_ps(t2i, t3i);
+    _mm_storeu_ps(re + k, _mm_add_ps(ar, cr));
+    _mm_storeu_ps(im + k, _mm_add_ps(ai, ci));
+    _mm_storeu_ps(r2 + k, _mm_sub_ps(ar, cr));
+    _mm_storeu_ps(i2 + k, _mm_sub_ps(ai, ci));
+    _mm_storeu_ps(r1 + k, _mm_add_ps(br, di));
+    _mm_storeu_ps(i1 + k, _mm_sub_ps(bi, dr));
+    _mm_storeu_ps(r3 + k, _mm_sub_ps(br, di));
+    _mm_storeu_ps(i3 + k, _mm_add_ps(bi, dr));
+  }
+}
+#endif
+
+static inline void aviutl2_fft_complex_(struct aviutl2_fft const *fft, float *re, float *im) {
+  int const half = fft->size / 2;
+  int m = 1;
+  if (aviutl2_fft_log2_(half) & 1) {
+    for (int i = 0; i < half; i += 2) {
+      float const ar = re[i], ai = im[i];
+      re[i] = ar + re[i + 1];
+      im[i] = ai + im[i + 1];
+      re[i + 1] = ar - re[i + 1];
+      im[i + 1] = ai - im[i + 1];
+    }
+    m = 2;
+  }
+  float const *tw = fft->stage_twiddle;
+  for (; m < half; m *= 4) {
+    for (int base = 0; base < half; base += 4 * m) {
+#if AVIUTL2_HAS_SSE2
+      if (m >= 4) {
+        aviutl2_fft_radix4_sse2_(re + base, im + base, m, tw);
+        continue;
+      }
+#endif
+      aviutl2_fft_radix4_scalar_(re + base, im + base, m, tw);
+    }
+    tw += 6 * m;
+  }
+}
+
+static inline void aviutl2_fft_split_scalar_(float *re, float *im, float const *cs, float const *sn, int k, int half) {
+  // X[k] = Fe + W^k Fo and X[half - k] = conj(Fe - W^k Fo), where Fe and Fo are the spectra of the even and odd
+  // samples recovered from Z[k] and conj(Z[half - k]).
+  int const j = half - k;
+  float const fer = 0.5f * (re[k] + re[j]), fei = 0.5f * (im[k] - im[j]);
+  float const for_ = 0.5f * (im[k] + im[j]), foi = -0.5f * (re[k] - re[j]);
+  float const pr = for_ * cs[k] + foi * sn[k], pi = foi * cs[k] - for_ * sn[k];
+  re[k] = fer + pr;
+  im[k] = fei + pi;
+  re[j] = fer - pr;
+  im[j] = pi - fei;
+}
+
+/**
+ * Compute the spectrum of real input
+ * @param fft FFT plan
+ * @param input fft->size samples; the plan window is applied while reading
+ * @param re Destination for the real parts (fft->bin_num floats)
+ * @param im Destination for the imaginary parts (fft->bin_num floats)
+ */
+static inline void aviutl2_fft_forward(struct aviutl2_fft const *fft, float const *input, float *re, float *im) {
+  int const half = fft->size / 2;
+  float const *const w = fft->window;
+  for (int i = 0; i < half; ++i) {
+    uint32_t const r = fft->bitrev[i];
+    re[r] = input[2 * i] * w[2 * i];
+    im[r] = input[2 * i + 1] * w[2 * i + 1];
+  }
+  aviutl2_fft_complex_(fft, re, im);
+
+  float const z0r = re[0], z0i = im[0];
+  re[0] = z0r + z0i;
+  im[0] = 0.f;
+  re[half] = z0r - z0i;
+  im[half] = 0.f;
+  int const quarter = half / 2;
+  float const *const cs = fft->split_twiddle;
+  float const *const sn = fft->split_twiddle + quarter + 1;
+  int k = 1;
+#if AVIUTL2_HAS_SSE2
+  __m128 const h = _mm_set1_ps(0.5f);
+  for (; 2 * k + 6 < half; k += 4) {
+    int const j = half - k - 3;
+    __m128 const ar = _mm_loadu_ps(re + k), ai = _mm_loadu_ps(im + k);
+    __m128 br = _mm_loadu_ps(re + j), bi = _mm_loadu_ps(im + j);
+    br = _mm_shuffle_ps(br, br, _MM_SHUFFLE(0, 1, 2, 3));
+    bi = _mm_shuffle_ps(bi, bi, _MM_SHUFFLE(0, 1, 2, 3));
+    __m128 const c = _mm_loadu_ps(cs + k), s = _mm_loadu_ps(sn + k);
+    __m128 const fer = _mm_mul_ps(h, _mm_add_ps(ar, br)), fei = _mm_mul_ps(h, _mm_sub_ps(ai, bi));
+    __m128 const for_ = _mm_mul_ps(h, _mm_add_ps(ai, bi)), foi = _mm_mul_ps(h, _mm_sub_ps(br, ar));
+    __m128 const pr = _mm_add_ps(_mm_mul_ps(for_, c), _mm_mul_ps(foi, s));
+    __m128 const pi = _mm_sub_ps(_mm_mul_ps(foi, c), _mm_mul_ps(for_, s));
+    _mm_storeu_ps(re + k, _mm_add_ps(fer, pr));
+    _mm_storeu_ps(im + k, _mm_add_ps(fei, pi));
+    __m128 const xr = _mm_sub_ps(fer, pr), xi = _mm_sub_ps(pi, fei);
+    _mm_storeu_ps(re + j, _mm_shuffle_ps(xr, xr, _MM_SHUFFLE(0, 1, 2, 3)));
+    _mm_storeu_ps(im + j, _mm_shuffle_ps(xi, xi, _MM_SHUFFLE(0, 1, 2, 3)));
+  }
+#endif
+  for (; k <= quarter; ++k) {
+    aviutl2_fft_split_scalar_(re, im, cs, sn, k, half);
+  }
+}
+
+/**
+ * Compute real output from a spectrum in the layout produced by aviutl2_fft_forward()
+ * The window is not applied or removed, so with a rectangular window the transform round-trips exactly.
+ * @param fft FFT plan
+ * @param re Real parts (fft->bin_num floats)
+ * @param im Imaginary parts (fft->bin_num floats)
+ * @param work Work area (fft->size floats)
+ * @param output Destination (fft->size samples)
+ */
+static inline void aviutl2_fft_inverse(struct aviutl2_fft const *fft,
+                                       float const *re,
+                                       float const *im,
+                                       float *work,
+                                       float *output) {
+  // Rebuild Z[k] = Fe[k] + i Fo[k] from the real spectrum and run the forward complex FFT on conj(Z), which is the
+  // inverse transform up to a final conjugation and 1 / (size / 2) scale.
+  int const half = fft->size / 2;
+  int const quarter = half / 2;
+  float *const zr = work;
+  float *const zi = work + half;
+  float const *const cs = fft->split_twiddle;
+  float const *const sn = fft->split_twiddle + quarter + 1;
+  uint32_t const *const br = fft->bitrev;
+  zr[0] = 0.5f * (re[0] + re[half]);
+  zi[0] = -0.5f * (re[0] - re[half]);
+  for (int k = 1; k <= quarter; ++k) {
+    int const j = half - k;
+    float const fer = 0.5f * (re[k] + re[j]), fei = 0.5f * (im[k] - im[j]);
+    float const dr = 0.5f * (re[k] - re[j]), di = 0.5f * (im[k] + im[j]);
+    float const for_ = dr * cs[k] - di * sn[k], foi = dr * sn[k] + di * cs[k];
+    zr[br[k]] = fer - foi;
+    zi[br[k]] = -(fei + for_);
+    zr[br[j]] = fer + foi;
+    zi[br[j]] = fei - for_;
+  }
+  aviutl2_fft_complex_(fft, zr, zi);
+  float const scale = 1.f / (float)half;
+  for (int i = 0; i < half; ++i) {
+    output[2 * i] = zr[i] * scale;
+    output[2 * i + 1] = -zi[i] * scale;
+  }
+}
+
+/**
+ * Compute the amplitude spectrum of real input
+ * A full-scale sine wave centered on a bin yields an amplitude of about 1.0 regardless of the window.
+ * @param fft FFT plan
+ * @param input fft->size samples
+ * @param work Work area (fft->bin_num * 2 floats)
+ * @param magnitude Destination (fft->bin_num floats)
+ */
+static inline void aviutl2_fft_magnitude(struct aviutl2_fft const *fft,
+                                         float const *input,
+                                         float *work,
+                                         float *magnitude) {
+  int const n = fft->bin_num;
+  float *const re = work;
+  float *const im = work + n;
+  aviutl2_fft_forward(fft, input, re, im);
+  float const scale = fft->scale;
+  int k = 0;
+#if AVIUTL2_HAS_SSE2
+  __m128 const s = _mm_set1_ps(scale);
+  for (; k + 4 <= n; k += 4) {
+    __m128 const r = _mm_loadu_ps(re + k), i = _mm_loadu_ps(im + k);
+    _mm_storeu_ps(magnitude + k, _mm_mul_ps(s, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(i, i)))));
+  }
+#endif
+  for (; k < n; ++k) {
+    magnitude[k] = scale * sqrtf(re[k] * re[k] + im[k] * im[k]);
+  }
+  magnitude[0] *= 0.5f;
+  magnitude[n - 1] *= 0.5f;
+}
+
+/**
+ * Convert amplitudes to decibels in place
+ * @param values Amplitudes
+ * @param n Number of values
+ * @param floor_db Lower limit in dB, used for silent bins
+ */
+static inline void aviutl2_fft_to_db(float *values, size_t n, float floor_db) {
+  float const floor_amp = powf(10.f, floor_db / 20.f);
+  for (size_t i = 0; i < n; ++i) {
+    values[i] = values[i] > floor_amp ? 20.f * log10f(values[i]) : floor_db;
+  }
+}
+
+/**
+ * Reduce a spectrum to logarithmically spaced bands
+ * Bands span bin 1 to the last bin; each band takes the peak of its bins, and narrow low bands that fall between
+ * bins take the nearest bin so that no band is empty.
+ * @param magnitude Amplitude spectrum
+ * @param bin_num Number of bins
+ * @param bands Destination
+ * @param band_num Number of bands
+ */
+static inline void aviutl2_fft_bands(float const *magnitude, int bin_num, float *bands, int band_num) {
+  if (band_num <= 0) {
+    return;
+  }
+  if (bin_num < 2) {
+    memset(bands, 0, (size_t)band_num * sizeof(float));
+    return;
+  }
+  double const ratio = log((double)(bin_num - 1)) / (double)band_num;
+  int lo = 1;
+  for (int b = 0; b < band_num; ++b) {
+    int hi = (int)exp(ratio * (double)(b + 1));
+    if (hi > bin_num - 1) {
+      hi = bin_num - 1;
+    }
+    if (lo > hi) {
+      lo = hi;
+    }
+    float peak = 0.f;
+    for (int k = lo; k <= hi; ++k) {
+      if (magnitude[k] > peak) {
+        peak = magnitude[k];
+      }
+    }
+    bands[b] = peak;
+    lo = hi + 1;
+  }
+}
+
+//--------------------------------
+
+/**
+ * Spectrum cache key
+ */
+struct aviutl2_fft_cache_key {
+  uint64_t file_hash; /**< aviutl2_hash_wstr() of the media file path */
+  int track;          /**< Audio track number */
+  int frame;          /**< Frame number */
+  int rate, scale;    /**< Frame rate used to convert the frame to a sample position */
+};
+
+/**
+ * Spectrum cache entry
+ */
+struct aviutl2_fft_cache_entry {
+  struct aviutl2_fft_cache_key key;
+  bool used;
+  uint64_t last_used;
+  float *magnitude; /**< fft.bin_num floats */
+};
+
+/**
+ * Spectrum cache
+ * All members except fft are private; use the aviutl2_fft_cache_* functions
+ */
+struct aviutl2_fft_cache {
+  struct aviutl2_cache_handle *cache;
+  struct aviutl2_fft fft;
+  SRWLOCK lock;
+  struct aviutl2_fft_cache_entry *entries;
+  float *storage;
+  size_t set_num;
+  uint64_t tick;
+};
+
+/**
+ * Release all resources owned by the spectrum cache
+ * @param c Spectrum cache
+ */
+static inline void aviutl2_fft_cache_exit(struct aviutl2_fft_cache *c) {
+  if (!c) {
+    return;
+  }
+  aviutl2_fft_exit(&c->fft);
+  free(c->entries);
+  free(c->storage);
+  memset(c, 0, sizeof(*c));
+}
+
+/**
+ * Initialize the spectrum cache
+ * @param c Spectrum cache
+ * @param cache Cache handle passed to InitializeCache()
+ * @param size FFT size (see aviutl2_fft_init())
+ * @param window Analysis window
+ * @param capacity Number of spectra kept in memory (rounded up to a multiple of aviutl2_fft_cache_ways)
+ * @return true on success
+ */
+static inline bool aviutl2_fft_cache_init(struct aviutl2_fft_cache *c,
+                                          struct aviutl2_cache_handle *cache,
+                                          int size,
+                                          enum aviutl2_fft_window window,
+                                          size_t capacity) {
+  if (!c || !cache || capacity == 0) {
+    return false;
+  }
+  memset(c, 0, sizeof(*c));
+  c->cache = cache;
+  InitializeSRWLock(&c->lock);
+  if (!aviutl2_fft_init(&c->fft, size, window)) {
+    aviutl2_fft_cache_exit(c);
+    return false;
+  }
+  c->set_num = (capacity + aviutl2_fft_cache_ways - 1) / aviutl2_fft_cache_ways;
+  size_t const n = c->set_num * aviutl2_fft_cache_ways;
+  c->entries = (struct aviutl2_fft_cache_entry *)calloc(n, sizeof(struct aviutl2_fft_cache_entry));
+  c->storage = (float *)malloc(n * (size_t)c->fft.bin_num * sizeof(float));
+  if (!c->entries || !c->storage) {
+    aviutl2_fft_cache_exit(c);
+    return false;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    c->entries[i].magnitude = c->storage + i * (size_t)c->fft.bin_num;
+  }
+  return true;
+}
+
+static inline bool aviutl2_fft_cache_key_equal(struct aviutl2_fft_cache_key const *a,
+                                               struct aviutl2_fft_cache_key const *b) {
+  return a->file_hash == b->file_hash && a->track == b->track && a->frame == b->frame && a->rate == b->rate &&
+         a->scale == b->scale;
+}
+
+static inline struct aviutl2_fft_cache_entry *aviutl2_fft_cache_set(struct aviutl2_fft_cache *c,
+                                                                    struct aviutl2_fft_cache_key const *key) {
+  uint64_t h = aviutl2_hash_u64(AVIUTL2_HASH_INIT, key->file_hash);
+  h = aviutl2_hash_u64(h, ((uint64_t)(uint32_t)key->track << 32) | (uint32_t)key->frame);
+  h = aviutl2_hash_u64(h, ((uint64_t)(uint32_t)key->rate << 32) | (uint32_t)key->scale);
+  return c->entries + (size_t)(h % c->set_num) * aviutl2_fft_cache_ways;
+}
+
+/**
+ * Find an entry. Must be called with the lock held
+ */
+static inline struct aviutl2_fft_cache_entry *aviutl2_fft_cache_find(struct aviutl2_fft_cache *c,
+                                                                     struct aviutl2_fft_cache_key const *key) {
+  struct aviutl2_fft_cache_entry *set = aviutl2_fft_cache_set(c, key);
+  for (int i = 0; i < aviutl2_fft_cache_ways; ++i) {
+    if (set[i].used && aviutl2_fft_cache_key_equal(&set[i].key, key)) {
+      return set + i;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Read the mono mix of fft->size samples centered on a frame
+ * Samples outside the file are zero
+ * @return true on success
+ */
+static inline bool aviutl2_fft_cache_read(struct aviutl2_fft_cache *c,
+                                          wchar_t const *file,
+                                          struct aviutl2_fft_cache_key const *key,
+                                          float *left,
+                                          float *right) {
+  struct aviutl2_audio_info info = {0};
+  if (!c->cache->get_audio_file_info(file, &info, (int)sizeof(info)) || info.rate <= 0) {
+    return false;
+  }
+  int const n = c->fft.size;
+  int64_t const center = (int64_t)key->frame * key->scale * info.rate / key->rate;
+  int64_t const start = center - n / 2;
+  int const skip = start < 0 ? (int)(start < -n ? n : -start) : 0;
+  memset(left, 0, (size_t)n * sizeof(float));
+  memset(right, 0, (size_t)n * sizeof(float));
+  if (skip < n) {
+    c->cache->get_audio_file_data(file, key->track, start + skip, n - skip, left + skip, right + skip);
+  }
+  for (int i = 0; i < n; ++i) {
+    left[i] = 0.5f * (left[i] + right[i]);
+  }
+  return true;
+}
+
+/**
+ * Get the amplitude spectrum of a media file at a frame
+ * The analysis window is centered on the first sample of the frame. Thread-safe; concurrent misses for the same key
+ * may both compute the spectrum, and the first result stored wins.
+ * @param c Spectrum cache
+ * @param file Path to media file
+ * @param track Audio track number
+ * @param frame Frame number
+ * @param rate Frame rate numerator
+ * @param scale Frame rate denominator
+ * @param magnitude Destination (c->fft.bin_num floats)
+ * @return true on success
+ */
+static inline bool aviutl2_fft_cache_get(struct aviutl2_fft_cache *c,
+                                         wchar_t const *file,
+                                         int track,
+                                         int frame,
+                                         int rate,
+                                         int scale,
+                                         float *magnitude) {
+  if (!c || !c->entries || !file || !magnitude || rate <= 0 || scale <= 0 || frame < 0) {
+    return false;
+  }
+  struct aviutl2_fft_cache_key const key = {
+      .file_hash = aviutl2_hash_wstr(AVIUTL2_HASH_INIT, file),
+      .track = track,
+      .frame = frame,
+      .rate = rate,
+      .scale = scale,
+  };
+  size_t const bytes = (size_t)c->fft.bin_num * sizeof(float);
+  AcquireSRWLockExclusive(&c->lock);
+  struct aviutl2_fft_cache_entry *e = aviutl2_fft_cache_find(c, &key);
+  if (e) {
+    e->last_used = ++c->tick;
+    memcpy(magnitude, e->magnitude, bytes);
+    ReleaseSRWLockExclusive(&c->lock);
+    return true;
+  }
+  ReleaseSRWLockExclusive(&c->lock);
+
+  size_t const n = (size_t)c->fft.size;
+  float *const buf = (float *)malloc((n * 2 + (size_t)c->fft.bin_num * 2) * sizeof(float));
+  if (!buf) {
+    return false;
+  }
+  if (!aviutl2_fft_cache_read(c, file, &key, buf, buf + n)) {
+    free(buf);
+    return false;
+  }
+  aviutl2_fft_magnitude(&c->fft, buf, buf + n * 2, magnitude);
+  free(buf);
+
+  AcquireSRWLockExclusive(&c->lock);
+  if (!aviutl2_fft_cache_find(c, &key)) {
+    struct aviutl2_fft_cache_entry *set = aviutl2_fft_cache_set(c, &key);
+    e = set;
+    for (int i = 1; i < aviutl2_fft_cache_ways && e->used; ++i) {
+      if (!set[i].used || set[i].last_used < e->last_used) {
+        e = set + i;
+      }
+    }
+    e->key = key;
+    e->used = true;
+    e->last_used = ++c->tick;
+    memcpy(e->magnitude, magnitude, bytes);
+  }
+  ReleaseSRWLockExclusive(&c->lock);
+  return true;
+}
+
+/**
+ * Discard all cached spectra
+ * Call when media files may have changed on disk
+ * @param c Spectrum cache
+ */
+static inline void aviutl2_fft_cache_clear(struct aviutl2_fft_cache *c) {
+  if (!c || !c->entries) {
+    return;
+  }
+  AcquireSRWLockExclusive(&c->lock);
+  for (size_t i = 0; i < c->set_num * aviutl2_fft_cache_ways; ++i) {
+    c->entries[i].used = false;
+  }
+  ReleaseSRWLockExclusive(&c->lock);
+}
+
+//--------------------------------
+
+#if WCHAR_MAX == 0xffff
+
+/**
+ * Get the spectrum cache used by the script module
+ * @return Spectrum cache of this translation unit
+ */
+static inline struct aviutl2_fft_cache *aviutl2_fft_module_cache(void) {
+  static struct aviutl2_fft_cache cache;
+  return &cache;
+}
+
+/**
+ * Initialize the script module
+ * @param cache Cache handle passed to InitializeCache()
+ * @param size FFT size (see aviutl2_fft_init())
+ * @param window Analysis window
+ * @param capacity Number of spectra kept in memory
+ * @return true on success
+ */
+static inline bool aviutl2_fft_module_init(struct aviutl2_cache_handle *cache,
+                                           int size,
+                                           enum aviutl2_fft_window window,
+                                           size_t capacity) {
+  return aviutl2_fft_cache_init(aviutl2_fft_module_cache(), cache, size, window, capacity);
+}
+
+/**
+ * Release the script module state
+ */
+static inline void aviutl2_fft_module_exit(void) { aviutl2_fft_cache_exit(aviutl2_fft_module_cache()); }
+
+static inline void aviutl2_fft_module_push_(struct aviutl2_script_module_param *param,
+                                            float const *magnitude,
+                                            int bin_num,
+                                            int band_num) {
+  int const n = band_num > 0 ? band_num : bin_num;
+  double *const out = (double *)malloc((size_t)n * (sizeof(double) + sizeof(float)));
+  if (!out) {
+    param->set_error("out of memory");
+    return;
+  }
+  float const *src = magnitude;
+  if (band_num > 0) {
+    float *const bands = (float *)(void *)(out + n);
+    aviutl2_fft_bands(magnitude, bin_num, bands, band_num);
+    src = bands;
+  }
+  for (int i = 0; i < n; ++i) {
+    out[i] = (double)src[i];
+  }
+  param->push_result_array_double(out, n);
+  free(out);
+}
+
+/**
+ * fft.spectrum(file, frame, rate, scale[, band_num[, track]])
+ * Returns the amplitude spectrum, or band_num logarithmic bands when band_num is greater than zero
+ */
+static inline void aviutl2_fft_func_spectrum(struct aviutl2_script_module_param *param) {
+  struct aviutl2_fft_cache *const c = aviutl2_fft_module_cache();
+  if (!c->entries) {
+    param->set_error("fft module is not initialized");
+    return;
+  }
+  int const num = param->get_param_num();
+  int const band_num = num > 4 ? param->get_param_int(4) : 0;
+  int const track = num > 5 ? param->get_param_int(5) : 0;
+  if (band_num < 0 || band_num > c->fft.bin_num) {
+    param->set_error("band_num is out of range");
+    return;
+  }
+  struct aviutl2_wstr file = {0};
+  float *const magnitude = (float *)malloc((size_t)c->fft.bin_num * sizeof(float));
+  if (!magnitude || !aviutl2_wstr_from_utf8(&file, param->get_param_string(0), SIZE_MAX)) {
+    param->set_error("out of memory");
+  } else if (aviutl2_fft_cache_get(c,
+                                   file.ptr,
+                                   track,
+                                   param->get_param_int(1),
+                                   param->get_param_int(2),
+                                   param->get_param_int(3),
+                                   magnitude)) {
+    aviutl2_fft_module_push_(param, magnitude, c->fft.bin_num, band_num);
+  } else {
+    param->set_error("failed to read audio");
+  }
+  aviutl2_wstr_free(&file);
+  free(magnitude);
+}
+
+/**
+ * fft.analyze(samples[, band_num])
+ * Returns the amplitude spectrum of an array of samples; missing samples are zero
+ */
+static inline void aviutl2_fft_func_analyze(struct aviutl2_script_module_param *param) {
+  struct aviutl2_fft_cache *const c = aviutl2_fft_module_cache();
+  if (!c->entries) {
+    param->set_error("fft module is not initialized");
+    return;
+  }
+  int const band_num = param->get_param_num() > 1 ? param->get_param_int(1) : 0;
+  if (band_num < 0 || band_num > c->fft.bin_num) {
+    param->set_error("band_num is out of range");
+    return;
+  }
+  int const n = c->fft.size;
+  int const bin_num = c->fft.bin_num;
+  float *const buf = (float *)malloc(((size_t)n + (size_t)bin_num * 3) * sizeof(float));
+  if (!buf) {
+    param->set_error("out of memory");
+    return;
+  }
+  int len = param->get_param_array_num(0);
+  if (len > n) {
+    len = n;
+  }
+  for (int i = 0; i < len; ++i) {
+    buf[i] = (float)param->get_param_array_double(0, i);
+  }
+  memset(buf + len, 0, (size_t)(n - len) * sizeof(float));
+  float *const magnitude = buf + n + bin_num * 2;
+  aviutl2_fft_magnitude(&c->fft, buf, buf + n, magnitude);
+  aviutl2_fft_module_push_(param, magnitude, bin_num, band_num);
+  free(buf);
+}
+
+/**
+ * fft.size()
+ * Returns the FFT size and the number of bins
+ */
+static inline void aviutl2_fft_func_size(struct aviutl2_script_module_param *param) {
+  struct aviutl2_fft_cache const *const c = aviutl2_fft_module_cache();
+  param->push_result_int(c->fft.size);
+  param->push_result_int(c->fft.bin_num);
+}
+
+/**
+ * Get the script module table exposing the spectrum cache
+ * @return Script module table
+ */
+static inline struct aviutl2_script_module_table *aviutl2_fft_module_table(void) {
+  static struct aviutl2_script_module_function functions[] = {
+      {L"spectrum", aviutl2_fft_func_spectrum},
+      {L"analyze", aviutl2_fft_func_analyze},
+      {L"size", aviutl2_fft_func_size},
+      {NULL, NULL},
+  };
+  static struct aviutl2_script_module_table table = {
+      L"fft",
+      functions,
+  };
+  return &table;
+}
+
+#endif
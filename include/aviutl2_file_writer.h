@@ -0,0 +1,333 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Asynchronous large-block file writer for output plugins
+//
+// Output plugins usually write many small pieces from func_output and wait for the disk on each one. This writer
+// copies the pieces into one of two page-aligned blocks of 4 to 16 MB and hands each full block to a background
+// thread, so func_output only waits when the disk falls more than one block behind:
+//   struct aviutl2_file_writer *w = aviutl2_file_writer_create(oip->savefile, 0, estimated_size, 0);
+//   aviutl2_file_writer_write(w, header, sizeof(header));
+//   ... aviutl2_file_writer_write(w, packet, packet_size); ...
+//   aviutl2_file_writer_patch(w, 0, &final_header, sizeof(final_header));
+//   bool ok = aviutl2_file_writer_close(w);
+//
+// With aviutl2_file_writer_flag_unbuffered the file is opened with FILE_FLAG_NO_BUFFERING, which bypasses the system
+// cache so that long exports do not evict everything else from memory. Block sizes are multiples of the page size,
+// and the final partial block is padded and then cut back to the real size. When the expected size is known the
+// file is extended once at creation, which lets the file system allocate it in few extents.
+// Headers that are only known at the end (RIFF sizes and similar) are written with aviutl2_file_writer_patch(); the
+// patches are applied through a normal handle after the data has been written.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+enum {
+  aviutl2_file_writer_alignment = 4096,
+  aviutl2_file_writer_min_block_size = 4 * 1024 * 1024,
+  aviutl2_file_writer_default_block_size = 8 * 1024 * 1024,
+  aviutl2_file_writer_max_block_size = 16 * 1024 * 1024,
+};
+
+/**
+ * File writer flags
+ */
+enum aviutl2_file_writer_flag {
+  aviutl2_file_writer_flag_unbuffered = 1,    /**< Bypass the system file cache (FILE_FLAG_NO_BUFFERING) */
+  aviutl2_file_writer_flag_write_through = 2, /**< Return from each block write only when it is on the disk */
+};
+
+struct aviutl2_file_writer_patch {
+  uint64_t offset;
+  size_t size;
+  struct aviutl2_file_writer_patch *next;
+};
+
+/**
+ * Asynchronous file writer
+ * All functions must be called from one thread
+ */
+struct aviutl2_file_writer {
+  HANDLE file;
+  HANDLE thread;
+  HANDLE submitted;       /**< Signaled when a block is handed to the I/O thread */
+  HANDLE completed;       /**< Signaled when the I/O thread has finished a block */
+  uint8_t *blocks;        /**< Two blocks of block_size bytes */
+  size_t block_size;      /**< Bytes per block */
+  int flags;              /**< aviutl2_file_writer_flag values */
+  int current;            /**< Block being filled */
+  size_t used;            /**< Bytes in the block being filled */
+  bool in_flight;         /**< The I/O thread owns the other block */
+  uint8_t const *io_data; /**< Block handed to the I/O thread */
+  size_t io_size;         /**< Bytes to write from io_data */
+  LONG failed;            /**< Set by the I/O thread when a write fails */
+  LONG quit;
+  uint64_t position; /**< Bytes accepted so far (the final file size) */
+  struct aviutl2_file_writer_patch *patches;
+  wchar_t path[1];
+};
+
+static inline DWORD WINAPI aviutl2_file_writer_proc(void *param) {
+  struct aviutl2_file_writer *w = (struct aviutl2_file_writer *)param;
+  for (;;) {
+    WaitForSingleObject(w->submitted, INFINITE);
+    if (w->quit) {
+      break;
+    }
+    uint8_t const *p = w->io_data;
+    size_t rest = w->io_size;
+    while (rest > 0 && !w->failed) {
+      DWORD written = 0;
+      if (!WriteFile(w->file, p, (DWORD)rest, &written, NULL) || written == 0) {
+        InterlockedExchange(&w->failed, 1);
+        break;
+      }
+      p += written;
+      rest -= written;
+    }
+    SetEvent(w->completed);
+  }
+  return 0;
+}
+
+static inline void aviutl2_file_writer_wait_(struct aviutl2_file_writer *w) {
+  if (w->in_flight) {
+    WaitForSingleObject(w->completed, INFINITE);
+    w->in_flight = false;
+  }
+}
+
+static inline bool aviutl2_file_writer_submit_(struct aviutl2_file_writer *w, size_t size) {
+  aviutl2_file_writer_wait_(w);
+  if (w->failed) {
+    return false;
+  }
+  w->io_data = w->blocks + (size_t)w->current * w->block_size;
+  w->io_size = size;
+  w->in_flight = true;
+  SetEvent(w->submitted);
+  w->current ^= 1;
+  w->used = 0;
+  return true;
+}
+
+static inline void aviutl2_file_writer_free_(struct aviutl2_file_writer *w) {
+  if (w->thread) {
+    InterlockedExchange(&w->quit, 1);
+    SetEvent(w->submitted);
+    WaitForSingleObject(w->thread, INFINITE);
+    CloseHandle(w->thread);
+  }
+  if (w->submitted) {
+    CloseHandle(w->submitted);
+  }
+  if (w->completed) {
+    CloseHandle(w->completed);
+  }
+  if (w->file != INVALID_HANDLE_VALUE) {
+    CloseHandle(w->file);
+  }
+  if (w->blocks) {
+    VirtualFree(w->blocks, 0, MEM_RELEASE);
+  }
+  while (w->patches) {
+    struct aviutl2_file_writer_patch *const next = w->patches->next;
+    free(w->patches);
+    w->patches = next;
+  }
+  free(w);
+}
+
+static inline bool aviutl2_file_writer_set_size_(HANDLE file, uint64_t size) {
+  // SetFilePointerEx() + SetEndOfFile() would need a sector-aligned position on an unbuffered handle
+  FILE_END_OF_FILE_INFO info;
+  info.EndOfFile.QuadPart = (LONGLONG)size;
+  return SetFileInformationByHandle(file, FileEndOfFileInfo, &info, sizeof(info));
+}
+
+/**
+ * Create a file and start its writer
+ * @param path Path to the file (an existing file is replaced)
+ * @param block_size Block size in bytes, rounded to the page size and clamped to 4 to 16 MB (0 for 8 MB)
+ * @param expected_size Expected final size used to preallocate the file (0 if unknown)
+ * @param flags aviutl2_file_writer_flag values
+ * @return Writer, or NULL on failure
+ */
+static inline struct aviutl2_file_writer *
+aviutl2_file_writer_create(wchar_t const *path, size_t block_size, uint64_t expected_size, int flags) {
+  if (!path || !path[0]) {
+    return NULL;
+  }
+  if (block_size == 0) {
+    block_size = aviutl2_file_writer_default_block_size;
+  }
+  block_size = (block_size + aviutl2_file_writer_alignment - 1) & ~(size_t)(aviutl2_file_writer_alignment - 1);
+  if (block_size < aviutl2_file_writer_min_block_size) {
+    block_size = aviutl2_file_writer_min_block_size;
+  }
+  if (block_size > aviutl2_file_writer_max_block_size) {
+    block_size = aviutl2_file_writer_max_block_size;
+  }
+  size_t const len = wcslen(path);
+  struct aviutl2_file_writer *w = (struct aviutl2_file_writer *)calloc(1, sizeof(*w) + len * sizeof(wchar_t));
+  if (!w) {
+    return NULL;
+  }
+  memcpy(w->path, path, (len + 1) * sizeof(wchar_t));
+  w->block_size = block_size;
+  w->flags = flags;
+  DWORD attributes = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+  if (flags & aviutl2_file_writer_flag_unbuffered) {
+    attributes |= FILE_FLAG_NO_BUFFERING;
+  }
+  if (flags & aviutl2_file_writer_flag_write_through) {
+    attributes |= FILE_FLAG_WRITE_THROUGH;
+  }
+  w->file = CreateFileW(path, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, attributes, NULL);
+  if (w->file == INVALID_HANDLE_VALUE) {
+    aviutl2_file_writer_free_(w);
+    return NULL;
+  }
+  if (expected_size > 0) {
+    // Failure only loses the preallocation, so the result is not checked
+    aviutl2_file_writer_set_size_(w->file, expected_size);
+  }
+  w->blocks = (uint8_t *)VirtualAlloc(NULL, block_size * 2, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+  w->submitted = CreateEventW(NULL, FALSE, FALSE, NULL);
+  w->completed = CreateEventW(NULL, FALSE, FALSE, NULL);
+  if (!w->blocks || !w->submitted || !w->completed) {
+    aviutl2_file_writer_free_(w);
+    return NULL;
+  }
+  w->thread = CreateThread(NULL, 0, aviutl2_file_writer_proc, w, 0, NULL);
+  if (!w->thread) {
+    aviutl2_file_writer_free_(w);
+    return NULL;
+  }
+  return w;
+}
+
+/**
+ * Append data
+ * Returns after copying the data; waits for the disk only when both blocks are full.
+ * @param w Writer
+ * @param data Data
+ * @param size Size in bytes
+ * @return false if a write has failed (the error is sticky)
+ */
+static inline bool aviutl2_file_writer_write(struct aviutl2_file_writer *w, void const *data, size_t size) {
+  uint8_t const *src = (uint8_t const *)data;
+  while (size > 0) {
+    if (w->failed) {
+      return false;
+    }
+    size_t n = w->block_size - w->used;
+    if (n > size) {
+      n = size;
+    }
+    memcpy(w->blocks + (size_t)w->current * w->block_size + w->used, src, n);
+    w->used += n;
+    w->position += n;
+    src += n;
+    size -= n;
+    if (w->used == w->block_size && !aviutl2_file_writer_submit_(w, w->block_size)) {
+      return false;
+    }
+  }
+  return !w->failed;
+}
+
+/**
+ * Get the number of bytes appended so far
+ * @param w Writer
+ * @return Current end of the file
+ */
+static inline uint64_t aviutl2_file_writer_tell(struct aviutl2_file_writer const *w) { return w->position; }
+
+/**
+ * Overwrite already appended bytes when the writer is closed
+ * Patches are applied in the order they were added.
+ * @param w Writer
+ * @param offset Position in the file (offset + size must not exceed the final size)
+ * @param data Data
+ * @param size Size in bytes
+ * @return false if memory ran out
+ */
+static inline bool
+aviutl2_file_writer_patch(struct aviutl2_file_writer *w, uint64_t offset, void const *data, size_t size) {
+  struct aviutl2_file_writer_patch *const patch =
+      (struct aviutl2_file_writer_patch *)malloc(sizeof(struct aviutl2_file_writer_patch) + size);
+  if (!patch) {
+    return false;
+  }
+  patch->offset = offset;
+  patch->size = size;
+  patch->next = NULL;
+  memcpy(patch + 1, data, size);
+  struct aviutl2_file_writer_patch **tail = &w->patches;
+  while (*tail) {
+    tail = &(*tail)->next;
+  }
+  *tail = patch;
+  return true;
+}
+
+static inline bool aviutl2_file_writer_apply_patches_(struct aviutl2_file_writer const *w) {
+  HANDLE h = CreateFileW(w->path, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (h == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  bool ok = true;
+  for (struct aviutl2_file_writer_patch const *p = w->patches; p && ok; p = p->next) {
+    LARGE_INTEGER pos;
+    pos.QuadPart = (LONGLONG)p->offset;
+    DWORD written = 0;
+    ok = p->offset + p->size <= w->position && SetFilePointerEx(h, pos, NULL, FILE_BEGIN) &&
+         WriteFile(h, p + 1, (DWORD)p->size, &written, NULL) && written == (DWORD)p->size;
+  }
+  CloseHandle(h);
+  return ok;
+}
+
+/**
+ * Flush the remaining data, apply patches and close the file
+ * The writer is destroyed even when this fails; the file is left as far as it was written.
+ * @param w Writer (may be NULL)
+ * @return true if every byte was written
+ */
+static inline bool aviutl2_file_writer_close(struct aviutl2_file_writer *w) {
+  if (!w) {
+    return false;
+  }
+  size_t size = w->used;
+  if (size > 0 && (w->flags & aviutl2_file_writer_flag_unbuffered)) {
+    // Unbuffered writes must cover whole sectors; the padding is cut off below
+    size_t const padded = (size + aviutl2_file_writer_alignment - 1) & ~(size_t)(aviutl2_file_writer_alignment - 1);
+    memset(w->blocks + (size_t)w->current * w->block_size + size, 0, padded - size);
+    size = padded;
+  }
+  bool ok = size == 0 || aviutl2_file_writer_submit_(w, size);
+  aviutl2_file_writer_wait_(w);
+  ok = ok && !w->failed;
+  if (ok) {
+    // Removes the padding and whatever part of the preallocation was not used
+    ok = aviutl2_file_writer_set_size_(w->file, w->position);
+  }
+  CloseHandle(w->file);
+  w->file = INVALID_HANDLE_VALUE;
+  if (ok && w->patches) {
+    ok = aviutl2_file_writer_apply_patches_(w);
+  }
+  aviutl2_file_writer_free_(w);
+  return ok;
+}
@@ -0,0 +1,84 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Declarative filter item definitions
+//
+// Describe the items once as an X-macro list and AVIUTL2_FILTER_ITEMS_DEFINE() generates:
+//   - enum <prefix>_item_index with one constant per item and <prefix>_item_count
+//   - a static structure <prefix>_items holding each item as a typed member
+//   - the null-terminated array <prefix>_item_list for aviutl2_filter_plugin_table.items
+// Item values are then read by direct member access without looking up names or comparing type strings.
+//
+// Every list entry has the form X(P, kind, member, initializer...), where kind is one of the suffixes of the
+// AVIUTL2_FILTER_ITEM_TYPE_* macros below and the initializer lists the members that follow the type string
+// (line continuations omitted):
+//   #define BLUR_ITEMS(X, P)
+//     X(P, track, size, L"Size", 10.0, 0.0, 500.0, 1.0)
+//     X(P, check, keep_size, L"Keep size", false)
+//     X(P, color, tint, L"Tint", 0xffffff)
+//     X(P, select, mode, L"Mode", 0, blur_modes)
+//   AVIUTL2_FILTER_ITEMS_DEFINE(blur, BLUR_ITEMS);
+//
+//   static struct aviutl2_filter_plugin_table table = {
+//       .items = blur_item_list,
+//       ...
+//   };
+//   static bool func_proc_video(struct aviutl2_filter_proc_video *video) {
+//     double const size = blur_items.size.value;
+//     ...
+//   }
+//
+// Enum constants match the positions in the items array, so they can be combined with AVIUTL2_ITEM_BIT() from
+// aviutl2_item_change.h.
+
+#include <stddef.h>
+
+#include "aviutl2_filter2.h"
+
+#define AVIUTL2_FILTER_ITEM_TYPE_track struct aviutl2_filter_item_track
+#define AVIUTL2_FILTER_ITEM_TYPE_trackgroup struct aviutl2_filter_item_track_group
+#define AVIUTL2_FILTER_ITEM_TYPE_check struct aviutl2_filter_item_check
+#define AVIUTL2_FILTER_ITEM_TYPE_checksection struct aviutl2_filter_item_check_section
+#define AVIUTL2_FILTER_ITEM_TYPE_color struct aviutl2_filter_item_color
+#define AVIUTL2_FILTER_ITEM_TYPE_select struct aviutl2_filter_item_select
+#define AVIUTL2_FILTER_ITEM_TYPE_file struct aviutl2_filter_item_file
+#define AVIUTL2_FILTER_ITEM_TYPE_data struct aviutl2_filter_item_data
+#define AVIUTL2_FILTER_ITEM_TYPE_group struct aviutl2_filter_item_group
+#define AVIUTL2_FILTER_ITEM_TYPE_button struct aviutl2_filter_item_button
+#define AVIUTL2_FILTER_ITEM_TYPE_string struct aviutl2_filter_item_string
+#define AVIUTL2_FILTER_ITEM_TYPE_text struct aviutl2_filter_item_text
+#define AVIUTL2_FILTER_ITEM_TYPE_folder struct aviutl2_filter_item_folder
+#define AVIUTL2_FILTER_ITEM_TYPE_separator struct aviutl2_filter_item_separator
+
+#define AVIUTL2_FILTER_ITEM_INIT_track(...) {L"track2", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_trackgroup(...) {L"trackgroup", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_check(...) {L"check", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_checksection(...) {L"checksection2", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_color(name, value) {L"color", name, {.code = (value)}}
+#define AVIUTL2_FILTER_ITEM_INIT_select(...) {L"select", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_file(...) {L"file", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_data(...) {L"data", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_group(...) {L"group", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_button(...) {L"button", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_string(...) {L"string", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_text(...) {L"text", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_folder(...) {L"folder", __VA_ARGS__}
+#define AVIUTL2_FILTER_ITEM_INIT_separator(...) {L"separator", __VA_ARGS__}
+
+#define AVIUTL2_FILTER_ITEMS_ENUM_(P, kind, member, ...) P##_item_##member,
+#define AVIUTL2_FILTER_ITEMS_MEMBER_(P, kind, member, ...) AVIUTL2_FILTER_ITEM_TYPE_##kind member;
+#define AVIUTL2_FILTER_ITEMS_INIT_(P, kind, member, ...) .member = AVIUTL2_FILTER_ITEM_INIT_##kind(__VA_ARGS__),
+#define AVIUTL2_FILTER_ITEMS_PTR_(P, kind, member, ...) &P##_items.member,
+
+/**
+ * Define the item index enum, the typed item structure and the items array
+ * @param prefix Prefix of the generated identifiers
+ * @param LIST X-macro list taking (X, P)
+ */
+#define AVIUTL2_FILTER_ITEMS_DEFINE(prefix, LIST)                                                                      \
+  enum prefix##_item_index { LIST(AVIUTL2_FILTER_ITEMS_ENUM_, prefix) prefix##_item_count };                         \
+  static struct prefix##_items {                                                                                       \
+    LIST(AVIUTL2_FILTER_ITEMS_MEMBER_, prefix)                                                                         \
+  } prefix##_items = {LIST(AVIUTL2_FILTER_ITEMS_INIT_, prefix)};                                                       \
+  static void *prefix##_item_list[] = {LIST(AVIUTL2_FILTER_ITEMS_PTR_, prefix) NULL}
@@ -0,0 +1,319 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Duplicate frame elimination for output plugins
+//
+// Screen recordings and slides contain long runs of identical frames. aviutl2_frame_dedup_get_video() wraps
+// aviutl2_output_info::func_get_video() and reports frames that are byte-identical to the last frame handed to the
+// encoder, so that they can be skipped; the kept frames are written as a timecode v2 file that muxers use to restore
+// the original timing (variable frame rate):
+//   struct aviutl2_frame_dedup dedup;
+//   aviutl2_frame_dedup_init(&dedup, oip, format, 300);
+//   for (int frame = 0; frame < oip->n; ++frame) {
+//     bool duplicate;
+//     void *data = aviutl2_frame_dedup_get_video(&dedup, oip, frame, &duplicate);
+//     if (data && !duplicate) encode(data);
+//   }
+//   aviutl2_frame_dedup_write_timecodes(&dedup, timecode_path);
+//   aviutl2_frame_dedup_exit(&dedup);
+//
+// The comparison first probes 64 blocks spread over the frame, which rejects frames that change broadly (a new slide,
+// a scrolled page) after 4 KB, and then compares the whole frame with SSE2, stopping at the first difference.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_output2.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+/**
+ * Image formats accepted by aviutl2_output_info::func_get_video()
+ */
+enum aviutl2_frame_dedup_format {
+  aviutl2_frame_dedup_format_rgb = 0,           /**< BI_RGB (24-bit DIB, rows padded to 4 bytes) */
+  aviutl2_frame_dedup_format_pa64 = 0x50413634, /**< 'P''A''6''4' */
+  aviutl2_frame_dedup_format_hf64 = 0x48463634, /**< 'H''F''6''4' */
+  aviutl2_frame_dedup_format_yuy2 = 0x59555932, /**< 'Y''U''Y''2' */
+  aviutl2_frame_dedup_format_yc48 = 0x59433438, /**< 'Y''C''4''8' */
+};
+
+enum {
+  aviutl2_frame_dedup_probe_blocks = 64,
+  aviutl2_frame_dedup_block_size = 64,
+  aviutl2_frame_dedup_write_chunk = 65536,
+};
+
+/**
+ * Duplicate frame eliminator
+ */
+struct aviutl2_frame_dedup {
+  uint32_t format;   /**< Image format requested from func_get_video() */
+  size_t frame_size; /**< Bytes per frame */
+  int rate, scale;   /**< Frame rate of the output */
+  int frame_total;   /**< Number of frames of the output */
+  int max_run;       /**< Duplicates after which a frame is kept anyway (0 for no limit) */
+  int run;           /**< Duplicates since the last kept frame */
+  int processed_num; /**< Frames passed through aviutl2_frame_dedup_get_video() */
+  uint8_t *last;     /**< Copy of the last kept frame (16-byte aligned) */
+  void *last_block;
+  int *kept; /**< Frame numbers of the kept frames */
+  size_t kept_num;
+  size_t kept_cap;
+};
+
+/**
+ * Number of bytes in one frame returned by func_get_video()
+ * @param width Image width
+ * @param height Image height
+ * @param format Image format
+ * @return Frame size in bytes, or 0 for an unknown format
+ */
+static inline size_t aviutl2_frame_dedup_frame_size(int width, int height, uint32_t format) {
+  size_t const w = (size_t)width, h = (size_t)height;
+  switch (format) {
+  case aviutl2_frame_dedup_format_rgb:
+    return ((w * 3 + 3) & ~(size_t)3) * h;
+  case aviutl2_frame_dedup_format_pa64:
+  case aviutl2_frame_dedup_format_hf64:
+    return w * h * 8;
+  case aviutl2_frame_dedup_format_yuy2:
+    return ((w + 1) & ~(size_t)1) * 2 * h;
+  case aviutl2_frame_dedup_format_yc48:
+    return w * h * 6;
+  }
+  return 0;
+}
+
+/**
+ * Release a duplicate frame eliminator
+ * @param d Eliminator
+ */
+static inline void aviutl2_frame_dedup_exit(struct aviutl2_frame_dedup *d) {
+  if (!d) {
+    return;
+  }
+  free(d->last_block);
+  free(d->kept);
+  memset(d, 0, sizeof(*d));
+}
+
+/**
+ * Initialize a duplicate frame eliminator
+ * @param d Eliminator
+ * @param oip Output information
+ * @param format Image format to request from func_get_video()
+ * @param max_run Keep a frame after this many consecutive duplicates even if it is identical, which bounds the
+ *                distance between frames for players and seeking (0 for no limit)
+ * @return true on success
+ */
+static inline bool aviutl2_frame_dedup_init(struct aviutl2_frame_dedup *d,
+                                            struct aviutl2_output_info const *oip,
+                                            uint32_t format,
+                                            int max_run) {
+  if (!d) {
+    return false;
+  }
+  memset(d, 0, sizeof(*d));
+  size_t const size = aviutl2_frame_dedup_frame_size(oip->w, oip->h, format);
+  if (size == 0 || oip->rate <= 0 || oip->scale <= 0) {
+    return false;
+  }
+  d->last_block = malloc(size + 15);
+  if (!d->last_block) {
+    return false;
+  }
+  d->last = (uint8_t *)(((uintptr_t)d->last_block + 15) & ~(uintptr_t)15);
+  d->format = format;
+  d->frame_size = size;
+  d->rate = oip->rate;
+  d->scale = oip->scale;
+  d->frame_total = oip->n;
+  d->max_run = max_run > 0 ? max_run : 0;
+  return true;
+}
+
+static inline bool aviutl2_frame_dedup_block_equal_(uint8_t const *a, uint8_t const *b) {
+#if AVIUTL2_HAS_SSE2
+  __m128i const e0 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)(void const *)a),
+                                    _mm_loadu_si128((__m128i const *)(void const *)b));
+  __m128i const e1 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)(void const *)(a + 16)),
+                                    _mm_loadu_si128((__m128i const *)(void const *)(b + 16)));
+  __m128i const e2 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)(void const *)(a + 32)),
+                                    _mm_loadu_si128((__m128i const *)(void const *)(b + 32)));
+  __m128i const e3 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)(void const *)(a + 48)),
+                                    _mm_loadu_si128((__m128i const *)(void const *)(b + 48)));
+  return _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3))) == 0xffff;
+#else
+  return memcmp(a, b, aviutl2_frame_dedup_block_size) == 0;
+#endif
+}
+
+/**
+ * Compare two frames
+ * @param a Frame
+ * @param b Frame
+ * @param size Frame size in bytes
+ * @return true if the frames are byte-identical
+ */
+static inline bool aviutl2_frame_dedup_equal(void const *a, void const *b, size_t size) {
+  uint8_t const *const pa = (uint8_t const *)a;
+  uint8_t const *const pb = (uint8_t const *)b;
+  size_t const block = aviutl2_frame_dedup_block_size;
+  size_t const block_num = size / block;
+  // Broad changes are found by the probes long before a sequential scan would reach them; local changes such as a
+  // moving cursor are left to the full comparison
+  if (block_num >= aviutl2_frame_dedup_probe_blocks) {
+    size_t const step = block_num / aviutl2_frame_dedup_probe_blocks;
+    for (size_t i = 0; i < aviutl2_frame_dedup_probe_blocks; ++i) {
+      size_t const offset = (i * step + step / 2) * block;
+      if (!aviutl2_frame_dedup_block_equal_(pa + offset, pb + offset)) {
+        return false;
+      }
+    }
+  }
+  for (size_t i = 0; i < block_num; ++i) {
+    if (!aviutl2_frame_dedup_block_equal_(pa + i * block, pb + i * block)) {
+      return false;
+    }
+  }
+  size_t const tail = block_num * block;
+  return memcmp(pa + tail, pb + tail, size - tail) == 0;
+}
+
+/**
+ * Get a frame and check whether it duplicates the last kept frame
+ * Frames must be requested in increasing order. The first frame and the last two frames of the output are always
+ * kept: a timecode v2 file has no duration for its last frame, and muxers derive it from the previous interval, so
+ * that interval has to be exactly one frame for the output to end where the audio does.
+ * @param d Eliminator
+ * @param oip Output information
+ * @param frame Frame number
+ * @param duplicate Set to true if the frame should be skipped
+ * @return Pointer to the frame data as returned by func_get_video(), or NULL on failure
+ */
+static inline void *aviutl2_frame_dedup_get_video(struct aviutl2_frame_dedup *d,
+                                                  struct aviutl2_output_info *oip,
+                                                  int frame,
+                                                  bool *duplicate) {
+  *duplicate = false;
+  void *const data = oip->func_get_video(frame, d->format);
+  if (!data) {
+    return NULL;
+  }
+  ++d->processed_num;
+  bool const forced = d->kept_num == 0 || frame >= d->frame_total - 2 || (d->max_run && d->run >= d->max_run);
+  if (!forced && aviutl2_frame_dedup_equal(data, d->last, d->frame_size)) {
+    ++d->run;
+    *duplicate = true;
+    return data;
+  }
+  if (d->kept_num == d->kept_cap) {
+    size_t const cap = d->kept_cap ? d->kept_cap * 2 : 1024;
+    int *const kept = (int *)realloc(d->kept, cap * sizeof(int));
+    if (!kept) {
+      return NULL;
+    }
+    d->kept = kept;
+    d->kept_cap = cap;
+  }
+  d->kept[d->kept_num++] = frame;
+  d->run = 0;
+  memcpy(d->last, data, d->frame_size);
+  return data;
+}
+
+/**
+ * Presentation time of a frame of the output
+ * @param d Eliminator
+ * @param frame Frame number
+ * @return Time in milliseconds
+ */
+static inline double aviutl2_frame_dedup_timestamp(struct aviutl2_frame_dedup const *d, int frame) {
+  return (double)frame * 1000.0 * (double)d->scale / (double)d->rate;
+}
+
+/**
+ * Format the presentation time of a frame as milliseconds with three decimals and a newline
+ * Uses integer arithmetic only, so the output does not depend on the C locale.
+ * @param d Eliminator
+ * @param frame Frame number
+ * @param buf Buffer of at least 32 bytes
+ * @return Number of bytes written
+ */
+static inline int aviutl2_frame_dedup_format_timestamp_(struct aviutl2_frame_dedup const *d, int frame, char *buf) {
+  // Microseconds rounded to nearest, split so that the intermediate products do not overflow
+  int64_t const t = (int64_t)frame * (int64_t)d->scale;
+  int64_t const rate = (int64_t)d->rate;
+  int64_t const us = t / rate * 1000000 + ((t % rate) * 1000000 + rate / 2) / rate;
+  int const n = snprintf(buf, 32, "%lld.%03d\n", (long long)(us / 1000), (int)(us % 1000));
+  return n > 0 ? n : 0;
+}
+
+/**
+ * Write the timestamps of the kept frames as a timecode v2 file
+ * The file is written to a temporary name first and replaces path only when complete.
+ * @param d Eliminator
+ * @param path Destination path
+ * @return true on success
+ */
+static inline bool aviutl2_frame_dedup_write_timecodes(struct aviutl2_frame_dedup const *d, wchar_t const *path) {
+  size_t const len = wcslen(path);
+  wchar_t *tmp = (wchar_t *)malloc((len + 5) * sizeof(wchar_t));
+  char *buf = (char *)malloc(aviutl2_frame_dedup_write_chunk);
+  if (!tmp || !buf) {
+    free(tmp);
+    free(buf);
+    return false;
+  }
+  memcpy(tmp, path, len * sizeof(wchar_t));
+  memcpy(tmp + len, L".tmp", 5 * sizeof(wchar_t));
+  bool ok = false;
+  HANDLE h = CreateFileW(tmp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (h != INVALID_HANDLE_VALUE) {
+    static char const header[] = "# timecode format v2\n";
+    size_t used = sizeof(header) - 1;
+    memcpy(buf, header, used);
+    ok = true;
+    for (size_t i = 0; ok && i <= d->kept_num; ++i) {
+      // A timestamp line is at most a few dozen bytes, so flush while there is still room for one
+      if (i == d->kept_num || used > aviutl2_frame_dedup_write_chunk - 64) {
+        DWORD written = 0;
+        ok = WriteFile(h, buf, (DWORD)used, &written, NULL) && written == (DWORD)used;
+        used = 0;
+      }
+      if (i < d->kept_num) {
+        used += (size_t)aviutl2_frame_dedup_format_timestamp_(d, d->kept[i], buf + used);
+      }
+    }
+    CloseHandle(h);
+    if (!ok || !MoveFileExW(tmp, path, MOVEFILE_REPLACE_EXISTING)) {
+      DeleteFileW(tmp);
+      ok = false;
+    }
+  }
+  free(buf);
+  free(tmp);
+  return ok;
+}
@@ -0,0 +1,674 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Image processing kernels for PIXEL_RGBA buffers
+//
+// Levels, curves, threshold, blend, convolution and resize operating on 8-bit RGBA images with arbitrary row pitch.
+// The kernels are plain C functions and are also exposed as a script module that works on buffers passed as
+// lightuserdata, such as the pointer returned by obj.getpixeldata():
+//   local data, w, h = obj.getpixeldata("object")
+//   image_ops.levels(data, w, h, 0, 16, 235, 1.0, 0, 255)
+//   obj.putpixeldata("object", data, w, h)
+// Every script function takes the buffer, width, height and pitch (0 means width * 4) first.
+// Return aviutl2_image_ops_module_table() from GetScriptModuleTable() to ship the module as is, or add the
+// aviutl2_image_ops_func_* callbacks to an existing function list.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aviutl2_image_scale.h"
+#include "aviutl2_module2.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+enum {
+  aviutl2_image_ops_max_curve_points = 64,
+  aviutl2_image_ops_max_kernel_size = 31,
+};
+
+/**
+ * Blend mode
+ */
+enum aviutl2_image_blend_mode {
+  aviutl2_image_blend_normal = 0,   /**< Source color */
+  aviutl2_image_blend_add = 1,      /**< min(dst + src, 255) */
+  aviutl2_image_blend_subtract = 2, /**< max(dst - src, 0) */
+  aviutl2_image_blend_multiply = 3, /**< dst * src / 255 */
+  aviutl2_image_blend_screen = 4,   /**< dst + src - dst * src / 255 */
+};
+
+static inline uint32_t aviutl2_image_ops_div255(uint32_t x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+/**
+ * Apply per-channel lookup tables to the color channels (alpha is unchanged)
+ * @param data Image data (PIXEL_RGBA)
+ * @param width Image width
+ * @param height Image height
+ * @param pitch Number of bytes per row
+ * @param lut_r Lookup table for red
+ * @param lut_g Lookup table for green
+ * @param lut_b Lookup table for blue
+ */
+static inline void aviutl2_image_apply_lut(void *data,
+                                           int width,
+                                           int height,
+                                           int pitch,
+                                           uint8_t const lut_r[256],
+                                           uint8_t const lut_g[256],
+                                           uint8_t const lut_b[256]) {
+  // Table lookups beat arithmetic kernels for any per-channel tone curve, so levels and curves only build tables.
+  for (int y = 0; y < height; ++y) {
+    uint8_t *p = (uint8_t *)data + (size_t)y * (size_t)pitch;
+    for (int x = 0; x < width; ++x, p += 4) {
+      p[0] = lut_r[p[0]];
+      p[1] = lut_g[p[1]];
+      p[2] = lut_b[p[2]];
+    }
+  }
+}
+
+/**
+ * Build a levels lookup table
+ * @param lut Destination table
+ * @param in_black Input value mapped to out_black
+ * @param in_white Input value mapped to out_white
+ * @param gamma Gamma applied between black and white (1.0 = linear, larger is brighter)
+ * @param out_black Output black level
+ * @param out_white Output white level
+ */
+static inline void aviutl2_image_lut_levels(
+    uint8_t lut[256], double in_black, double in_white, double gamma, double out_black, double out_white) {
+  double const range = in_white - in_black;
+  double const inv_gamma = gamma > 0.0 ? 1.0 / gamma : 1.0;
+  for (int i = 0; i < 256; ++i) {
+    double v = range != 0.0 ? ((double)i - in_black) / range : (i >= in_black ? 1.0 : 0.0);
+    v = v < 0.0 ? 0.0 : v > 1.0 ? 1.0 : v;
+    v = out_black + pow(v, inv_gamma) * (out_white - out_black);
+    lut[i] = (uint8_t)(v <= 0.0 ? 0 : v >= 255.0 ? 255 : (int)(v + 0.5));
+  }
+}
+
+/**
+ * Build a tone curve lookup table by monotone cubic interpolation of control points
+ * Inputs outside the first and last points take the value of the nearest end point.
+ * @param lut Destination table
+ * @param xs Input values of the control points (ascending, 0 to 255)
+ * @param ys Output values of the control points (0 to 255)
+ * @param n Number of control points (2 to aviutl2_image_ops_max_curve_points)
+ * @return false if the points are invalid
+ */
+static inline bool aviutl2_image_lut_curve(uint8_t lut[256], double const *xs, double const *ys, size_t n) {
+  if (n < 2 || n > aviutl2_image_ops_max_curve_points) {
+    return false;
+  }
+  double d[aviutl2_image_ops_max_curve_points];
+  double m[aviutl2_image_ops_max_curve_points];
+  for (size_t i = 0; i + 1 < n; ++i) {
+    if (!(xs[i + 1] > xs[i])) {
+      return false;
+    }
+    d[i] = (ys[i + 1] - ys[i]) / (xs[i + 1] - xs[i]);
+  }
+  // Fritsch-Carlson tangents keep the curve monotone between monotone points.
+  m[0] = d[0];
+  m[n - 1] = d[n - 2];
+  for (size_t i = 1; i + 1 < n; ++i) {
+    m[i] = d[i - 1] * d[i] <= 0.0 ? 0.0 : (d[i - 1] + d[i]) * 0.5;
+  }
+  for (size_t i = 0; i + 1 < n; ++i) {
+    if (d[i] == 0.0) {
+      m[i] = m[i + 1] = 0.0;
+      continue;
+    }
+    double const a = m[i] / d[i], b = m[i + 1] / d[i];
+    double const s = a * a + b * b;
+    if (s > 9.0) {
+      double const t = 3.0 / sqrt(s);
+      m[i] = t * a * d[i];
+      m[i + 1] = t * b * d[i];
+    }
+  }
+  size_t seg = 0;
+  for (int i = 0; i < 256; ++i) {
+    double const x = (double)i;
+    double v;
+    if (x <= xs[0]) {
+      v = ys[0];
+    } else if (x >= xs[n - 1]) {
+      v = ys[n - 1];
+    } else {
+      while (x > xs[seg + 1]) {
+        ++seg;
+      }
+      double const h = xs[seg + 1] - xs[seg];
+      double const t = (x - xs[seg]) / h, t2 = t * t, t3 = t2 * t;
+      v = (2 * t3 - 3 * t2 + 1) * ys[seg] + (t3 - 2 * t2 + t) * h * m[seg] + (-2 * t3 + 3 * t2) * ys[seg + 1] +
+          (t3 - t2) * h * m[seg + 1];
+    }
+    lut[i] = (uint8_t)(v <= 0.0 ? 0 : v >= 255.0 ? 255 : (int)(v + 0.5));
+  }
+  return true;
+}
+
+/**
+ * Binarize the color channels by luma (alpha is unchanged)
+ * Luma is (77 * r + 150 * g + 29 * b + 128) / 256.
+ * @param data Image data (PIXEL_RGBA)
+ * @param width Image width
+ * @param height Image height
+ * @param pitch Number of bytes per row
+ * @param threshold Pixels with luma greater than or equal to this become white, the others black
+ */
+static inline void aviutl2_image_threshold(void *data, int width, int height, int pitch, int threshold) {
+  for (int y = 0; y < height; ++y) {
+    uint8_t *p = (uint8_t *)data + (size_t)y * (size_t)pitch;
+    int x = 0;
+#if AVIUTL2_HAS_SSE2
+    __m128i const byte = _mm_set1_epi32(0xff);
+    __m128i const wr = _mm_set1_epi32(77), wg = _mm_set1_epi32(150), wb = _mm_set1_epi32(29);
+    __m128i const round = _mm_set1_epi32(128);
+    __m128i const limit = _mm_set1_epi32(threshold - 1);
+    __m128i const alpha = _mm_set1_epi32((int)0xff000000u);
+    __m128i const rgb = _mm_set1_epi32(0x00ffffff);
+    for (; x + 4 <= width; x += 4, p += 16) {
+      __m128i const v = _mm_loadu_si128((__m128i const *)p);
+      // Each 32-bit lane holds one pixel; products and their sum fit in the low 16 bits.
+      __m128i const r = _mm_and_si128(v, byte);
+      __m128i const g = _mm_and_si128(_mm_srli_epi32(v, 8), byte);
+      __m128i const b = _mm_and_si128(_mm_srli_epi32(v, 16), byte);
+      __m128i luma = _mm_add_epi16(_mm_mullo_epi16(r, wr), _mm_mullo_epi16(g, wg));
+      luma = _mm_add_epi16(luma, _mm_add_epi16(_mm_mullo_epi16(b, wb), round));
+      luma = _mm_srli_epi32(_mm_and_si128(luma, _mm_set1_epi32(0xffff)), 8);
+      __m128i const mask = _mm_cmpgt_epi32(luma, limit);
+      _mm_storeu_si128((__m128i *)p, _mm_or_si128(_mm_and_si128(mask, rgb), _mm_and_si128(v, alpha)));
+    }
+#endif
+    for (; x < width; ++x, p += 4) {
+      int const luma = (77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8;
+      uint8_t const c = luma >= threshold ? 255 : 0;
+      p[0] = p[1] = p[2] = c;
+    }
+  }
+}
+
+static inline uint32_t aviutl2_image_blend_channel(uint32_t d, uint32_t s, enum aviutl2_image_blend_mode mode) {
+  switch (mode) {
+  case aviutl2_image_blend_normal:
+    return s;
+  case aviutl2_image_blend_add:
+    return d + s > 255 ? 255 : d + s;
+  case aviutl2_image_blend_subtract:
+    return d > s ? d - s : 0;
+  case aviutl2_image_blend_multiply:
+    return aviutl2_image_ops_div255(d * s);
+  case aviutl2_image_blend_screen:
+    return d + s - aviutl2_image_ops_div255(d * s);
+  }
+  return s;
+}
+
+#if AVIUTL2_HAS_SSE2
+static inline __m128i aviutl2_image_ops_div255_epu16(__m128i x) {
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+static inline __m128i aviutl2_image_blend_epi16(__m128i d, __m128i s, int mode, __m128i opacity) {
+  __m128i const max = _mm_set1_epi16(255);
+  __m128i f;
+  switch (mode) {
+  case aviutl2_image_blend_add:
+    f = _mm_min_epi16(_mm_add_epi16(d, s), max);
+    break;
+  case aviutl2_image_blend_subtract:
+    f = _mm_subs_epu16(d, s);
+    break;
+  case aviutl2_image_blend_multiply:
+    f = aviutl2_image_ops_div255_epu16(_mm_mullo_epi16(d, s));
+    break;
+  case aviutl2_image_blend_screen:
+    f = _mm_sub_epi16(_mm_add_epi16(d, s), aviutl2_image_ops_div255_epu16(_mm_mullo_epi16(d, s)));
+    break;
+  default:
+    f = s;
+    break;
+  }
+  // Same integer steps as the scalar path in aviutl2_image_blend(); products up to 65025 are unsigned 16-bit.
+  __m128i const zero = _mm_setzero_si128();
+  __m128i const sa = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xff), 0xff);
+  __m128i const da = _mm_shufflehi_epi16(_mm_shufflelo_epi16(d, 0xff), 0xff);
+  __m128i const a = aviutl2_image_ops_div255_epu16(_mm_mullo_epi16(sa, opacity));
+  __m128i const w = _mm_mullo_epi16(da, _mm_sub_epi16(max, a));
+  __m128i const oa = _mm_add_epi16(a, aviutl2_image_ops_div255_epu16(w));
+  __m128i const m = aviutl2_image_ops_div255_epu16(
+      _mm_add_epi16(_mm_mullo_epi16(s, _mm_sub_epi16(max, da)), _mm_mullo_epi16(f, da)));
+  __m128i const ma = _mm_mullo_epi16(m, a);
+  __m128i const ma_lo = _mm_mullo_epi16(ma, max), ma_hi = _mm_mulhi_epu16(ma, max);
+  __m128i const dw_lo = _mm_mullo_epi16(d, w), dw_hi = _mm_mulhi_epu16(d, w);
+  __m128i const den = _mm_sub_epi16(_mm_mullo_epi16(oa, max), _mm_cmpeq_epi16(oa, zero));
+  __m128 const half = _mm_set1_ps(0.5f);
+  __m128 const q0 = _mm_div_ps(
+      _mm_cvtepi32_ps(_mm_add_epi32(_mm_unpacklo_epi16(ma_lo, ma_hi), _mm_unpacklo_epi16(dw_lo, dw_hi))),
+      _mm_cvtepi32_ps(_mm_unpacklo_epi16(den, zero)));
+  __m128 const q1 = _mm_div_ps(
+      _mm_cvtepi32_ps(_mm_add_epi32(_mm_unpackhi_epi16(ma_lo, ma_hi), _mm_unpackhi_epi16(dw_lo, dw_hi))),
+      _mm_cvtepi32_ps(_mm_unpackhi_epi16(den, zero)));
+  __m128i const color = _mm_min_epi16(
+      _mm_packs_epi32(_mm_cvttps_epi32(_mm_add_ps(q0, half)), _mm_cvttps_epi32(_mm_add_ps(q1, half))), max);
+  __m128i const alpha_mask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+  return _mm_or_si128(_mm_andnot_si128(alpha_mask, color), _mm_and_si128(alpha_mask, oa));
+}
+#endif
+
+/**
+ * Blend a source image over a destination image
+ * Both images have straight (not premultiplied) alpha. The source, with its alpha multiplied by opacity, is composited
+ * with the "over" operator; the blend mode result is used where the destination is opaque and the plain source color
+ * where it is transparent, and the resulting colors are divided by the resulting alpha.
+ * @param dst Destination image data (PIXEL_RGBA)
+ * @param dst_pitch Number of bytes per row in destination
+ * @param src Source image data (PIXEL_RGBA)
+ * @param src_pitch Number of bytes per row in source
+ * @param width Width of the blended area
+ * @param height Height of the blended area
+ * @param mode Blend mode
+ * @param opacity Opacity (0 to 255)
+ */
+static inline void aviutl2_image_blend(void *dst,
+                                       int dst_pitch,
+                                       void const *src,
+                                       int src_pitch,
+                                       int width,
+                                       int height,
+                                       enum aviutl2_image_blend_mode mode,
+                                       int opacity) {
+  uint32_t const op = opacity < 0 ? 0 : opacity > 255 ? 255 : (uint32_t)opacity;
+  for (int y = 0; y < height; ++y) {
+    uint8_t *d = (uint8_t *)dst + (size_t)y * (size_t)dst_pitch;
+    uint8_t const *s = (uint8_t const *)src + (size_t)y * (size_t)src_pitch;
+    int x = 0;
+#if AVIUTL2_HAS_SSE2
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const opv = _mm_set1_epi16((short)op);
+    for (; x + 4 <= width; x += 4, d += 16, s += 16) {
+      __m128i const dv = _mm_loadu_si128((__m128i const *)d);
+      __m128i const sv = _mm_loadu_si128((__m128i const *)s);
+      __m128i const lo = aviutl2_image_blend_epi16(_mm_unpacklo_epi8(dv, zero), _mm_unpacklo_epi8(sv, zero), mode, opv);
+      __m128i const hi = aviutl2_image_blend_epi16(_mm_unpackhi_epi8(dv, zero), _mm_unpackhi_epi8(sv, zero), mode, opv);
+      _mm_storeu_si128((__m128i *)d, _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < width; ++x, d += 4, s += 4) {
+      uint32_t const a = aviutl2_image_ops_div255(s[3] * op);
+      uint32_t const da = d[3];
+      uint32_t const w = da * (255 - a);
+      uint32_t const oa = a + aviutl2_image_ops_div255(w);
+      // Single precision division is exact enough here (numerators are below 2^24) and matches the SSE2 path.
+      float const den = (float)(oa ? oa * 255 : 1);
+      for (int c = 0; c < 3; ++c) {
+        uint32_t const f = aviutl2_image_blend_channel(d[c], s[c], mode);
+        uint32_t const m = aviutl2_image_ops_div255(s[c] * (255 - da) + f * da);
+        uint32_t const q = (uint32_t)((float)(m * a * 255 + d[c] * w) / den + 0.5f);
+        d[c] = (uint8_t)(q > 255 ? 255 : q);
+      }
+      d[3] = (uint8_t)oa;
+    }
+  }
+}
+
+#if AVIUTL2_HAS_SSE2
+static inline __m128 aviutl2_image_ops_load_ps(uint8_t const *p) {
+  __m128i const zero = _mm_setzero_si128();
+  __m128i const v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(int const *)(void const *)p), zero);
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+}
+
+static inline void aviutl2_image_ops_store_ps(uint8_t *p, __m128 v) {
+  __m128i const i = _mm_cvtps_epi32(v);
+  __m128i const w = _mm_packs_epi32(i, i);
+  *(int *)(void *)p = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+}
+#endif
+
+static inline uint8_t aviutl2_image_ops_clamp_u8(float v) {
+  return (uint8_t)(v <= 0.0f ? 0 : v >= 255.0f ? 255 : (int)(v + 0.5f));
+}
+
+/**
+ * Convolve an image with a square kernel
+ * All four channels are filtered; pixels outside the image repeat the nearest edge pixel.
+ * @param dst Destination image data (PIXEL_RGBA, must not overlap src)
+ * @param dst_pitch Number of bytes per row in destination
+ * @param src Source image data (PIXEL_RGBA)
+ * @param src_pitch Number of bytes per row in source
+ * @param width Image width
+ * @param height Image height
+ * @param kernel size * size weights in row-major order
+ * @param size Kernel size (odd, up to aviutl2_image_ops_max_kernel_size)
+ * @param bias Value added after weighting
+ * @return false if the kernel size is invalid
+ */
+static inline bool aviutl2_image_convolve(void *dst,
+                                          int dst_pitch,
+                                          void const *src,
+                                          int src_pitch,
+                                          int width,
+                                          int height,
+                                          float const *kernel,
+                                          int size,
+                                          float bias) {
+  if (size < 1 || size > aviutl2_image_ops_max_kernel_size || (size & 1) == 0 || width <= 0 || height <= 0) {
+    return false;
+  }
+  int const r = size / 2;
+  uint8_t const *rows[aviutl2_image_ops_max_kernel_size];
+  for (int y = 0; y < height; ++y) {
+    for (int k = 0; k < size; ++k) {
+      int const sy = y + k - r < 0 ? 0 : y + k - r >= height ? height - 1 : y + k - r;
+      rows[k] = (uint8_t const *)src + (size_t)sy * (size_t)src_pitch;
+    }
+    uint8_t *d = (uint8_t *)dst + (size_t)y * (size_t)dst_pitch;
+    for (int x = 0; x < width; ++x, d += 4) {
+      bool const inside = x >= r && x + r < width;
+#if AVIUTL2_HAS_SSE2
+      __m128 acc = _mm_set1_ps(bias);
+      for (int ky = 0; ky < size; ++ky) {
+        float const *kr = kernel + ky * size;
+        for (int kx = 0; kx < size; ++kx) {
+          int const sx = inside ? x + kx - r : x + kx - r < 0 ? 0 : x + kx - r >= width ? width - 1 : x + kx - r;
+          acc = _mm_add_ps(acc, _mm_mul_ps(aviutl2_image_ops_load_ps(rows[ky] + (size_t)sx * 4), _mm_set1_ps(kr[kx])));
+        }
+      }
+      aviutl2_image_ops_store_ps(d, acc);
+#else
+      float acc[4] = {bias, bias, bias, bias};
+      for (int ky = 0; ky < size; ++ky) {
+        float const *kr = kernel + ky * size;
+        for (int kx = 0; kx < size; ++kx) {
+          int const sx = inside ? x + kx - r : x + kx - r < 0 ? 0 : x + kx - r >= width ? width - 1 : x + kx - r;
+          uint8_t const *p = rows[ky] + (size_t)sx * 4;
+          for (int c = 0; c < 4; ++c) {
+            acc[c] += (float)p[c] * kr[kx];
+          }
+        }
+      }
+      for (int c = 0; c < 4; ++c) {
+        d[c] = aviutl2_image_ops_clamp_u8(acc[c]);
+      }
+#endif
+    }
+  }
+  return true;
+}
+
+/**
+ * Resize an image
+ * Uses the box filter from aviutl2_image_scale.h when shrinking on both axes and bilinear interpolation otherwise.
+ * @param dst Destination image data (PIXEL_RGBA, must not overlap src)
+ * @param dst_width Destination width
+ * @param dst_height Destination height
+ * @param dst_pitch Number of bytes per row in destination
+ * @param src Source image data (PIXEL_RGBA)
+ * @param src_width Source width
+ * @param src_height Source height
+ * @param src_pitch Number of bytes per row in source
+ * @return false if any size is invalid
+ */
+static inline bool aviutl2_image_resize(void *dst,
+                                        int dst_width,
+                                        int dst_height,
+                                        int dst_pitch,
+                                        void const *src,
+                                        int src_width,
+                                        int src_height,
+                                        int src_pitch) {
+  if (!dst || !src || dst_width <= 0 || dst_height <= 0 || src_width <= 0 || src_height <= 0) {
+    return false;
+  }
+  if (dst_width <= src_width && dst_height <= src_height) {
+    return aviutl2_image_downscale_box(
+        (struct aviutl2_pixel_rgba *)dst, dst_width, dst_height, dst_pitch, src, src_width, src_height, src_pitch);
+  }
+  float const sx_scale = (float)src_width / (float)dst_width;
+  float const sy_scale = (float)src_height / (float)dst_height;
+  for (int y = 0; y < dst_height; ++y) {
+    float fy = ((float)y + 0.5f) * sy_scale - 0.5f;
+    fy = fy < 0.0f ? 0.0f : fy;
+    int const y0 = (int)fy < src_height - 1 ? (int)fy : src_height - 1;
+    int const y1 = y0 + 1 < src_height ? y0 + 1 : y0;
+    float const wy = fy - (float)y0 > 1.0f ? 1.0f : fy - (float)y0;
+    uint8_t const *r0 = (uint8_t const *)src + (size_t)y0 * (size_t)src_pitch;
+    uint8_t const *r1 = (uint8_t const *)src + (size_t)y1 * (size_t)src_pitch;
+    uint8_t *d = (uint8_t *)dst + (size_t)y * (size_t)dst_pitch;
+    for (int x = 0; x < dst_width; ++x, d += 4) {
+      float fx = ((float)x + 0.5f) * sx_scale - 0.5f;
+      fx = fx < 0.0f ? 0.0f : fx;
+      int const x0 = (int)fx < src_width - 1 ? (int)fx : src_width - 1;
+      int const x1 = x0 + 1 < src_width ? x0 + 1 : x0;
+      float const wx = fx - (float)x0 > 1.0f ? 1.0f : fx - (float)x0;
+#if AVIUTL2_HAS_SSE2
+      __m128 const wxv = _mm_set1_ps(wx), wyv = _mm_set1_ps(wy);
+      __m128 const p00 = aviutl2_image_ops_load_ps(r0 + (size_t)x0 * 4);
+      __m128 const p01 = aviutl2_image_ops_load_ps(r0 + (size_t)x1 * 4);
+      __m128 const p10 = aviutl2_image_ops_load_ps(r1 + (size_t)x0 * 4);
+      __m128 const p11 = aviutl2_image_ops_load_ps(r1 + (size_t)x1 * 4);
+      __m128 const top = _mm_add_ps(p00, _mm_mul_ps(_mm_sub_ps(p01, p00), wxv));
+      __m128 const bottom = _mm_add_ps(p10, _mm_mul_ps(_mm_sub_ps(p11, p10), wxv));
+      aviutl2_image_ops_store_ps(d, _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), wyv)));
+#else
+      for (int c = 0; c < 4; ++c) {
+        float const top = (float)r0[x0 * 4 + c] + ((float)r0[x1 * 4 + c] - (float)r0[x0 * 4 + c]) * wx;
+        float const bottom = (float)r1[x0 * 4 + c] + ((float)r1[x1 * 4 + c] - (float)r1[x0 * 4 + c]) * wx;
+        d[c] = aviutl2_image_ops_clamp_u8(top + (bottom - top) * wy);
+      }
+#endif
+    }
+  }
+  return true;
+}
+
+// Script module functions
+
+static inline bool aviutl2_image_ops_get_image(struct aviutl2_script_module_param *param,
+                                               int index,
+                                               uint8_t **data,
+                                               int *width,
+                                               int *height,
+                                               int *pitch) {
+  *data = (uint8_t *)param->get_param_data(index);
+  *width = param->get_param_int(index + 1);
+  *height = param->get_param_int(index + 2);
+  *pitch = param->get_param_int(index + 3);
+  if (*pitch == 0) {
+    *pitch = *width * 4;
+  }
+  if (!*data || *width <= 0 || *height <= 0 || *pitch < *width * 4) {
+    param->set_error("invalid image");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Script function levels(data, w, h, pitch, in_black, in_white, gamma, out_black, out_white)
+ * @param param Parameter interface
+ */
+static inline void aviutl2_image_ops_func_levels(struct aviutl2_script_module_param *param) {
+  uint8_t *data;
+  int w, h, pitch;
+  if (!aviutl2_image_ops_get_image(param, 0, &data, &w, &h, &pitch)) {
+    return;
+  }
+  uint8_t lut[256];
+  aviutl2_image_lut_levels(lut,
+                           param->get_param_double(4),
+                           param->get_param_double(5),
+                           param->get_param_double(6),
+                           param->get_param_double(7),
+                           param->get_param_double(8));
+  aviutl2_image_apply_lut(data, w, h, pitch, lut, lut, lut);
+}
+
+/**
+ * Script function curves(data, w, h, pitch, {x1, y1, x2, y2, ...})
+ * @param param Parameter interface
+ */
+static inline void aviutl2_image_ops_func_curves(struct aviutl2_script_module_param *param) {
+  uint8_t *data;
+  int w, h, pitch;
+  if (!aviutl2_image_ops_get_image(param, 0, &data, &w, &h, &pitch)) {
+    return;
+  }
+  double xs[aviutl2_image_ops_max_curve_points], ys[aviutl2_image_ops_max_curve_points];
+  int const n = param->get_param_array_num(4) / 2;
+  if (n > aviutl2_image_ops_max_curve_points) {
+    param->set_error("too many curve points");
+    return;
+  }
+  for (int i = 0; i < n; ++i) {
+    xs[i] = param->get_param_array_double(4, i * 2);
+    ys[i] = param->get_param_array_double(4, i * 2 + 1);
+  }
+  uint8_t lut[256];
+  if (!aviutl2_image_lut_curve(lut, xs, ys, n > 0 ? (size_t)n : 0)) {
+    param->set_error("invalid curve points");
+    return;
+  }
+  aviutl2_image_apply_lut(data, w, h, pitch, lut, lut, lut);
+}
+
+/**
+ * Script function threshold(data, w, h, pitch, threshold)
+ * @param param Parameter interface
+ */
+static inline void aviutl2_image_ops_func_threshold(struct aviutl2_script_module_param *param) {
+  uint8_t *data;
+  int w, h, pitch;
+  if (aviutl2_image_ops_get_image(param, 0, &data, &w, &h, &pitch)) {
+    aviutl2_image_threshold(data, w, h, pitch, param->get_param_int(4));
+  }
+}
+
+/**
+ * Script function blend(dst, w, h, dst_pitch, src, src_pitch, mode, opacity)
+ * mode is "normal", "add", "subtract", "multiply" or "screen"; opacity is 0.0 to 1.0
+ * @param param Parameter interface
+ */
+static inline void aviutl2_image_ops_func_blend(struct aviutl2_script_module_param *param) {
+  static struct {
+    char const *name;
+    enum aviutl2_image_blend_mode mode;
+  } const modes[] = {
+      {"normal", aviutl2_image_blend_normal},
+      {"add", aviutl2_image_blend_add},
+      {"subtract", aviutl2_image_blend_subtract},
+      {"multiply", aviutl2_image_blend_multiply},
+      {"screen", aviutl2_image_blend_screen},
+  };
+  uint8_t *dst;
+  int w, h, pitch;
+  if (!aviutl2_image_ops_get_image(param, 0, &dst, &w, &h, &pitch)) {
+    return;
+  }
+  uint8_t const *src = (uint8_t const *)param->get_param_data(4);
+  int const src_pitch = param->get_param_int(5) ? param->get_param_int(5) : w * 4;
+  char const *name = param->get_param_string(6);
+  if (!src || src_pitch < w * 4) {
+    param->set_error("invalid image");
+    return;
+  }
+  for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+    if (name && strcmp(name, modes[i].name) == 0) {
+      double const opacity = param->get_param_num() > 7 ? param->get_param_double(7) : 1.0;
+      aviutl2_image_blend(dst, pitch, src, src_pitch, w, h, modes[i].mode, (int)(opacity * 255.0 + 0.5));
+      return;
+    }
+  }
+  param->set_error("unknown blend mode");
+}
+
+/**
+ * Script function convolve(data, w, h, pitch, {weights...}, size [, bias])
+ * The image is filtered in place through a temporary copy
+ * @param param Parameter interface
+ */
+static inline void aviutl2_image_ops_func_convolve(struct aviutl2_script_module_param *param) {
+  uint8_t *data;
+  int w, h, pitch;
+  if (!aviutl2_image_ops_get_image(param, 0, &data, &w, &h, &pitch)) {
+    return;
+  }
+  int const size = param->get_param_int(5);
+  float kernel[aviutl2_image_ops_max_kernel_size * aviutl2_image_ops_max_kernel_size];
+  if (size < 1 || size > aviutl2_image_ops_max_kernel_size || (size & 1) == 0 ||
+      param->get_param_array_num(4) != size * size) {
+    param->set_error("invalid kernel");
+    return;
+  }
+  for (int i = 0; i < size * size; ++i) {
+    kernel[i] = (float)param->get_param_array_double(4, i);
+  }
+  uint8_t *copy = (uint8_t *)malloc((size_t)w * 4 * (size_t)h);
+  if (!copy) {
+    param->set_error("failed to allocate memory");
+    return;
+  }
+  for (int y = 0; y < h; ++y) {
+    memcpy(copy + (size_t)y * (size_t)w * 4, data + (size_t)y * (size_t)pitch, (size_t)w * 4);
+  }
+  float const bias = param->get_param_num() > 6 ? (float)param->get_param_double(6) : 0.0f;
+  aviutl2_image_convolve(data, pitch, copy, w * 4, w, h, kernel, size, bias);
+  free(copy);
+}
+
+/**
+ * Script function resize(dst, dst_w, dst_h, dst_pitch, src, src_w, src_h, src_pitch)
+ * @param param Parameter interface
+ */
+static inline void aviutl2_image_ops_func_resize(struct aviutl2_script_module_param *param) {
+  uint8_t *dst, *src;
+  int dw, dh, dp, sw, sh, sp;
+  if (aviutl2_image_ops_get_image(param, 0, &dst, &dw, &dh, &dp) &&
+      aviutl2_image_ops_get_image(param, 4, &src, &sw, &sh, &sp)) {
+    aviutl2_image_resize(dst, dw, dh, dp, src, sw, sh, sp);
+  }
+}
+
+/**
+ * Get the script module table exposing the image operations
+ * @return Script module table
+ */
+static inline struct aviutl2_script_module_table *aviutl2_image_ops_module_table(void) {
+  static struct aviutl2_script_module_function functions[] = {
+      {L"levels", aviutl2_image_ops_func_levels},
+      {L"curves", aviutl2_image_ops_func_curves},
+      {L"threshold", aviutl2_image_ops_func_threshold},
+      {L"blend", aviutl2_image_ops_func_blend},
+      {L"convolve", aviutl2_image_ops_func_convolve},
+      {L"resize", aviutl2_image_ops_func_resize},
+      {NULL, NULL},
+  };
+  static struct aviutl2_script_module_table table = {
+      L"image_ops",
+      functions,
+  };
+  return &table;
+}
@@ -0,0 +1,140 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Box (area average) downscaler for PIXEL_RGBA images.
+// Source and destination images may have arbitrary row pitch, such as the buffers passed to
+// rendering_object_video() / rendering_scene_video() callbacks.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aviutl2_filter2.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+/**
+ * Calculate the largest size that fits in the specified box while keeping the aspect ratio
+ * The result is never larger than the source size and never smaller than 1x1
+ * @param src_width Source image width
+ * @param src_height Source image height
+ * @param max_width Maximum width
+ * @param max_height Maximum height
+ * @param width Pointer to storage for the fitted width
+ * @param height Pointer to storage for the fitted height
+ */
+static inline void
+aviutl2_image_fit_size(int src_width, int src_height, int max_width, int max_height, int *width, int *height) {
+  int w = src_width, h = src_height;
+  if (w > max_width) {
+    h = (int)(((int64_t)h * max_width + w / 2) / w);
+    w = max_width;
+  }
+  if (h > max_height) {
+    w = (int)(((int64_t)w * max_height + h / 2) / h);
+    h = max_height;
+  }
+  *width = w < 1 ? 1 : w;
+  *height = h < 1 ? 1 : h;
+}
+
+/**
+ * Per-channel sums of a pixel span (r, g, b, a)
+ */
+struct aviutl2_image_sum {
+  uint32_t c[4];
+};
+
+/**
+ * Add the channel values of pixels [x0, x1) in a row to sum
+ * @param sum Accumulator
+ * @param row Pointer to the first pixel of the row
+ * @param x0 First pixel index
+ * @param x1 Last pixel index (exclusive)
+ */
+static inline void aviutl2_image_sum_span(struct aviutl2_image_sum *sum, uint8_t const *row, int x0, int x1) {
+  uint8_t const *p = row + (size_t)x0 * 4;
+  int n = x1 - x0;
+#if AVIUTL2_HAS_SSE2
+  __m128i const zero = _mm_setzero_si128();
+  __m128i acc = _mm_loadu_si128((__m128i const *)sum->c);
+  for (; n >= 4; n -= 4, p += 16) {
+    __m128i const v = _mm_loadu_si128((__m128i const *)p);
+    __m128i const s16 = _mm_add_epi16(_mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero));
+    acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_unpacklo_epi16(s16, zero), _mm_unpackhi_epi16(s16, zero)));
+  }
+  _mm_storeu_si128((__m128i *)sum->c, acc);
+#endif
+  for (; n > 0; --n, p += 4) {
+    sum->c[0] += p[0];
+    sum->c[1] += p[1];
+    sum->c[2] += p[2];
+    sum->c[3] += p[3];
+  }
+}
+
+/**
+ * Downscale a PIXEL_RGBA image with a box filter
+ * Each destination pixel is the rounded average of the source pixels it covers.
+ * When the destination is larger than the source on an axis, pixels are replicated on that axis.
+ * @param dst Pointer to destination image data
+ * @param dst_width Destination image width
+ * @param dst_height Destination image height
+ * @param dst_pitch Number of bytes per row in destination image data
+ * @param src Pointer to source image data (PIXEL_RGBA)
+ * @param src_width Source image width
+ * @param src_height Source image height
+ * @param src_pitch Number of bytes per row in source image data
+ * @return false if any size is invalid
+ */
+static inline bool aviutl2_image_downscale_box(struct aviutl2_pixel_rgba *dst,
+                                               int dst_width,
+                                               int dst_height,
+                                               int dst_pitch,
+                                               void const *src,
+                                               int src_width,
+                                               int src_height,
+                                               int src_pitch) {
+  if (!dst || !src || dst_width <= 0 || dst_height <= 0 || src_width <= 0 || src_height <= 0) {
+    return false;
+  }
+  uint8_t const *const src_bytes = (uint8_t const *)src;
+  uint8_t *const dst_bytes = (uint8_t *)dst;
+  for (int y = 0; y < dst_height; ++y) {
+    int sy0 = (int)((int64_t)y * src_height / dst_height);
+    int sy1 = (int)((int64_t)(y + 1) * src_height / dst_height);
+    if (sy1 <= sy0) {
+      sy1 = sy0 + 1;
+    }
+    uint8_t *d = dst_bytes + (size_t)y * (size_t)dst_pitch;
+    for (int x = 0; x < dst_width; ++x, d += 4) {
+      int sx0 = (int)((int64_t)x * src_width / dst_width);
+      int sx1 = (int)((int64_t)(x + 1) * src_width / dst_width);
+      if (sx1 <= sx0) {
+        sx1 = sx0 + 1;
+      }
+      struct aviutl2_image_sum sum = {{0, 0, 0, 0}};
+      for (int sy = sy0; sy < sy1; ++sy) {
+        aviutl2_image_sum_span(&sum, src_bytes + (size_t)sy * (size_t)src_pitch, sx0, sx1);
+      }
+      uint32_t const n = (uint32_t)((sx1 - sx0) * (sy1 - sy0));
+      uint32_t const half = n / 2;
+      d[0] = (uint8_t)((sum.c[0] + half) / n);
+      d[1] = (uint8_t)((sum.c[1] + half) / n);
+      d[2] = (uint8_t)((sum.c[2] + half) / n);
+      d[3] = (uint8_t)((sum.c[3] + half) / n);
+    }
+  }
+  return true;
+}
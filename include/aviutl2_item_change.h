@@ -0,0 +1,292 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Filter item change detection and memoized derived resources
+//
+// aviutl2_item_change_update() hashes the current value of every item in a filter plugin's items array and reports
+// which items changed since the previous call as a bit mask (bit n = items[n]). Derived resources such as lookup
+// tables or convolution kernels are kept in struct aviutl2_item_memo together with the mask of items they depend on,
+// and are rebuilt only when one of those items has changed since the resource was built, including changes on calls
+// where the memo was not queried.
+//
+// Keep the state per effect instance in the user data created by func_create():
+//   struct state {
+//     struct aviutl2_item_change change;
+//     struct aviutl2_item_memo lut;
+//   };
+//   static bool func_proc_video(struct aviutl2_filter_proc_video *video) {
+//     struct state *st = video->userdata;
+//     aviutl2_item_change_update(&st->change, items);
+//     uint8_t *lut = aviutl2_item_memo_get(&st->lut, &st->change, AVIUTL2_ITEM_BIT(0) | AVIUTL2_ITEM_BIT(2),
+//                                          build_lut, NULL);
+//     ...
+//   }
+// and release resources with aviutl2_item_memo_free() in func_destroy().
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "aviutl2_filter2.h"
+#include "aviutl2_hash.h"
+
+enum {
+  aviutl2_item_change_max_items = 64,
+};
+
+/**
+ * Bit for the item at the specified index of the items array
+ */
+#define AVIUTL2_ITEM_BIT(index) (UINT64_C(1) << (index))
+
+/**
+ * How an item value is hashed
+ */
+enum aviutl2_item_change_kind {
+  aviutl2_item_change_kind_none = 0,    /**< Items without a value (group, button, separator, unknown types) */
+  aviutl2_item_change_kind_track = 1,   /**< track, track2 */
+  aviutl2_item_change_kind_group = 2,   /**< trackgroup */
+  aviutl2_item_change_kind_check = 3,   /**< check, checksection, checksection2 */
+  aviutl2_item_change_kind_color = 4,   /**< color */
+  aviutl2_item_change_kind_select = 5,  /**< select */
+  aviutl2_item_change_kind_string = 6,  /**< file, string, text, folder */
+  aviutl2_item_change_kind_data = 7,    /**< data */
+};
+
+/**
+ * Change detection state
+ * Initialize with {0}
+ */
+struct aviutl2_item_change {
+  void *const *items; /**< Items array the kinds were resolved for */
+  size_t item_num;
+  uint8_t kinds[aviutl2_item_change_max_items];
+  uint64_t hashes[aviutl2_item_change_max_items];
+  uint64_t changed_at[aviutl2_item_change_max_items]; /**< Value of updates when each item last changed */
+  uint64_t changed;                                   /**< Items changed by the last update */
+  uint64_t updates;                                   /**< Number of aviutl2_item_change_update() calls */
+};
+
+/**
+ * Derived resource memo
+ * Initialize with {0}
+ */
+struct aviutl2_item_memo {
+  void *value;
+  bool valid;
+  uint64_t built_at; /**< aviutl2_item_change::updates when the resource was built */
+  uint64_t builds;   /**< Number of times the resource was built */
+  uint64_t hits;     /**< Number of times the cached resource was reused */
+};
+
+/**
+ * Determine how an item is hashed from its type string
+ * @param item Pointer to an aviutl2_filter_item_* structure
+ * @return Item kind
+ */
+static inline enum aviutl2_item_change_kind aviutl2_item_change_classify(void const *item) {
+  static struct {
+    wchar_t const *type;
+    enum aviutl2_item_change_kind kind;
+  } const table[] = {
+      {L"track2", aviutl2_item_change_kind_track},
+      {L"track", aviutl2_item_change_kind_track},
+      {L"trackgroup", aviutl2_item_change_kind_group},
+      {L"check", aviutl2_item_change_kind_check},
+      {L"checksection2", aviutl2_item_change_kind_check},
+      {L"checksection", aviutl2_item_change_kind_check},
+      {L"color", aviutl2_item_change_kind_color},
+      {L"select", aviutl2_item_change_kind_select},
+      {L"file", aviutl2_item_change_kind_string},
+      {L"string", aviutl2_item_change_kind_string},
+      {L"text", aviutl2_item_change_kind_string},
+      {L"folder", aviutl2_item_change_kind_string},
+      {L"data", aviutl2_item_change_kind_data},
+  };
+  // Every aviutl2_filter_item_* structure starts with the type string.
+  wchar_t const *type = *(wchar_t const *const *)item;
+  if (!type) {
+    return aviutl2_item_change_kind_none;
+  }
+  for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); ++i) {
+    if (wcscmp(type, table[i].type) == 0) {
+      return table[i].kind;
+    }
+  }
+  return aviutl2_item_change_kind_none;
+}
+
+/**
+ * Hash the current value of an item
+ * @param item Pointer to an aviutl2_filter_item_* structure
+ * @param kind Item kind returned by aviutl2_item_change_classify()
+ * @return Hash value
+ */
+static inline uint64_t aviutl2_item_change_hash(void const *item, enum aviutl2_item_change_kind kind) {
+  uint64_t h = AVIUTL2_HASH_INIT;
+  switch (kind) {
+  case aviutl2_item_change_kind_none:
+    break;
+  case aviutl2_item_change_kind_track: {
+    double const v = ((struct aviutl2_filter_item_track const *)item)->value;
+    h = aviutl2_hash_bytes(h, &v, sizeof(v));
+  } break;
+  case aviutl2_item_change_kind_group: {
+    struct aviutl2_filter_item_track **tracks = ((struct aviutl2_filter_item_track_group const *)item)->tracks;
+    for (size_t i = 0; tracks && tracks[i]; ++i) {
+      h = aviutl2_hash_bytes(h, &tracks[i]->value, sizeof(tracks[i]->value));
+    }
+  } break;
+  case aviutl2_item_change_kind_check:
+    h = aviutl2_hash_u64(h, ((struct aviutl2_filter_item_check const *)item)->value);
+    break;
+  case aviutl2_item_change_kind_color:
+    h = aviutl2_hash_u64(h, ((struct aviutl2_filter_item_color const *)item)->value.code);
+    break;
+  case aviutl2_item_change_kind_select:
+    h = aviutl2_hash_u64(h, (uint64_t)(int64_t)((struct aviutl2_filter_item_select const *)item)->value);
+    break;
+  case aviutl2_item_change_kind_string:
+    // The pointer may change while the content stays the same, so hash the content.
+    h = aviutl2_hash_wstr(h, ((struct aviutl2_filter_item_string const *)item)->value);
+    break;
+  case aviutl2_item_change_kind_data: {
+    struct aviutl2_filter_item_data const *d = (struct aviutl2_filter_item_data const *)item;
+    if (d->value && d->size > 0) {
+      h = aviutl2_hash_bytes(h, d->value, (size_t)d->size);
+    }
+    h = aviutl2_hash_u64(h, (uint64_t)(int64_t)d->size);
+  } break;
+  }
+  return h;
+}
+
+/**
+ * Detect changed items
+ * Call at the start of func_proc_video() / func_proc_audio(), when item values are up to date.
+ * Every item is reported as changed on the first call and when a different items array is passed.
+ * @param c Change detection state
+ * @param items Null-terminated items array of the filter plugin (only the first 64 items are tracked)
+ * @return Bit mask of changed items
+ */
+static inline uint64_t aviutl2_item_change_update(struct aviutl2_item_change *c, void *const *items) {
+  bool const reset = c->items != items || c->updates == 0;
+  ++c->updates;
+  if (reset) {
+    c->items = items;
+    c->item_num = 0;
+    while (c->item_num < aviutl2_item_change_max_items && items[c->item_num]) {
+      c->kinds[c->item_num] = (uint8_t)aviutl2_item_change_classify(items[c->item_num]);
+      ++c->item_num;
+    }
+  }
+  uint64_t changed = 0;
+  for (size_t i = 0; i < c->item_num; ++i) {
+    enum aviutl2_item_change_kind const kind = (enum aviutl2_item_change_kind)c->kinds[i];
+    if (kind == aviutl2_item_change_kind_none) {
+      continue;
+    }
+    uint64_t const h = aviutl2_item_change_hash(items[i], kind);
+    if (reset || h != c->hashes[i]) {
+      c->hashes[i] = h;
+      changed |= AVIUTL2_ITEM_BIT(i);
+    }
+  }
+  if (reset) {
+    changed = c->item_num == aviutl2_item_change_max_items ? UINT64_MAX : AVIUTL2_ITEM_BIT(c->item_num) - 1;
+  }
+  for (size_t i = 0; i < c->item_num; ++i) {
+    if (changed & AVIUTL2_ITEM_BIT(i)) {
+      c->changed_at[i] = c->updates;
+    }
+  }
+  c->changed = changed;
+  return changed;
+}
+
+/**
+ * Forget all hashes so that every item is reported as changed on the next update
+ * @param c Change detection state
+ */
+static inline void aviutl2_item_change_invalidate(struct aviutl2_item_change *c) {
+  // The update counter keeps counting so that memos built before this are still seen as stale
+  c->items = NULL;
+}
+
+/**
+ * Check whether any of the specified items changed in the last update
+ * @param c Change detection state
+ * @param mask Bit mask of items (AVIUTL2_ITEM_BIT)
+ * @return true if any of the items changed
+ */
+static inline bool aviutl2_item_change_any(struct aviutl2_item_change const *c, uint64_t mask) {
+  return (c->changed & mask) != 0;
+}
+
+/**
+ * Check whether any of the specified items changed after a given update
+ * @param c Change detection state
+ * @param mask Bit mask of items (AVIUTL2_ITEM_BIT)
+ * @param since Value of aviutl2_item_change::updates to compare with
+ * @return true if any of the items changed in a later update
+ */
+static inline bool aviutl2_item_change_since(struct aviutl2_item_change const *c, uint64_t mask, uint64_t since) {
+  if (since >= c->updates) {
+    return false;
+  }
+  for (size_t i = 0; i < c->item_num; ++i) {
+    if ((mask & AVIUTL2_ITEM_BIT(i)) && c->changed_at[i] > since) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Get a derived resource, rebuilding it if an item it depends on changed after it was built
+ * Changes are tracked per item, so a memo that is only queried on some calls still sees changes made in between.
+ * Use each memo with a single change detection state.
+ * @param m Memo
+ * @param c Change detection state updated for the current call
+ * @param deps Bit mask of items the resource depends on
+ * @param build Function that builds the resource. old is the previous resource (NULL on the first build) and can be
+ *              reused or released; return NULL on failure (the memo is then empty and the next call retries)
+ * @param userdata Value passed to build
+ * @return Resource, or NULL if building failed
+ */
+static inline void *aviutl2_item_memo_get(struct aviutl2_item_memo *m,
+                                          struct aviutl2_item_change const *c,
+                                          uint64_t deps,
+                                          void *(*build)(void *userdata, void *old),
+                                          void *userdata) {
+  if (m->valid && !aviutl2_item_change_since(c, deps, m->built_at)) {
+    ++m->hits;
+    return m->value;
+  }
+  m->value = build(userdata, m->value);
+  m->valid = m->value != NULL;
+  m->built_at = c->updates;
+  ++m->builds;
+  return m->value;
+}
+
+/**
+ * Mark a memo as stale so that the next aviutl2_item_memo_get() rebuilds it
+ * @param m Memo
+ */
+static inline void aviutl2_item_memo_invalidate(struct aviutl2_item_memo *m) { m->valid = false; }
+
+/**
+ * Release the resource held by a memo
+ * @param m Memo
+ * @param destroy Function that releases the resource (may be NULL)
+ */
+static inline void aviutl2_item_memo_free(struct aviutl2_item_memo *m, void (*destroy)(void *value)) {
+  if (m->value && destroy) {
+    destroy(m->value);
+  }
+  memset(m, 0, sizeof(*m));
+}
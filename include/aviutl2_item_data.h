@@ -0,0 +1,584 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Compact binary layout for aviutl2_filter_item_data
+//
+// The data block is read in place from aviutl2_filter_item_data.value on every filter call, so no deserialization
+// or allocation is needed. The layout is:
+//   struct aviutl2_item_data_header
+//   struct aviutl2_item_data_entry[field_num]   Field directory
+//   field payloads                               4-byte aligned (8-byte aligned for 64-bit values)
+//
+// Fields are identified by a numeric id chosen by the plugin. Readers ignore unknown ids and fall back to defaults
+// for missing ones, so a schema can gain fields without breaking old data. The header also carries a schema
+// version number for changes that cannot be expressed that way.
+//
+// Integer arrays can be stored as zigzag LEB128 varints, optionally delta-encoded, which keeps sorted tables such
+// as keyframe positions small. They are read with an allocation-free iterator.
+//
+// Writing:
+//   static struct aviutl2_item_data_writer w; // about 17 KB, avoid putting it on the stack
+//   aviutl2_item_data_writer_init(&w, 1);
+//   aviutl2_item_data_writer_add_f32_array(&w, 1, curve, curve_num);
+//   aviutl2_item_data_writer_add_delta_array(&w, 2, keyframes, keyframe_num);
+//   aviutl2_item_data_writer_commit(&w, &item_data, video->set_filter_item_data_size);
+// Reading:
+//   struct aviutl2_item_data_reader r;
+//   if (aviutl2_item_data_reader_init(&r, item_data.value, item_data.size)) {
+//     size_t n;
+//     float const *curve = aviutl2_item_data_get_f32_array(&r, 1, &n);
+//   }
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "aviutl2_filter2.h"
+
+#define AVIUTL2_ITEM_DATA_MAGIC 0x44494141 /**< "AAID" */
+#define AVIUTL2_ITEM_DATA_MAX_SIZE 16384   /**< Maximum size of aviutl2_filter_item_data */
+
+enum {
+  aviutl2_item_data_max_fields = 64,
+};
+
+/**
+ * Field kind
+ */
+enum aviutl2_item_data_kind {
+  aviutl2_item_data_kind_bytes = 1,        /**< Arbitrary bytes */
+  aviutl2_item_data_kind_i32 = 2,          /**< int32_t */
+  aviutl2_item_data_kind_f32 = 3,          /**< float */
+  aviutl2_item_data_kind_f64 = 4,          /**< double */
+  aviutl2_item_data_kind_f32_array = 5,    /**< Array of float */
+  aviutl2_item_data_kind_varint_array = 6, /**< Varint count followed by zigzag varint values */
+  aviutl2_item_data_kind_delta_array = 7,  /**< Varint count followed by zigzag varint differences */
+};
+
+/**
+ * Data block header
+ */
+struct aviutl2_item_data_header {
+  uint32_t magic;     /**< AVIUTL2_ITEM_DATA_MAGIC */
+  uint16_t version;   /**< Schema version defined by the plugin */
+  uint16_t field_num; /**< Number of directory entries */
+};
+
+/**
+ * Field directory entry
+ */
+struct aviutl2_item_data_entry {
+  uint16_t id;     /**< Field id */
+  uint8_t kind;    /**< enum aviutl2_item_data_kind */
+  uint8_t reserved;
+  uint16_t offset; /**< Offset of the payload from the start of the data block */
+  uint16_t size;   /**< Payload size in bytes */
+};
+
+/**
+ * In-place reader
+ */
+struct aviutl2_item_data_reader {
+  uint8_t const *data;
+  size_t size;
+  struct aviutl2_item_data_entry const *entries;
+  uint16_t version;
+  uint16_t field_num;
+};
+
+/**
+ * Iterator over a varint or delta array
+ */
+struct aviutl2_item_data_iter {
+  uint8_t const *p;
+  uint8_t const *end;
+  size_t remain; /**< Number of values not yet returned */
+  int64_t prev;
+  bool delta;
+};
+
+static inline uint8_t const *aviutl2_item_data_read_varint(uint8_t const *p, uint8_t const *end, uint64_t *value) {
+  uint64_t v = 0;
+  for (unsigned shift = 0; p < end && shift < 64; shift += 7) {
+    uint8_t const b = *p++;
+    v |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) {
+      *value = v;
+      return p;
+    }
+  }
+  return NULL;
+}
+
+static inline int64_t aviutl2_item_data_unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+static inline uint64_t aviutl2_item_data_zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+
+/**
+ * Initialize a reader
+ * @param r Reader
+ * @param data Data block (aviutl2_filter_item_data.value)
+ * @param size Size of data block (aviutl2_filter_item_data.size)
+ * @return false if the block is empty or does not have a valid layout
+ */
+static inline bool aviutl2_item_data_reader_init(struct aviutl2_item_data_reader *r, void const *data, int size) {
+  memset(r, 0, sizeof(*r));
+  struct aviutl2_item_data_header header;
+  if (!data || size < (int)sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  size_t const dir_end = sizeof(header) + (size_t)header.field_num * sizeof(struct aviutl2_item_data_entry);
+  if (header.magic != AVIUTL2_ITEM_DATA_MAGIC || dir_end > (size_t)size) {
+    return false;
+  }
+  r->data = (uint8_t const *)data;
+  r->size = (size_t)size;
+  r->entries = (struct aviutl2_item_data_entry const *)(r->data + sizeof(header));
+  r->version = header.version;
+  r->field_num = header.field_num;
+  return true;
+}
+
+/**
+ * Find a field
+ * @param r Reader
+ * @param id Field id
+ * @param kind Expected kind
+ * @param size Pointer to storage for the payload size (may be NULL)
+ * @return Pointer to the payload, or NULL if the field does not exist, has a different kind or is out of bounds
+ */
+static inline void const *aviutl2_item_data_find(struct aviutl2_item_data_reader const *r,
+                                                  uint16_t id,
+                                                  enum aviutl2_item_data_kind kind,
+                                                  size_t *size) {
+  for (uint16_t i = 0; i < r->field_num; ++i) {
+    struct aviutl2_item_data_entry const *e = r->entries + i;
+    if (e->id != id) {
+      continue;
+    }
+    if (e->kind != kind || (size_t)e->offset + e->size > r->size) {
+      return NULL;
+    }
+    if (size) {
+      *size = e->size;
+    }
+    return r->data + e->offset;
+  }
+  return NULL;
+}
+
+/**
+ * Get an int32_t field
+ * @param r Reader
+ * @param id Field id
+ * @param def Value returned if the field does not exist
+ * @return Field value
+ */
+static inline int32_t aviutl2_item_data_get_i32(struct aviutl2_item_data_reader const *r, uint16_t id, int32_t def) {
+  size_t size;
+  void const *p = aviutl2_item_data_find(r, id, aviutl2_item_data_kind_i32, &size);
+  if (p && size == sizeof(int32_t)) {
+    memcpy(&def, p, sizeof(def));
+  }
+  return def;
+}
+
+/**
+ * Get a float field
+ * @param r Reader
+ * @param id Field id
+ * @param def Value returned if the field does not exist
+ * @return Field value
+ */
+static inline float aviutl2_item_data_get_f32(struct aviutl2_item_data_reader const *r, uint16_t id, float def) {
+  size_t size;
+  void const *p = aviutl2_item_data_find(r, id, aviutl2_item_data_kind_f32, &size);
+  if (p && size == sizeof(float)) {
+    memcpy(&def, p, sizeof(def));
+  }
+  return def;
+}
+
+/**
+ * Get a double field
+ * @param r Reader
+ * @param id Field id
+ * @param def Value returned if the field does not exist
+ * @return Field value
+ */
+static inline double aviutl2_item_data_get_f64(struct aviutl2_item_data_reader const *r, uint16_t id, double def) {
+  size_t size;
+  void const *p = aviutl2_item_data_find(r, id, aviutl2_item_data_kind_f64, &size);
+  if (p && size == sizeof(double)) {
+    memcpy(&def, p, sizeof(def));
+  }
+  return def;
+}
+
+/**
+ * Get a bytes field
+ * @param r Reader
+ * @param id Field id
+ * @param size Pointer to storage for the size in bytes
+ * @return Pointer into the data block, or NULL if the field does not exist
+ */
+static inline void const *
+aviutl2_item_data_get_bytes(struct aviutl2_item_data_reader const *r, uint16_t id, size_t *size) {
+  return aviutl2_item_data_find(r, id, aviutl2_item_data_kind_bytes, size);
+}
+
+/**
+ * Get a float array field without copying
+ * The payload is 4-byte aligned relative to the start of the data block
+ * @param r Reader
+ * @param id Field id
+ * @param num Pointer to storage for the number of elements
+ * @return Pointer into the data block, or NULL if the field does not exist
+ */
+static inline float const *
+aviutl2_item_data_get_f32_array(struct aviutl2_item_data_reader const *r, uint16_t id, size_t *num) {
+  size_t size = 0;
+  void const *p = aviutl2_item_data_find(r, id, aviutl2_item_data_kind_f32_array, &size);
+  *num = p ? size / sizeof(float) : 0;
+  return (float const *)p;
+}
+
+/**
+ * Start iterating over a varint or delta array field
+ * @param r Reader
+ * @param id Field id
+ * @param it Iterator
+ * @return Number of elements (0 if the field does not exist)
+ */
+static inline size_t
+aviutl2_item_data_iter_init(struct aviutl2_item_data_reader const *r, uint16_t id, struct aviutl2_item_data_iter *it) {
+  memset(it, 0, sizeof(*it));
+  size_t size = 0;
+  uint8_t const *p = (uint8_t const *)aviutl2_item_data_find(r, id, aviutl2_item_data_kind_delta_array, &size);
+  it->delta = p != NULL;
+  if (!p) {
+    p = (uint8_t const *)aviutl2_item_data_find(r, id, aviutl2_item_data_kind_varint_array, &size);
+  }
+  if (!p) {
+    return 0;
+  }
+  uint64_t count = 0;
+  uint8_t const *const end = p + size;
+  p = aviutl2_item_data_read_varint(p, end, &count);
+  // Every value takes at least one byte.
+  if (!p || count > (uint64_t)(end - p)) {
+    return 0;
+  }
+  it->p = p;
+  it->end = end;
+  it->remain = (size_t)count;
+  return it->remain;
+}
+
+/**
+ * Get the next value
+ * @param it Iterator
+ * @param value Pointer to storage for the value
+ * @return false at the end of the array or if the data is corrupted
+ */
+static inline bool aviutl2_item_data_iter_next(struct aviutl2_item_data_iter *it, int64_t *value) {
+  if (!it->remain) {
+    return false;
+  }
+  uint64_t v;
+  uint8_t const *p = aviutl2_item_data_read_varint(it->p, it->end, &v);
+  if (!p) {
+    it->remain = 0;
+    return false;
+  }
+  it->p = p;
+  --it->remain;
+  int64_t const d = aviutl2_item_data_unzigzag(v);
+  it->prev = it->delta ? (int64_t)((uint64_t)it->prev + (uint64_t)d) : d;
+  *value = it->prev;
+  return true;
+}
+
+/**
+ * Writer
+ * Holds a complete data block while fields are added
+ */
+struct aviutl2_item_data_writer {
+  uint16_t version;
+  uint16_t field_num;
+  bool overflow; /**< Set when a field did not fit; commit fails */
+  struct aviutl2_item_data_entry entries[aviutl2_item_data_max_fields];
+  size_t payload_size;
+  uint8_t payload[AVIUTL2_ITEM_DATA_MAX_SIZE];
+  uint8_t block[AVIUTL2_ITEM_DATA_MAX_SIZE];
+};
+
+/**
+ * Initialize a writer
+ * @param w Writer
+ * @param version Schema version
+ */
+static inline void aviutl2_item_data_writer_init(struct aviutl2_item_data_writer *w, uint16_t version) {
+  w->version = version;
+  w->field_num = 0;
+  w->overflow = false;
+  w->payload_size = 0;
+}
+
+static inline uint8_t *aviutl2_item_data_writer_begin(struct aviutl2_item_data_writer *w,
+                                                      uint16_t id,
+                                                      enum aviutl2_item_data_kind kind,
+                                                      size_t align,
+                                                      size_t max_size) {
+  size_t const start = (w->payload_size + align - 1) & ~(align - 1);
+  size_t const dir_end = sizeof(struct aviutl2_item_data_header) +
+                         (size_t)(w->field_num + 1) * sizeof(struct aviutl2_item_data_entry);
+  if (w->overflow || w->field_num >= aviutl2_item_data_max_fields ||
+      dir_end + start + max_size > AVIUTL2_ITEM_DATA_MAX_SIZE) {
+    w->overflow = true;
+    return NULL;
+  }
+  memset(w->payload + w->payload_size, 0, start - w->payload_size);
+  w->entries[w->field_num] = (struct aviutl2_item_data_entry){
+      .id = id,
+      .kind = (uint8_t)kind,
+      .offset = (uint16_t)start,
+  };
+  w->payload_size = start;
+  return w->payload + start;
+}
+
+static inline void aviutl2_item_data_writer_end(struct aviutl2_item_data_writer *w, size_t size) {
+  w->entries[w->field_num++].size = (uint16_t)size;
+  w->payload_size += size;
+}
+
+/**
+ * Add a bytes field
+ * @param w Writer
+ * @param id Field id
+ * @param data Data
+ * @param size Size in bytes
+ * @return false if the data block is full
+ */
+static inline bool
+aviutl2_item_data_writer_add_bytes(struct aviutl2_item_data_writer *w, uint16_t id, void const *data, size_t size) {
+  uint8_t *p = aviutl2_item_data_writer_begin(w, id, aviutl2_item_data_kind_bytes, 1, size);
+  if (!p) {
+    return false;
+  }
+  if (size) {
+    memcpy(p, data, size);
+  }
+  aviutl2_item_data_writer_end(w, size);
+  return true;
+}
+
+/**
+ * Add an int32_t field
+ * @param w Writer
+ * @param id Field id
+ * @param value Value
+ * @return false if the data block is full
+ */
+static inline bool aviutl2_item_data_writer_add_i32(struct aviutl2_item_data_writer *w, uint16_t id, int32_t value) {
+  uint8_t *p = aviutl2_item_data_writer_begin(w, id, aviutl2_item_data_kind_i32, 4, sizeof(value));
+  if (!p) {
+    return false;
+  }
+  memcpy(p, &value, sizeof(value));
+  aviutl2_item_data_writer_end(w, sizeof(value));
+  return true;
+}
+
+/**
+ * Add a float field
+ * @param w Writer
+ * @param id Field id
+ * @param value Value
+ * @return false if the data block is full
+ */
+static inline bool aviutl2_item_data_writer_add_f32(struct aviutl2_item_data_writer *w, uint16_t id, float value) {
+  uint8_t *p = aviutl2_item_data_writer_begin(w, id, aviutl2_item_data_kind_f32, 4, sizeof(value));
+  if (!p) {
+    return false;
+  }
+  memcpy(p, &value, sizeof(value));
+  aviutl2_item_data_writer_end(w, sizeof(value));
+  return true;
+}
+
+/**
+ * Add a double field
+ * @param w Writer
+ * @param id Field id
+ * @param value Value
+ * @return false if the data block is full
+ */
+static inline bool aviutl2_item_data_writer_add_f64(struct aviutl2_item_data_writer *w, uint16_t id, double value) {
+  uint8_t *p = aviutl2_item_data_writer_begin(w, id, aviutl2_item_data_kind_f64, 8, sizeof(value));
+  if (!p) {
+    return false;
+  }
+  memcpy(p, &value, sizeof(value));
+  aviutl2_item_data_writer_end(w, sizeof(value));
+  return true;
+}
+
+/**
+ * Add a float array field
+ * @param w Writer
+ * @param id Field id
+ * @param values Values
+ * @param num Number of elements
+ * @return false if the data block is full
+ */
+static inline bool aviutl2_item_data_writer_add_f32_array(struct aviutl2_item_data_writer *w,
+                                                          uint16_t id,
+                                                          float const *values,
+                                                          size_t num) {
+  if (num > AVIUTL2_ITEM_DATA_MAX_SIZE / sizeof(float)) {
+    w->overflow = true;
+    return false;
+  }
+  uint8_t *p = aviutl2_item_data_writer_begin(w, id, aviutl2_item_data_kind_f32_array, 4, num * sizeof(float));
+  if (!p) {
+    return false;
+  }
+  if (num) {
+    memcpy(p, values, num * sizeof(float));
+  }
+  aviutl2_item_data_writer_end(w, num * sizeof(float));
+  return true;
+}
+
+static inline uint8_t *aviutl2_item_data_write_varint(uint8_t *p, uint8_t const *end, uint64_t v) {
+  while (p < end) {
+    if (v < 0x80) {
+      *p++ = (uint8_t)v;
+      return p;
+    }
+    *p++ = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  return NULL;
+}
+
+static inline bool aviutl2_item_data_writer_add_ints(
+    struct aviutl2_item_data_writer *w, uint16_t id, int64_t const *values, size_t num, bool delta) {
+  enum aviutl2_item_data_kind const kind =
+      delta ? aviutl2_item_data_kind_delta_array : aviutl2_item_data_kind_varint_array;
+  uint8_t *const start = aviutl2_item_data_writer_begin(w, id, kind, 1, 0);
+  if (!start) {
+    return false;
+  }
+  uint8_t const *const end = w->payload + AVIUTL2_ITEM_DATA_MAX_SIZE - sizeof(struct aviutl2_item_data_header) -
+                             (size_t)(w->field_num + 1) * sizeof(struct aviutl2_item_data_entry);
+  uint8_t *p = aviutl2_item_data_write_varint(start, end, num);
+  int64_t prev = 0;
+  for (size_t i = 0; p && i < num; ++i) {
+    int64_t const v = delta ? (int64_t)((uint64_t)values[i] - (uint64_t)prev) : values[i];
+    prev = values[i];
+    p = aviutl2_item_data_write_varint(p, end, aviutl2_item_data_zigzag(v));
+  }
+  if (!p) {
+    w->overflow = true;
+    return false;
+  }
+  aviutl2_item_data_writer_end(w, (size_t)(p - start));
+  return true;
+}
+
+/**
+ * Add an integer array stored as varints
+ * Small absolute values take fewer bytes
+ * @param w Writer
+ * @param id Field id
+ * @param values Values
+ * @param num Number of elements
+ * @return false if the data block is full
+ */
+static inline bool aviutl2_item_data_writer_add_varint_array(struct aviutl2_item_data_writer *w,
+                                                             uint16_t id,
+                                                             int64_t const *values,
+                                                             size_t num) {
+  return aviutl2_item_data_writer_add_ints(w, id, values, num, false);
+}
+
+/**
+ * Add an integer array stored as varint differences
+ * Sorted or slowly changing values such as frame numbers take fewer bytes
+ * @param w Writer
+ * @param id Field id
+ * @param values Values
+ * @param num Number of elements
+ * @return false if the data block is full
+ */
+static inline bool aviutl2_item_data_writer_add_delta_array(struct aviutl2_item_data_writer *w,
+                                                            uint16_t id,
+                                                            int64_t const *values,
+                                                            size_t num) {
+  return aviutl2_item_data_writer_add_ints(w, id, values, num, true);
+}
+
+/**
+ * Build the data block
+ * @param w Writer
+ * @param size Pointer to storage for the block size in bytes
+ * @return Pointer to the block (owned by the writer), or NULL if a field did not fit
+ */
+static inline void const *aviutl2_item_data_writer_finish(struct aviutl2_item_data_writer *w, size_t *size) {
+  if (w->overflow) {
+    return NULL;
+  }
+  struct aviutl2_item_data_header const header = {
+      .magic = AVIUTL2_ITEM_DATA_MAGIC,
+      .version = w->version,
+      .field_num = w->field_num,
+  };
+  size_t const dir_size = (size_t)w->field_num * sizeof(struct aviutl2_item_data_entry);
+  size_t const payload_offset = sizeof(header) + dir_size;
+  memcpy(w->block, &header, sizeof(header));
+  struct aviutl2_item_data_entry *entries = (struct aviutl2_item_data_entry *)(w->block + sizeof(header));
+  for (uint16_t i = 0; i < w->field_num; ++i) {
+    entries[i] = w->entries[i];
+    entries[i].offset = (uint16_t)(entries[i].offset + payload_offset);
+  }
+  memcpy(w->block + payload_offset, w->payload, w->payload_size);
+  *size = payload_offset + w->payload_size;
+  return w->block;
+}
+
+/**
+ * Store the data block into a filter item
+ * The item is resized with set_filter_item_data_size() when needed and left untouched if the content is the same
+ * Call from func_proc_video() / func_proc_audio()
+ * @param w Writer
+ * @param item Generic data filter item
+ * @param set_filter_item_data_size set_filter_item_data_size of the filter processing structure
+ * @return false if a field did not fit or resizing failed
+ */
+static inline bool
+aviutl2_item_data_writer_commit(struct aviutl2_item_data_writer *w,
+                                struct aviutl2_filter_item_data *item,
+                                void (*set_filter_item_data_size)(void *filter_item_data, int size)) {
+  size_t size = 0;
+  void const *block = aviutl2_item_data_writer_finish(w, &size);
+  if (!block) {
+    return false;
+  }
+  if (item->size == (int)size && item->value && memcmp(item->value, block, size) == 0) {
+    return true;
+  }
+  if (item->size != (int)size) {
+    set_filter_item_data_size(item, (int)size);
+    if (!item->value) {
+      return false;
+    }
+  }
+  memcpy(item->value, block, size);
+  return true;
+}
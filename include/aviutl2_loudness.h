@@ -0,0 +1,611 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Streaming loudness meter (ITU-R BS.1770-4 / EBU R128)
+//
+// Measures momentary, short-term and integrated loudness, loudness range and true peak from interleaved audio in
+// the layout returned by aviutl2_output_info::func_get_audio(). The meter never allocates; gating uses fixed
+// histograms with 0.01 LU bins, so integrated loudness and loudness range are exact up to the placement of the gate
+// thresholds within one bin. The structure is large (about 200 KB), so allocate it on the heap.
+//
+// Single pass, measuring while encoding:
+//   aviutl2_loudness_init(m, oip->audio_rate, oip->audio_ch);
+//   void *pcm = aviutl2_loudness_get_audio(m, oip, start, length, &readed, 3);
+//   ...
+//   aviutl2_loudness_get_result(m, &result);
+//
+// Two pass, normalizing the output to a target:
+//   aviutl2_loudness_init(m, oip->audio_rate, oip->audio_ch);
+//   aviutl2_loudness_measure_output(m, oip);
+//   aviutl2_loudness_get_result(m, &first);
+//   aviutl2_loudness_reset(m);
+//   m->gain = aviutl2_loudness_normalize_gain(&first, -23.0, -1.0);
+//   then read audio through aviutl2_loudness_get_audio() as in the single pass case; the gain is applied to the
+//   returned buffer and the meter reports the loudness of the normalized output.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "aviutl2_audio_dsp.h"
+#include "aviutl2_output2.h"
+
+enum {
+  aviutl2_loudness_max_channels = 8,
+  aviutl2_loudness_histogram_bins = 8000, /**< 0.01 LU bins from -70 LUFS */
+  aviutl2_loudness_short_term_quarters = 30,
+  aviutl2_loudness_true_peak_phases = 4,
+  aviutl2_loudness_true_peak_taps = 12,
+  aviutl2_loudness_pcm16_chunk = 1024,
+};
+
+/**
+ * Second-order filter coefficients (a0 normalized to 1)
+ */
+struct aviutl2_loudness_biquad {
+  double b0, b1, b2, a1, a2;
+};
+
+/**
+ * Gating histogram
+ */
+struct aviutl2_loudness_histogram {
+  uint32_t count[aviutl2_loudness_histogram_bins];
+  double energy[aviutl2_loudness_histogram_bins];
+};
+
+/**
+ * Loudness measurement
+ * Loudness values are -HUGE_VAL when nothing above the absolute gate has been measured
+ */
+struct aviutl2_loudness_result {
+  double integrated;     /**< Integrated loudness (LUFS) */
+  double range;          /**< Loudness range (LU) */
+  double max_momentary;  /**< Maximum momentary loudness (LUFS) */
+  double max_short_term; /**< Maximum short-term loudness (LUFS) */
+  double true_peak;      /**< Maximum true peak (dBTP) */
+  double sample_peak;    /**< Maximum sample peak (dBFS) */
+  uint64_t sample_num;   /**< Number of measured samples per channel */
+};
+
+/**
+ * Loudness meter
+ * Members other than gain are private; use the aviutl2_loudness_* functions
+ */
+struct aviutl2_loudness_meter {
+  float gain; /**< Gain applied by aviutl2_loudness_get_audio() before metering (1.0 = unchanged) */
+  int sample_rate;
+  int channel_num;
+  int quarter_len;
+  double weight[aviutl2_loudness_max_channels];
+  struct aviutl2_loudness_biquad shelf;
+  struct aviutl2_loudness_biquad highpass;
+  double state[4][aviutl2_loudness_max_channels];
+  double quarter_energy;
+  int quarter_pos;
+  double quarters[aviutl2_loudness_short_term_quarters];
+  uint64_t quarter_num;
+  double max_momentary;
+  double max_short_term;
+  float true_peak_coef[aviutl2_loudness_true_peak_phases][aviutl2_loudness_true_peak_taps];
+  float true_peak_history[aviutl2_loudness_max_channels][aviutl2_loudness_true_peak_taps * 2];
+  int true_peak_pos;
+  float true_peak;
+  float sample_peak;
+  uint64_t sample_num;
+  struct aviutl2_loudness_histogram blocks;
+  struct aviutl2_loudness_histogram short_terms;
+};
+
+static inline double aviutl2_loudness_lufs_(double energy) {
+  return energy > 0.0 ? -0.691 + 10.0 * log10(energy) : -HUGE_VAL;
+}
+
+/**
+ * Clear the measurement, keeping the configuration and gain
+ * @param m Loudness meter
+ */
+static inline void aviutl2_loudness_reset(struct aviutl2_loudness_meter *m) {
+  memset(m->state, 0, sizeof(m->state));
+  m->quarter_energy = 0.0;
+  m->quarter_pos = 0;
+  memset(m->quarters, 0, sizeof(m->quarters));
+  m->quarter_num = 0;
+  m->max_momentary = 0.0;
+  m->max_short_term = 0.0;
+  memset(m->true_peak_history, 0, sizeof(m->true_peak_history));
+  m->true_peak_pos = 0;
+  m->true_peak = 0.f;
+  m->sample_peak = 0.f;
+  m->sample_num = 0;
+  memset(&m->blocks, 0, sizeof(m->blocks));
+  memset(&m->short_terms, 0, sizeof(m->short_terms));
+}
+
+/**
+ * Initialize a loudness meter
+ * Channels follow the WAVE order; with six or more channels the fourth is treated as LFE (excluded) and the fifth and
+ * sixth as surround channels (+1.5 dB).
+ * @param m Loudness meter
+ * @param sample_rate Sampling rate
+ * @param channel_num Number of interleaved channels (1 to aviutl2_loudness_max_channels)
+ * @return true on success
+ */
+static inline bool aviutl2_loudness_init(struct aviutl2_loudness_meter *m, int sample_rate, int channel_num) {
+  if (!m || sample_rate < 8000 || channel_num < 1 || channel_num > aviutl2_loudness_max_channels) {
+    return false;
+  }
+  m->gain = 1.f;
+  m->sample_rate = sample_rate;
+  m->channel_num = channel_num;
+  m->quarter_len = (sample_rate + 5) / 10;
+  for (int c = 0; c < aviutl2_loudness_max_channels; ++c) {
+    double w = c < channel_num ? 1.0 : 0.0;
+    if (channel_num >= 6 && c == 3) {
+      w = 0.0;
+    } else if (channel_num >= 6 && (c == 4 || c == 5)) {
+      w = 1.41;
+    }
+    m->weight[c] = w;
+  }
+
+  // K-weighting coefficients for an arbitrary sampling rate, derived from the 48 kHz filters of BS.1770
+  double const pi = 3.14159265358979323846;
+  double k = tan(pi * 1681.974450955533 / (double)sample_rate);
+  double q = 0.7071752369554196;
+  double const vh = pow(10.0, 3.999843853973347 / 20.0);
+  double const vb = pow(vh, 0.4996667741545416);
+  double a0 = 1.0 + k / q + k * k;
+  m->shelf.b0 = (vh + vb * k / q + k * k) / a0;
+  m->shelf.b1 = 2.0 * (k * k - vh) / a0;
+  m->shelf.b2 = (vh - vb * k / q + k * k) / a0;
+  m->shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+  m->shelf.a2 = (1.0 - k / q + k * k) / a0;
+  k = tan(pi * 38.13547087602444 / (double)sample_rate);
+  q = 0.5003270373238773;
+  a0 = 1.0 + k / q + k * k;
+  m->highpass.b0 = 1.0;
+  m->highpass.b1 = -2.0;
+  m->highpass.b2 = 1.0;
+  m->highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+  m->highpass.a2 = (1.0 - k / q + k * k) / a0;
+
+  // 4x polyphase interpolator: Blackman-windowed sinc, each phase normalized to unity DC gain. Coefficients are
+  // stored oldest sample first to match the history window.
+  int const taps = aviutl2_loudness_true_peak_taps;
+  int const phases = aviutl2_loudness_true_peak_phases;
+  for (int p = 0; p < phases; ++p) {
+    double h[aviutl2_loudness_true_peak_taps];
+    double sum = 0.0;
+    for (int j = 0; j < taps; ++j) {
+      int const n = p + phases * j;
+      double const t = ((double)n - (double)(taps * phases - 1) * 0.5) / (double)phases;
+      double const x = 2.0 * pi * ((double)n + 0.5) / (double)(taps * phases);
+      double const window = 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+      h[j] = (t == 0.0 ? 1.0 : sin(pi * t) / (pi * t)) * window;
+      sum += h[j];
+    }
+    for (int j = 0; j < taps; ++j) {
+      m->true_peak_coef[p][taps - 1 - j] = (float)(h[j] / sum);
+    }
+  }
+  aviutl2_loudness_reset(m);
+  return true;
+}
+
+static inline void aviutl2_loudness_histogram_add_(struct aviutl2_loudness_histogram *h, double energy) {
+  double const lufs = aviutl2_loudness_lufs_(energy);
+  if (lufs < -70.0) {
+    return;
+  }
+  int bin = (int)((lufs + 70.0) * 100.0);
+  if (bin >= aviutl2_loudness_histogram_bins) {
+    bin = aviutl2_loudness_histogram_bins - 1;
+  }
+  ++h->count[bin];
+  h->energy[bin] += energy;
+}
+
+static inline int aviutl2_loudness_histogram_bin_(double lufs) {
+  double const bin = ceil((lufs + 70.0) * 100.0);
+  return bin < 0.0 ? 0 : (bin > (double)aviutl2_loudness_histogram_bins ? aviutl2_loudness_histogram_bins : (int)bin);
+}
+
+static inline void aviutl2_loudness_quarter_done_(struct aviutl2_loudness_meter *m) {
+  // Gating blocks are 400 ms with 75% overlap and short-term windows are 3 s, so both are sums of 100 ms quarters
+  size_t const slot = (size_t)(m->quarter_num % aviutl2_loudness_short_term_quarters);
+  m->quarters[slot] = m->quarter_energy / (double)m->quarter_len;
+  m->quarter_energy = 0.0;
+  m->quarter_pos = 0;
+  ++m->quarter_num;
+  if (m->quarter_num >= 4) {
+    double e = 0.0;
+    for (int i = 0; i < 4; ++i) {
+      e += m->quarters[(size_t)((m->quarter_num - 1 - (uint64_t)i) % aviutl2_loudness_short_term_quarters)];
+    }
+    e *= 0.25;
+    aviutl2_loudness_histogram_add_(&m->blocks, e);
+    if (e > m->max_momentary) {
+      m->max_momentary = e;
+    }
+  }
+  if (m->quarter_num >= aviutl2_loudness_short_term_quarters) {
+    double e = 0.0;
+    for (int i = 0; i < aviutl2_loudness_short_term_quarters; ++i) {
+      e += m->quarters[i];
+    }
+    e /= (double)aviutl2_loudness_short_term_quarters;
+    aviutl2_loudness_histogram_add_(&m->short_terms, e);
+    if (e > m->max_short_term) {
+      m->max_short_term = e;
+    }
+  }
+}
+
+static inline double aviutl2_loudness_filter_(struct aviutl2_loudness_meter *m, float const *x, int frames, int c) {
+  // Filters channel c and c + 1 together and returns their weighted sum of squares. Double precision keeps the
+  // 38 Hz high-pass stable at high sampling rates.
+  int const stride = m->channel_num;
+  bool const pair = c + 1 < stride;
+  struct aviutl2_loudness_biquad const *const s = &m->shelf;
+  struct aviutl2_loudness_biquad const *const h = &m->highpass;
+#if AVIUTL2_HAS_SSE2
+  __m128d const sb0 = _mm_set1_pd(s->b0), sb1 = _mm_set1_pd(s->b1), sb2 = _mm_set1_pd(s->b2);
+  __m128d const sa1 = _mm_set1_pd(s->a1), sa2 = _mm_set1_pd(s->a2);
+  __m128d const ha1 = _mm_set1_pd(h->a1), ha2 = _mm_set1_pd(h->a2), minus_two = _mm_set1_pd(-2.0);
+  __m128d s1 = _mm_loadu_pd(m->state[0] + c), s2 = _mm_loadu_pd(m->state[1] + c);
+  __m128d h1 = _mm_loadu_pd(m->state[2] + c), h2 = _mm_loadu_pd(m->state[3] + c);
+  __m128d acc = _mm_setzero_pd();
+  for (int i = 0; i < frames; ++i) {
+    float const *const p = x + (size_t)i * (size_t)stride + c;
+    __m128d const in = pair ? _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((__m128i const *)(void const *)p)))
+                            : _mm_set_sd((double)p[0]);
+    __m128d const y = _mm_add_pd(_mm_mul_pd(sb0, in), s1);
+    s1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(sb1, in), _mm_mul_pd(sa1, y)), s2);
+    s2 = _mm_sub_pd(_mm_mul_pd(sb2, in), _mm_mul_pd(sa2, y));
+    // Second stage has b = {1, -2, 1}
+    __m128d const z = _mm_add_pd(y, h1);
+    h1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(minus_two, y), _mm_mul_pd(ha1, z)), h2);
+    h2 = _mm_sub_pd(y, _mm_mul_pd(ha2, z));
+    acc = _mm_add_pd(acc, _mm_mul_pd(z, z));
+  }
+  _mm_storeu_pd(m->state[0] + c, s1);
+  _mm_storeu_pd(m->state[1] + c, s2);
+  _mm_storeu_pd(m->state[2] + c, h1);
+  _mm_storeu_pd(m->state[3] + c, h2);
+  double sum[2];
+  _mm_storeu_pd(sum, _mm_mul_pd(acc, _mm_loadu_pd(m->weight + c)));
+  return sum[0] + sum[1];
+#else
+  double result = 0.0;
+  for (int k = c; k < c + (pair ? 2 : 1); ++k) {
+    double s1 = m->state[0][k], s2 = m->state[1][k], h1 = m->state[2][k], h2 = m->state[3][k];
+    double acc = 0.0;
+    for (int i = 0; i < frames; ++i) {
+      double const in = (double)x[(size_t)i * (size_t)stride + (size_t)k];
+      double const y = s->b0 * in + s1;
+      s1 = s->b1 * in - s->a1 * y + s2;
+      s2 = s->b2 * in - s->a2 * y;
+      double const z = y + h1;
+      h1 = -2.0 * y - h->a1 * z + h2;
+      h2 = y - h->a2 * z;
+      acc += z * z;
+    }
+    m->state[0][k] = s1;
+    m->state[1][k] = s2;
+    m->state[2][k] = h1;
+    m->state[3][k] = h2;
+    result += acc * m->weight[k];
+  }
+  return result;
+#endif
+}
+
+static inline void aviutl2_loudness_true_peak_(struct aviutl2_loudness_meter *m, float const *x, int frames) {
+  // The history of each channel is stored twice so that the latest taps are always contiguous
+  int const taps = aviutl2_loudness_true_peak_taps;
+  int const stride = m->channel_num;
+  int pos = m->true_peak_pos;
+  float peak = m->true_peak;
+  float sample_peak = m->sample_peak;
+  for (int c = 0; c < stride; ++c) {
+    float *const hist = m->true_peak_history[c];
+    pos = m->true_peak_pos;
+#if AVIUTL2_HAS_SSE2
+    __m128 const abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vpeak = _mm_setzero_ps();
+#endif
+    for (int i = 0; i < frames; ++i) {
+      float const v = x[(size_t)i * (size_t)stride + (size_t)c];
+      float const a = fabsf(v);
+      sample_peak = a > sample_peak ? a : sample_peak;
+      hist[pos] = v;
+      hist[pos + taps] = v;
+      pos = pos + 1 == taps ? 0 : pos + 1;
+      float const *const w = hist + pos;
+#if AVIUTL2_HAS_SSE2
+      __m128 const w0 = _mm_loadu_ps(w), w1 = _mm_loadu_ps(w + 4), w2 = _mm_loadu_ps(w + 8);
+      __m128 out[aviutl2_loudness_true_peak_phases];
+      for (int p = 0; p < aviutl2_loudness_true_peak_phases; ++p) {
+        float const *const k = m->true_peak_coef[p];
+        out[p] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, _mm_loadu_ps(k)), _mm_mul_ps(w1, _mm_loadu_ps(k + 4))),
+                            _mm_mul_ps(w2, _mm_loadu_ps(k + 8)));
+      }
+      // Transpose so that each lane holds the complete dot product of one phase
+      _MM_TRANSPOSE4_PS(out[0], out[1], out[2], out[3]);
+      __m128 const sum = _mm_add_ps(_mm_add_ps(out[0], out[1]), _mm_add_ps(out[2], out[3]));
+      vpeak = _mm_max_ps(vpeak, _mm_and_ps(sum, abs_mask));
+#else
+      for (int p = 0; p < aviutl2_loudness_true_peak_phases; ++p) {
+        float sum = 0.f;
+        for (int j = 0; j < taps; ++j) {
+          sum += w[j] * m->true_peak_coef[p][j];
+        }
+        sum = fabsf(sum);
+        peak = sum > peak ? sum : peak;
+      }
+#endif
+    }
+#if AVIUTL2_HAS_SSE2
+    float lanes[4];
+    _mm_storeu_ps(lanes, vpeak);
+    for (int i = 0; i < 4; ++i) {
+      peak = lanes[i] > peak ? lanes[i] : peak;
+    }
+#endif
+  }
+  m->true_peak_pos = pos;
+  m->true_peak = peak;
+  m->sample_peak = sample_peak;
+}
+
+/**
+ * Measure interleaved float samples
+ * @param m Loudness meter
+ * @param samples Interleaved samples (m->channel_num per frame)
+ * @param frames Number of frames
+ */
+static inline void aviutl2_loudness_process(struct aviutl2_loudness_meter *m, float const *samples, int frames) {
+  if (frames <= 0) {
+    return;
+  }
+  unsigned const csr = aviutl2_audio_denormals_begin();
+  aviutl2_loudness_true_peak_(m, samples, frames);
+  m->sample_num += (uint64_t)frames;
+  while (frames > 0) {
+    int n = m->quarter_len - m->quarter_pos;
+    if (n > frames) {
+      n = frames;
+    }
+    for (int c = 0; c < m->channel_num; c += 2) {
+      m->quarter_energy += aviutl2_loudness_filter_(m, samples, n, c);
+    }
+    m->quarter_pos += n;
+    if (m->quarter_pos == m->quarter_len) {
+      aviutl2_loudness_quarter_done_(m);
+    }
+    samples += (size_t)n * (size_t)m->channel_num;
+    frames -= n;
+  }
+  aviutl2_audio_denormals_end(csr);
+}
+
+/**
+ * Measure interleaved 16-bit samples
+ * @param m Loudness meter
+ * @param samples Interleaved samples (m->channel_num per frame)
+ * @param frames Number of frames
+ */
+static inline void
+aviutl2_loudness_process_pcm16(struct aviutl2_loudness_meter *m, int16_t const *samples, int frames) {
+  float buf[aviutl2_loudness_pcm16_chunk * aviutl2_loudness_max_channels];
+  int const ch = m->channel_num;
+  while (frames > 0) {
+    int const n = frames < aviutl2_loudness_pcm16_chunk ? frames : aviutl2_loudness_pcm16_chunk;
+    for (int i = 0; i < n * ch; ++i) {
+      buf[i] = (float)samples[i] * (1.f / 32768.f);
+    }
+    aviutl2_loudness_process(m, buf, n);
+    samples += (size_t)n * (size_t)ch;
+    frames -= n;
+  }
+}
+
+/**
+ * Get the current momentary loudness (last 400 ms)
+ * @param m Loudness meter
+ * @return Loudness in LUFS
+ */
+static inline double aviutl2_loudness_momentary(struct aviutl2_loudness_meter const *m) {
+  if (m->quarter_num < 4) {
+    return -HUGE_VAL;
+  }
+  double e = 0.0;
+  for (int i = 0; i < 4; ++i) {
+    e += m->quarters[(size_t)((m->quarter_num - 1 - (uint64_t)i) % aviutl2_loudness_short_term_quarters)];
+  }
+  return aviutl2_loudness_lufs_(e * 0.25);
+}
+
+/**
+ * Get the current short-term loudness (last 3 s)
+ * @param m Loudness meter
+ * @return Loudness in LUFS
+ */
+static inline double aviutl2_loudness_short_term(struct aviutl2_loudness_meter const *m) {
+  if (m->quarter_num < aviutl2_loudness_short_term_quarters) {
+    return -HUGE_VAL;
+  }
+  double e = 0.0;
+  for (int i = 0; i < aviutl2_loudness_short_term_quarters; ++i) {
+    e += m->quarters[i];
+  }
+  return aviutl2_loudness_lufs_(e / (double)aviutl2_loudness_short_term_quarters);
+}
+
+static inline double
+aviutl2_loudness_gated_mean_(struct aviutl2_loudness_histogram const *h, int from, uint64_t *count) {
+  double energy = 0.0;
+  uint64_t n = 0;
+  for (int i = from; i < aviutl2_loudness_histogram_bins; ++i) {
+    energy += h->energy[i];
+    n += h->count[i];
+  }
+  *count = n;
+  return n ? energy / (double)n : 0.0;
+}
+
+/**
+ * Get the measurement so far
+ * @param m Loudness meter
+ * @param result Pointer to storage for the measurement
+ */
+static inline void aviutl2_loudness_get_result(struct aviutl2_loudness_meter const *m,
+                                               struct aviutl2_loudness_result *result) {
+  uint64_t n;
+  // Integrated loudness: absolute gate at -70 LUFS (applied when filling the histogram), then relative gate -10 LU
+  double const absolute = aviutl2_loudness_gated_mean_(&m->blocks, 0, &n);
+  result->integrated = -HUGE_VAL;
+  if (n) {
+    int const from = aviutl2_loudness_histogram_bin_(aviutl2_loudness_lufs_(absolute) - 10.0);
+    double const gated = aviutl2_loudness_gated_mean_(&m->blocks, from, &n);
+    result->integrated = n ? aviutl2_loudness_lufs_(gated) : -HUGE_VAL;
+  }
+
+  // Loudness range (EBU Tech 3342): short-term values above a -20 LU relative gate, 10th to 95th percentile
+  result->range = 0.0;
+  double const st = aviutl2_loudness_gated_mean_(&m->short_terms, 0, &n);
+  if (n) {
+    int const from = aviutl2_loudness_histogram_bin_(aviutl2_loudness_lufs_(st) - 20.0);
+    aviutl2_loudness_gated_mean_(&m->short_terms, from, &n);
+    if (n) {
+      uint64_t const lo_rank = (uint64_t)((double)(n - 1) * 0.10);
+      uint64_t const hi_rank = (uint64_t)((double)(n - 1) * 0.95);
+      uint64_t seen = 0;
+      int lo = -1, hi = -1;
+      for (int i = from; i < aviutl2_loudness_histogram_bins && hi < 0; ++i) {
+        seen += m->short_terms.count[i];
+        if (lo < 0 && seen > lo_rank) {
+          lo = i;
+        }
+        if (seen > hi_rank) {
+          hi = i;
+        }
+      }
+      result->range = (double)(hi - lo) * 0.01;
+    }
+  }
+
+  result->max_momentary = aviutl2_loudness_lufs_(m->max_momentary);
+  result->max_short_term = aviutl2_loudness_lufs_(m->max_short_term);
+  float const tp = m->true_peak > m->sample_peak ? m->true_peak : m->sample_peak;
+  result->true_peak = tp > 0.f ? 20.0 * log10((double)tp) : -HUGE_VAL;
+  result->sample_peak = m->sample_peak > 0.f ? 20.0 * log10((double)m->sample_peak) : -HUGE_VAL;
+  result->sample_num = m->sample_num;
+}
+
+/**
+ * Compute the gain that brings a measurement to a loudness target without exceeding a true peak limit
+ * @param result Measurement of the unprocessed audio
+ * @param target_lufs Target integrated loudness (for example -23.0 for EBU R128 or -14.0 for streaming services)
+ * @param max_true_peak Maximum true peak in dBTP after the gain (for example -1.0)
+ * @return Linear gain (1.0 if the measurement has no gated loudness)
+ */
+static inline float aviutl2_loudness_normalize_gain(struct aviutl2_loudness_result const *result,
+                                                    double target_lufs,
+                                                    double max_true_peak) {
+  if (result->integrated == -HUGE_VAL) {
+    return 1.f;
+  }
+  double db = target_lufs - result->integrated;
+  if (result->true_peak != -HUGE_VAL && result->true_peak + db > max_true_peak) {
+    db = max_true_peak - result->true_peak;
+  }
+  return (float)pow(10.0, db / 20.0);
+}
+
+//--------------------------------
+
+static inline void aviutl2_loudness_apply_gain_(float gain, void *data, size_t n, uint32_t format) {
+  if (format == 3) {
+    float *const p = (float *)data;
+    size_t i = 0;
+#if AVIUTL2_HAS_SSE2
+    __m128 const g = _mm_set1_ps(gain);
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(p + i, _mm_mul_ps(_mm_loadu_ps(p + i), g));
+    }
+#endif
+    for (; i < n; ++i) {
+      p[i] *= gain;
+    }
+  } else if (format == 1) {
+    int16_t *const p = (int16_t *)data;
+    for (size_t i = 0; i < n; ++i) {
+      float const v = (float)p[i] * gain;
+      p[i] = (int16_t)(v >= 32767.f ? 32767 : (v <= -32768.f ? -32768 : (int)lrintf(v)));
+    }
+  }
+}
+
+/**
+ * Read audio through aviutl2_output_info::func_get_audio(), applying m->gain and measuring the result
+ * The gain is applied in place to the buffer returned by the host.
+ * @param m Loudness meter
+ * @param oip Output information
+ * @param start Start sample number
+ * @param length Number of samples to read
+ * @param readed Pointer to store number of samples actually read
+ * @param format Audio format (1 = PCM 16-bit, 3 = PCM float 32-bit)
+ * @return Pointer to data, or NULL on failure
+ */
+static inline void *aviutl2_loudness_get_audio(struct aviutl2_loudness_meter *m,
+                                               struct aviutl2_output_info *oip,
+                                               int start,
+                                               int length,
+                                               int *readed,
+                                               uint32_t format) {
+  int got = 0;
+  void *const data = oip->func_get_audio(start, length, &got, format);
+  if (readed) {
+    *readed = got;
+  }
+  if (!data || got <= 0) {
+    return data;
+  }
+  if (m->gain != 1.f) {
+    aviutl2_loudness_apply_gain_(m->gain, data, (size_t)got * (size_t)m->channel_num, format);
+  }
+  if (format == 3) {
+    aviutl2_loudness_process(m, (float const *)data, got);
+  } else if (format == 1) {
+    aviutl2_loudness_process_pcm16(m, (int16_t const *)data, got);
+  }
+  return data;
+}
+
+/**
+ * Measure the whole output audio (the first pass of two-pass normalization)
+ * m->gain is applied as in aviutl2_loudness_get_audio()
+ * @param m Loudness meter initialized with oip->audio_rate and oip->audio_ch
+ * @param oip Output information
+ * @return false if aborted or the audio could not be read
+ */
+static inline bool aviutl2_loudness_measure_output(struct aviutl2_loudness_meter *m, struct aviutl2_output_info *oip) {
+  int const chunk = oip->audio_rate;
+  for (int start = 0; start < oip->audio_n;) {
+    if (oip->func_is_abort()) {
+      return false;
+    }
+    int const length = oip->audio_n - start < chunk ? oip->audio_n - start : chunk;
+    int got = 0;
+    if (!aviutl2_loudness_get_audio(m, oip, start, length, &got, 3) || got <= 0) {
+      return false;
+    }
+    start += got;
+  }
+  return true;
+}
@@ -0,0 +1,184 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Fast LZ77 block compressor for plugin state.
+// The format is a sequence of (literals, match) pairs similar to LZ4 and is meant for blocks of up to 64 KiB.
+//
+// Each sequence starts with a token byte. The upper 4 bits are the literal length and the lower 4 bits are the
+// match length minus 4. A value of 15 in either field is followed by extra length bytes, each added to it,
+// until a byte other than 255. The literals follow the token, then a 16-bit little endian match offset.
+// The last sequence has literals only and ends the block.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+enum {
+  aviutl2_lz_max_block_size = 65536,
+  aviutl2_lz_min_match = 4,
+  aviutl2_lz_hash_bits = 13,
+};
+
+/**
+ * Get the worst-case compressed size
+ * @param size Source size in bytes
+ * @return Maximum number of bytes aviutl2_lz_compress() can write
+ */
+static inline size_t aviutl2_lz_compress_bound(size_t size) { return size + size / 255 + 16; }
+
+static inline uint8_t *aviutl2_lz_write_length(uint8_t *op, size_t len) {
+  for (; len >= 255; len -= 255) {
+    *op++ = 255;
+  }
+  *op++ = (uint8_t)len;
+  return op;
+}
+
+static inline uint32_t aviutl2_lz_read32(uint8_t const *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/**
+ * Compress a block
+ * @param dst Destination buffer (aviutl2_lz_compress_bound(src_size) bytes or more)
+ * @param src Source data
+ * @param src_size Source size in bytes (aviutl2_lz_max_block_size or less)
+ * @return Compressed size in bytes, or 0 if src_size is too large
+ */
+static inline size_t aviutl2_lz_compress(void *dst, void const *src, size_t src_size) {
+  if (src_size > aviutl2_lz_max_block_size) {
+    return 0;
+  }
+  uint8_t const *const base = (uint8_t const *)src;
+  uint8_t const *const end = base + src_size;
+  uint8_t *op = (uint8_t *)dst;
+  uint8_t const *anchor = base;
+  // Matches never start in the last bytes so that the block always ends with literals.
+  if (src_size > 12) {
+    uint16_t table[1 << aviutl2_lz_hash_bits];
+    memset(table, 0, sizeof(table));
+    uint8_t const *const match_limit = end - 5;
+    uint8_t const *const search_end = end - 12;
+    uint8_t const *ip = base + 1;
+    while (ip < search_end) {
+      uint32_t const seq = aviutl2_lz_read32(ip);
+      uint32_t const h = (seq * 2654435761u) >> (32 - aviutl2_lz_hash_bits);
+      uint8_t const *ref = base + table[h];
+      table[h] = (uint16_t)(ip - base);
+      if (ref >= ip || aviutl2_lz_read32(ref) != seq) {
+        ++ip;
+        continue;
+      }
+      uint8_t const *mp = ip + aviutl2_lz_min_match;
+      uint8_t const *rp = ref + aviutl2_lz_min_match;
+      while (mp < match_limit && *mp == *rp) {
+        ++mp;
+        ++rp;
+      }
+      size_t const lit = (size_t)(ip - anchor);
+      size_t const mlen = (size_t)(mp - ip) - aviutl2_lz_min_match;
+      uint8_t *token = op++;
+      *token = (uint8_t)(((lit < 15 ? lit : 15) << 4) | (mlen < 15 ? mlen : 15));
+      if (lit >= 15) {
+        op = aviutl2_lz_write_length(op, lit - 15);
+      }
+      memcpy(op, anchor, lit);
+      op += lit;
+      size_t const offset = (size_t)(ip - ref);
+      *op++ = (uint8_t)(offset & 0xff);
+      *op++ = (uint8_t)(offset >> 8);
+      if (mlen >= 15) {
+        op = aviutl2_lz_write_length(op, mlen - 15);
+      }
+      ip = mp;
+      anchor = ip;
+      if (ip < search_end) {
+        // Register a position inside the match so that the following data can refer to it.
+        uint8_t const *p = ip - 2;
+        table[(aviutl2_lz_read32(p) * 2654435761u) >> (32 - aviutl2_lz_hash_bits)] = (uint16_t)(p - base);
+      }
+    }
+  }
+  size_t const lit = (size_t)(end - anchor);
+  *op++ = (uint8_t)((lit < 15 ? lit : 15) << 4);
+  if (lit >= 15) {
+    op = aviutl2_lz_write_length(op, lit - 15);
+  }
+  memcpy(op, anchor, lit);
+  op += lit;
+  return (size_t)(op - (uint8_t *)dst);
+}
+
+/**
+ * Decompress a block
+ * Malformed input never reads or writes out of bounds
+ * @param dst Destination buffer
+ * @param dst_size Exact decompressed size in bytes
+ * @param src Compressed data
+ * @param src_size Compressed size in bytes
+ * @return true if the block was decompressed to exactly dst_size bytes
+ */
+static inline bool aviutl2_lz_decompress(void *dst, size_t dst_size, void const *src, size_t src_size) {
+  uint8_t const *ip = (uint8_t const *)src;
+  uint8_t const *const iend = ip + src_size;
+  uint8_t *const obase = (uint8_t *)dst;
+  uint8_t *op = obase;
+  uint8_t *const oend = op + dst_size;
+  while (ip < iend) {
+    uint8_t const token = *ip++;
+    size_t lit = token >> 4;
+    if (lit == 15) {
+      uint8_t b;
+      do {
+        if (ip >= iend) {
+          return false;
+        }
+        b = *ip++;
+        lit += b;
+      } while (b == 255);
+    }
+    if (lit > (size_t)(iend - ip) || lit > (size_t)(oend - op)) {
+      return false;
+    }
+    memcpy(op, ip, lit);
+    ip += lit;
+    op += lit;
+    if (ip == iend) {
+      break;
+    }
+    if (iend - ip < 2) {
+      return false;
+    }
+    size_t const offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    size_t mlen = (token & 15u);
+    if (mlen == 15) {
+      uint8_t b;
+      do {
+        if (ip >= iend) {
+          return false;
+        }
+        b = *ip++;
+        mlen += b;
+      } while (b == 255);
+    }
+    mlen += aviutl2_lz_min_match;
+    if (offset == 0 || offset > (size_t)(op - obase) || mlen > (size_t)(oend - op)) {
+      return false;
+    }
+    uint8_t const *ref = op - offset;
+    if (offset >= mlen) {
+      memcpy(op, ref, mlen);
+      op += mlen;
+    } else {
+      for (size_t i = 0; i < mlen; ++i) {
+        *op++ = ref[i];
+      }
+    }
+  }
+  return op == oend;
+}
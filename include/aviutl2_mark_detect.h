@@ -0,0 +1,709 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Silence and scene cut detection for timeline marks
+//
+// Scans a media file through aviutl2_cache_handle::get_audio_file_data() and get_video_file_cache() without
+// rendering the timeline. Audio is reduced to 20 ms mean-square windows; long runs below a level become silence
+// marks. Each video frame is reduced to a luma histogram and a 32x18 luma thumbnail; a frame whose difference to the
+// previous one stands out from its neighbours becomes a cut mark, which rejects motion and single-frame flashes.
+//
+// The file is split into segments that worker threads take one at a time, and the marks are written in one edit
+// section:
+//   struct aviutl2_mark_detect_params params;
+//   aviutl2_mark_detect_params_default(&params);
+//   params.frame_origin = object_start_frame;
+//   g_job = aviutl2_mark_detect_job_start(g_cache, path, &params);
+//   // from a timer: show aviutl2_mark_detect_job_progress(g_job) until the job is no longer running, then
+//   g_edit->call_edit_section_param(g_job, aviutl2_mark_detect_job_apply);
+//   aviutl2_mark_detect_job_destroy(g_job);
+// Destroying a running job cancels it and waits until every worker has finished its current frame or audio chunk;
+// destroy every job before UninitializePlugin() returns.
+
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_cache2.h"
+#include "aviutl2_filter2.h"
+#include "aviutl2_plugin2.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+#ifndef AVIUTL2_MARK_DETECT_MEMO_SILENCE_BEGIN
+#  define AVIUTL2_MARK_DETECT_MEMO_SILENCE_BEGIN L"silence"
+#endif
+#ifndef AVIUTL2_MARK_DETECT_MEMO_SILENCE_END
+#  define AVIUTL2_MARK_DETECT_MEMO_SILENCE_END L"silence end"
+#endif
+#ifndef AVIUTL2_MARK_DETECT_MEMO_CUT
+#  define AVIUTL2_MARK_DETECT_MEMO_CUT L"cut"
+#endif
+
+enum {
+  aviutl2_mark_detect_thumb_width = 32,
+  aviutl2_mark_detect_thumb_height = 18,
+  aviutl2_mark_detect_rows_per_cell = 4,
+  aviutl2_mark_detect_histogram_bins = 64,
+  aviutl2_mark_detect_cut_neighbors = 4,
+  aviutl2_mark_detect_windows_per_second = 50,
+  aviutl2_mark_detect_video_segment = 240,
+  aviutl2_mark_detect_audio_segment_seconds = 60,
+  aviutl2_mark_detect_read_chunk = 65536,
+  aviutl2_mark_detect_max_threads = 64,
+};
+
+/**
+ * Kind of detected mark
+ */
+enum aviutl2_mark_detect_kind {
+  aviutl2_mark_detect_kind_silence_begin = 0, /**< First silent moment of a silence */
+  aviutl2_mark_detect_kind_silence_end = 1,   /**< First moment with sound after a silence */
+  aviutl2_mark_detect_kind_cut = 2,           /**< First frame of a new shot */
+};
+
+/**
+ * Detected mark
+ */
+struct aviutl2_mark_detect_mark {
+  double time;                        /**< Position in seconds from the beginning of the file */
+  enum aviutl2_mark_detect_kind kind; /**< Kind of mark */
+};
+
+/**
+ * Detection settings
+ */
+struct aviutl2_mark_detect_params {
+  float silence_db;      /**< Level below which audio is silent (dBFS RMS) */
+  float silence_seconds; /**< Shortest silence that is marked (0 disables silence detection) */
+  float cut_threshold;   /**< Frame difference that can be a cut (0.0 to 1.0, 0 disables cut detection) */
+  int track;             /**< Audio and video track number */
+  int frame_origin;      /**< Timeline frame where the beginning of the file is placed */
+  int thread_num;        /**< Number of worker threads (0 uses one per processor) */
+};
+
+/**
+ * Fill detection settings with defaults
+ * @param params Settings
+ */
+static inline void aviutl2_mark_detect_params_default(struct aviutl2_mark_detect_params *params) {
+  params->silence_db = -50.f;
+  params->silence_seconds = 1.f;
+  params->cut_threshold = 0.3f;
+  params->track = 0;
+  params->frame_origin = 0;
+  params->thread_num = 0;
+}
+
+//--------------------------------
+
+/**
+ * Mean square of stereo or mono audio
+ * @param left Left channel (or the only channel)
+ * @param right Right channel (NULL for mono)
+ * @param sample_num Number of samples per channel
+ * @return Mean of the squared samples over all channels
+ */
+static inline double aviutl2_mark_detect_power(float const *left, float const *right, int sample_num) {
+  if (sample_num <= 0) {
+    return 0.0;
+  }
+  double sum = 0.0;
+  int const channel_num = right ? 2 : 1;
+  for (int c = 0; c < channel_num; ++c) {
+    float const *const src = c ? right : left;
+    int i = 0;
+#if AVIUTL2_HAS_SSE2
+    // Float accumulators are flushed into the double sum every 4096 samples to keep the rounding error small
+    while (i + 16 <= sample_num) {
+      int const end = i + 4096 < sample_num ? i + 4096 : sample_num;
+      __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+      for (; i + 16 <= end; i += 16) {
+        __m128 const x0 = _mm_loadu_ps(src + i), x1 = _mm_loadu_ps(src + i + 4);
+        __m128 const x2 = _mm_loadu_ps(src + i + 8), x3 = _mm_loadu_ps(src + i + 12);
+        a0 = _mm_add_ps(a0, _mm_mul_ps(x0, x0));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(x1, x1));
+        a2 = _mm_add_ps(a2, _mm_mul_ps(x2, x2));
+        a3 = _mm_add_ps(a3, _mm_mul_ps(x3, x3));
+      }
+      float lane[4];
+      _mm_storeu_ps(lane, _mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3)));
+      sum += (double)lane[0] + (double)lane[1] + (double)lane[2] + (double)lane[3];
+    }
+#endif
+    for (; i < sample_num; ++i) {
+      sum += (double)src[i] * (double)src[i];
+    }
+  }
+  return sum / ((double)sample_num * (double)channel_num);
+}
+
+/**
+ * Reduced representation of a video frame
+ */
+struct aviutl2_mark_detect_signature {
+  uint32_t histogram[aviutl2_mark_detect_histogram_bins]; /**< Luma histogram of the sampled pixels */
+  uint32_t pixel_num;                                     /**< Number of sampled pixels */
+  uint8_t thumb[aviutl2_mark_detect_thumb_width * aviutl2_mark_detect_thumb_height]; /**< Mean luma per cell */
+};
+
+/**
+ * Convert one row of 8-bit RGBA, BGRA or BGRX pixels to luma
+ * red and blue give the byte offsets of the red and blue channels (0 and 2, or 2 and 0)
+ */
+static inline void aviutl2_mark_detect_luma_row32_(uint8_t *dst, uint8_t const *src, int width, int red, int blue) {
+  int x = 0;
+#if AVIUTL2_HAS_SSE2
+  int16_t const wr = 77, wg = 150, wb = 29;
+  __m128i const w =
+      red == 0 ? _mm_setr_epi16(wr, wg, wb, 0, wr, wg, wb, 0) : _mm_setr_epi16(wb, wg, wr, 0, wb, wg, wr, 0);
+  __m128i const zero = _mm_setzero_si128();
+  for (; x + 8 <= width; x += 8) {
+    __m128i y[2];
+    for (int h = 0; h < 2; ++h) {
+      __m128i const px = _mm_loadu_si128((__m128i const *)(void const *)(src + (size_t)(x + h * 4) * 4));
+      __m128 const lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(px, zero), w));
+      __m128 const hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(px, zero), w));
+      __m128i const even = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+      __m128i const odd = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+      y[h] = _mm_srli_epi32(_mm_add_epi32(even, odd), 8);
+    }
+    __m128i const y16 = _mm_packs_epi32(y[0], y[1]);
+    _mm_storel_epi64((__m128i *)(void *)(dst + x), _mm_packus_epi16(y16, y16));
+  }
+#endif
+  for (; x < width; ++x) {
+    uint8_t const *const p = src + (size_t)x * 4;
+    dst[x] = (uint8_t)((p[red] * 77 + p[1] * 150 + p[blue] * 29) >> 8);
+  }
+}
+
+/**
+ * Compute the signature of a video frame
+ * Supports the 8-bit RGB formats, YUY2 and PA64; other formats are reported as unsupported.
+ * @param sig Destination
+ * @param image Image from aviutl2_cache_handle::get_video_file_cache()
+ * @param row Work area (image->width bytes)
+ * @return false if the image is unavailable or its format is not supported
+ */
+static inline bool aviutl2_mark_detect_signature(struct aviutl2_mark_detect_signature *sig,
+                                                 struct aviutl2_cache_file_image const *image,
+                                                 uint8_t *row) {
+  if (!aviutl2_cache_file_image_available(image) || image->width < aviutl2_mark_detect_thumb_width ||
+      image->height < aviutl2_mark_detect_thumb_height) {
+    return false;
+  }
+  int const format = image->format;
+  if (format != aviutl2_input_pixel_format_rgba && format != aviutl2_input_pixel_format_bgra &&
+      format != aviutl2_input_pixel_format_bgr && format != aviutl2_input_pixel_format_yuy2 &&
+      format != aviutl2_input_pixel_format_pa64) {
+    return false;
+  }
+  int const width = image->width, height = image->height;
+  int const tw = aviutl2_mark_detect_thumb_width, th = aviutl2_mark_detect_thumb_height;
+  int const rows = aviutl2_mark_detect_rows_per_cell;
+  memset(sig, 0, sizeof(*sig));
+  for (int cy = 0; cy < th; ++cy) {
+    uint32_t cell[aviutl2_mark_detect_thumb_width] = {0};
+    int const y0 = (int)((int64_t)cy * height / th), y1 = (int)((int64_t)(cy + 1) * height / th);
+    for (int r = 0; r < rows; ++r) {
+      int const y = y0 + (int)((int64_t)(2 * r + 1) * (y1 - y0) / (2 * rows));
+      uint8_t const *const src = (uint8_t const *)image->buffer + (size_t)y * (size_t)image->pitch;
+      if (format == aviutl2_input_pixel_format_rgba) {
+        aviutl2_mark_detect_luma_row32_(row, src, width, 0, 2);
+      } else if (format == aviutl2_input_pixel_format_yuy2) {
+        for (int x = 0; x < width; ++x) {
+          row[x] = src[x * 2];
+        }
+      } else if (format == aviutl2_input_pixel_format_pa64) {
+        for (int x = 0; x < width; ++x) {
+          uint8_t const *const p = src + (size_t)x * 8;
+          row[x] = (uint8_t)((p[1] * 77 + p[3] * 150 + p[5] * 29) >> 8);
+        }
+      } else {
+        aviutl2_mark_detect_luma_row32_(row, src, width, 2, 0);
+      }
+      for (int cx = 0; cx < tw; ++cx) {
+        int const x1 = (int)((int64_t)(cx + 1) * width / tw);
+        uint32_t sum = 0;
+        for (int x = (int)((int64_t)cx * width / tw); x < x1; ++x) {
+          sum += row[x];
+          ++sig->histogram[row[x] >> 2];
+        }
+        cell[cx] += sum;
+      }
+    }
+    for (int cx = 0; cx < tw; ++cx) {
+      uint32_t const n = (uint32_t)(((int64_t)(cx + 1) * width / tw - (int64_t)cx * width / tw) * rows);
+      sig->thumb[cy * tw + cx] = (uint8_t)((cell[cx] + n / 2) / n);
+    }
+  }
+  sig->pixel_num = (uint32_t)(width * rows * th);
+  return true;
+}
+
+/**
+ * Difference between two frames
+ * The geometric mean of the histogram distance and the thumbnail difference; a cut changes both, while motion
+ * mostly changes the thumbnail and gradual lighting changes mostly change the histogram.
+ * @param a Signature of the earlier frame
+ * @param b Signature of the later frame
+ * @return Difference from 0.0 (identical) to 1.0
+ */
+static inline float aviutl2_mark_detect_difference(struct aviutl2_mark_detect_signature const *a,
+                                                   struct aviutl2_mark_detect_signature const *b) {
+  double hist = 0.0;
+  double const sa = 1.0 / (double)a->pixel_num, sb = 1.0 / (double)b->pixel_num;
+  for (int i = 0; i < aviutl2_mark_detect_histogram_bins; ++i) {
+    hist += fabs((double)a->histogram[i] * sa - (double)b->histogram[i] * sb);
+  }
+  hist *= 0.5;
+  uint32_t sad = 0;
+  int const n = aviutl2_mark_detect_thumb_width * aviutl2_mark_detect_thumb_height;
+  int i = 0;
+#if AVIUTL2_HAS_SSE2
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 16 <= n; i += 16) {
+    acc = _mm_add_epi64(acc,
+                        _mm_sad_epu8(_mm_loadu_si128((__m128i const *)(void const *)(a->thumb + i)),
+                                     _mm_loadu_si128((__m128i const *)(void const *)(b->thumb + i))));
+  }
+  sad = (uint32_t)(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#endif
+  for (; i < n; ++i) {
+    sad += (uint32_t)abs((int)a->thumb[i] - (int)b->thumb[i]);
+  }
+  // A mean change of a quarter of the luma range counts as a complete change of the picture
+  double thumb = (double)sad / ((double)n * 255.0) * 4.0;
+  if (thumb > 1.0) {
+    thumb = 1.0;
+  }
+  return (float)sqrt(hist * thumb);
+}
+
+//--------------------------------
+
+/**
+ * State of a background detection job
+ */
+enum aviutl2_mark_detect_state {
+  aviutl2_mark_detect_state_running = 0, /**< Still scanning */
+  aviutl2_mark_detect_state_done = 1,    /**< Result is available (it may be empty) */
+  aviutl2_mark_detect_state_failed = 2,  /**< File could not be read or memory ran out */
+};
+
+/**
+ * Background detection job for a media file
+ */
+struct aviutl2_mark_detect_job {
+  struct aviutl2_cache_handle *cache;
+  struct aviutl2_mark_detect_params params;
+  HANDLE thread;
+  LONG cancelled;
+  LONG state;
+  LONG task_next;
+  LONG task_done;
+  LONG failed;
+  int task_num;
+  int video_task_num;
+  int frame_num;
+  double frame_rate;
+  int64_t sample_num;
+  int sample_rate;
+  int window;
+  int window_num;
+  int window_per_task;
+  float *score;
+  float *power;
+  struct aviutl2_mark_detect_mark *marks;
+  int mark_num;
+  wchar_t path[1];
+};
+
+static inline bool aviutl2_mark_detect_video_task_(struct aviutl2_mark_detect_job *job, int task, uint8_t *row) {
+  int const begin = task * aviutl2_mark_detect_video_segment;
+  int const end = job->frame_num - begin > aviutl2_mark_detect_video_segment
+                      ? begin + aviutl2_mark_detect_video_segment
+                      : job->frame_num;
+  struct aviutl2_mark_detect_signature sig[2];
+  bool valid[2] = {false, false};
+  // Each segment also reads the last frame of the previous one so that its first difference is available
+  for (int frame = begin > 0 ? begin - 1 : 0; frame < end; ++frame) {
+    if (job->cancelled) {
+      return false;
+    }
+    int const cur = frame & 1;
+    struct aviutl2_cache_file_image image = job->cache->get_video_file_cache(job->path, job->params.track, frame);
+    valid[cur] =
+        image.width <= aviutl2_mark_detect_read_chunk * 8 && aviutl2_mark_detect_signature(&sig[cur], &image, row);
+    aviutl2_cache_file_image_release(&image);
+    if (frame >= begin) {
+      bool const pair = frame > 0 && valid[cur] && valid[cur ^ 1];
+      job->score[frame] = pair ? aviutl2_mark_detect_difference(&sig[cur ^ 1], &sig[cur]) : 0.f;
+    }
+  }
+  return true;
+}
+
+static inline bool aviutl2_mark_detect_audio_task_(struct aviutl2_mark_detect_job *job, int task, float *buf) {
+  int const begin = task * job->window_per_task;
+  int const end = begin + job->window_per_task < job->window_num ? begin + job->window_per_task : job->window_num;
+  int const window = job->window;
+  int const chunk_windows = aviutl2_mark_detect_read_chunk / window;
+  for (int w = begin; w < end;) {
+    if (job->cancelled) {
+      return false;
+    }
+    int const wn = end - w < chunk_windows ? end - w : chunk_windows;
+    int64_t const pos = (int64_t)w * window;
+    int64_t const rest = job->sample_num - pos;
+    int const n = rest < (int64_t)wn * window ? (int)rest : wn * window;
+    int const got = job->cache->get_audio_file_data(
+        job->path, job->params.track, pos, n, buf, buf + aviutl2_mark_detect_read_chunk);
+    if (got <= 0) {
+      // Unreadable audio is left as silence-free so that it never produces marks
+      for (int i = w; i < end; ++i) {
+        job->power[i] = 1.f;
+      }
+      return true;
+    }
+    for (int i = 0; i < wn; ++i) {
+      int const offset = i * window;
+      int const len = got - offset < window ? got - offset : window;
+      job->power[w + i] =
+          len > 0 ? (float)aviutl2_mark_detect_power(buf + offset, buf + aviutl2_mark_detect_read_chunk + offset, len)
+                  : 1.f;
+    }
+    w += wn;
+  }
+  return true;
+}
+
+static inline DWORD WINAPI aviutl2_mark_detect_worker_proc(void *param) {
+  struct aviutl2_mark_detect_job *job = (struct aviutl2_mark_detect_job *)param;
+  void *const work = malloc((size_t)aviutl2_mark_detect_read_chunk * 2 * sizeof(float));
+  if (!work) {
+    InterlockedExchange(&job->failed, 1);
+    return 0;
+  }
+  for (;;) {
+    LONG const task = InterlockedIncrement(&job->task_next) - 1;
+    if (task >= job->task_num) {
+      break;
+    }
+    // The audio read buffer doubles as the luma row buffer of video tasks
+    bool const ok = task < job->video_task_num
+                        ? aviutl2_mark_detect_video_task_(job, (int)task, (uint8_t *)work)
+                        : aviutl2_mark_detect_audio_task_(job, (int)task - job->video_task_num, (float *)work);
+    if (!ok) {
+      InterlockedExchange(&job->failed, 1);
+      break;
+    }
+    InterlockedIncrement(&job->task_done);
+  }
+  free(work);
+  return 0;
+}
+
+static inline int aviutl2_mark_detect_collect_(struct aviutl2_mark_detect_job const *job,
+                                               struct aviutl2_mark_detect_mark *marks) {
+  int num = 0;
+  if (job->score) {
+    float const threshold = job->params.cut_threshold;
+    int const neighbors = aviutl2_mark_detect_cut_neighbors;
+    for (int f = 1; f < job->frame_num; ++f) {
+      float const s = job->score[f];
+      if (s < threshold) {
+        continue;
+      }
+      // A cut is a lone peak; motion and flashes raise the neighbouring differences as well
+      float peak = 0.f;
+      for (int k = f > neighbors ? f - neighbors : 1; k <= f + neighbors && k < job->frame_num; ++k) {
+        if (k != f && job->score[k] > peak) {
+          peak = job->score[k];
+        }
+      }
+      if (s < peak * 2.f) {
+        continue;
+      }
+      if (marks) {
+        marks[num].time = (double)f / job->frame_rate;
+        marks[num].kind = aviutl2_mark_detect_kind_cut;
+      }
+      ++num;
+    }
+  }
+  if (job->power) {
+    float const limit = (float)pow(10.0, job->params.silence_db / 10.0);
+    double const seconds_per_window = (double)job->window / (double)job->sample_rate;
+    int const min_windows = (int)ceil(job->params.silence_seconds / seconds_per_window);
+    int begin = -1;
+    for (int w = 0; w <= job->window_num; ++w) {
+      bool const silent = w < job->window_num && job->power[w] < limit;
+      if (silent) {
+        if (begin < 0) {
+          begin = w;
+        }
+        continue;
+      }
+      if (begin >= 0 && w - begin >= min_windows) {
+        if (begin > 0) {
+          if (marks) {
+            marks[num].time = (double)begin * seconds_per_window;
+            marks[num].kind = aviutl2_mark_detect_kind_silence_begin;
+          }
+          ++num;
+        }
+        if (w < job->window_num) {
+          if (marks) {
+            marks[num].time = (double)w * seconds_per_window;
+            marks[num].kind = aviutl2_mark_detect_kind_silence_end;
+          }
+          ++num;
+        }
+      }
+      begin = -1;
+    }
+  }
+  return num;
+}
+
+static inline int aviutl2_mark_detect_compare_mark_(void const *a, void const *b) {
+  struct aviutl2_mark_detect_mark const *const x = (struct aviutl2_mark_detect_mark const *)a;
+  struct aviutl2_mark_detect_mark const *const y = (struct aviutl2_mark_detect_mark const *)b;
+  return x->time < y->time ? -1 : x->time > y->time ? 1 : (int)x->kind - (int)y->kind;
+}
+
+static inline bool aviutl2_mark_detect_job_prepare_(struct aviutl2_mark_detect_job *job) {
+  struct aviutl2_cache_handle *const cache = job->cache;
+  struct aviutl2_video_info vi = {0};
+  if (job->params.cut_threshold > 0.f && cache->get_video_file_info(job->path, &vi, (int)sizeof(vi)) &&
+      vi.frame_num > 1 && vi.rate > 0 && vi.scale > 0) {
+    job->score = (float *)calloc((size_t)vi.frame_num, sizeof(float));
+    if (!job->score) {
+      return false;
+    }
+    job->frame_num = vi.frame_num;
+    job->frame_rate = (double)vi.rate / (double)vi.scale;
+    job->video_task_num = (vi.frame_num + aviutl2_mark_detect_video_segment - 1) / aviutl2_mark_detect_video_segment;
+  }
+  struct aviutl2_audio_info ai = {0};
+  int audio_task_num = 0;
+  if (job->params.silence_seconds > 0.f && cache->get_audio_file_info(job->path, &ai, (int)sizeof(ai)) &&
+      ai.sample_num > 0 && ai.rate >= aviutl2_mark_detect_windows_per_second) {
+    job->sample_rate = ai.rate;
+    job->sample_num = ai.sample_num;
+    job->window = ai.rate / aviutl2_mark_detect_windows_per_second;
+    int64_t const window_num = (ai.sample_num + job->window - 1) / job->window;
+    if (window_num > INT_MAX) {
+      return false;
+    }
+    job->window_num = (int)window_num;
+    job->window_per_task = aviutl2_mark_detect_windows_per_second * aviutl2_mark_detect_audio_segment_seconds;
+    job->power = (float *)malloc((size_t)job->window_num * sizeof(float));
+    if (!job->power) {
+      return false;
+    }
+    audio_task_num = (job->window_num + job->window_per_task - 1) / job->window_per_task;
+  }
+  job->task_num = job->video_task_num + audio_task_num;
+  return job->score || job->power;
+}
+
+static inline bool aviutl2_mark_detect_job_run_(struct aviutl2_mark_detect_job *job) {
+  if (!aviutl2_mark_detect_job_prepare_(job)) {
+    return false;
+  }
+  int thread_num = job->params.thread_num;
+  if (thread_num <= 0) {
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    thread_num = (int)si.dwNumberOfProcessors;
+  }
+  if (thread_num > aviutl2_mark_detect_max_threads) {
+    thread_num = aviutl2_mark_detect_max_threads;
+  }
+  if (thread_num > job->task_num) {
+    thread_num = job->task_num;
+  }
+  HANDLE threads[aviutl2_mark_detect_max_threads];
+  int started = 0;
+  while (started < thread_num) {
+    HANDLE const thread = CreateThread(NULL, 0, aviutl2_mark_detect_worker_proc, job, 0, NULL);
+    if (!thread) {
+      break;
+    }
+    threads[started++] = thread;
+  }
+  if (started == 0) {
+    aviutl2_mark_detect_worker_proc(job);
+  }
+  for (int i = 0; i < started; ++i) {
+    WaitForSingleObject(threads[i], INFINITE);
+    CloseHandle(threads[i]);
+  }
+  if (job->failed || job->cancelled) {
+    return false;
+  }
+  int const num = aviutl2_mark_detect_collect_(job, NULL);
+  if (num > 0) {
+    job->marks = (struct aviutl2_mark_detect_mark *)malloc((size_t)num * sizeof(struct aviutl2_mark_detect_mark));
+    if (!job->marks) {
+      return false;
+    }
+    aviutl2_mark_detect_collect_(job, job->marks);
+    qsort(job->marks, (size_t)num, sizeof(struct aviutl2_mark_detect_mark), aviutl2_mark_detect_compare_mark_);
+  }
+  job->mark_num = num;
+  return true;
+}
+
+static inline DWORD WINAPI aviutl2_mark_detect_job_proc(void *param) {
+  struct aviutl2_mark_detect_job *job = (struct aviutl2_mark_detect_job *)param;
+  bool const ok = aviutl2_mark_detect_job_run_(job);
+  // The interlocked store orders the result before the state change
+  InterlockedExchange(&job->state, ok ? aviutl2_mark_detect_state_done : aviutl2_mark_detect_state_failed);
+  return 0;
+}
+
+/**
+ * Start detecting silences and cuts of a media file on background threads
+ * @param cache Cache handle passed to InitializeCache()
+ * @param path Path to media file
+ * @param params Detection settings (see aviutl2_mark_detect_params_default())
+ * @return Job, or NULL if it could not be started
+ */
+static inline struct aviutl2_mark_detect_job *aviutl2_mark_detect_job_start(
+    struct aviutl2_cache_handle *cache, wchar_t const *path, struct aviutl2_mark_detect_params const *params) {
+  if (!cache || !path || !path[0] || !params) {
+    return NULL;
+  }
+  size_t const len = wcslen(path);
+  struct aviutl2_mark_detect_job *job =
+      (struct aviutl2_mark_detect_job *)calloc(1, sizeof(*job) + len * sizeof(wchar_t));
+  if (!job) {
+    return NULL;
+  }
+  memcpy(job->path, path, (len + 1) * sizeof(wchar_t));
+  job->cache = cache;
+  job->params = *params;
+  job->thread = CreateThread(NULL, 0, aviutl2_mark_detect_job_proc, job, 0, NULL);
+  if (!job->thread) {
+    free(job);
+    return NULL;
+  }
+  return job;
+}
+
+/**
+ * Get the state of a job
+ * @param job Job
+ * @return State
+ */
+static inline enum aviutl2_mark_detect_state aviutl2_mark_detect_job_state(struct aviutl2_mark_detect_job *job) {
+  return (enum aviutl2_mark_detect_state)InterlockedCompareExchange(&job->state, 0, 0);
+}
+
+/**
+ * Get the progress of a job
+ * @param job Job
+ * @return Fraction of the file segments scanned so far (0.0 to 1.0)
+ */
+static inline float aviutl2_mark_detect_job_progress(struct aviutl2_mark_detect_job *job) {
+  if (aviutl2_mark_detect_job_state(job) != aviutl2_mark_detect_state_running) {
+    return 1.f;
+  }
+  LONG const done = InterlockedCompareExchange(&job->task_done, 0, 0);
+  return job->task_num > 0 ? (float)done / (float)job->task_num : 0.f;
+}
+
+/**
+ * Get the detected marks
+ * @param job Job
+ * @param marks Destination, in time order (may be NULL)
+ * @param mark_num Number of marks that can be stored
+ * @return Number of detected marks, or 0 if the job has not finished successfully
+ */
+static inline int aviutl2_mark_detect_job_result(struct aviutl2_mark_detect_job *job,
+                                                 struct aviutl2_mark_detect_mark *marks,
+                                                 int mark_num) {
+  if (aviutl2_mark_detect_job_state(job) != aviutl2_mark_detect_state_done) {
+    return 0;
+  }
+  if (marks) {
+    memcpy(marks,
+           job->marks,
+           (size_t)(mark_num < job->mark_num ? mark_num : job->mark_num) * sizeof(struct aviutl2_mark_detect_mark));
+  }
+  return job->mark_num;
+}
+
+/**
+ * Write the detected marks to the timeline
+ * Pass to aviutl2_edit_handle::call_edit_section_param() with the job as param so that all marks are set in one
+ * edit section. Positions are converted with the scene frame rate and params.frame_origin; existing marks at the
+ * same frames get the new memo.
+ * @param param Job
+ * @param edit Edit section
+ */
+static inline void aviutl2_mark_detect_job_apply(void *param, struct aviutl2_edit_section *edit) {
+  struct aviutl2_mark_detect_job *job = (struct aviutl2_mark_detect_job *)param;
+  if (aviutl2_mark_detect_job_state(job) != aviutl2_mark_detect_state_done || !edit->info || edit->info->scale <= 0) {
+    return;
+  }
+  double const fps = (double)edit->info->rate / (double)edit->info->scale;
+  for (int i = 0; i < job->mark_num; ++i) {
+    int const frame = job->params.frame_origin + (int)floor(job->marks[i].time * fps + 0.5);
+    if (frame < 0) {
+      continue;
+    }
+    wchar_t const *memo = AVIUTL2_MARK_DETECT_MEMO_CUT;
+    if (job->marks[i].kind == aviutl2_mark_detect_kind_silence_begin) {
+      memo = AVIUTL2_MARK_DETECT_MEMO_SILENCE_BEGIN;
+    } else if (job->marks[i].kind == aviutl2_mark_detect_kind_silence_end) {
+      memo = AVIUTL2_MARK_DETECT_MEMO_SILENCE_END;
+    }
+    edit->set_mark_frame(frame, memo);
+  }
+}
+
+/**
+ * Destroy a job
+ * A running job is cancelled and this waits until all of its threads have exited, so the cache handle is no longer
+ * used afterwards. Call this for every job before UninitializePlugin() returns.
+ * @param job Job (may be NULL)
+ */
+static inline void aviutl2_mark_detect_job_destroy(struct aviutl2_mark_detect_job *job) {
+  if (!job) {
+    return;
+  }
+  InterlockedExchange(&job->cancelled, 1);
+  // The coordinator thread joins the workers before it exits
+  WaitForSingleObject(job->thread, INFINITE);
+  CloseHandle(job->thread);
+  free(job->score);
+  free(job->power);
+  free(job->marks);
+  free(job);
+}
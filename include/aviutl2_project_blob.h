@@ -0,0 +1,314 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Large binary state persistence on aviutl2_project_file
+//
+// set_param_binary() accepts at most 4096 bytes per key. aviutl2_project_blob_save() splits the data into
+// 64 KiB blocks, compresses each block with aviutl2_lz.h and stores the result across numbered keys:
+//   "<name>"                 struct aviutl2_project_blob_header
+//   "<name>.0", "<name>.1"... Block index followed by block data, 4096 bytes per key (the last one may be shorter)
+//
+// Project data is only accessible inside the load callback, so aviutl2_project_blob_load() copies the compressed
+// stream there. Blocks are decompressed and verified on first access, so a plugin that only needs part of its
+// state does not pay for the rest.
+//
+// A blob is not thread-safe; protect it with a lock if it is accessed from multiple threads.
+//
+// Keys left over from a previous larger save are not removed because aviutl2_project_file can only clear all
+// parameters at once. They are ignored when loading.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aviutl2_hash.h"
+#include "aviutl2_lz.h"
+#include "aviutl2_plugin2.h"
+
+#define AVIUTL2_PROJECT_BLOB_MAGIC 0x424c4241 /**< "ABLB" */
+#define AVIUTL2_PROJECT_BLOB_VERSION 1
+
+enum {
+  aviutl2_project_blob_block_size = aviutl2_lz_max_block_size,
+  aviutl2_project_blob_chunk_size = 4096,
+  aviutl2_project_blob_max_key = 256,
+};
+
+/**
+ * Blob header stored under the blob name
+ */
+struct aviutl2_project_blob_header {
+  uint32_t magic;       /**< AVIUTL2_PROJECT_BLOB_MAGIC */
+  uint32_t version;     /**< AVIUTL2_PROJECT_BLOB_VERSION */
+  uint64_t size;        /**< Uncompressed data size in bytes */
+  uint64_t stream_size; /**< Size of the block index and block data in bytes */
+  uint32_t block_size;  /**< Uncompressed block size in bytes */
+  uint32_t block_num;   /**< Number of blocks */
+  uint32_t index_crc;   /**< CRC-32 of the block index */
+  uint32_t reserved;
+};
+
+/**
+ * Block index entry
+ */
+struct aviutl2_project_blob_block {
+  uint32_t offset;      /**< Offset of the block data from the start of the stream */
+  uint32_t packed_size; /**< Size of the block data; the top bit is set if the block is stored uncompressed */
+  uint32_t crc;         /**< CRC-32 of the uncompressed block */
+};
+
+#define AVIUTL2_PROJECT_BLOB_STORED 0x80000000u
+
+/**
+ * Loaded blob
+ * Initialize with {0} and release with aviutl2_project_blob_free()
+ */
+struct aviutl2_project_blob {
+  uint8_t *stream;
+  size_t stream_size;
+  size_t size;
+  uint32_t block_size;
+  uint32_t block_num;
+  uint8_t **blocks; /**< Decompressed blocks (NULL until accessed) */
+};
+
+static inline void aviutl2_project_blob_key(char *key, char const *name, size_t chunk) {
+  snprintf(key, aviutl2_project_blob_max_key, "%s.%zu", name, chunk);
+}
+
+/**
+ * Save data to the project
+ * Call from the project save handler
+ * @param project Project file
+ * @param name Key name (UTF-8, less than 200 bytes)
+ * @param data Data to save
+ * @param size Size of data in bytes
+ * @return false if memory allocation failed or name is too long
+ */
+static inline bool
+aviutl2_project_blob_save(struct aviutl2_project_file *project, char const *name, void const *data, size_t size) {
+  if (strlen(name) >= aviutl2_project_blob_max_key - 24) {
+    return false;
+  }
+  size_t const block_size = aviutl2_project_blob_block_size;
+  size_t const block_num = (size + block_size - 1) / block_size;
+  if (block_num > UINT32_MAX / sizeof(struct aviutl2_project_blob_block)) {
+    return false;
+  }
+  size_t const index_size = block_num * sizeof(struct aviutl2_project_blob_block);
+  size_t cap = index_size + block_num * aviutl2_lz_compress_bound(block_size);
+  uint8_t *stream = (uint8_t *)malloc(cap ? cap : 1);
+  if (!stream) {
+    return false;
+  }
+  struct aviutl2_project_blob_block *index = (struct aviutl2_project_blob_block *)stream;
+  uint8_t const *src = (uint8_t const *)data;
+  size_t pos = index_size;
+  for (size_t i = 0; i < block_num; ++i) {
+    size_t const raw = i + 1 < block_num ? block_size : size - i * block_size;
+    uint8_t const *block = src + i * block_size;
+    size_t packed = aviutl2_lz_compress(stream + pos, block, raw);
+    uint32_t flags = 0;
+    if (packed >= raw) {
+      memcpy(stream + pos, block, raw);
+      packed = raw;
+      flags = AVIUTL2_PROJECT_BLOB_STORED;
+    }
+    if (pos > UINT32_MAX) {
+      free(stream);
+      return false;
+    }
+    index[i] = (struct aviutl2_project_blob_block){
+        .offset = (uint32_t)pos,
+        .packed_size = (uint32_t)packed | flags,
+        .crc = aviutl2_crc32(0, block, raw),
+    };
+    pos += packed;
+  }
+  struct aviutl2_project_blob_header header = {
+      .magic = AVIUTL2_PROJECT_BLOB_MAGIC,
+      .version = AVIUTL2_PROJECT_BLOB_VERSION,
+      .size = size,
+      .stream_size = pos,
+      .block_size = (uint32_t)block_size,
+      .block_num = (uint32_t)block_num,
+      .index_crc = aviutl2_crc32(0, index, index_size),
+  };
+  char key[aviutl2_project_blob_max_key];
+  for (size_t off = 0, chunk = 0; off < pos; off += aviutl2_project_blob_chunk_size, ++chunk) {
+    size_t const n = pos - off < aviutl2_project_blob_chunk_size ? pos - off : aviutl2_project_blob_chunk_size;
+    aviutl2_project_blob_key(key, name, chunk);
+    project->set_param_binary(key, stream + off, (int)n);
+  }
+  project->set_param_binary(name, &header, (int)sizeof(header));
+  free(stream);
+  return true;
+}
+
+/**
+ * Release a loaded blob
+ * @param blob Blob
+ */
+static inline void aviutl2_project_blob_free(struct aviutl2_project_blob *blob) {
+  if (blob->blocks) {
+    for (uint32_t i = 0; i < blob->block_num; ++i) {
+      free(blob->blocks[i]);
+    }
+    free(blob->blocks);
+  }
+  free(blob->stream);
+  memset(blob, 0, sizeof(*blob));
+}
+
+/**
+ * Load the compressed data of a blob from the project
+ * Call from the project load handler. Any previously loaded data in blob is released.
+ * Blocks are not decompressed until they are accessed.
+ * @param project Project file
+ * @param name Key name (UTF-8)
+ * @param blob Blob
+ * @return false if the blob does not exist, is corrupted or memory allocation failed
+ */
+static inline bool
+aviutl2_project_blob_load(struct aviutl2_project_file *project, char const *name, struct aviutl2_project_blob *blob) {
+  aviutl2_project_blob_free(blob);
+  struct aviutl2_project_blob_header header;
+  if (strlen(name) >= aviutl2_project_blob_max_key - 24 ||
+      !project->get_param_binary(name, &header, (int)sizeof(header)) || header.magic != AVIUTL2_PROJECT_BLOB_MAGIC ||
+      header.version != AVIUTL2_PROJECT_BLOB_VERSION || header.block_size == 0 ||
+      header.block_size > aviutl2_lz_max_block_size || header.stream_size > SIZE_MAX || header.size > SIZE_MAX ||
+      header.size > (uint64_t)header.block_num * header.block_size ||
+      (header.size + header.block_size - 1) / header.block_size != header.block_num ||
+      header.stream_size < (uint64_t)header.block_num * sizeof(struct aviutl2_project_blob_block)) {
+    return false;
+  }
+  size_t const stream_size = (size_t)header.stream_size;
+  uint8_t *stream = (uint8_t *)malloc(stream_size ? stream_size : 1);
+  uint8_t **blocks = (uint8_t **)calloc(header.block_num ? header.block_num : 1, sizeof(uint8_t *));
+  if (!stream || !blocks) {
+    free(stream);
+    free(blocks);
+    return false;
+  }
+  char key[aviutl2_project_blob_max_key];
+  for (size_t off = 0, chunk = 0; off < stream_size; off += aviutl2_project_blob_chunk_size, ++chunk) {
+    size_t const n =
+        stream_size - off < aviutl2_project_blob_chunk_size ? stream_size - off : aviutl2_project_blob_chunk_size;
+    aviutl2_project_blob_key(key, name, chunk);
+    if (!project->get_param_binary(key, stream + off, (int)n)) {
+      free(stream);
+      free(blocks);
+      return false;
+    }
+  }
+  size_t const index_size = header.block_num * sizeof(struct aviutl2_project_blob_block);
+  if (aviutl2_crc32(0, stream, index_size) != header.index_crc) {
+    free(stream);
+    free(blocks);
+    return false;
+  }
+  *blob = (struct aviutl2_project_blob){
+      .stream = stream,
+      .stream_size = stream_size,
+      .size = (size_t)header.size,
+      .block_size = header.block_size,
+      .block_num = header.block_num,
+      .blocks = blocks,
+  };
+  return true;
+}
+
+/**
+ * Get a decompressed block
+ * The block is decompressed and verified on first access and kept until the blob is released
+ * @param blob Loaded blob
+ * @param index Block index
+ * @param size Pointer to storage for the block size in bytes (may be NULL)
+ * @return Pointer to block data, or NULL if the block is corrupted, index is out of range or memory allocation failed
+ */
+static inline void const *aviutl2_project_blob_block(struct aviutl2_project_blob *blob, size_t index, size_t *size) {
+  if (index >= blob->block_num) {
+    return NULL;
+  }
+  size_t const raw = index + 1 < blob->block_num ? blob->block_size : blob->size - index * blob->block_size;
+  if (size) {
+    *size = raw;
+  }
+  if (blob->blocks[index]) {
+    return blob->blocks[index];
+  }
+  struct aviutl2_project_blob_block entry;
+  memcpy(&entry, blob->stream + index * sizeof(entry), sizeof(entry));
+  size_t const packed = entry.packed_size & ~AVIUTL2_PROJECT_BLOB_STORED;
+  if (entry.offset > blob->stream_size || packed > blob->stream_size - entry.offset) {
+    return NULL;
+  }
+  uint8_t *block = (uint8_t *)malloc(raw ? raw : 1);
+  if (!block) {
+    return NULL;
+  }
+  uint8_t const *src = blob->stream + entry.offset;
+  bool ok;
+  if (entry.packed_size & AVIUTL2_PROJECT_BLOB_STORED) {
+    ok = packed == raw;
+    if (ok) {
+      memcpy(block, src, raw);
+    }
+  } else {
+    ok = aviutl2_lz_decompress(block, raw, src, packed);
+  }
+  if (!ok || aviutl2_crc32(0, block, raw) != entry.crc) {
+    free(block);
+    return NULL;
+  }
+  blob->blocks[index] = block;
+  return block;
+}
+
+/**
+ * Copy a range of the uncompressed data
+ * Only the blocks that overlap the range are decompressed
+ * @param blob Loaded blob
+ * @param offset Offset in bytes
+ * @param dst Destination buffer
+ * @param size Number of bytes to copy
+ * @return false if the range is out of bounds or a block is corrupted
+ */
+static inline bool aviutl2_project_blob_read(struct aviutl2_project_blob *blob, size_t offset, void *dst, size_t size) {
+  if (offset > blob->size || size > blob->size - offset) {
+    return false;
+  }
+  uint8_t *out = (uint8_t *)dst;
+  while (size) {
+    size_t const index = offset / blob->block_size;
+    size_t const in_block = offset % blob->block_size;
+    size_t block_bytes = 0;
+    uint8_t const *block = (uint8_t const *)aviutl2_project_blob_block(blob, index, &block_bytes);
+    if (!block) {
+      return false;
+    }
+    size_t const n = block_bytes - in_block < size ? block_bytes - in_block : size;
+    memcpy(out, block + in_block, n);
+    out += n;
+    offset += n;
+    size -= n;
+  }
+  return true;
+}
+
+/**
+ * Release the decompressed copy of a block to reduce memory usage
+ * The block is decompressed again on the next access
+ * @param blob Loaded blob
+ * @param index Block index
+ */
+static inline void aviutl2_project_blob_evict(struct aviutl2_project_blob *blob, size_t index) {
+  if (index < blob->block_num) {
+    free(blob->blocks[index]);
+    blob->blocks[index] = NULL;
+  }
+}
@@ -0,0 +1,472 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Image resource names for aviutl2_filter_proc_video
+//
+// Functions such as draw_image(), copy_image_resource() and exec_pixelshader_data() identify images by names like
+// L"resource:xxxx" or L"layer:12+". This header provides two ways to obtain those names without formatting them on
+// every frame:
+//
+// - AVIUTL2_RESOURCE_* macros build names from wide string literals at compile time
+//     draw_image(AVIUTL2_RESOURCE_CACHE(L"blur"), ...)
+// - aviutl2_resource_names is an intern table for names that are only known at run time, such as
+//   names with an index or a file path. Keep one table per effect instance (for example in the user data returned by
+//   func_create()) and resolve names once; the returned pointers stay valid until the table is destroyed.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "aviutl2_hash.h"
+
+#define AVIUTL2_RESOURCE_WIDEN_(x) L##x
+#define AVIUTL2_RESOURCE_WSTR_(x) AVIUTL2_RESOURCE_WIDEN_(#x)
+
+/**
+ * Current object
+ */
+#define AVIUTL2_RESOURCE_OBJECT L"object"
+
+/**
+ * Framebuffer
+ */
+#define AVIUTL2_RESOURCE_FRAMEBUFFER L"framebuffer"
+
+/**
+ * Virtual buffer
+ */
+#define AVIUTL2_RESOURCE_TEMPBUFFER L"tempbuffer"
+
+/**
+ * Random buffer (256x256 random values in range 0.0 to 1.0, DXGI_FORMAT_R32_FLOAT/r only)
+ */
+#define AVIUTL2_RESOURCE_RANDOM L"random"
+
+/**
+ * Immediately preceding object
+ */
+#define AVIUTL2_RESOURCE_BEFORE L"before"
+
+/**
+ * Standard resource
+ * @param name Wide string literal
+ */
+#define AVIUTL2_RESOURCE(name) L"resource:" name
+
+/**
+ * Cache buffer
+ * @param name Wide string literal
+ */
+#define AVIUTL2_RESOURCE_CACHE(name) L"cache:" name
+
+/**
+ * Image file
+ * @param path Wide string literal
+ */
+#define AVIUTL2_RESOURCE_IMAGE(path) L"image:" path
+
+/**
+ * Object on the layer
+ * @param layer Layer number as an integer literal
+ */
+#define AVIUTL2_RESOURCE_LAYER(layer) L"layer:" AVIUTL2_RESOURCE_WSTR_(layer)
+
+/**
+ * Object on the layer with additional filters executed
+ * @param layer Layer number as an integer literal
+ */
+#define AVIUTL2_RESOURCE_LAYER_FILTERED(layer) L"layer:" AVIUTL2_RESOURCE_WSTR_(layer) L"+"
+
+//--------------------------------
+
+/**
+ * Image resource name kind
+ */
+enum aviutl2_resource_kind {
+  aviutl2_resource_kind_invalid = 0,
+  aviutl2_resource_kind_object = 1,      /**< "object" */
+  aviutl2_resource_kind_resource = 2,    /**< "resource:xxxx" */
+  aviutl2_resource_kind_tempbuffer = 3,  /**< "tempbuffer" */
+  aviutl2_resource_kind_cache = 4,       /**< "cache:xxxx" */
+  aviutl2_resource_kind_image = 5,       /**< "image:xxxx" */
+  aviutl2_resource_kind_framebuffer = 6, /**< "framebuffer" */
+  aviutl2_resource_kind_random = 7,      /**< "random" */
+  aviutl2_resource_kind_layer = 8,       /**< "layer:xxxx[+]" */
+  aviutl2_resource_kind_before = 9,      /**< "before" */
+};
+
+/**
+ * Where a resource name is used
+ * Each value lists the kinds accepted by the corresponding aviutl2_filter_proc_video functions
+ */
+enum aviutl2_resource_usage {
+  /**
+   * draw_image(), draw_poly() texture, get_image_resource_texture2d() without "random",
+   * and src_resource of draw_image_to_resource() / draw_poly_to_resource()
+   */
+  aviutl2_resource_usage_draw_source = (1 << aviutl2_resource_kind_object) | (1 << aviutl2_resource_kind_resource) |
+                                       (1 << aviutl2_resource_kind_tempbuffer) | (1 << aviutl2_resource_kind_cache) |
+                                       (1 << aviutl2_resource_kind_image),
+
+  /**
+   * create_image_resource(), clear_image_resource(), dst_resource of copy_image_resource(),
+   * draw_image_to_resource() and draw_poly_to_resource()
+   */
+  aviutl2_resource_usage_destination = (1 << aviutl2_resource_kind_object) | (1 << aviutl2_resource_kind_resource) |
+                                       (1 << aviutl2_resource_kind_tempbuffer) | (1 << aviutl2_resource_kind_cache),
+
+  /**
+   * src_resource of copy_image_resource()
+   */
+  aviutl2_resource_usage_copy_source =
+      (1 << aviutl2_resource_kind_object) | (1 << aviutl2_resource_kind_resource) |
+      (1 << aviutl2_resource_kind_framebuffer) | (1 << aviutl2_resource_kind_tempbuffer) |
+      (1 << aviutl2_resource_kind_cache) | (1 << aviutl2_resource_kind_image) | (1 << aviutl2_resource_kind_random) |
+      (1 << aviutl2_resource_kind_layer) | (1 << aviutl2_resource_kind_before),
+
+  /**
+   * target of exec_pixelshader_*() and target_list of exec_computeshader_*()
+   */
+  aviutl2_resource_usage_shader_target = (1 << aviutl2_resource_kind_object) | (1 << aviutl2_resource_kind_resource) |
+                                         (1 << aviutl2_resource_kind_framebuffer) |
+                                         (1 << aviutl2_resource_kind_tempbuffer) | (1 << aviutl2_resource_kind_cache),
+
+  /**
+   * resource_list of exec_pixelshader_*() / exec_computeshader_*() and get_image_resource_texture2d()
+   */
+  aviutl2_resource_usage_shader_input = (1 << aviutl2_resource_kind_object) | (1 << aviutl2_resource_kind_resource) |
+                                        (1 << aviutl2_resource_kind_tempbuffer) | (1 << aviutl2_resource_kind_cache) |
+                                        (1 << aviutl2_resource_kind_image) | (1 << aviutl2_resource_kind_random),
+
+  /**
+   * release_image_resource()
+   */
+  aviutl2_resource_usage_release = (1 << aviutl2_resource_kind_resource),
+};
+
+/**
+ * Check whether a kind is accepted for a usage
+ * @param kind Resource name kind
+ * @param usage Usage
+ * @return true if accepted
+ */
+static inline bool aviutl2_resource_kind_usable(enum aviutl2_resource_kind kind, enum aviutl2_resource_usage usage) {
+  return kind != aviutl2_resource_kind_invalid && (usage & (1 << kind)) != 0;
+}
+
+static inline wchar_t const *aviutl2_resource_kind_prefix(enum aviutl2_resource_kind kind) {
+  switch (kind) {
+  case aviutl2_resource_kind_object:
+    return L"object";
+  case aviutl2_resource_kind_resource:
+    return L"resource:";
+  case aviutl2_resource_kind_tempbuffer:
+    return L"tempbuffer";
+  case aviutl2_resource_kind_cache:
+    return L"cache:";
+  case aviutl2_resource_kind_image:
+    return L"image:";
+  case aviutl2_resource_kind_framebuffer:
+    return L"framebuffer";
+  case aviutl2_resource_kind_random:
+    return L"random";
+  case aviutl2_resource_kind_layer:
+    return L"layer:";
+  case aviutl2_resource_kind_before:
+    return L"before";
+  case aviutl2_resource_kind_invalid:
+    break;
+  }
+  return NULL;
+}
+
+static inline bool aviutl2_resource_kind_has_name(enum aviutl2_resource_kind kind) {
+  return kind == aviutl2_resource_kind_resource || kind == aviutl2_resource_kind_cache ||
+         kind == aviutl2_resource_kind_image || kind == aviutl2_resource_kind_layer;
+}
+
+/**
+ * Determine the kind of a resource name
+ * Checks the syntax only; it does not check whether the resource exists
+ * @param name Resource name (NULL means the current object)
+ * @return Kind, or aviutl2_resource_kind_invalid if the name is malformed
+ */
+static inline enum aviutl2_resource_kind aviutl2_resource_name_kind(wchar_t const *name) {
+  if (!name) {
+    return aviutl2_resource_kind_object;
+  }
+  for (int k = aviutl2_resource_kind_object; k <= aviutl2_resource_kind_before; ++k) {
+    enum aviutl2_resource_kind const kind = (enum aviutl2_resource_kind)k;
+    wchar_t const *prefix = aviutl2_resource_kind_prefix(kind);
+    size_t const len = wcslen(prefix);
+    if (wcsncmp(name, prefix, len) != 0) {
+      continue;
+    }
+    wchar_t const *rest = name + len;
+    if (!aviutl2_resource_kind_has_name(kind)) {
+      return *rest == L'\0' ? kind : aviutl2_resource_kind_invalid;
+    }
+    if (*rest == L'\0') {
+      return aviutl2_resource_kind_invalid;
+    }
+    if (kind == aviutl2_resource_kind_layer) {
+      wchar_t const *digits = rest;
+      while (*rest >= L'0' && *rest <= L'9') {
+        ++rest;
+      }
+      if (rest == digits) {
+        return aviutl2_resource_kind_invalid;
+      }
+      if (*rest == L'+') {
+        ++rest;
+      }
+      return *rest == L'\0' ? kind : aviutl2_resource_kind_invalid;
+    }
+    return kind;
+  }
+  return aviutl2_resource_kind_invalid;
+}
+
+//--------------------------------
+
+/**
+ * Interned resource name entry
+ */
+struct aviutl2_resource_names_entry {
+  uint64_t hash;
+  enum aviutl2_resource_kind kind;
+  int index;
+  wchar_t const *base; /**< Points into str, after the prefix */
+  size_t base_len;
+  wchar_t const *str; /**< Full resource name */
+};
+
+/**
+ * Arena block holding interned strings
+ */
+struct aviutl2_resource_names_block {
+  struct aviutl2_resource_names_block *next;
+  size_t used, cap;
+  wchar_t data[1];
+};
+
+/**
+ * Resource name intern table
+ * Initialize with {0}. Pointers returned by aviutl2_resource_names_* functions stay valid until
+ * aviutl2_resource_names_destroy() because strings are stored in blocks that never move
+ */
+struct aviutl2_resource_names {
+  struct aviutl2_resource_names_entry *entries;
+  size_t entry_cap, entry_num;
+  struct aviutl2_resource_names_block *blocks;
+};
+
+/**
+ * Release all interned names
+ * @param t Intern table
+ */
+static inline void aviutl2_resource_names_destroy(struct aviutl2_resource_names *t) {
+  struct aviutl2_resource_names_block *b = t->blocks;
+  while (b) {
+    struct aviutl2_resource_names_block *next = b->next;
+    free(b);
+    b = next;
+  }
+  free(t->entries);
+  memset(t, 0, sizeof(*t));
+}
+
+static inline wchar_t *aviutl2_resource_names_alloc(struct aviutl2_resource_names *t, size_t len) {
+  struct aviutl2_resource_names_block *b = t->blocks;
+  if (!b || b->cap - b->used < len) {
+    size_t cap = 1024;
+    if (cap < len) {
+      cap = len;
+    }
+    b = (struct aviutl2_resource_names_block *)malloc(sizeof(struct aviutl2_resource_names_block) +
+                                                      cap * sizeof(wchar_t));
+    if (!b) {
+      return NULL;
+    }
+    b->next = t->blocks;
+    b->used = 0;
+    b->cap = cap;
+    t->blocks = b;
+  }
+  wchar_t *p = b->data + b->used;
+  b->used += len;
+  return p;
+}
+
+static inline bool aviutl2_resource_names_grow(struct aviutl2_resource_names *t) {
+  size_t const cap = t->entry_cap ? t->entry_cap * 2 : 32;
+  struct aviutl2_resource_names_entry *entries =
+      (struct aviutl2_resource_names_entry *)calloc(cap, sizeof(struct aviutl2_resource_names_entry));
+  if (!entries) {
+    return false;
+  }
+  for (size_t i = 0; i < t->entry_cap; ++i) {
+    if (!t->entries[i].str) {
+      continue;
+    }
+    size_t j = (size_t)t->entries[i].hash & (cap - 1);
+    while (entries[j].str) {
+      j = (j + 1) & (cap - 1);
+    }
+    entries[j] = t->entries[i];
+  }
+  free(t->entries);
+  t->entries = entries;
+  t->entry_cap = cap;
+  return true;
+}
+
+static inline size_t aviutl2_resource_names_format_int(wchar_t *buf, int value) {
+  wchar_t tmp[12];
+  size_t n = 0;
+  unsigned v = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+  do {
+    tmp[n++] = (wchar_t)(L'0' + v % 10);
+    v /= 10;
+  } while (v);
+  size_t len = 0;
+  if (value < 0) {
+    buf[len++] = L'-';
+  }
+  while (n) {
+    buf[len++] = tmp[--n];
+  }
+  return len;
+}
+
+/**
+ * Get an interned resource name with an optional numeric suffix
+ * The name is built as prefix + base + index, for example (cache, L"particle", 3) -> L"cache:particle3"
+ * For aviutl2_resource_kind_layer, base is ignored, index is the layer number and a non-zero filtered flag
+ * is expressed by passing L"+" as base
+ * @param t Intern table
+ * @param kind Resource name kind
+ * @param base Name part (NULL for kinds without a name)
+ * @param index Numeric suffix (negative values mean no suffix, except for layers)
+ * @return Interned name, or NULL if the name is invalid for the kind or memory allocation failed
+ */
+static inline wchar_t const *aviutl2_resource_names_get_indexed(struct aviutl2_resource_names *t,
+                                                                enum aviutl2_resource_kind kind,
+                                                                wchar_t const *base,
+                                                                int index) {
+  wchar_t const *prefix = aviutl2_resource_kind_prefix(kind);
+  if (!prefix) {
+    return NULL;
+  }
+  if (kind == aviutl2_resource_kind_layer) {
+    if (index < 0 || (base && wcscmp(base, L"+") != 0 && base[0] != L'\0')) {
+      return NULL;
+    }
+  } else if (aviutl2_resource_kind_has_name(kind)) {
+    if (!base || (base[0] == L'\0' && index < 0)) {
+      return NULL;
+    }
+  } else {
+    base = NULL;
+    index = -1;
+  }
+  if (!base) {
+    base = L"";
+  }
+  size_t const base_len = wcslen(base);
+
+  uint64_t hash = aviutl2_hash_u64(AVIUTL2_HASH_INIT, (uint64_t)kind);
+  hash = aviutl2_hash_u64(aviutl2_hash_wstr(hash, base), (uint64_t)(int64_t)index);
+  if (t->entry_cap) {
+    size_t j = (size_t)hash & (t->entry_cap - 1);
+    for (; t->entries[j].str; j = (j + 1) & (t->entry_cap - 1)) {
+      struct aviutl2_resource_names_entry const *e = t->entries + j;
+      if (e->hash == hash && e->kind == kind && e->index == index && e->base_len == base_len &&
+          wmemcmp(e->base, base, base_len) == 0) {
+        return e->str;
+      }
+    }
+  }
+
+  if ((t->entry_num + 1) * 2 > t->entry_cap && !aviutl2_resource_names_grow(t)) {
+    return NULL;
+  }
+  size_t const prefix_len = wcslen(prefix);
+  wchar_t *str = aviutl2_resource_names_alloc(t, prefix_len + base_len + 12 + 1);
+  if (!str) {
+    return NULL;
+  }
+  size_t len = prefix_len;
+  memcpy(str, prefix, prefix_len * sizeof(wchar_t));
+  if (kind == aviutl2_resource_kind_layer) {
+    len += aviutl2_resource_names_format_int(str + len, index);
+    memcpy(str + len, base, base_len * sizeof(wchar_t));
+    len += base_len;
+  } else {
+    memcpy(str + len, base, base_len * sizeof(wchar_t));
+    len += base_len;
+    if (index >= 0) {
+      len += aviutl2_resource_names_format_int(str + len, index);
+    }
+  }
+  str[len] = L'\0';
+
+  size_t j = (size_t)hash & (t->entry_cap - 1);
+  while (t->entries[j].str) {
+    j = (j + 1) & (t->entry_cap - 1);
+  }
+  struct aviutl2_resource_names_entry *e = t->entries + j;
+  e->hash = hash;
+  e->kind = kind;
+  e->index = index;
+  e->base = kind == aviutl2_resource_kind_layer ? str + len - base_len : str + prefix_len;
+  e->base_len = base_len;
+  e->str = str;
+  ++t->entry_num;
+  return str;
+}
+
+/**
+ * Get an interned resource name
+ * @param t Intern table
+ * @param kind Resource name kind
+ * @param base Name part (NULL for kinds without a name)
+ * @return Interned name, or NULL if the name is invalid for the kind or memory allocation failed
+ */
+static inline wchar_t const *
+aviutl2_resource_names_get(struct aviutl2_resource_names *t, enum aviutl2_resource_kind kind, wchar_t const *base) {
+  return aviutl2_resource_names_get_indexed(t, kind, base, -1);
+}
+
+/**
+ * Get an interned layer resource name
+ * @param t Intern table
+ * @param layer Layer number
+ * @param filtered true to execute additional filters ("layer:xxxx+")
+ * @return Interned name, or NULL on failure
+ */
+static inline wchar_t const *aviutl2_resource_names_layer(struct aviutl2_resource_names *t, int layer, bool filtered) {
+  return aviutl2_resource_names_get_indexed(t, aviutl2_resource_kind_layer, filtered ? L"+" : NULL, layer);
+}
+
+/**
+ * Get an interned resource name and check that it can be used for the specified usage
+ * @param t Intern table
+ * @param kind Resource name kind
+ * @param base Name part (NULL for kinds without a name)
+ * @param usage Intended usage
+ * @return Interned name, or NULL if the kind is not accepted for the usage or the name is invalid
+ */
+static inline wchar_t const *aviutl2_resource_names_get_for(struct aviutl2_resource_names *t,
+                                                            enum aviutl2_resource_kind kind,
+                                                            wchar_t const *base,
+                                                            enum aviutl2_resource_usage usage) {
+  if (!aviutl2_resource_kind_usable(kind, usage)) {
+    return NULL;
+  }
+  return aviutl2_resource_names_get(t, kind, base);
+}
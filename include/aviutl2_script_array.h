@@ -0,0 +1,561 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Typed arrays for script modules
+//
+// Large numeric results such as histograms or spectra are kept in native memory and returned to scripts as
+// metatable-backed userdata instead of being converted to Lua tables element by element. Scripts access them as
+//   local a = mod.histogram(...)
+//   for i = 1, #a do local v = a[i] end
+//   a[1] = 0
+// and other script module functions receive them back with aviutl2_script_array_get() without copying.
+//
+// Arrays are reference counted: the creator holds one reference, every push adds one that is dropped by __gc.
+// Optional script functions for creating, copying and converting arrays can be added to a module's function list:
+//   {L"array_new", aviutl2_script_array_func_new},
+//   {L"array_copy", aviutl2_script_array_func_copy},
+//   {L"array_to_table", aviutl2_script_array_func_to_table},
+//   {L"array_from_table", aviutl2_script_array_func_from_table},
+//
+// The metatable is identified by the address of aviutl2_script_array_methods(), which is per translation unit;
+// push and get arrays from the same source file.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_module2.h"
+
+/**
+ * Element type
+ */
+enum aviutl2_script_array_type {
+  aviutl2_script_array_type_f64 = 0, /**< double */
+  aviutl2_script_array_type_f32 = 1, /**< float */
+  aviutl2_script_array_type_i32 = 2, /**< int32_t */
+  aviutl2_script_array_type_u8 = 3,  /**< uint8_t */
+};
+
+/**
+ * Typed array
+ */
+struct aviutl2_script_array {
+  LONG volatile refs;
+  enum aviutl2_script_array_type type;
+  void *data;
+  size_t len; /**< Number of elements */
+  void (*release)(void *userdata, void *data); /**< Called with data when the last reference is dropped (may be NULL) */
+  void *userdata;                              /**< Value passed to release */
+};
+
+/**
+ * Get the element size of a type
+ * @param type Element type
+ * @return Size in bytes
+ */
+static inline size_t aviutl2_script_array_type_size(enum aviutl2_script_array_type type) {
+  switch (type) {
+  case aviutl2_script_array_type_f64:
+    return sizeof(double);
+  case aviutl2_script_array_type_f32:
+    return sizeof(float);
+  case aviutl2_script_array_type_i32:
+    return sizeof(int32_t);
+  case aviutl2_script_array_type_u8:
+    return sizeof(uint8_t);
+  }
+  return 0;
+}
+
+/**
+ * Create an array that owns zero-initialized storage
+ * @param type Element type
+ * @param len Number of elements
+ * @return Array with one reference, or NULL on failure
+ */
+static inline struct aviutl2_script_array *aviutl2_script_array_new(enum aviutl2_script_array_type type, size_t len) {
+  size_t const elem = aviutl2_script_array_type_size(type);
+  if (!elem || len > (SIZE_MAX - sizeof(struct aviutl2_script_array) - 16) / elem) {
+    return NULL;
+  }
+  // Elements follow the header, aligned to 16 bytes.
+  size_t const header = (sizeof(struct aviutl2_script_array) + 15) & ~(size_t)15;
+  struct aviutl2_script_array *a = (struct aviutl2_script_array *)calloc(1, header + len * elem);
+  if (!a) {
+    return NULL;
+  }
+  a->refs = 1;
+  a->type = type;
+  a->data = (uint8_t *)a + header;
+  a->len = len;
+  return a;
+}
+
+/**
+ * Create an array that refers to plugin-owned storage
+ * @param type Element type
+ * @param data Storage
+ * @param len Number of elements
+ * @param release Called with data when the last reference is dropped (may be NULL)
+ * @param userdata Value passed to release
+ * @return Array with one reference, or NULL on failure
+ */
+static inline struct aviutl2_script_array *aviutl2_script_array_wrap(enum aviutl2_script_array_type type,
+                                                                     void *data,
+                                                                     size_t len,
+                                                                     void (*release)(void *userdata, void *data),
+                                                                     void *userdata) {
+  if (!aviutl2_script_array_type_size(type)) {
+    return NULL;
+  }
+  struct aviutl2_script_array *a = (struct aviutl2_script_array *)calloc(1, sizeof(struct aviutl2_script_array));
+  if (!a) {
+    return NULL;
+  }
+  a->refs = 1;
+  a->type = type;
+  a->data = data;
+  a->len = len;
+  a->release = release;
+  a->userdata = userdata;
+  return a;
+}
+
+/**
+ * Add a reference
+ * @param a Array
+ * @return a
+ */
+static inline struct aviutl2_script_array *aviutl2_script_array_retain(struct aviutl2_script_array *a) {
+  if (a) {
+    InterlockedIncrement(&a->refs);
+  }
+  return a;
+}
+
+/**
+ * Drop a reference
+ * @param a Array (may be NULL)
+ */
+static inline void aviutl2_script_array_release(struct aviutl2_script_array *a) {
+  if (!a || InterlockedDecrement(&a->refs) != 0) {
+    return;
+  }
+  if (a->release) {
+    a->release(a->userdata, a->data);
+  }
+  free(a);
+}
+
+/**
+ * Get an element as double
+ * @param a Array
+ * @param index Element index (must be less than len)
+ * @return Value
+ */
+static inline double aviutl2_script_array_at(struct aviutl2_script_array const *a, size_t index) {
+  switch (a->type) {
+  case aviutl2_script_array_type_f64:
+    return ((double const *)a->data)[index];
+  case aviutl2_script_array_type_f32:
+    return (double)((float const *)a->data)[index];
+  case aviutl2_script_array_type_i32:
+    return (double)((int32_t const *)a->data)[index];
+  case aviutl2_script_array_type_u8:
+    return (double)((uint8_t const *)a->data)[index];
+  }
+  return 0.0;
+}
+
+static inline int32_t aviutl2_script_array_to_i32(double v) {
+  return v >= 2147483647.0 ? INT32_MAX : v <= -2147483648.0 ? INT32_MIN : v == v ? (int32_t)v : 0;
+}
+
+static inline uint8_t aviutl2_script_array_to_u8(double v) {
+  return v >= 255.0 ? 255 : v > 0.0 ? (uint8_t)v : 0;
+}
+
+/**
+ * Set an element from double
+ * Integer types are truncated and saturated
+ * @param a Array
+ * @param index Element index (must be less than len)
+ * @param value Value
+ */
+static inline void aviutl2_script_array_set(struct aviutl2_script_array *a, size_t index, double value) {
+  switch (a->type) {
+  case aviutl2_script_array_type_f64:
+    ((double *)a->data)[index] = value;
+    break;
+  case aviutl2_script_array_type_f32:
+    ((float *)a->data)[index] = (float)value;
+    break;
+  case aviutl2_script_array_type_i32:
+    ((int32_t *)a->data)[index] = aviutl2_script_array_to_i32(value);
+    break;
+  case aviutl2_script_array_type_u8:
+    ((uint8_t *)a->data)[index] = aviutl2_script_array_to_u8(value);
+    break;
+  }
+}
+
+/**
+ * Copy elements out as double
+ * @param a Array
+ * @param offset First element
+ * @param dst Destination
+ * @param n Number of elements (clamped to the array length)
+ * @return Number of elements copied
+ */
+static inline size_t
+aviutl2_script_array_read(struct aviutl2_script_array const *a, size_t offset, double *dst, size_t n) {
+  if (offset >= a->len) {
+    return 0;
+  }
+  if (n > a->len - offset) {
+    n = a->len - offset;
+  }
+  // One loop per type so that each conversion loop vectorizes.
+  switch (a->type) {
+  case aviutl2_script_array_type_f64:
+    memcpy(dst, (double const *)a->data + offset, n * sizeof(double));
+    break;
+  case aviutl2_script_array_type_f32: {
+    float const *src = (float const *)a->data + offset;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = (double)src[i];
+    }
+  } break;
+  case aviutl2_script_array_type_i32: {
+    int32_t const *src = (int32_t const *)a->data + offset;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = (double)src[i];
+    }
+  } break;
+  case aviutl2_script_array_type_u8: {
+    uint8_t const *src = (uint8_t const *)a->data + offset;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = (double)src[i];
+    }
+  } break;
+  }
+  return n;
+}
+
+/**
+ * Copy elements in from double
+ * Integer types are truncated and saturated
+ * @param a Array
+ * @param offset First element
+ * @param src Source
+ * @param n Number of elements (clamped to the array length)
+ * @return Number of elements copied
+ */
+static inline size_t
+aviutl2_script_array_write(struct aviutl2_script_array *a, size_t offset, double const *src, size_t n) {
+  if (offset >= a->len) {
+    return 0;
+  }
+  if (n > a->len - offset) {
+    n = a->len - offset;
+  }
+  switch (a->type) {
+  case aviutl2_script_array_type_f64:
+    memmove((double *)a->data + offset, src, n * sizeof(double));
+    break;
+  case aviutl2_script_array_type_f32: {
+    float *dst = (float *)a->data + offset;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = (float)src[i];
+    }
+  } break;
+  case aviutl2_script_array_type_i32: {
+    int32_t *dst = (int32_t *)a->data + offset;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = aviutl2_script_array_to_i32(src[i]);
+    }
+  } break;
+  case aviutl2_script_array_type_u8: {
+    uint8_t *dst = (uint8_t *)a->data + offset;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = aviutl2_script_array_to_u8(src[i]);
+    }
+  } break;
+  }
+  return n;
+}
+
+/**
+ * Copy elements between arrays
+ * Uses memmove when the types match; otherwise converts through double
+ * @param dst Destination array
+ * @param dst_offset First destination element
+ * @param src Source array
+ * @param src_offset First source element
+ * @param n Number of elements (clamped to both array lengths)
+ * @return Number of elements copied
+ */
+static inline size_t aviutl2_script_array_copy(struct aviutl2_script_array *dst,
+                                               size_t dst_offset,
+                                               struct aviutl2_script_array const *src,
+                                               size_t src_offset,
+                                               size_t n) {
+  if (dst_offset >= dst->len || src_offset >= src->len) {
+    return 0;
+  }
+  if (n > dst->len - dst_offset) {
+    n = dst->len - dst_offset;
+  }
+  if (n > src->len - src_offset) {
+    n = src->len - src_offset;
+  }
+  if (dst->type == src->type) {
+    size_t const elem = aviutl2_script_array_type_size(dst->type);
+    memmove((uint8_t *)dst->data + dst_offset * elem, (uint8_t const *)src->data + src_offset * elem, n * elem);
+    return n;
+  }
+  double buf[256];
+  for (size_t done = 0; done < n;) {
+    size_t const chunk = n - done < 256 ? n - done : 256;
+    aviutl2_script_array_read(src, src_offset + done, buf, chunk);
+    aviutl2_script_array_write(dst, dst_offset + done, buf, chunk);
+    done += chunk;
+  }
+  return n;
+}
+
+static inline struct aviutl2_meta_method_function *aviutl2_script_array_methods(void);
+
+/**
+ * Return an array to the script
+ * Adds a reference that is dropped when the script value is garbage collected
+ * @param param Parameter interface
+ * @param a Array
+ */
+static inline void aviutl2_script_array_push(struct aviutl2_script_module_param *param,
+                                             struct aviutl2_script_array *a) {
+  param->push_result_meta_table(aviutl2_script_array_methods(), aviutl2_script_array_retain(a));
+}
+
+/**
+ * Get an array passed by the script
+ * @param param Parameter interface
+ * @param index Parameter position (0 based)
+ * @return Array (borrowed, valid during the callback), or NULL if the parameter is not an array
+ */
+static inline struct aviutl2_script_array *aviutl2_script_array_get(struct aviutl2_script_module_param *param,
+                                                                    int index) {
+  return (struct aviutl2_script_array *)param->get_param_meta_table(index, aviutl2_script_array_methods());
+}
+
+/**
+ * Return the elements as a Lua array table
+ * @param param Parameter interface
+ * @param a Array
+ * @return false if memory allocation failed or the array is too large
+ */
+static inline bool aviutl2_script_array_push_table(struct aviutl2_script_module_param *param,
+                                                   struct aviutl2_script_array const *a) {
+  if (a->len > INT32_MAX) {
+    return false;
+  }
+  if (a->type == aviutl2_script_array_type_f64) {
+    param->push_result_array_double((double *)a->data, (int)a->len);
+    return true;
+  }
+  double *tmp = (double *)malloc((a->len ? a->len : 1) * sizeof(double));
+  if (!tmp) {
+    return false;
+  }
+  aviutl2_script_array_read(a, 0, tmp, a->len);
+  param->push_result_array_double(tmp, (int)a->len);
+  free(tmp);
+  return true;
+}
+
+/**
+ * Create an array from a Lua array table parameter
+ * @param param Parameter interface
+ * @param index Parameter position (0 based)
+ * @param type Element type
+ * @return Array with one reference, or NULL on failure
+ */
+static inline struct aviutl2_script_array *aviutl2_script_array_from_table(struct aviutl2_script_module_param *param,
+                                                                           int index,
+                                                                           enum aviutl2_script_array_type type) {
+  int const n = param->get_param_array_num(index);
+  struct aviutl2_script_array *a = aviutl2_script_array_new(type, n > 0 ? (size_t)n : 0);
+  if (!a) {
+    return NULL;
+  }
+  for (int i = 0; i < n; ++i) {
+    aviutl2_script_array_set(a, (size_t)i, param->get_param_array_double(index, i));
+  }
+  return a;
+}
+
+// Metamethods. The host may or may not pass the userdata itself as the first parameter, so the key and value are
+// located from the end of the parameter list.
+
+static inline bool aviutl2_script_array_key(struct aviutl2_script_module_param *param,
+                                            struct aviutl2_script_array const *a,
+                                            int index,
+                                            size_t *pos) {
+  if (index < 0 || param->get_param_type(index) != aviutl2_param_type_number) {
+    return false;
+  }
+  double const key = param->get_param_double(index);
+  if (!(key >= 1.0) || key > (double)a->len || key != (double)(size_t)key) {
+    return false;
+  }
+  *pos = (size_t)key - 1;
+  return true;
+}
+
+static inline void aviutl2_script_array_meta_index(struct aviutl2_script_module_param *param) {
+  struct aviutl2_script_array *a = (struct aviutl2_script_array *)param->userdata;
+  size_t pos;
+  if (aviutl2_script_array_key(param, a, param->get_param_num() - 1, &pos)) {
+    param->push_result_double(aviutl2_script_array_at(a, pos));
+  }
+}
+
+static inline void aviutl2_script_array_meta_newindex(struct aviutl2_script_module_param *param) {
+  struct aviutl2_script_array *a = (struct aviutl2_script_array *)param->userdata;
+  int const num = param->get_param_num();
+  size_t pos;
+  if (!aviutl2_script_array_key(param, a, num - 2, &pos)) {
+    param->set_error("array index out of range");
+    return;
+  }
+  aviutl2_script_array_set(a, pos, param->get_param_double(num - 1));
+}
+
+static inline void aviutl2_script_array_meta_len(struct aviutl2_script_module_param *param) {
+  struct aviutl2_script_array const *a = (struct aviutl2_script_array const *)param->userdata;
+  param->push_result_int(a->len > INT32_MAX ? INT32_MAX : (int)a->len);
+}
+
+static inline void aviutl2_script_array_meta_gc(struct aviutl2_script_module_param *param) {
+  aviutl2_script_array_release((struct aviutl2_script_array *)param->userdata);
+}
+
+/**
+ * Get the metamethod list used for arrays
+ * @return Metamethod list
+ */
+static inline struct aviutl2_meta_method_function *aviutl2_script_array_methods(void) {
+  static struct aviutl2_meta_method_function methods[] = {
+      {"__index", aviutl2_script_array_meta_index},
+      {"__newindex", aviutl2_script_array_meta_newindex},
+      {"__len", aviutl2_script_array_meta_len},
+      {"__gc", aviutl2_script_array_meta_gc},
+      {NULL, NULL},
+  };
+  return methods;
+}
+
+static inline bool aviutl2_script_array_parse_type(char const *name, enum aviutl2_script_array_type *type) {
+  static struct {
+    char const *name;
+    enum aviutl2_script_array_type type;
+  } const table[] = {
+      {"f64", aviutl2_script_array_type_f64},
+      {"f32", aviutl2_script_array_type_f32},
+      {"i32", aviutl2_script_array_type_i32},
+      {"u8", aviutl2_script_array_type_u8},
+  };
+  if (!name) {
+    *type = aviutl2_script_array_type_f64;
+    return true;
+  }
+  for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); ++i) {
+    if (strcmp(name, table[i].name) == 0) {
+      *type = table[i].type;
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline void aviutl2_script_array_push_new(struct aviutl2_script_module_param *param,
+                                                 struct aviutl2_script_array *a) {
+  if (!a) {
+    param->set_error("failed to allocate array");
+    return;
+  }
+  aviutl2_script_array_push(param, a);
+  aviutl2_script_array_release(a);
+}
+
+/**
+ * Script function array_new(len [, type])
+ * type is "f64" (default), "f32", "i32" or "u8"
+ * @param param Parameter interface
+ */
+static inline void aviutl2_script_array_func_new(struct aviutl2_script_module_param *param) {
+  enum aviutl2_script_array_type type;
+  char const *const name = param->get_param_num() > 1 ? param->get_param_string(1) : NULL;
+  if (!aviutl2_script_array_parse_type(name, &type)) {
+    param->set_error("unknown array type");
+    return;
+  }
+  int const len = param->get_param_int(0);
+  aviutl2_script_array_push_new(param, aviutl2_script_array_new(type, len > 0 ? (size_t)len : 0));
+}
+
+/**
+ * Script function array_copy(dst, dst_pos, src, src_pos, n)
+ * Positions are 1 based; returns the number of elements copied
+ * @param param Parameter interface
+ */
+static inline void aviutl2_script_array_func_copy(struct aviutl2_script_module_param *param) {
+  struct aviutl2_script_array *dst = aviutl2_script_array_get(param, 0);
+  struct aviutl2_script_array const *src = aviutl2_script_array_get(param, 2);
+  int const dst_pos = param->get_param_int(1);
+  int const src_pos = param->get_param_int(3);
+  int const n = param->get_param_int(4);
+  if (!dst || !src || dst_pos < 1 || src_pos < 1 || n < 0) {
+    param->set_error("invalid arguments");
+    return;
+  }
+  param->push_result_int(
+      (int)aviutl2_script_array_copy(dst, (size_t)dst_pos - 1, src, (size_t)src_pos - 1, (size_t)n));
+}
+
+/**
+ * Script function array_to_table(array)
+ * @param param Parameter interface
+ */
+static inline void aviutl2_script_array_func_to_table(struct aviutl2_script_module_param *param) {
+  struct aviutl2_script_array const *a = aviutl2_script_array_get(param, 0);
+  if (!a) {
+    param->set_error("invalid arguments");
+    return;
+  }
+  if (!aviutl2_script_array_push_table(param, a)) {
+    param->set_error("failed to allocate table");
+  }
+}
+
+/**
+ * Script function array_from_table(table [, type])
+ * @param param Parameter interface
+ */
+static inline void aviutl2_script_array_func_from_table(struct aviutl2_script_module_param *param) {
+  enum aviutl2_script_array_type type;
+  char const *const name = param->get_param_num() > 1 ? param->get_param_string(1) : NULL;
+  if (param->get_param_type(0) != aviutl2_param_type_table || !aviutl2_script_array_parse_type(name, &type)) {
+    param->set_error("invalid arguments");
+    return;
+  }
+  aviutl2_script_array_push_new(param, aviutl2_script_array_from_table(param, 0, type));
+}
@@ -0,0 +1,178 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Declarative script module function bindings
+//
+// AVIUTL2_SCRIPT_BIND0 ... AVIUTL2_SCRIPT_BIND4 generate an aviutl2_script_module_function callback from a typed
+// signature: the arguments are read with the matching get_param_* function and the return value is pushed with the
+// matching push_result_* function.
+//   static double lerp(double a, double b, double t) { return a + (b - a) * t; }
+//   AVIUTL2_SCRIPT_BIND3(script_lerp, double, lerp, double, double, double)
+//
+//   static struct aviutl2_script_module_function functions[] = {
+//       AVIUTL2_SCRIPT_BIND_ENTRY(lerp, script_lerp),
+//       {NULL, NULL},
+//   };
+//
+// Type tags: int, double, boolean (bool), string (char const *), data (void *); the return type can also be void.
+//
+// Argument types are trusted by default, so a call costs only the getter calls. Define AVIUTL2_SCRIPT_BIND_CHECKED
+// to 1 before including this header to check every argument with get_param_type() and report mismatches with
+// set_error(), or use the AVIUTL2_SCRIPT_BINDn_CHECKED variants to check individual functions.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "aviutl2_module2.h"
+
+#ifndef AVIUTL2_SCRIPT_BIND_CHECKED
+#  define AVIUTL2_SCRIPT_BIND_CHECKED 0
+#endif
+
+#define AVIUTL2_SCRIPT_BIND_GET_int(param, index) (param)->get_param_int(index)
+#define AVIUTL2_SCRIPT_BIND_GET_double(param, index) (param)->get_param_double(index)
+#define AVIUTL2_SCRIPT_BIND_GET_boolean(param, index) (param)->get_param_boolean(index)
+#define AVIUTL2_SCRIPT_BIND_GET_string(param, index) (param)->get_param_string(index)
+#define AVIUTL2_SCRIPT_BIND_GET_data(param, index) (param)->get_param_data(index)
+
+#define AVIUTL2_SCRIPT_BIND_RET_void(param, expr) (expr)
+#define AVIUTL2_SCRIPT_BIND_RET_int(param, expr) (param)->push_result_int(expr)
+#define AVIUTL2_SCRIPT_BIND_RET_double(param, expr) (param)->push_result_double(expr)
+#define AVIUTL2_SCRIPT_BIND_RET_boolean(param, expr) (param)->push_result_boolean(expr)
+#define AVIUTL2_SCRIPT_BIND_RET_string(param, expr) (param)->push_result_string(expr)
+#define AVIUTL2_SCRIPT_BIND_RET_data(param, expr) (param)->push_result_data(expr)
+
+#define AVIUTL2_SCRIPT_BIND_PARAM_BIT_(type) (1u << (unsigned)(type))
+
+// Parameter types accepted by each tag; numbers are accepted as strings because Lua converts them implicitly.
+#define AVIUTL2_SCRIPT_BIND_ACCEPT_int AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_number)
+#define AVIUTL2_SCRIPT_BIND_ACCEPT_double AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_number)
+#define AVIUTL2_SCRIPT_BIND_ACCEPT_boolean                                                                             \
+  (AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_boolean) | AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_nil))
+#define AVIUTL2_SCRIPT_BIND_ACCEPT_string                                                                              \
+  (AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_string) |                                                         \
+   AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_number))
+#define AVIUTL2_SCRIPT_BIND_ACCEPT_data                                                                                \
+  (AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_lightuserdata) |                                                  \
+   AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_userdata) | AVIUTL2_SCRIPT_BIND_PARAM_BIT_(aviutl2_param_type_nil))
+
+#define AVIUTL2_SCRIPT_BIND_NAME_int "number"
+#define AVIUTL2_SCRIPT_BIND_NAME_double "number"
+#define AVIUTL2_SCRIPT_BIND_NAME_boolean "boolean"
+#define AVIUTL2_SCRIPT_BIND_NAME_string "string"
+#define AVIUTL2_SCRIPT_BIND_NAME_data "userdata"
+
+/**
+ * Check the type of an argument
+ * @param param Parameter interface
+ * @param index Parameter position (0 based)
+ * @param accept Bit mask of accepted aviutl2_param_type values
+ * @param message Error message reported with set_error() on mismatch
+ * @return true if the type is accepted
+ */
+static inline bool aviutl2_script_bind_check(struct aviutl2_script_module_param *param,
+                                             int index,
+                                             unsigned accept,
+                                             char const *message) {
+  enum aviutl2_param_type const type = param->get_param_type(index);
+  if (type >= 0 && (accept & AVIUTL2_SCRIPT_BIND_PARAM_BIT_(type))) {
+    return true;
+  }
+  param->set_error(message);
+  return false;
+}
+
+// The error message is built at compile time so that no formatting happens on the call path.
+#define AVIUTL2_SCRIPT_BIND_ARG_(param, index, pos, t, name, checked)                                                  \
+  (!(checked) || aviutl2_script_bind_check((param),                                                                    \
+                                           (index),                                                                    \
+                                           AVIUTL2_SCRIPT_BIND_ACCEPT_##t,                                             \
+                                           "bad argument #" pos " to '" #name "' (" AVIUTL2_SCRIPT_BIND_NAME_##t       \
+                                           " expected)"))
+
+#define AVIUTL2_SCRIPT_BIND0_(name, ret, fn, checked)                                                                  \
+  static void name(struct aviutl2_script_module_param *param) {                                                        \
+    (void)param;                                                                                                       \
+    AVIUTL2_SCRIPT_BIND_RET_##ret(param, fn());                                                                        \
+  }
+
+#define AVIUTL2_SCRIPT_BIND1_(name, ret, fn, checked, t0)                                                              \
+  static void name(struct aviutl2_script_module_param *param) {                                                        \
+    if (!AVIUTL2_SCRIPT_BIND_ARG_(param, 0, "1", t0, name, checked)) {                                                 \
+      return;                                                                                                          \
+    }                                                                                                                  \
+    AVIUTL2_SCRIPT_BIND_RET_##ret(param, fn(AVIUTL2_SCRIPT_BIND_GET_##t0(param, 0)));                                  \
+  }
+
+#define AVIUTL2_SCRIPT_BIND2_(name, ret, fn, checked, t0, t1)                                                          \
+  static void name(struct aviutl2_script_module_param *param) {                                                        \
+    if (!AVIUTL2_SCRIPT_BIND_ARG_(param, 0, "1", t0, name, checked) ||                                                 \
+        !AVIUTL2_SCRIPT_BIND_ARG_(param, 1, "2", t1, name, checked)) {                                                 \
+      return;                                                                                                          \
+    }                                                                                                                  \
+    AVIUTL2_SCRIPT_BIND_RET_##ret(param,                                                                               \
+                                  fn(AVIUTL2_SCRIPT_BIND_GET_##t0(param, 0), AVIUTL2_SCRIPT_BIND_GET_##t1(param, 1))); \
+  }
+
+#define AVIUTL2_SCRIPT_BIND3_(name, ret, fn, checked, t0, t1, t2)                                                      \
+  static void name(struct aviutl2_script_module_param *param) {                                                        \
+    if (!AVIUTL2_SCRIPT_BIND_ARG_(param, 0, "1", t0, name, checked) ||                                                 \
+        !AVIUTL2_SCRIPT_BIND_ARG_(param, 1, "2", t1, name, checked) ||                                                 \
+        !AVIUTL2_SCRIPT_BIND_ARG_(param, 2, "3", t2, name, checked)) {                                                 \
+      return;                                                                                                          \
+    }                                                                                                                  \
+    AVIUTL2_SCRIPT_BIND_RET_##ret(param,                                                                               \
+                                  fn(AVIUTL2_SCRIPT_BIND_GET_##t0(param, 0),                                           \
+                                     AVIUTL2_SCRIPT_BIND_GET_##t1(param, 1),                                           \
+                                     AVIUTL2_SCRIPT_BIND_GET_##t2(param, 2)));                                         \
+  }
+
+#define AVIUTL2_SCRIPT_BIND4_(name, ret, fn, checked, t0, t1, t2, t3)                                                  \
+  static void name(struct aviutl2_script_module_param *param) {                                                        \
+    if (!AVIUTL2_SCRIPT_BIND_ARG_(param, 0, "1", t0, name, checked) ||                                                 \
+        !AVIUTL2_SCRIPT_BIND_ARG_(param, 1, "2", t1, name, checked) ||                                                 \
+        !AVIUTL2_SCRIPT_BIND_ARG_(param, 2, "3", t2, name, checked) ||                                                 \
+        !AVIUTL2_SCRIPT_BIND_ARG_(param, 3, "4", t3, name, checked)) {                                                 \
+      return;                                                                                                          \
+    }                                                                                                                  \
+    AVIUTL2_SCRIPT_BIND_RET_##ret(param,                                                                               \
+                                  fn(AVIUTL2_SCRIPT_BIND_GET_##t0(param, 0),                                           \
+                                     AVIUTL2_SCRIPT_BIND_GET_##t1(param, 1),                                           \
+                                     AVIUTL2_SCRIPT_BIND_GET_##t2(param, 2),                                           \
+                                     AVIUTL2_SCRIPT_BIND_GET_##t3(param, 3)));                                         \
+  }
+
+/**
+ * Define a script module function that calls fn with 0 to 4 typed arguments
+ * @param name Name of the generated callback
+ * @param ret Return type tag (void, int, double, boolean, string, data)
+ * @param fn Function to call
+ * @param t0... Argument type tags (int, double, boolean, string, data)
+ */
+#define AVIUTL2_SCRIPT_BIND0(name, ret, fn) AVIUTL2_SCRIPT_BIND0_(name, ret, fn, AVIUTL2_SCRIPT_BIND_CHECKED)
+#define AVIUTL2_SCRIPT_BIND1(name, ret, fn, t0) AVIUTL2_SCRIPT_BIND1_(name, ret, fn, AVIUTL2_SCRIPT_BIND_CHECKED, t0)
+#define AVIUTL2_SCRIPT_BIND2(name, ret, fn, t0, t1)                                                                    \
+  AVIUTL2_SCRIPT_BIND2_(name, ret, fn, AVIUTL2_SCRIPT_BIND_CHECKED, t0, t1)
+#define AVIUTL2_SCRIPT_BIND3(name, ret, fn, t0, t1, t2)                                                                \
+  AVIUTL2_SCRIPT_BIND3_(name, ret, fn, AVIUTL2_SCRIPT_BIND_CHECKED, t0, t1, t2)
+#define AVIUTL2_SCRIPT_BIND4(name, ret, fn, t0, t1, t2, t3)                                                            \
+  AVIUTL2_SCRIPT_BIND4_(name, ret, fn, AVIUTL2_SCRIPT_BIND_CHECKED, t0, t1, t2, t3)
+
+/**
+ * Same as AVIUTL2_SCRIPT_BINDn but always checks the argument types
+ */
+#define AVIUTL2_SCRIPT_BIND1_CHECKED(name, ret, fn, t0) AVIUTL2_SCRIPT_BIND1_(name, ret, fn, 1, t0)
+#define AVIUTL2_SCRIPT_BIND2_CHECKED(name, ret, fn, t0, t1) AVIUTL2_SCRIPT_BIND2_(name, ret, fn, 1, t0, t1)
+#define AVIUTL2_SCRIPT_BIND3_CHECKED(name, ret, fn, t0, t1, t2) AVIUTL2_SCRIPT_BIND3_(name, ret, fn, 1, t0, t1, t2)
+#define AVIUTL2_SCRIPT_BIND4_CHECKED(name, ret, fn, t0, t1, t2, t3)                                                    \
+  AVIUTL2_SCRIPT_BIND4_(name, ret, fn, 1, t0, t1, t2, t3)
+
+#define AVIUTL2_SCRIPT_BIND_WIDE_(str) L##str
+
+/**
+ * Function list entry for a generated callback
+ * @param script_name Function name used by scripts (identifier)
+ * @param name Name of the generated callback
+ */
+#define AVIUTL2_SCRIPT_BIND_ENTRY(script_name, name) {AVIUTL2_SCRIPT_BIND_WIDE_(#script_name), name}
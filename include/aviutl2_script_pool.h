@@ -0,0 +1,355 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Object pool for script module metatable userdata
+//
+// Objects returned to scripts with push_result_meta_table() are allocated from fixed-size slots in chunks that are
+// never freed while the pool is alive, so creating and collecting objects does not touch the heap after warm-up.
+// Free slots are kept in several lists selected by the calling thread to reduce lock contention.
+//
+// The userdata value given to the host is a handle made of the slot index and a generation counter rather than a
+// pointer. A handle that outlives its object (for example one stored by plugin code and used after __gc) resolves to
+// NULL instead of reaching a slot that was reused for another object.
+//
+// The metamethod callbacks do not receive the pool, so each object type wraps it in its own functions:
+//   static struct aviutl2_script_pool vec_pool;
+//   static void vec_gc(struct aviutl2_script_module_param *param) { aviutl2_script_pool_gc(&vec_pool, param); }
+//   static void vec_index(struct aviutl2_script_module_param *param) {
+//     struct vec *v = aviutl2_script_pool_self(&vec_pool, param);
+//     ...
+//   }
+//   static struct aviutl2_meta_method_function vec_methods[] = {{"__index", vec_index}, {"__gc", vec_gc}, {NULL}};
+//   // once: aviutl2_script_pool_init(&vec_pool, sizeof(struct vec), vec_methods, NULL);
+//   // in a function: struct vec *v = aviutl2_script_pool_push_new(&vec_pool, param);
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_module2.h"
+
+enum {
+  aviutl2_script_pool_chunk_bits = 10,
+  aviutl2_script_pool_chunk_slots = 1 << aviutl2_script_pool_chunk_bits,
+  aviutl2_script_pool_max_chunks = 4096,
+  aviutl2_script_pool_shards = 8,
+};
+
+/**
+ * Object handle
+ * Upper 32 bits are the generation and lower 32 bits are the slot index + 1 (0 is never a valid handle).
+ * Handles are passed to the host as the userdata pointer, which requires a 64-bit build.
+ */
+typedef uint64_t aviutl2_script_pool_handle;
+
+struct aviutl2_script_pool_chunk {
+  LONG volatile generation[aviutl2_script_pool_chunk_slots]; /**< Odd while the slot is in use */
+  uint32_t next[aviutl2_script_pool_chunk_slots];            /**< Next free slot index + 1 */
+  uint8_t *objects;                                          /**< 16-byte aligned object storage */
+};
+
+struct aviutl2_script_pool_shard {
+  SRWLOCK lock;
+  uint32_t head; /**< First free slot index + 1 */
+  uint64_t allocs;
+  uint64_t frees;
+};
+
+/**
+ * Pool statistics
+ */
+struct aviutl2_script_pool_stats {
+  uint64_t allocs; /**< Objects allocated */
+  uint64_t frees;  /**< Objects freed */
+  uint64_t chunks; /**< Chunks allocated from the heap */
+  uint64_t stale;  /**< Frees or lookups with a handle whose object no longer exists */
+};
+
+/**
+ * Object pool
+ * Initialize with aviutl2_script_pool_init() and release with aviutl2_script_pool_exit()
+ */
+struct aviutl2_script_pool {
+  size_t object_size;
+  size_t stride;
+  struct aviutl2_meta_method_function *methods; /**< Metatable of the objects */
+  void (*destroy)(void *object);                /**< Called before a slot is reused (may be NULL) */
+  SRWLOCK grow_lock;
+  struct aviutl2_script_pool_chunk *chunks[aviutl2_script_pool_max_chunks];
+  LONG volatile chunk_num;
+  struct aviutl2_script_pool_shard shards[aviutl2_script_pool_shards];
+  LONG volatile stale;
+};
+
+/**
+ * Initialize a pool
+ * @param pool Pool
+ * @param object_size Size of an object in bytes
+ * @param methods Metamethod list used for push_result_meta_table() and get_param_meta_table(); its __gc should call
+ *                aviutl2_script_pool_gc()
+ * @param destroy Called with an object when it is freed (may be NULL)
+ */
+static inline void aviutl2_script_pool_init(struct aviutl2_script_pool *pool,
+                                            size_t object_size,
+                                            struct aviutl2_meta_method_function *methods,
+                                            void (*destroy)(void *object)) {
+  memset(pool, 0, sizeof(*pool));
+  pool->object_size = object_size;
+  pool->stride = (object_size + 15) & ~(size_t)15;
+  pool->methods = methods;
+  pool->destroy = destroy;
+  InitializeSRWLock(&pool->grow_lock);
+  for (size_t i = 0; i < aviutl2_script_pool_shards; ++i) {
+    InitializeSRWLock(&pool->shards[i].lock);
+  }
+}
+
+/**
+ * Release all chunks
+ * Handles must not be used afterwards, even if the pool is initialized again
+ * @param pool Pool
+ */
+static inline void aviutl2_script_pool_exit(struct aviutl2_script_pool *pool) {
+  for (LONG i = 0; i < pool->chunk_num; ++i) {
+    struct aviutl2_script_pool_chunk *c = pool->chunks[i];
+    if (pool->destroy) {
+      for (size_t j = 0; j < aviutl2_script_pool_chunk_slots; ++j) {
+        if (c->generation[j] & 1) {
+          pool->destroy(c->objects + j * pool->stride);
+        }
+      }
+    }
+    free(c->objects);
+    free(c);
+  }
+  memset(pool, 0, sizeof(*pool));
+}
+
+static inline struct aviutl2_script_pool_shard *aviutl2_script_pool_shard(struct aviutl2_script_pool *pool) {
+  return pool->shards + (GetCurrentThreadId() % aviutl2_script_pool_shards);
+}
+
+static inline uint32_t aviutl2_script_pool_pop(struct aviutl2_script_pool *pool,
+                                               struct aviutl2_script_pool_shard *shard) {
+  AcquireSRWLockExclusive(&shard->lock);
+  uint32_t const slot = shard->head;
+  if (slot) {
+    uint32_t const i = slot - 1;
+    shard->head = pool->chunks[i >> aviutl2_script_pool_chunk_bits]->next[i & (aviutl2_script_pool_chunk_slots - 1)];
+    ++shard->allocs;
+  }
+  ReleaseSRWLockExclusive(&shard->lock);
+  return slot;
+}
+
+static inline uint32_t aviutl2_script_pool_grow(struct aviutl2_script_pool *pool,
+                                                struct aviutl2_script_pool_shard *shard) {
+  AcquireSRWLockExclusive(&pool->grow_lock);
+  LONG const n = pool->chunk_num;
+  struct aviutl2_script_pool_chunk *c = NULL;
+  if (n < aviutl2_script_pool_max_chunks) {
+    c = (struct aviutl2_script_pool_chunk *)calloc(1, sizeof(struct aviutl2_script_pool_chunk));
+  }
+  if (c) {
+    c->objects = (uint8_t *)calloc(aviutl2_script_pool_chunk_slots, pool->stride ? pool->stride : 16);
+    if (!c->objects) {
+      free(c);
+      c = NULL;
+    }
+  }
+  if (!c) {
+    ReleaseSRWLockExclusive(&pool->grow_lock);
+    return 0;
+  }
+  pool->chunks[n] = c;
+  InterlockedExchange(&pool->chunk_num, n + 1);
+  ReleaseSRWLockExclusive(&pool->grow_lock);
+
+  // Keep the first slot for the caller and give the rest to the caller's free list.
+  uint32_t const base = (uint32_t)n << aviutl2_script_pool_chunk_bits;
+  for (uint32_t i = 1; i < aviutl2_script_pool_chunk_slots - 1; ++i) {
+    c->next[i] = base + i + 2;
+  }
+  AcquireSRWLockExclusive(&shard->lock);
+  c->next[aviutl2_script_pool_chunk_slots - 1] = shard->head;
+  shard->head = base + 2;
+  ++shard->allocs;
+  ReleaseSRWLockExclusive(&shard->lock);
+  return base + 1;
+}
+
+/**
+ * Allocate a zero-initialized object
+ * @param pool Pool
+ * @param handle Pointer to storage for the handle
+ * @return Object, or NULL if memory allocation failed
+ */
+static inline void *aviutl2_script_pool_alloc(struct aviutl2_script_pool *pool, aviutl2_script_pool_handle *handle) {
+  struct aviutl2_script_pool_shard *const own = aviutl2_script_pool_shard(pool);
+  uint32_t slot = aviutl2_script_pool_pop(pool, own);
+  for (size_t i = 1; !slot && i < aviutl2_script_pool_shards; ++i) {
+    // Objects freed on other threads accumulate in their lists.
+    size_t const shard = ((size_t)(own - pool->shards) + i) % aviutl2_script_pool_shards;
+    slot = aviutl2_script_pool_pop(pool, pool->shards + shard);
+  }
+  if (!slot) {
+    slot = aviutl2_script_pool_grow(pool, own);
+    if (!slot) {
+      return NULL;
+    }
+  }
+  uint32_t const i = slot - 1;
+  struct aviutl2_script_pool_chunk *c = pool->chunks[i >> aviutl2_script_pool_chunk_bits];
+  uint32_t const j = i & (aviutl2_script_pool_chunk_slots - 1);
+  LONG const generation = InterlockedIncrement(&c->generation[j]);
+  void *object = c->objects + j * pool->stride;
+  memset(object, 0, pool->object_size);
+  *handle = ((uint64_t)(uint32_t)generation << 32) | slot;
+  return object;
+}
+
+/**
+ * Get the object of a handle
+ * @param pool Pool
+ * @param handle Handle
+ * @return Object, or NULL if the handle is invalid or the object was freed
+ */
+static inline void *aviutl2_script_pool_resolve(struct aviutl2_script_pool *pool, aviutl2_script_pool_handle handle) {
+  uint32_t const slot = (uint32_t)handle;
+  uint32_t const i = slot - 1;
+  if (!slot || (LONG)(i >> aviutl2_script_pool_chunk_bits) >= pool->chunk_num) {
+    return NULL;
+  }
+  struct aviutl2_script_pool_chunk *c = pool->chunks[i >> aviutl2_script_pool_chunk_bits];
+  uint32_t const j = i & (aviutl2_script_pool_chunk_slots - 1);
+  if ((uint32_t)c->generation[j] != (uint32_t)(handle >> 32)) {
+    InterlockedIncrement(&pool->stale);
+    return NULL;
+  }
+  return c->objects + j * pool->stride;
+}
+
+/**
+ * Free an object
+ * Freeing the same handle twice is detected and ignored
+ * @param pool Pool
+ * @param handle Handle
+ * @return false if the handle is invalid or the object was already freed
+ */
+static inline bool aviutl2_script_pool_free(struct aviutl2_script_pool *pool, aviutl2_script_pool_handle handle) {
+  void *object = aviutl2_script_pool_resolve(pool, handle);
+  if (!object) {
+    return false;
+  }
+  uint32_t const slot = (uint32_t)handle;
+  uint32_t const i = slot - 1;
+  struct aviutl2_script_pool_chunk *c = pool->chunks[i >> aviutl2_script_pool_chunk_bits];
+  uint32_t const j = i & (aviutl2_script_pool_chunk_slots - 1);
+  LONG const generation = (LONG)(uint32_t)(handle >> 32);
+  // Only one of concurrent frees of the same handle wins.
+  if (InterlockedCompareExchange(&c->generation[j], (LONG)((uint32_t)generation + 1), generation) != generation) {
+    InterlockedIncrement(&pool->stale);
+    return false;
+  }
+  if (pool->destroy) {
+    pool->destroy(object);
+  }
+  struct aviutl2_script_pool_shard *shard = aviutl2_script_pool_shard(pool);
+  AcquireSRWLockExclusive(&shard->lock);
+  c->next[j] = shard->head;
+  shard->head = slot;
+  ++shard->frees;
+  ReleaseSRWLockExclusive(&shard->lock);
+  return true;
+}
+
+/**
+ * Return an object to the script
+ * @param pool Pool
+ * @param param Parameter interface
+ * @param handle Handle
+ */
+static inline void aviutl2_script_pool_push(struct aviutl2_script_pool *pool,
+                                            struct aviutl2_script_module_param *param,
+                                            aviutl2_script_pool_handle handle) {
+  param->push_result_meta_table(pool->methods, (void *)(uintptr_t)handle);
+}
+
+/**
+ * Allocate an object and return it to the script
+ * @param pool Pool
+ * @param param Parameter interface
+ * @return Object to fill in, or NULL if memory allocation failed (an error is set)
+ */
+static inline void *aviutl2_script_pool_push_new(struct aviutl2_script_pool *pool,
+                                                 struct aviutl2_script_module_param *param) {
+  aviutl2_script_pool_handle handle;
+  void *object = aviutl2_script_pool_alloc(pool, &handle);
+  if (!object) {
+    param->set_error("failed to allocate object");
+    return NULL;
+  }
+  aviutl2_script_pool_push(pool, param, handle);
+  return object;
+}
+
+/**
+ * Get an object passed by the script
+ * @param pool Pool
+ * @param param Parameter interface
+ * @param index Parameter position (0 based)
+ * @return Object, or NULL if the parameter is not an object of this pool or the object no longer exists
+ */
+static inline void *
+aviutl2_script_pool_get(struct aviutl2_script_pool *pool, struct aviutl2_script_module_param *param, int index) {
+  void *const userdata = param->get_param_meta_table(index, pool->methods);
+  return userdata ? aviutl2_script_pool_resolve(pool, (aviutl2_script_pool_handle)(uintptr_t)userdata) : NULL;
+}
+
+/**
+ * Get the object a metamethod was called for
+ * @param pool Pool
+ * @param param Parameter interface passed to the metamethod
+ * @return Object, or NULL if it no longer exists
+ */
+static inline void *aviutl2_script_pool_self(struct aviutl2_script_pool *pool,
+                                             struct aviutl2_script_module_param *param) {
+  return aviutl2_script_pool_resolve(pool, (aviutl2_script_pool_handle)(uintptr_t)param->userdata);
+}
+
+/**
+ * Free the object a __gc metamethod was called for
+ * @param pool Pool
+ * @param param Parameter interface passed to __gc
+ */
+static inline void aviutl2_script_pool_gc(struct aviutl2_script_pool *pool, struct aviutl2_script_module_param *param) {
+  aviutl2_script_pool_free(pool, (aviutl2_script_pool_handle)(uintptr_t)param->userdata);
+}
+
+/**
+ * Get a snapshot of the pool statistics
+ * @param pool Pool
+ * @return Statistics
+ */
+static inline struct aviutl2_script_pool_stats aviutl2_script_pool_get_stats(struct aviutl2_script_pool *pool) {
+  struct aviutl2_script_pool_stats stats = {
+      .chunks = (uint64_t)pool->chunk_num,
+      .stale = (uint64_t)(uint32_t)pool->stale,
+  };
+  for (size_t i = 0; i < aviutl2_script_pool_shards; ++i) {
+    struct aviutl2_script_pool_shard *shard = pool->shards + i;
+    AcquireSRWLockShared(&shard->lock);
+    stats.allocs += shard->allocs;
+    stats.frees += shard->frees;
+    ReleaseSRWLockShared(&shard->lock);
+  }
+  return stats;
+}
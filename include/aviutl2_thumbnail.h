@@ -0,0 +1,605 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Timeline thumbnail service
+//
+// Renders object frames through aviutl2_edit_handle::rendering_object_video(), downscales them with
+// aviutl2_image_downscale_box() and keeps the results in a set-associative memory cache backed by an optional
+// on-disk cache. Thumbnails are keyed by object handle, alias hash and frame; the disk cache uses only the alias hash
+// and frame so that it survives application restarts.
+//
+// Typical usage:
+//   - aviutl2_thumbnail_service_init() after creating the edit handle
+//   - aviutl2_thumbnail_service_update_visible() from a read section whenever the visible range changes
+//   - aviutl2_thumbnail_service_get() from the UI when painting
+//   - aviutl2_thumbnail_service_exit() in UninitializePlugin()
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_hash.h"
+#include "aviutl2_image_scale.h"
+#include "aviutl2_plugin2.h"
+
+/**
+ * Number of entries per cache set
+ */
+enum {
+  aviutl2_thumbnail_ways = 4,
+};
+
+/**
+ * Thumbnail key
+ */
+struct aviutl2_thumbnail_key {
+  aviutl2_object_handle object; /**< Object handle */
+  uint64_t alias_hash;          /**< Hash of object alias data (see aviutl2_thumbnail_alias_hash()) */
+  int frame;                    /**< Frame number passed to rendering_object_video() */
+};
+
+/**
+ * Thumbnail entry state
+ */
+enum aviutl2_thumbnail_state {
+  aviutl2_thumbnail_state_empty = 0,   /**< Unused */
+  aviutl2_thumbnail_state_pending = 1, /**< Waiting for rendering */
+  aviutl2_thumbnail_state_ready = 2,   /**< Thumbnail is available */
+};
+
+/**
+ * Thumbnail cache entry
+ */
+struct aviutl2_thumbnail_entry {
+  struct aviutl2_thumbnail_key key;
+  enum aviutl2_thumbnail_state state;
+  int width, height;
+  uint64_t last_used;
+  struct aviutl2_pixel_rgba *pixels; /**< max_width * max_height pixels, allocated on init */
+};
+
+/**
+ * Thumbnail service statistics
+ */
+struct aviutl2_thumbnail_stats {
+  uint64_t memory_hits;     /**< Requests served from memory */
+  uint64_t disk_hits;       /**< Requests served from the disk cache */
+  uint64_t renders;         /**< Render requests issued */
+  uint64_t render_failures; /**< Render requests that failed or were rejected */
+  uint64_t completed;       /**< Rendered thumbnails stored */
+};
+
+/**
+ * Thumbnail service
+ * All members are private; use the aviutl2_thumbnail_service_* functions
+ */
+struct aviutl2_thumbnail_service {
+  struct aviutl2_edit_handle *edit;
+  wchar_t *cache_dir;
+  int max_width, max_height;
+  bool apply_effect;
+  SRWLOCK lock;
+  struct aviutl2_thumbnail_entry *entries;
+  size_t set_num;
+  uint64_t tick;
+  struct aviutl2_thumbnail_stats stats;
+};
+
+/**
+ * On-disk thumbnail header
+ * Followed by width * height PIXEL_RGBA pixels
+ */
+struct aviutl2_thumbnail_file_header {
+  uint32_t magic;   /**< 'A''U''T''H' */
+  uint32_t version; /**< 1 */
+  uint64_t disk_key;
+  int32_t width, height;
+};
+
+enum {
+  aviutl2_thumbnail_file_magic = 0x48545541,
+  aviutl2_thumbnail_file_version = 1,
+};
+
+/**
+ * Hash object alias data for use in aviutl2_thumbnail_key
+ * @param alias Object alias data (UTF-8) returned by get_object_alias()
+ * @return Alias hash
+ */
+static inline uint64_t aviutl2_thumbnail_alias_hash(char const *alias) {
+  return aviutl2_hash_str(AVIUTL2_HASH_INIT, alias);
+}
+
+static inline bool aviutl2_thumbnail_key_equal(struct aviutl2_thumbnail_key const *a,
+                                               struct aviutl2_thumbnail_key const *b) {
+  return a->object == b->object && a->alias_hash == b->alias_hash && a->frame == b->frame;
+}
+
+static inline uint64_t aviutl2_thumbnail_disk_key(struct aviutl2_thumbnail_service const *svc,
+                                                  struct aviutl2_thumbnail_key const *key) {
+  uint64_t h = aviutl2_hash_u64(AVIUTL2_HASH_INIT, key->alias_hash);
+  h = aviutl2_hash_u64(h, (uint64_t)(uint32_t)key->frame);
+  h = aviutl2_hash_u64(h, svc->apply_effect ? 1 : 0);
+  return aviutl2_hash_u64(h, ((uint64_t)(uint32_t)svc->max_width << 32) | (uint32_t)svc->max_height);
+}
+
+static inline struct aviutl2_thumbnail_entry *aviutl2_thumbnail_set(struct aviutl2_thumbnail_service *svc,
+                                                                    struct aviutl2_thumbnail_key const *key) {
+  uint64_t h = aviutl2_hash_u64(AVIUTL2_HASH_INIT, (uint64_t)(uintptr_t)key->object);
+  h = aviutl2_hash_u64(h, key->alias_hash);
+  h = aviutl2_hash_u64(h, (uint64_t)(uint32_t)key->frame);
+  return svc->entries + (size_t)(h % svc->set_num) * aviutl2_thumbnail_ways;
+}
+
+/**
+ * Find an entry. Must be called with the lock held
+ */
+static inline struct aviutl2_thumbnail_entry *aviutl2_thumbnail_find(struct aviutl2_thumbnail_service *svc,
+                                                                     struct aviutl2_thumbnail_key const *key) {
+  struct aviutl2_thumbnail_entry *set = aviutl2_thumbnail_set(svc, key);
+  for (int i = 0; i < aviutl2_thumbnail_ways; ++i) {
+    if (set[i].state != aviutl2_thumbnail_state_empty && aviutl2_thumbnail_key_equal(&set[i].key, key)) {
+      return set + i;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Select an entry to store a new key, evicting the least recently used ready entry
+ * Pending entries are never evicted. Must be called with the exclusive lock held
+ * @return Entry, or NULL if every entry in the set is pending
+ */
+static inline struct aviutl2_thumbnail_entry *aviutl2_thumbnail_victim(struct aviutl2_thumbnail_service *svc,
+                                                                       struct aviutl2_thumbnail_key const *key) {
+  struct aviutl2_thumbnail_entry *set = aviutl2_thumbnail_set(svc, key);
+  struct aviutl2_thumbnail_entry *victim = NULL;
+  for (int i = 0; i < aviutl2_thumbnail_ways; ++i) {
+    if (set[i].state == aviutl2_thumbnail_state_empty) {
+      return set + i;
+    }
+    if (set[i].state == aviutl2_thumbnail_state_ready && (!victim || set[i].last_used < victim->last_used)) {
+      victim = set + i;
+    }
+  }
+  return victim;
+}
+
+/**
+ * Build the disk cache file path for a key
+ * @param svc Thumbnail service
+ * @param disk_key Disk key
+ * @return Newly allocated path (free with free()), or NULL if the disk cache is disabled
+ */
+static inline wchar_t *aviutl2_thumbnail_file_path(struct aviutl2_thumbnail_service const *svc, uint64_t disk_key) {
+  static wchar_t const hex[] = L"0123456789abcdef";
+  static wchar_t const ext[] = L".thumb";
+  if (!svc->cache_dir) {
+    return NULL;
+  }
+  size_t const dir_len = wcslen(svc->cache_dir);
+  wchar_t *path = (wchar_t *)malloc((dir_len + 1 + 16 + sizeof(ext) / sizeof(ext[0])) * sizeof(wchar_t));
+  if (!path) {
+    return NULL;
+  }
+  wchar_t *p = path;
+  memcpy(p, svc->cache_dir, dir_len * sizeof(wchar_t));
+  p += dir_len;
+  *p++ = L'\\';
+  for (int i = 15; i >= 0; --i) {
+    *p++ = hex[(disk_key >> (i * 4)) & 0xf];
+  }
+  memcpy(p, ext, sizeof(ext));
+  return path;
+}
+
+/**
+ * Load a thumbnail from the disk cache
+ * @return true if the thumbnail was loaded into pixels
+ */
+static inline bool aviutl2_thumbnail_file_load(struct aviutl2_thumbnail_service const *svc,
+                                               uint64_t disk_key,
+                                               struct aviutl2_pixel_rgba *pixels,
+                                               int *width,
+                                               int *height) {
+  wchar_t *path = aviutl2_thumbnail_file_path(svc, disk_key);
+  if (!path) {
+    return false;
+  }
+  bool ok = false;
+  HANDLE h = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  free(path);
+  if (h == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  struct aviutl2_thumbnail_file_header header;
+  DWORD read = 0;
+  DWORD size = 0;
+  if (!ReadFile(h, &header, sizeof(header), &read, NULL) || read != sizeof(header)) {
+    goto cleanup;
+  }
+  if (header.magic != aviutl2_thumbnail_file_magic || header.version != aviutl2_thumbnail_file_version ||
+      header.disk_key != disk_key || header.width <= 0 || header.height <= 0 || header.width > svc->max_width ||
+      header.height > svc->max_height) {
+    goto cleanup;
+  }
+  size = (DWORD)header.width * (DWORD)header.height * sizeof(struct aviutl2_pixel_rgba);
+  if (!ReadFile(h, pixels, size, &read, NULL) || read != size) {
+    goto cleanup;
+  }
+  *width = header.width;
+  *height = header.height;
+  ok = true;
+cleanup:
+  CloseHandle(h);
+  return ok;
+}
+
+/**
+ * Store a thumbnail to the disk cache
+ * The file is written to a temporary name and then renamed so that readers never see a partial file
+ */
+static inline void aviutl2_thumbnail_file_store(struct aviutl2_thumbnail_service const *svc,
+                                                uint64_t disk_key,
+                                                struct aviutl2_pixel_rgba const *pixels,
+                                                int width,
+                                                int height) {
+  wchar_t *path = aviutl2_thumbnail_file_path(svc, disk_key);
+  if (!path) {
+    return;
+  }
+  size_t const len = wcslen(path);
+  wchar_t *tmp = (wchar_t *)malloc((len + 5) * sizeof(wchar_t));
+  if (!tmp) {
+    free(path);
+    return;
+  }
+  memcpy(tmp, path, len * sizeof(wchar_t));
+  memcpy(tmp + len, L".tmp", 5 * sizeof(wchar_t));
+  HANDLE h = CreateFileW(tmp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (h != INVALID_HANDLE_VALUE) {
+    struct aviutl2_thumbnail_file_header const header = {
+        .magic = aviutl2_thumbnail_file_magic,
+        .version = aviutl2_thumbnail_file_version,
+        .disk_key = disk_key,
+        .width = width,
+        .height = height,
+    };
+    DWORD const size = (DWORD)width * (DWORD)height * sizeof(struct aviutl2_pixel_rgba);
+    DWORD written = 0, written2 = 0;
+    bool const ok = WriteFile(h, &header, sizeof(header), &written, NULL) && written == sizeof(header) &&
+                    WriteFile(h, pixels, size, &written2, NULL) && written2 == size;
+    CloseHandle(h);
+    if (!ok || !MoveFileExW(tmp, path, MOVEFILE_REPLACE_EXISTING)) {
+      DeleteFileW(tmp);
+    }
+  }
+  free(tmp);
+  free(path);
+}
+
+/**
+ * Release all resources owned by the thumbnail service
+ * Waits for outstanding rendering tasks. Do not call while holding a read lock or edit lock
+ * @param svc Thumbnail service
+ */
+static inline void aviutl2_thumbnail_service_exit(struct aviutl2_thumbnail_service *svc) {
+  if (!svc) {
+    return;
+  }
+  if (svc->edit && svc->entries) {
+    svc->edit->wait_rendering_task();
+  }
+  if (svc->entries) {
+    for (size_t i = 0; i < svc->set_num * aviutl2_thumbnail_ways; ++i) {
+      free(svc->entries[i].pixels);
+    }
+    free(svc->entries);
+  }
+  free(svc->cache_dir);
+  memset(svc, 0, sizeof(*svc));
+}
+
+/**
+ * Initialize the thumbnail service
+ * @param svc Thumbnail service
+ * @param edit Edit handle
+ * @param cache_dir Disk cache directory (NULL disables the disk cache). The directory is created if it does not exist
+ * @param max_width Maximum thumbnail width
+ * @param max_height Maximum thumbnail height
+ * @param capacity Number of thumbnails kept in memory (rounded up to a multiple of aviutl2_thumbnail_ways)
+ * @param apply_effect Whether to apply additional filter effects when rendering
+ * @return true on success
+ */
+static inline bool aviutl2_thumbnail_service_init(struct aviutl2_thumbnail_service *svc,
+                                                  struct aviutl2_edit_handle *edit,
+                                                  wchar_t const *cache_dir,
+                                                  int max_width,
+                                                  int max_height,
+                                                  size_t capacity,
+                                                  bool apply_effect) {
+  if (!svc || !edit || max_width <= 0 || max_height <= 0 || capacity == 0) {
+    return false;
+  }
+  memset(svc, 0, sizeof(*svc));
+  svc->edit = edit;
+  svc->max_width = max_width;
+  svc->max_height = max_height;
+  svc->apply_effect = apply_effect;
+  InitializeSRWLock(&svc->lock);
+  svc->set_num = (capacity + aviutl2_thumbnail_ways - 1) / aviutl2_thumbnail_ways;
+  size_t const n = svc->set_num * aviutl2_thumbnail_ways;
+  svc->entries = (struct aviutl2_thumbnail_entry *)calloc(n, sizeof(struct aviutl2_thumbnail_entry));
+  if (!svc->entries) {
+    goto failed;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    svc->entries[i].pixels = (struct aviutl2_pixel_rgba *)malloc((size_t)max_width * (size_t)max_height *
+                                                                 sizeof(struct aviutl2_pixel_rgba));
+    if (!svc->entries[i].pixels) {
+      goto failed;
+    }
+  }
+  if (cache_dir && cache_dir[0]) {
+    size_t const len = wcslen(cache_dir);
+    svc->cache_dir = (wchar_t *)malloc((len + 1) * sizeof(wchar_t));
+    if (!svc->cache_dir) {
+      goto failed;
+    }
+    memcpy(svc->cache_dir, cache_dir, (len + 1) * sizeof(wchar_t));
+    if (len > 0 && (svc->cache_dir[len - 1] == L'\\' || svc->cache_dir[len - 1] == L'/')) {
+      svc->cache_dir[len - 1] = L'\0';
+    }
+    CreateDirectoryW(svc->cache_dir, NULL);
+  }
+  return true;
+
+failed:
+  svc->edit = NULL;
+  aviutl2_thumbnail_service_exit(svc);
+  return false;
+}
+
+struct aviutl2_thumbnail_request {
+  struct aviutl2_thumbnail_service *svc;
+  struct aviutl2_thumbnail_key key;
+};
+
+/**
+ * Rendering completion callback. Called from the event notification thread
+ */
+static inline void aviutl2_thumbnail_on_rendered(
+    void *param, int frame, void const *buffer, int width, int height, int pitch) {
+  (void)frame;
+  struct aviutl2_thumbnail_request *req = (struct aviutl2_thumbnail_request *)param;
+  struct aviutl2_thumbnail_service *svc = req->svc;
+  int tw = 0, th = 0;
+  struct aviutl2_pixel_rgba *pixels = NULL;
+  if (buffer && width > 0 && height > 0) {
+    aviutl2_image_fit_size(width, height, svc->max_width, svc->max_height, &tw, &th);
+    pixels = (struct aviutl2_pixel_rgba *)malloc((size_t)tw * (size_t)th * sizeof(struct aviutl2_pixel_rgba));
+    if (pixels) {
+      aviutl2_image_downscale_box(pixels, tw, th, tw * 4, buffer, width, height, pitch);
+    }
+  }
+  AcquireSRWLockExclusive(&svc->lock);
+  struct aviutl2_thumbnail_entry *e = aviutl2_thumbnail_find(svc, &req->key);
+  if (e && e->state == aviutl2_thumbnail_state_pending) {
+    if (pixels) {
+      memcpy(e->pixels, pixels, (size_t)tw * (size_t)th * sizeof(struct aviutl2_pixel_rgba));
+      e->width = tw;
+      e->height = th;
+      e->state = aviutl2_thumbnail_state_ready;
+      ++svc->stats.completed;
+    } else {
+      e->state = aviutl2_thumbnail_state_empty;
+      ++svc->stats.render_failures;
+    }
+  }
+  ReleaseSRWLockExclusive(&svc->lock);
+  if (pixels) {
+    aviutl2_thumbnail_file_store(svc, aviutl2_thumbnail_disk_key(svc, &req->key), pixels, tw, th);
+    free(pixels);
+  }
+  free(req);
+}
+
+/**
+ * Request a thumbnail
+ * Looks up the memory cache, then the disk cache, and finally enqueues a rendering task
+ * @param svc Thumbnail service
+ * @param key Thumbnail key
+ * @return true if the thumbnail is available now
+ */
+static inline bool aviutl2_thumbnail_service_request(struct aviutl2_thumbnail_service *svc,
+                                                     struct aviutl2_thumbnail_key const *key) {
+  AcquireSRWLockExclusive(&svc->lock);
+  struct aviutl2_thumbnail_entry *e = aviutl2_thumbnail_find(svc, key);
+  if (e) {
+    e->last_used = ++svc->tick;
+    bool const ready = e->state == aviutl2_thumbnail_state_ready;
+    if (ready) {
+      ++svc->stats.memory_hits;
+    }
+    ReleaseSRWLockExclusive(&svc->lock);
+    return ready;
+  }
+  e = aviutl2_thumbnail_victim(svc, key);
+  if (!e) {
+    ReleaseSRWLockExclusive(&svc->lock);
+    return false;
+  }
+  // Pending entries are never evicted or written by other threads until a render is issued,
+  // so the disk cache can be read into the entry without holding the lock
+  e->key = *key;
+  e->last_used = ++svc->tick;
+  e->state = aviutl2_thumbnail_state_pending;
+  ReleaseSRWLockExclusive(&svc->lock);
+
+  int width = 0, height = 0;
+  if (aviutl2_thumbnail_file_load(svc, aviutl2_thumbnail_disk_key(svc, key), e->pixels, &width, &height)) {
+    AcquireSRWLockExclusive(&svc->lock);
+    e->width = width;
+    e->height = height;
+    e->state = aviutl2_thumbnail_state_ready;
+    ++svc->stats.disk_hits;
+    ReleaseSRWLockExclusive(&svc->lock);
+    return true;
+  }
+
+  AcquireSRWLockExclusive(&svc->lock);
+  ++svc->stats.renders;
+  ReleaseSRWLockExclusive(&svc->lock);
+
+  struct aviutl2_thumbnail_request *req =
+      (struct aviutl2_thumbnail_request *)malloc(sizeof(struct aviutl2_thumbnail_request));
+  if (req) {
+    req->svc = svc;
+    req->key = *key;
+    if (svc->edit->rendering_object_video(
+            key->object, key->frame, svc->apply_effect, req, aviutl2_thumbnail_on_rendered)) {
+      return false;
+    }
+    free(req);
+  }
+  AcquireSRWLockExclusive(&svc->lock);
+  e = aviutl2_thumbnail_find(svc, key);
+  if (e && e->state == aviutl2_thumbnail_state_pending) {
+    e->state = aviutl2_thumbnail_state_empty;
+  }
+  ++svc->stats.render_failures;
+  ReleaseSRWLockExclusive(&svc->lock);
+  return false;
+}
+
+/**
+ * Request evenly spaced thumbnails in a frame range
+ * @param svc Thumbnail service
+ * @param object Object handle
+ * @param alias_hash Hash of object alias data
+ * @param frame_start First frame
+ * @param frame_end Last frame (inclusive)
+ * @param count Number of thumbnails to request
+ * @return Number of thumbnails available now
+ */
+static inline int aviutl2_thumbnail_service_request_range(struct aviutl2_thumbnail_service *svc,
+                                                          aviutl2_object_handle object,
+                                                          uint64_t alias_hash,
+                                                          int frame_start,
+                                                          int frame_end,
+                                                          int count) {
+  if (frame_end < frame_start || count <= 0) {
+    return 0;
+  }
+  int ready = 0;
+  int64_t const span = (int64_t)frame_end - frame_start + 1;
+  if (count > span) {
+    count = (int)span;
+  }
+  for (int i = 0; i < count; ++i) {
+    struct aviutl2_thumbnail_key const key = {
+        .object = object,
+        .alias_hash = alias_hash,
+        .frame = frame_start + (int)(span * i / count),
+    };
+    if (aviutl2_thumbnail_service_request(svc, &key)) {
+      ++ready;
+    }
+  }
+  return ready;
+}
+
+/**
+ * Request thumbnails for the part of an object that is visible in the layer editor
+ * Call this from a read section (edit->info is not available there, so pass the result of get_edit_info())
+ * @param svc Thumbnail service
+ * @param object Object handle
+ * @param alias_hash Hash of object alias data
+ * @param layer_frame Object layer and frame information from get_object_layer_frame()
+ * @param info Edit information
+ * @param count Number of thumbnails to show across the visible range
+ * @return Number of thumbnails available now
+ */
+static inline int aviutl2_thumbnail_service_update_visible(struct aviutl2_thumbnail_service *svc,
+                                                           aviutl2_object_handle object,
+                                                           uint64_t alias_hash,
+                                                           struct aviutl2_object_layer_frame const *layer_frame,
+                                                           struct aviutl2_edit_info const *info,
+                                                           int count) {
+  int const visible_start = info->display_frame_start;
+  int const visible_end = info->display_frame_start + info->display_frame_num - 1;
+  int const start = layer_frame->start > visible_start ? layer_frame->start : visible_start;
+  int const end = layer_frame->end < visible_end ? layer_frame->end : visible_end;
+  if (end < start) {
+    return 0;
+  }
+  return aviutl2_thumbnail_service_request_range(svc, object, alias_hash, start, end, count);
+}
+
+/**
+ * Copy a ready thumbnail
+ * @param svc Thumbnail service
+ * @param key Thumbnail key
+ * @param dst Destination buffer (at least max_width * max_height pixels when dst_pitch is max_width * 4)
+ * @param dst_pitch Number of bytes per row in dst
+ * @param width Pointer to storage for thumbnail width
+ * @param height Pointer to storage for thumbnail height
+ * @return true if the thumbnail was available
+ */
+static inline bool aviutl2_thumbnail_service_get(struct aviutl2_thumbnail_service *svc,
+                                                 struct aviutl2_thumbnail_key const *key,
+                                                 struct aviutl2_pixel_rgba *dst,
+                                                 int dst_pitch,
+                                                 int *width,
+                                                 int *height) {
+  bool ok = false;
+  AcquireSRWLockShared(&svc->lock);
+  struct aviutl2_thumbnail_entry const *e = aviutl2_thumbnail_find(svc, key);
+  if (e && e->state == aviutl2_thumbnail_state_ready) {
+    for (int y = 0; y < e->height; ++y) {
+      memcpy((uint8_t *)dst + (size_t)y * (size_t)dst_pitch,
+             e->pixels + (size_t)y * (size_t)e->width,
+             (size_t)e->width * sizeof(struct aviutl2_pixel_rgba));
+    }
+    *width = e->width;
+    *height = e->height;
+    ok = true;
+  }
+  ReleaseSRWLockShared(&svc->lock);
+  return ok;
+}
+
+/**
+ * Drop all thumbnails kept in memory
+ * Pending renders are kept and stored when they complete. The disk cache is not affected
+ * @param svc Thumbnail service
+ */
+static inline void aviutl2_thumbnail_service_clear(struct aviutl2_thumbnail_service *svc) {
+  AcquireSRWLockExclusive(&svc->lock);
+  for (size_t i = 0; i < svc->set_num * aviutl2_thumbnail_ways; ++i) {
+    if (svc->entries[i].state == aviutl2_thumbnail_state_ready) {
+      svc->entries[i].state = aviutl2_thumbnail_state_empty;
+    }
+  }
+  ReleaseSRWLockExclusive(&svc->lock);
+}
+
+/**
+ * Get a snapshot of service statistics
+ * Hit ratio on repeated scrubs is (memory_hits + disk_hits) / (memory_hits + disk_hits + renders)
+ * @param svc Thumbnail service
+ * @return Statistics
+ */
+static inline struct aviutl2_thumbnail_stats aviutl2_thumbnail_service_stats(struct aviutl2_thumbnail_service *svc) {
+  AcquireSRWLockShared(&svc->lock);
+  struct aviutl2_thumbnail_stats const stats = svc->stats;
+  ReleaseSRWLockShared(&svc->lock);
+  return stats;
+}
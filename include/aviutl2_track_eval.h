@@ -0,0 +1,368 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// CPU evaluator for track bar movement
+//
+// Predicts track bar values at arbitrary fractional frames without calling the host for every sample, for example
+// to prefetch frames or to compute motion blur sub-frames. The evaluator is built once from aviutl2_track_info and
+// the key points of the track (the value at the start of every section and at the end of the object), and each
+// segment is turned into a cubic polynomial so that evaluation is a segment lookup followed by Horner's method.
+//
+// Built-in movement modes are linear, curve (Catmull-Rom spline) and instant, with the accelerate, decelerate and
+// twopoint (ignore midpoints) flags. Tracks without movement evaluate to the first key value. Other modes, such as
+// script based movement, and time control are not supported; aviutl2_track_eval_init() fails for them so that the
+// caller can fall back to get_effect_track_value(). The built-in curves approximate the host implementation, so
+// compare against the host before relying on exact values.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "aviutl2_plugin2.h"
+
+/**
+ * Movement mode
+ */
+enum aviutl2_track_eval_mode {
+  aviutl2_track_eval_mode_constant = 0, /**< No movement */
+  aviutl2_track_eval_mode_linear = 1,   /**< Straight line between key points */
+  aviutl2_track_eval_mode_curve = 2,    /**< Catmull-Rom spline through key points */
+  aviutl2_track_eval_mode_instant = 3,  /**< Jump to the next key value at the start of each section */
+};
+
+/**
+ * Segment between two key points as a cubic polynomial of the eased position t (0.0 to 1.0)
+ * value = ((c3 * t + c2) * t + c1) * t + c0
+ */
+struct aviutl2_track_eval_segment {
+  double start;   /**< Frame of the first key point */
+  double inv_len; /**< 1 / (frame of the second key point - start) */
+  double c0, c1, c2, c3;
+};
+
+/**
+ * Track evaluator
+ * Initialize with aviutl2_track_eval_init() and release with aviutl2_track_eval_free()
+ */
+struct aviutl2_track_eval {
+  enum aviutl2_track_eval_mode mode;
+  bool accelerate;
+  bool decelerate;
+  double first_value; /**< Value before the first key point */
+  double last_value;  /**< Value at and after the last key point */
+  double last_frame;
+  struct aviutl2_track_eval_segment *segments;
+  size_t segment_num;
+};
+
+/**
+ * Resolve a movement mode name
+ * @param name Movement mode name (aviutl2_track_info.mode)
+ * @param mode Pointer to storage for the mode
+ * @return false if the mode is not supported
+ */
+static inline bool aviutl2_track_eval_mode_from_name(wchar_t const *name, enum aviutl2_track_eval_mode *mode) {
+  static struct {
+    wchar_t const *name;
+    enum aviutl2_track_eval_mode mode;
+  } const table[] = {
+      {L"\u76f4\u7dda\u79fb\u52d5", aviutl2_track_eval_mode_linear},  // Linear movement
+      {L"\u66f2\u7dda\u79fb\u52d5", aviutl2_track_eval_mode_curve},   // Curve movement
+      {L"\u77ac\u9593\u79fb\u52d5", aviutl2_track_eval_mode_instant}, // Instant movement
+  };
+  if (!name) {
+    *mode = aviutl2_track_eval_mode_constant;
+    return true;
+  }
+  for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); ++i) {
+    if (wcscmp(name, table[i].name) == 0) {
+      *mode = table[i].mode;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Release an evaluator
+ * @param e Evaluator
+ */
+static inline void aviutl2_track_eval_free(struct aviutl2_track_eval *e) {
+  free(e->segments);
+  memset(e, 0, sizeof(*e));
+}
+
+/**
+ * Build an evaluator
+ * @param e Evaluator
+ * @param info Track bar information
+ * @param frames Frames of the key points in ascending order (section start frames followed by the end frame)
+ * @param values Track bar values at the key points
+ * @param point_num Number of key points (1 or more)
+ * @return false if the movement mode or time control is not supported or memory allocation failed
+ */
+static inline bool aviutl2_track_eval_init(struct aviutl2_track_eval *e,
+                                           struct aviutl2_track_info const *info,
+                                           double const *frames,
+                                           double const *values,
+                                           size_t point_num) {
+  memset(e, 0, sizeof(*e));
+  if (point_num == 0 || info->timecontrol || !aviutl2_track_eval_mode_from_name(info->mode, &e->mode)) {
+    return false;
+  }
+  e->accelerate = info->accelerate;
+  e->decelerate = info->decelerate;
+  e->first_value = values[0];
+  e->last_value = values[point_num - 1];
+  e->last_frame = frames[point_num - 1];
+  if (e->mode == aviutl2_track_eval_mode_constant || point_num == 1) {
+    e->mode = aviutl2_track_eval_mode_constant;
+    e->last_value = values[0];
+    return true;
+  }
+  // Ignoring midpoints leaves a single segment from the first to the last key point.
+  size_t const stride = info->twopoint ? point_num - 1 : 1;
+  size_t const n = (point_num - 1) / stride;
+  e->segments = (struct aviutl2_track_eval_segment *)malloc(n * sizeof(struct aviutl2_track_eval_segment));
+  if (!e->segments) {
+    return false;
+  }
+  e->segment_num = n;
+  for (size_t i = 0; i < n; ++i) {
+    size_t const k0 = i * stride, k1 = k0 + stride;
+    double const len = frames[k1] - frames[k0];
+    double const p1 = values[k0], p2 = values[k1];
+    struct aviutl2_track_eval_segment *s = e->segments + i;
+    s->start = frames[k0];
+    s->inv_len = len > 0.0 ? 1.0 / len : 0.0;
+    switch (e->mode) {
+    case aviutl2_track_eval_mode_constant:
+    case aviutl2_track_eval_mode_instant:
+      s->c0 = p1;
+      s->c1 = s->c2 = s->c3 = 0.0;
+      break;
+    case aviutl2_track_eval_mode_linear:
+      s->c0 = p1;
+      s->c1 = p2 - p1;
+      s->c2 = s->c3 = 0.0;
+      break;
+    case aviutl2_track_eval_mode_curve: {
+      // The first and last key points are repeated to give the end segments a neighbour.
+      double const p0 = k0 >= stride ? values[k0 - stride] : p1;
+      double const p3 = k1 + stride < point_num ? values[k1 + stride] : p2;
+      s->c0 = p1;
+      s->c1 = 0.5 * (p2 - p0);
+      s->c2 = 0.5 * (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3);
+      s->c3 = 0.5 * (3.0 * (p1 - p2) + p3 - p0);
+    } break;
+    }
+  }
+  return true;
+}
+
+/**
+ * Load the key points of a track bar and build an evaluator
+ * Call inside a read or edit section
+ * @param e Evaluator
+ * @param edit Edit section
+ * @param object Object handle
+ * @param effect Effect name (effect.name value in alias file)
+ * @param item Track bar item name (key name in alias file)
+ * @return false if the track bar was not found, the movement is not supported or memory allocation failed
+ */
+static inline bool aviutl2_track_eval_load(struct aviutl2_track_eval *e,
+                                           struct aviutl2_edit_section *edit,
+                                           aviutl2_object_handle object,
+                                           wchar_t const *effect,
+                                           wchar_t const *item) {
+  memset(e, 0, sizeof(*e));
+  aviutl2_effect_handle const h = edit->find_effect(object, effect);
+  struct aviutl2_track_info info;
+  if (!h || !edit->get_effect_track_info(h, item, &info, (int)sizeof(info))) {
+    return false;
+  }
+  int const section_num = edit->get_object_section_num(object);
+  if (section_num <= 0) {
+    return false;
+  }
+  double *const buf = (double *)malloc((size_t)(section_num + 1) * 2 * sizeof(double));
+  if (!buf) {
+    return false;
+  }
+  double *const frames = buf, *const values = buf + section_num + 1;
+  size_t n = 0;
+  for (int i = 0; i < section_num; ++i) {
+    int const f = edit->get_object_section_frame(object, i);
+    if (f >= 0 && (n == 0 || (double)f > frames[n - 1])) {
+      frames[n++] = (double)f;
+    }
+  }
+  double const end = (double)edit->get_object_layer_frame(object).end;
+  if (n == 0 || end > frames[n - 1]) {
+    frames[n++] = end;
+  }
+  bool ok = true;
+  for (size_t i = 0; i < n && ok; ++i) {
+    ok = edit->get_effect_track_value(h, item, frames[i], values + i);
+  }
+  ok = ok && aviutl2_track_eval_init(e, &info, frames, values, n);
+  free(buf);
+  return ok;
+}
+
+static inline double aviutl2_track_eval_ease(struct aviutl2_track_eval const *e, double t) {
+  if (e->accelerate && e->decelerate) {
+    return t < 0.5 ? 2.0 * t * t : 1.0 - 2.0 * (1.0 - t) * (1.0 - t);
+  }
+  if (e->accelerate) {
+    return t * t;
+  }
+  if (e->decelerate) {
+    return 1.0 - (1.0 - t) * (1.0 - t);
+  }
+  return t;
+}
+
+/**
+ * Find the segment that contains a frame
+ * @param e Evaluator
+ * @param frame Frame
+ * @param hint Segment index to try first (for example the result of the previous call)
+ * @return Segment index
+ */
+static inline size_t aviutl2_track_eval_find(struct aviutl2_track_eval const *e, double frame, size_t hint) {
+  struct aviutl2_track_eval_segment const *s = e->segments;
+  size_t const n = e->segment_num;
+  if (hint < n && frame >= s[hint].start && (hint + 1 == n || frame < s[hint + 1].start)) {
+    return hint;
+  }
+  if (hint + 1 < n && frame >= s[hint + 1].start && (hint + 2 == n || frame < s[hint + 2].start)) {
+    return hint + 1;
+  }
+  size_t lo = 0, hi = n;
+  while (hi - lo > 1) {
+    size_t const mid = (lo + hi) / 2;
+    if (frame < s[mid].start) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+  return lo;
+}
+
+static inline double aviutl2_track_eval_segment_value(struct aviutl2_track_eval const *e,
+                                                      struct aviutl2_track_eval_segment const *s,
+                                                      double frame) {
+  double t = (frame - s->start) * s->inv_len;
+  t = aviutl2_track_eval_ease(e, t < 0.0 ? 0.0 : t > 1.0 ? 1.0 : t);
+  return ((s->c3 * t + s->c2) * t + s->c1) * t + s->c0;
+}
+
+/**
+ * Evaluate at a single frame
+ * @param e Evaluator
+ * @param frame Frame (fractional part selects an in-between position)
+ * @return Track bar value
+ */
+static inline double aviutl2_track_eval_at(struct aviutl2_track_eval const *e, double frame) {
+  if (e->mode == aviutl2_track_eval_mode_constant || frame < e->segments[0].start) {
+    return e->first_value;
+  }
+  if (frame >= e->last_frame) {
+    return e->last_value;
+  }
+  return aviutl2_track_eval_segment_value(e, e->segments + aviutl2_track_eval_find(e, frame, 0), frame);
+}
+
+/**
+ * Evaluate at many frames
+ * Frames in ascending order are the fastest, but any order is accepted
+ * @param e Evaluator
+ * @param frames Frames
+ * @param num Number of frames
+ * @param values Destination
+ */
+static inline void
+aviutl2_track_eval_batch(struct aviutl2_track_eval const *e, double const *frames, size_t num, double *values) {
+  if (e->mode == aviutl2_track_eval_mode_constant) {
+    for (size_t i = 0; i < num; ++i) {
+      values[i] = e->first_value;
+    }
+    return;
+  }
+  size_t cursor = 0;
+  double const first = e->segments[0].start;
+  for (size_t i = 0; i < num; ++i) {
+    double const f = frames[i];
+    if (f < first) {
+      values[i] = e->first_value;
+    } else if (f >= e->last_frame) {
+      values[i] = e->last_value;
+    } else {
+      cursor = aviutl2_track_eval_find(e, f, cursor);
+      values[i] = aviutl2_track_eval_segment_value(e, e->segments + cursor, f);
+    }
+  }
+}
+
+/**
+ * Evaluate at evenly spaced frames
+ * Runs of frames inside one segment are evaluated in a branch-free loop that compilers can vectorize
+ * @param e Evaluator
+ * @param frame_start First frame
+ * @param frame_step Distance between frames (must be positive)
+ * @param num Number of frames
+ * @param values Destination
+ */
+static inline void aviutl2_track_eval_range(
+    struct aviutl2_track_eval const *e, double frame_start, double frame_step, size_t num, double *values) {
+  size_t i = 0;
+  if (e->mode != aviutl2_track_eval_mode_constant) {
+    for (; i < num && frame_start + frame_step * (double)i < e->segments[0].start; ++i) {
+      values[i] = e->first_value;
+    }
+    size_t seg = 0;
+    while (i < num) {
+      double const f = frame_start + frame_step * (double)i;
+      if (f >= e->last_frame) {
+        break;
+      }
+      seg = aviutl2_track_eval_find(e, f, seg);
+      struct aviutl2_track_eval_segment const s = e->segments[seg];
+      double const seg_end = seg + 1 < e->segment_num ? e->segments[seg + 1].start : e->last_frame;
+      // Number of samples that fall before the end of this segment.
+      double const estimate = ceil((seg_end - f) / frame_step);
+      size_t run = estimate < (double)(num - i) ? (size_t)estimate : num - i;
+      while (run > 1 && frame_start + frame_step * (double)(i + run - 1) >= seg_end) {
+        --run;
+      }
+      while (i + run < num && frame_start + frame_step * (double)(i + run) < seg_end) {
+        ++run;
+      }
+      if (run == 0) {
+        run = 1;
+      }
+      double const t0 = (frame_start - s.start) * s.inv_len, dt = frame_step * s.inv_len;
+      bool const acc = e->accelerate, dec = e->decelerate;
+      for (size_t j = i; j < i + run; ++j) {
+        double t = t0 + dt * (double)j;
+        t = t < 0.0 ? 0.0 : t > 1.0 ? 1.0 : t;
+        double const u = 1.0 - t;
+        double const both = t < 0.5 ? 2.0 * t * t : 1.0 - 2.0 * u * u;
+        t = acc && dec ? both : acc ? t * t : dec ? 1.0 - u * u : t;
+        values[j] = ((s.c3 * t + s.c2) * t + s.c1) * t + s.c0;
+      }
+      i += run;
+    }
+  }
+  double const tail = e->mode == aviutl2_track_eval_mode_constant ? e->first_value : e->last_value;
+  for (; i < num; ++i) {
+    values[i] = tail;
+  }
+}
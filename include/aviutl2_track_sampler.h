@@ -0,0 +1,341 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Bulk track bar value sampler
+//
+// Samples several (effect, item) track bars of an object over a frame range in one read section. Each effect is
+// looked up once with find_effect(), and tracks without movement are sampled once and broadcast. Results are written
+// as structure of arrays: the samples of item i are at values[i * sample_num].
+//
+// Results are cached per object and request until the object information changes. Register the invalidation
+// callback once after creating the sampler:
+//   host->register_event_listener(aviutl2_event_type_update_object, &sampler, aviutl2_track_sampler_on_update_object);
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "aviutl2_hash.h"
+#include "aviutl2_plugin2.h"
+
+/**
+ * Number of cached sampling results
+ */
+enum {
+  aviutl2_track_sampler_cache_num = 16,
+};
+
+/**
+ * Track bar to sample
+ */
+struct aviutl2_track_sampler_item {
+  wchar_t const *effect; /**< Effect name (effect.name value in alias file, ":n" suffix selects among duplicates) */
+  wchar_t const *item;   /**< Track bar item name (key name in alias file) */
+};
+
+/**
+ * Cached sampling result
+ */
+struct aviutl2_track_sampler_entry {
+  aviutl2_object_handle object;
+  uint64_t key;        /**< Hash of the request */
+  LONG generation;     /**< Generation the result belongs to */
+  uint64_t last_used;
+  size_t item_num;
+  size_t sample_num;
+  double *values;      /**< item_num * sample_num values */
+  uint64_t found_mask; /**< Bit i is set if items[i] was found (first 64 items) */
+};
+
+/**
+ * Sampler statistics
+ */
+struct aviutl2_track_sampler_stats {
+  uint64_t hits;       /**< Requests served from the cache */
+  uint64_t misses;     /**< Requests that read the project */
+  uint64_t host_calls; /**< Number of get_effect_track_value() calls */
+  uint64_t broadcasts; /**< Tracks without movement sampled only once */
+};
+
+/**
+ * Track bar sampler
+ * Initialize with aviutl2_track_sampler_init() and release with aviutl2_track_sampler_exit()
+ */
+struct aviutl2_track_sampler {
+  struct aviutl2_edit_handle *edit;
+  SRWLOCK lock;
+  LONG volatile generation;
+  uint64_t tick;
+  struct aviutl2_track_sampler_entry entries[aviutl2_track_sampler_cache_num];
+  struct aviutl2_track_sampler_stats stats;
+};
+
+/**
+ * Initialize a sampler
+ * @param s Sampler
+ * @param edit Edit handle
+ */
+static inline void aviutl2_track_sampler_init(struct aviutl2_track_sampler *s, struct aviutl2_edit_handle *edit) {
+  memset(s, 0, sizeof(*s));
+  s->edit = edit;
+  InitializeSRWLock(&s->lock);
+}
+
+/**
+ * Release cached results
+ * @param s Sampler
+ */
+static inline void aviutl2_track_sampler_exit(struct aviutl2_track_sampler *s) {
+  for (size_t i = 0; i < aviutl2_track_sampler_cache_num; ++i) {
+    free(s->entries[i].values);
+  }
+  memset(s, 0, sizeof(*s));
+}
+
+/**
+ * Invalidate all cached results
+ * Safe to call from any thread
+ * @param s Sampler
+ */
+static inline void aviutl2_track_sampler_invalidate(struct aviutl2_track_sampler *s) {
+  InterlockedIncrement(&s->generation);
+}
+
+/**
+ * Event listener for aviutl2_event_type_update_object
+ * @param param Pointer to struct aviutl2_track_sampler
+ */
+static inline void aviutl2_track_sampler_on_update_object(void *param) {
+  aviutl2_track_sampler_invalidate((struct aviutl2_track_sampler *)param);
+}
+
+static inline uint64_t aviutl2_track_sampler_key(struct aviutl2_track_sampler_item const *items,
+                                                 size_t item_num,
+                                                 double frame_start,
+                                                 double frame_step,
+                                                 size_t sample_num) {
+  uint64_t h = AVIUTL2_HASH_INIT;
+  for (size_t i = 0; i < item_num; ++i) {
+    h = aviutl2_hash_wstr(h, items[i].effect);
+    h = aviutl2_hash_u64(h, 0);
+    h = aviutl2_hash_wstr(h, items[i].item);
+    h = aviutl2_hash_u64(h, 1);
+  }
+  h = aviutl2_hash_bytes(h, &frame_start, sizeof(frame_start));
+  h = aviutl2_hash_bytes(h, &frame_step, sizeof(frame_step));
+  return aviutl2_hash_u64(h, sample_num);
+}
+
+/**
+ * Sample track bars inside an existing read or edit section
+ * Does not use the cache
+ * @param edit Edit section
+ * @param object Object handle
+ * @param items Track bars to sample
+ * @param item_num Number of track bars
+ * @param frame_start Frame of the first sample (fractional part selects an in-between position)
+ * @param frame_step Distance between samples in frames
+ * @param sample_num Number of samples per track bar
+ * @param values Destination (item_num * sample_num values; samples of item i start at values[i * sample_num])
+ * @param stats Statistics to update (may be NULL)
+ * @return Bit mask of items that were found (bit i = items[i], first 64 items); values of missing items are 0
+ */
+static inline uint64_t aviutl2_track_sampler_sample_section(struct aviutl2_edit_section *edit,
+                                                            aviutl2_object_handle object,
+                                                            struct aviutl2_track_sampler_item const *items,
+                                                            size_t item_num,
+                                                            double frame_start,
+                                                            double frame_step,
+                                                            size_t sample_num,
+                                                            double *values,
+                                                            struct aviutl2_track_sampler_stats *stats) {
+  uint64_t found = 0;
+  aviutl2_effect_handle effect = NULL;
+  wchar_t const *effect_name = NULL;
+  for (size_t i = 0; i < item_num; ++i) {
+    double *out = values + i * sample_num;
+    // Items are usually grouped by effect, so only look the effect up again when the name changes.
+    wchar_t const *const name = items[i].effect;
+    if (i == 0 || (effect_name != name && (!effect_name || !name || wcscmp(effect_name, name) != 0))) {
+      effect = edit->find_effect(object, name);
+    }
+    effect_name = name;
+    struct aviutl2_track_info info;
+    if (!effect || !edit->get_effect_track_info(effect, items[i].item, &info, (int)sizeof(info))) {
+      memset(out, 0, sample_num * sizeof(double));
+      continue;
+    }
+    size_t n = sample_num;
+    if (!info.mode && n > 1) {
+      // No movement: the value is the same at every frame.
+      n = 1;
+      if (stats) {
+        ++stats->broadcasts;
+      }
+    }
+    bool ok = true;
+    for (size_t j = 0; j < n && ok; ++j) {
+      ok = edit->get_effect_track_value(effect, items[i].item, frame_start + frame_step * (double)j, out + j);
+    }
+    if (stats) {
+      stats->host_calls += n;
+    }
+    if (!ok) {
+      memset(out, 0, sample_num * sizeof(double));
+      continue;
+    }
+    for (size_t j = n; j < sample_num; ++j) {
+      out[j] = out[0];
+    }
+    if (i < 64) {
+      found |= UINT64_C(1) << i;
+    }
+  }
+  return found;
+}
+
+struct aviutl2_track_sampler_request {
+  struct aviutl2_track_sampler *sampler;
+  aviutl2_object_handle object;
+  struct aviutl2_track_sampler_item const *items;
+  size_t item_num;
+  double frame_start;
+  double frame_step;
+  size_t sample_num;
+  double *values;
+  uint64_t found;
+  struct aviutl2_track_sampler_stats stats;
+};
+
+static inline void aviutl2_track_sampler_proc(void *param, struct aviutl2_edit_section *edit) {
+  struct aviutl2_track_sampler_request *req = (struct aviutl2_track_sampler_request *)param;
+  req->found = aviutl2_track_sampler_sample_section(edit,
+                                                    req->object,
+                                                    req->items,
+                                                    req->item_num,
+                                                    req->frame_start,
+                                                    req->frame_step,
+                                                    req->sample_num,
+                                                    req->values,
+                                                    &req->stats);
+}
+
+/**
+ * Sample track bars, using cached results when the object has not changed
+ * Must not be called from inside a read or edit section; use aviutl2_track_sampler_sample_section() there
+ * @param s Sampler
+ * @param object Object handle
+ * @param items Track bars to sample
+ * @param item_num Number of track bars
+ * @param frame_start Frame of the first sample (fractional part selects an in-between position)
+ * @param frame_step Distance between samples in frames
+ * @param sample_num Number of samples per track bar
+ * @param values Destination (item_num * sample_num values; samples of item i start at values[i * sample_num])
+ * @param found Pointer to storage for the bit mask of items that were found (may be NULL)
+ * @return false if the project could not be read or memory allocation failed
+ */
+static inline bool aviutl2_track_sampler_sample(struct aviutl2_track_sampler *s,
+                                                aviutl2_object_handle object,
+                                                struct aviutl2_track_sampler_item const *items,
+                                                size_t item_num,
+                                                double frame_start,
+                                                double frame_step,
+                                                size_t sample_num,
+                                                double *values,
+                                                uint64_t *found) {
+  if (item_num == 0 || sample_num == 0) {
+    if (found) {
+      *found = 0;
+    }
+    return true;
+  }
+  if (sample_num > SIZE_MAX / sizeof(double) / item_num) {
+    return false;
+  }
+  size_t const total = item_num * sample_num;
+  uint64_t const key = aviutl2_track_sampler_key(items, item_num, frame_start, frame_step, sample_num);
+  LONG const generation = s->generation;
+
+  AcquireSRWLockExclusive(&s->lock);
+  for (size_t i = 0; i < aviutl2_track_sampler_cache_num; ++i) {
+    struct aviutl2_track_sampler_entry *e = s->entries + i;
+    if (e->values && e->object == object && e->key == key && e->generation == generation &&
+        e->item_num == item_num && e->sample_num == sample_num) {
+      memcpy(values, e->values, total * sizeof(double));
+      if (found) {
+        *found = e->found_mask;
+      }
+      e->last_used = ++s->tick;
+      ++s->stats.hits;
+      ReleaseSRWLockExclusive(&s->lock);
+      return true;
+    }
+  }
+  ReleaseSRWLockExclusive(&s->lock);
+
+  struct aviutl2_track_sampler_request req = {
+      .sampler = s,
+      .object = object,
+      .items = items,
+      .item_num = item_num,
+      .frame_start = frame_start,
+      .frame_step = frame_step,
+      .sample_num = sample_num,
+      .values = values,
+  };
+  if (!s->edit->call_read_section_param(&req, aviutl2_track_sampler_proc)) {
+    return false;
+  }
+  if (found) {
+    *found = req.found;
+  }
+
+  double *copy = (double *)malloc(total * sizeof(double));
+  AcquireSRWLockExclusive(&s->lock);
+  ++s->stats.misses;
+  s->stats.host_calls += req.stats.host_calls;
+  s->stats.broadcasts += req.stats.broadcasts;
+  if (copy) {
+    struct aviutl2_track_sampler_entry *victim = s->entries;
+    for (size_t i = 1; i < aviutl2_track_sampler_cache_num; ++i) {
+      if (s->entries[i].last_used < victim->last_used) {
+        victim = s->entries + i;
+      }
+    }
+    free(victim->values);
+    memcpy(copy, values, total * sizeof(double));
+    *victim = (struct aviutl2_track_sampler_entry){
+        .object = object,
+        .key = key,
+        .generation = generation,
+        .last_used = ++s->tick,
+        .item_num = item_num,
+        .sample_num = sample_num,
+        .values = copy,
+        .found_mask = req.found,
+    };
+  }
+  ReleaseSRWLockExclusive(&s->lock);
+  return true;
+}
+
+/**
+ * Get a snapshot of the sampler statistics
+ * @param s Sampler
+ * @return Statistics
+ */
+static inline struct aviutl2_track_sampler_stats aviutl2_track_sampler_get_stats(struct aviutl2_track_sampler *s) {
+  AcquireSRWLockShared(&s->lock);
+  struct aviutl2_track_sampler_stats const stats = s->stats;
+  ReleaseSRWLockShared(&s->lock);
+  return stats;
+}
@@ -0,0 +1,395 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// UTF-8 / UTF-16 transcoding for API boundaries
+//
+// The core functions operate on uint16_t code units so that they behave identically on every platform.
+// The wchar_t wrappers (aviutl2_wstr / aviutl2_u8str) are available when wchar_t is 16-bit,
+// which is the case on Windows and on other platforms when compiled with -fshort-wchar.
+//
+// Invalid input is never rejected: ill-formed UTF-8 subsequences and unpaired surrogates are replaced with U+FFFD,
+// the same policy as MultiByteToWideChar() / WideCharToMultiByte() without error flags.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+/**
+ * Decode one code point from UTF-8
+ * @param src Pointer to the first byte
+ * @param len Number of bytes available (must be at least 1)
+ * @param cp Pointer to storage for the decoded code point (U+FFFD for ill-formed input)
+ * @return Number of bytes consumed (1 to 4)
+ */
+static inline size_t aviutl2_utf8_decode(uint8_t const *src, size_t len, uint32_t *cp) {
+  uint8_t const c = src[0];
+  if (c < 0x80) {
+    *cp = c;
+    return 1;
+  }
+  size_t need;
+  uint32_t v;
+  uint8_t lo = 0x80, hi = 0xbf;
+  if (c >= 0xc2 && c <= 0xdf) {
+    need = 1;
+    v = c & 0x1f;
+  } else if (c >= 0xe0 && c <= 0xef) {
+    need = 2;
+    v = c & 0x0f;
+    if (c == 0xe0) {
+      lo = 0xa0;
+    } else if (c == 0xed) {
+      hi = 0x9f;
+    }
+  } else if (c >= 0xf0 && c <= 0xf4) {
+    need = 3;
+    v = c & 0x07;
+    if (c == 0xf0) {
+      lo = 0x90;
+    } else if (c == 0xf4) {
+      hi = 0x8f;
+    }
+  } else {
+    *cp = 0xfffd;
+    return 1;
+  }
+  // Consume the maximal valid prefix of an ill-formed sequence, as recommended by the Unicode standard
+  for (size_t i = 1; i <= need; ++i) {
+    if (i >= len || src[i] < lo || src[i] > hi) {
+      *cp = 0xfffd;
+      return i;
+    }
+    v = (v << 6) | (src[i] & 0x3f);
+    lo = 0x80;
+    hi = 0xbf;
+  }
+  *cp = v;
+  return need + 1;
+}
+
+/**
+ * Check whether a byte sequence is well-formed UTF-8
+ * @param src Pointer to UTF-8 data
+ * @param len Length in bytes
+ * @return true if well-formed
+ */
+static inline bool aviutl2_utf8_validate(char const *src, size_t len) {
+  uint8_t const *p = (uint8_t const *)src;
+  size_t i = 0;
+  while (i < len) {
+#if AVIUTL2_HAS_SSE2
+    if (len - i >= 16 && _mm_movemask_epi8(_mm_loadu_si128((__m128i const *)(p + i))) == 0) {
+      i += 16;
+      continue;
+    }
+#endif
+    uint32_t cp;
+    size_t const n = aviutl2_utf8_decode(p + i, len - i, &cp);
+    if (cp == 0xfffd && !(n == 3 && p[i] == 0xef && p[i + 1] == 0xbf && p[i + 2] == 0xbd)) {
+      return false;
+    }
+    i += n;
+  }
+  return true;
+}
+
+/**
+ * Convert UTF-8 to UTF-16
+ * Output is written only up to dst_cap code units, but the return value is always the full required length,
+ * so calling with dst = NULL / dst_cap = 0 measures the output. No terminator is written
+ * @param dst Destination buffer (may be NULL when dst_cap is 0)
+ * @param dst_cap Capacity of dst in code units
+ * @param src Source UTF-8 data
+ * @param src_len Source length in bytes
+ * @return Number of UTF-16 code units required for the whole input
+ */
+static inline size_t aviutl2_utf8_to_utf16(uint16_t *dst, size_t dst_cap, char const *src, size_t src_len) {
+  uint8_t const *p = (uint8_t const *)src;
+  size_t i = 0, o = 0;
+  while (i < src_len) {
+#if AVIUTL2_HAS_SSE2
+    if (src_len - i >= 16) {
+      __m128i const v = _mm_loadu_si128((__m128i const *)(p + i));
+      if (_mm_movemask_epi8(v) == 0) {
+        if (o + 16 <= dst_cap) {
+          __m128i const zero = _mm_setzero_si128();
+          _mm_storeu_si128((__m128i *)(dst + o), _mm_unpacklo_epi8(v, zero));
+          _mm_storeu_si128((__m128i *)(dst + o + 8), _mm_unpackhi_epi8(v, zero));
+        } else {
+          for (size_t j = 0; j < 16; ++j) {
+            if (o + j < dst_cap) {
+              dst[o + j] = p[i + j];
+            }
+          }
+        }
+        i += 16;
+        o += 16;
+        continue;
+      }
+    }
+#endif
+    if (p[i] < 0x80) {
+      if (o < dst_cap) {
+        dst[o] = p[i];
+      }
+      ++i;
+      ++o;
+      continue;
+    }
+    uint32_t cp;
+    i += aviutl2_utf8_decode(p + i, src_len - i, &cp);
+    if (cp >= 0x10000) {
+      cp -= 0x10000;
+      if (o < dst_cap) {
+        dst[o] = (uint16_t)(0xd800 | (cp >> 10));
+      }
+      if (o + 1 < dst_cap) {
+        dst[o + 1] = (uint16_t)(0xdc00 | (cp & 0x3ff));
+      }
+      o += 2;
+    } else {
+      if (o < dst_cap) {
+        dst[o] = (uint16_t)cp;
+      }
+      ++o;
+    }
+  }
+  return o;
+}
+
+/**
+ * Convert UTF-16 to UTF-8
+ * Output is written only up to dst_cap bytes, but the return value is always the full required length,
+ * so calling with dst = NULL / dst_cap = 0 measures the output. No terminator is written
+ * @param dst Destination buffer (may be NULL when dst_cap is 0)
+ * @param dst_cap Capacity of dst in bytes
+ * @param src Source UTF-16 data
+ * @param src_len Source length in code units
+ * @return Number of bytes required for the whole input
+ */
+static inline size_t aviutl2_utf16_to_utf8(char *dst, size_t dst_cap, uint16_t const *src, size_t src_len) {
+  uint8_t *d = (uint8_t *)dst;
+  size_t i = 0, o = 0;
+  while (i < src_len) {
+#if AVIUTL2_HAS_SSE2
+    if (src_len - i >= 8) {
+      __m128i const v = _mm_loadu_si128((__m128i const *)(src + i));
+      __m128i const high = _mm_and_si128(v, _mm_set1_epi16((short)0xff80));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) == 0xffff) {
+        __m128i const packed = _mm_packus_epi16(v, v);
+        if (o + 8 <= dst_cap) {
+          _mm_storel_epi64((__m128i *)(d + o), packed);
+        } else {
+          uint8_t tmp[16];
+          _mm_storeu_si128((__m128i *)tmp, packed);
+          for (size_t j = 0; j < 8; ++j) {
+            if (o + j < dst_cap) {
+              d[o + j] = tmp[j];
+            }
+          }
+        }
+        i += 8;
+        o += 8;
+        continue;
+      }
+    }
+#endif
+    uint32_t cp = src[i++];
+    if (cp >= 0xd800 && cp <= 0xdfff) {
+      if (cp <= 0xdbff && i < src_len && src[i] >= 0xdc00 && src[i] <= 0xdfff) {
+        cp = 0x10000 + ((cp - 0xd800) << 10) + (src[i++] - 0xdc00);
+      } else {
+        cp = 0xfffd;
+      }
+    }
+    uint8_t buf[4];
+    size_t n;
+    if (cp < 0x80) {
+      buf[0] = (uint8_t)cp;
+      n = 1;
+    } else if (cp < 0x800) {
+      buf[0] = (uint8_t)(0xc0 | (cp >> 6));
+      buf[1] = (uint8_t)(0x80 | (cp & 0x3f));
+      n = 2;
+    } else if (cp < 0x10000) {
+      buf[0] = (uint8_t)(0xe0 | (cp >> 12));
+      buf[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3f));
+      buf[2] = (uint8_t)(0x80 | (cp & 0x3f));
+      n = 3;
+    } else {
+      buf[0] = (uint8_t)(0xf0 | (cp >> 18));
+      buf[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3f));
+      buf[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3f));
+      buf[3] = (uint8_t)(0x80 | (cp & 0x3f));
+      n = 4;
+    }
+    for (size_t j = 0; j < n; ++j) {
+      if (o + j < dst_cap) {
+        d[o + j] = buf[j];
+      }
+    }
+    o += n;
+  }
+  return o;
+}
+
+//--------------------------------
+
+#if WCHAR_MAX == 0xffff
+
+/**
+ * Number of wchar_t stored inline in aviutl2_wstr before falling back to the heap
+ */
+#  ifndef AVIUTL2_WSTR_SMALL
+#    define AVIUTL2_WSTR_SMALL 260
+#  endif
+
+/**
+ * Number of bytes stored inline in aviutl2_u8str before falling back to the heap
+ */
+#  ifndef AVIUTL2_U8STR_SMALL
+#    define AVIUTL2_U8STR_SMALL 520
+#  endif
+
+/**
+ * Wide string with small-buffer storage
+ * Initialize with {0}. Short strings never touch the heap; a heap buffer, once allocated, is reused by later
+ * conversions until aviutl2_wstr_free() is called, so a long-lived instance converts without allocation
+ */
+struct aviutl2_wstr {
+  wchar_t *ptr; /**< Null-terminated converted string */
+  size_t len;   /**< Length in wchar_t excluding the terminator */
+  wchar_t *heap;
+  size_t heap_cap;
+  wchar_t small[AVIUTL2_WSTR_SMALL];
+};
+
+/**
+ * UTF-8 string with small-buffer storage
+ * Same ownership rules as aviutl2_wstr
+ */
+struct aviutl2_u8str {
+  char *ptr;  /**< Null-terminated converted string */
+  size_t len; /**< Length in bytes excluding the terminator */
+  char *heap;
+  size_t heap_cap;
+  char small[AVIUTL2_U8STR_SMALL];
+};
+
+/**
+ * Convert UTF-8 to a null-terminated wide string
+ * @param s Destination string
+ * @param src Source UTF-8 string (NULL is treated as an empty string)
+ * @param src_len Source length in bytes, or SIZE_MAX for a null-terminated string
+ * @return Pointer to the converted string (valid until the next conversion or aviutl2_wstr_free()),
+ *         or NULL if memory allocation failed
+ */
+static inline wchar_t const *aviutl2_wstr_from_utf8(struct aviutl2_wstr *s, char const *src, size_t src_len) {
+  if (!src) {
+    src = "";
+    src_len = 0;
+  } else if (src_len == SIZE_MAX) {
+    src_len = strlen(src);
+  }
+  // UTF-16 output never has more code units than the UTF-8 input has bytes
+  size_t cap = AVIUTL2_WSTR_SMALL;
+  uint16_t *buf = (uint16_t *)s->small;
+  if (src_len + 1 > cap) {
+    if (s->heap_cap < src_len + 1) {
+      wchar_t *heap = (wchar_t *)realloc(s->heap, (src_len + 1) * sizeof(wchar_t));
+      if (!heap) {
+        return NULL;
+      }
+      s->heap = heap;
+      s->heap_cap = src_len + 1;
+    }
+    cap = s->heap_cap;
+    buf = (uint16_t *)s->heap;
+  }
+  s->len = aviutl2_utf8_to_utf16(buf, cap, src, src_len);
+  buf[s->len] = 0;
+  s->ptr = (wchar_t *)buf;
+  return s->ptr;
+}
+
+/**
+ * Release the heap buffer of a wide string
+ * @param s String
+ */
+static inline void aviutl2_wstr_free(struct aviutl2_wstr *s) {
+  free(s->heap);
+  s->heap = NULL;
+  s->heap_cap = 0;
+  s->ptr = NULL;
+  s->len = 0;
+}
+
+/**
+ * Convert a wide string to null-terminated UTF-8
+ * @param s Destination string
+ * @param src Source wide string (NULL is treated as an empty string)
+ * @param src_len Source length in wchar_t, or SIZE_MAX for a null-terminated string
+ * @return Pointer to the converted string (valid until the next conversion or aviutl2_u8str_free()),
+ *         or NULL if memory allocation failed
+ */
+static inline char const *aviutl2_u8str_from_wstr(struct aviutl2_u8str *s, wchar_t const *src, size_t src_len) {
+  if (!src) {
+    src = L"";
+    src_len = 0;
+  } else if (src_len == SIZE_MAX) {
+    src_len = wcslen(src);
+  }
+  uint16_t const *const src16 = (uint16_t const *)src;
+  size_t cap = AVIUTL2_U8STR_SMALL;
+  char *buf = s->small;
+  // Each code unit produces at most 3 bytes; only measure exactly when the worst case does not fit
+  if (src_len * 3 + 1 > cap) {
+    size_t const need = aviutl2_utf16_to_utf8(NULL, 0, src16, src_len) + 1;
+    if (need > cap) {
+      if (s->heap_cap < need) {
+        char *heap = (char *)realloc(s->heap, need);
+        if (!heap) {
+          return NULL;
+        }
+        s->heap = heap;
+        s->heap_cap = need;
+      }
+      cap = s->heap_cap;
+      buf = s->heap;
+    }
+  }
+  s->len = aviutl2_utf16_to_utf8(buf, cap, src16, src_len);
+  buf[s->len] = '\0';
+  s->ptr = buf;
+  return s->ptr;
+}
+
+/**
+ * Release the heap buffer of a UTF-8 string
+ * @param s String
+ */
+static inline void aviutl2_u8str_free(struct aviutl2_u8str *s) {
+  free(s->heap);
+  s->heap = NULL;
+  s->heap_cap = 0;
+  s->ptr = NULL;
+  s->len = 0;
+}
+
+#endif
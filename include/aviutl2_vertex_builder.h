@@ -0,0 +1,467 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Structure of arrays mesh builder for draw_poly() / draw_poly_to_resource()
+//
+// Vertex attributes are kept in separate arrays so that procedural geometry can be generated and transformed with
+// simple loops, and primitives refer to vertices by index. aviutl2_vertex_builder_pack() converts the mesh into the
+// array of structures layout that matches enum aviutl2_vertex_type.
+//
+// The builder keeps its buffers after aviutl2_vertex_builder_reset(), so keep one builder per effect instance to
+// avoid allocations on every frame. The host already associates user data with each effect_id:
+//   static void *func_create(int64_t effect_id) { return calloc(1, sizeof(struct aviutl2_vertex_builder)); }
+//   static void func_destroy(int64_t effect_id, void *userdata) {
+//     aviutl2_vertex_builder_destroy(userdata);
+//     free(userdata);
+//   }
+// and in func_proc_video():
+//   struct aviutl2_vertex_builder *vb = video->userdata;
+//   aviutl2_vertex_builder_reset(vb, 3);
+//   ... add vertices and primitives ...
+//   aviutl2_vertex_builder_compute_normals(vb);
+//   aviutl2_vertex_builder_draw(vb, video, aviutl2_vertex_type_triangle_color_norm, NULL);
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aviutl2_filter2.h"
+
+#ifndef AVIUTL2_HAS_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AVIUTL2_HAS_SSE2 1
+#  else
+#    define AVIUTL2_HAS_SSE2 0
+#  endif
+#endif
+
+#if AVIUTL2_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+/**
+ * Mesh builder
+ * Initialize with {0} and release with aviutl2_vertex_builder_destroy()
+ * Attribute arrays hold num elements and may be written directly
+ */
+struct aviutl2_vertex_builder {
+  float *x, *y, *z;     /**< Vertex coordinates */
+  float *nx, *ny, *nz;  /**< Normal vectors */
+  float *u, *v;         /**< Texture coordinates (normalized coordinates in the range 0.0 to 1.0) */
+  float *r, *g, *b, *a; /**< Vertex color (premultiplied alpha in the range 0.0 to 1.0), a is also the texture alpha */
+  size_t num, cap;
+  float *storage;
+
+  int primitive; /**< Vertices per primitive (3 = triangle list, 4 = quad list) */
+  uint32_t *indices;
+  size_t index_num, index_cap;
+
+  void *packed;
+  size_t packed_cap; /**< Size of packed in bytes */
+};
+
+enum {
+  aviutl2_vertex_builder_fields = 12,
+};
+
+/**
+ * Release buffers owned by a builder
+ * @param vb Builder
+ */
+static inline void aviutl2_vertex_builder_destroy(struct aviutl2_vertex_builder *vb) {
+  free(vb->storage);
+  free(vb->indices);
+  free(vb->packed);
+  memset(vb, 0, sizeof(*vb));
+}
+
+/**
+ * Discard the mesh and select the primitive type while keeping allocated buffers
+ * Call this before building each mesh
+ * @param vb Builder
+ * @param primitive Vertices per primitive (3 = triangle list, 4 = quad list)
+ */
+static inline void aviutl2_vertex_builder_reset(struct aviutl2_vertex_builder *vb, int primitive) {
+  vb->num = 0;
+  vb->index_num = 0;
+  vb->primitive = primitive == 4 ? 4 : 3;
+}
+
+/**
+ * Make sure the builder can hold the specified number of vertices and indices without reallocation
+ * @param vb Builder
+ * @param vertices Number of vertices
+ * @param indices Number of indices
+ * @return false if memory allocation failed
+ */
+static inline bool aviutl2_vertex_builder_reserve(struct aviutl2_vertex_builder *vb, size_t vertices, size_t indices) {
+  if (vertices > vb->cap) {
+    size_t cap = vb->cap ? vb->cap : 256;
+    while (cap < vertices) {
+      cap *= 2;
+    }
+    float *storage = (float *)malloc(cap * aviutl2_vertex_builder_fields * sizeof(float));
+    if (!storage) {
+      return false;
+    }
+    float **fields[aviutl2_vertex_builder_fields] = {
+        &vb->x, &vb->y, &vb->z, &vb->nx, &vb->ny, &vb->nz, &vb->u, &vb->v, &vb->r, &vb->g, &vb->b, &vb->a,
+    };
+    for (size_t i = 0; i < aviutl2_vertex_builder_fields; ++i) {
+      float *field = storage + cap * i;
+      if (vb->num) {
+        memcpy(field, *fields[i], vb->num * sizeof(float));
+      }
+      *fields[i] = field;
+    }
+    free(vb->storage);
+    vb->storage = storage;
+    vb->cap = cap;
+  }
+  if (indices > vb->index_cap) {
+    size_t cap = vb->index_cap ? vb->index_cap : 256;
+    while (cap < indices) {
+      cap *= 2;
+    }
+    uint32_t *p = (uint32_t *)realloc(vb->indices, cap * sizeof(uint32_t));
+    if (!p) {
+      return false;
+    }
+    vb->indices = p;
+    vb->index_cap = cap;
+  }
+  return true;
+}
+
+/**
+ * Append vertices
+ * New vertices have zero coordinates, zero normals, zero texture coordinates and opaque white color.
+ * Fill the attribute arrays from the returned index onwards.
+ * @param vb Builder
+ * @param n Number of vertices to append
+ * @return Index of the first appended vertex, or UINT32_MAX if memory allocation failed
+ */
+static inline uint32_t aviutl2_vertex_builder_add_vertices(struct aviutl2_vertex_builder *vb, size_t n) {
+  if (vb->num + n > UINT32_MAX || !aviutl2_vertex_builder_reserve(vb, vb->num + n, 0)) {
+    return UINT32_MAX;
+  }
+  size_t const first = vb->num;
+  size_t const bytes = n * sizeof(float);
+  memset(vb->x + first, 0, bytes);
+  memset(vb->y + first, 0, bytes);
+  memset(vb->z + first, 0, bytes);
+  memset(vb->nx + first, 0, bytes);
+  memset(vb->ny + first, 0, bytes);
+  memset(vb->nz + first, 0, bytes);
+  memset(vb->u + first, 0, bytes);
+  memset(vb->v + first, 0, bytes);
+  for (size_t i = first; i < first + n; ++i) {
+    vb->r[i] = vb->g[i] = vb->b[i] = vb->a[i] = 1.f;
+  }
+  vb->num += n;
+  return (uint32_t)first;
+}
+
+/**
+ * Append a vertex
+ * @param vb Builder
+ * @param x X coordinate
+ * @param y Y coordinate
+ * @param z Z coordinate
+ * @param u Texture U coordinate
+ * @param v Texture V coordinate
+ * @return Index of the vertex, or UINT32_MAX if memory allocation failed
+ */
+static inline uint32_t
+aviutl2_vertex_builder_add_vertex(struct aviutl2_vertex_builder *vb, float x, float y, float z, float u, float v) {
+  uint32_t const i = aviutl2_vertex_builder_add_vertices(vb, 1);
+  if (i != UINT32_MAX) {
+    vb->x[i] = x;
+    vb->y[i] = y;
+    vb->z[i] = z;
+    vb->u[i] = u;
+    vb->v[i] = v;
+  }
+  return i;
+}
+
+static inline bool
+aviutl2_vertex_builder_push_indices(struct aviutl2_vertex_builder *vb, uint32_t const *idx, size_t n) {
+  if (!aviutl2_vertex_builder_reserve(vb, 0, vb->index_num + n)) {
+    return false;
+  }
+  memcpy(vb->indices + vb->index_num, idx, n * sizeof(uint32_t));
+  vb->index_num += n;
+  return true;
+}
+
+/**
+ * Append a triangle
+ * On a quad list the triangle is emitted as a quad whose last two corners are the same vertex
+ * @param vb Builder
+ * @param i0 First vertex index
+ * @param i1 Second vertex index
+ * @param i2 Third vertex index
+ * @return false if memory allocation failed
+ */
+static inline bool
+aviutl2_vertex_builder_add_triangle(struct aviutl2_vertex_builder *vb, uint32_t i0, uint32_t i1, uint32_t i2) {
+  uint32_t const idx[4] = {i0, i1, i2, i2};
+  return aviutl2_vertex_builder_push_indices(vb, idx, vb->primitive == 4 ? 4 : 3);
+}
+
+/**
+ * Append a quad
+ * On a triangle list the quad is split into (i0, i1, i2) and (i0, i2, i3)
+ * @param vb Builder
+ * @param i0 First vertex index
+ * @param i1 Second vertex index
+ * @param i2 Third vertex index
+ * @param i3 Fourth vertex index
+ * @return false if memory allocation failed
+ */
+static inline bool
+aviutl2_vertex_builder_add_quad(struct aviutl2_vertex_builder *vb, uint32_t i0, uint32_t i1, uint32_t i2, uint32_t i3) {
+  if (vb->primitive == 4) {
+    uint32_t const idx[4] = {i0, i1, i2, i3};
+    return aviutl2_vertex_builder_push_indices(vb, idx, 4);
+  }
+  uint32_t const idx[6] = {i0, i1, i2, i0, i2, i3};
+  return aviutl2_vertex_builder_push_indices(vb, idx, 6);
+}
+
+/**
+ * Append quads for a regular grid of vertices
+ * Vertex (col, row) is expected at index first + row * cols + col, as produced by aviutl2_vertex_builder_add_vertices()
+ * @param vb Builder
+ * @param first Index of the first grid vertex
+ * @param cols Number of vertices per row
+ * @param rows Number of rows
+ * @return false if memory allocation failed
+ */
+static inline bool
+aviutl2_vertex_builder_add_grid(struct aviutl2_vertex_builder *vb, uint32_t first, size_t cols, size_t rows) {
+  if (cols < 2 || rows < 2) {
+    return true;
+  }
+  size_t const per_quad = vb->primitive == 4 ? 4 : 6;
+  if (!aviutl2_vertex_builder_reserve(vb, 0, vb->index_num + (cols - 1) * (rows - 1) * per_quad)) {
+    return false;
+  }
+  for (size_t row = 0; row + 1 < rows; ++row) {
+    uint32_t const top = first + (uint32_t)(row * cols);
+    uint32_t const bottom = top + (uint32_t)cols;
+    for (size_t col = 0; col + 1 < cols; ++col) {
+      uint32_t const c = (uint32_t)col;
+      aviutl2_vertex_builder_add_quad(vb, top + c, top + c + 1, bottom + c + 1, bottom + c);
+    }
+  }
+  return true;
+}
+
+/**
+ * Normalize normal vectors in place
+ * Zero-length vectors are left as they are
+ * @param vb Builder
+ */
+static inline void aviutl2_vertex_builder_normalize(struct aviutl2_vertex_builder *vb) {
+  size_t i = 0;
+#if AVIUTL2_HAS_SSE2
+  __m128 const zero = _mm_setzero_ps();
+  __m128 const one = _mm_set1_ps(1.f);
+  for (; i + 4 <= vb->num; i += 4) {
+    __m128 const x = _mm_loadu_ps(vb->nx + i), y = _mm_loadu_ps(vb->ny + i), z = _mm_loadu_ps(vb->nz + i);
+    __m128 const len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    __m128 const nonzero = _mm_cmpgt_ps(len2, zero);
+    __m128 const inv = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(one, _mm_sqrt_ps(len2))), _mm_andnot_ps(nonzero, one));
+    _mm_storeu_ps(vb->nx + i, _mm_mul_ps(x, inv));
+    _mm_storeu_ps(vb->ny + i, _mm_mul_ps(y, inv));
+    _mm_storeu_ps(vb->nz + i, _mm_mul_ps(z, inv));
+  }
+#endif
+  for (; i < vb->num; ++i) {
+    float const len2 = vb->nx[i] * vb->nx[i] + vb->ny[i] * vb->ny[i] + vb->nz[i] * vb->nz[i];
+    if (len2 > 0.f) {
+      float const inv = 1.f / sqrtf(len2);
+      vb->nx[i] *= inv;
+      vb->ny[i] *= inv;
+      vb->nz[i] *= inv;
+    }
+  }
+}
+
+/**
+ * Calculate smooth vertex normals from the primitives
+ * Each vertex normal is the area-weighted average of the face normals of the primitives that use it.
+ * The face normal of (p0, p1, p2) is (p1 - p0) x (p2 - p0); quads use their two diagonals.
+ * @param vb Builder
+ */
+static inline void aviutl2_vertex_builder_compute_normals(struct aviutl2_vertex_builder *vb) {
+  size_t const bytes = vb->num * sizeof(float);
+  memset(vb->nx, 0, bytes);
+  memset(vb->ny, 0, bytes);
+  memset(vb->nz, 0, bytes);
+  size_t const prim = vb->primitive == 4 ? 4 : 3;
+  size_t const faces = vb->index_num / prim;
+  uint32_t const *idx = vb->indices;
+  float const *px = vb->x, *py = vb->y, *pz = vb->z;
+  size_t f = 0;
+#if AVIUTL2_HAS_SSE2
+  for (; f + 4 <= faces; f += 4) {
+    uint32_t const *q0 = idx + f * prim, *q1 = q0 + prim, *q2 = q1 + prim, *q3 = q2 + prim;
+    // For a triangle a = p1 - p0, b = p2 - p0; for a quad a = p2 - p0, b = p3 - p1.
+    size_t const ia = prim == 4 ? 2 : 1, ib = prim == 4 ? 3 : 2, ic = prim == 4 ? 1 : 0;
+#  define AVIUTL2_VB_GATHER_(arr, k) _mm_set_ps(arr[q3[k]], arr[q2[k]], arr[q1[k]], arr[q0[k]])
+    __m128 const ax = _mm_sub_ps(AVIUTL2_VB_GATHER_(px, ia), AVIUTL2_VB_GATHER_(px, 0));
+    __m128 const ay = _mm_sub_ps(AVIUTL2_VB_GATHER_(py, ia), AVIUTL2_VB_GATHER_(py, 0));
+    __m128 const az = _mm_sub_ps(AVIUTL2_VB_GATHER_(pz, ia), AVIUTL2_VB_GATHER_(pz, 0));
+    __m128 const bx = _mm_sub_ps(AVIUTL2_VB_GATHER_(px, ib), AVIUTL2_VB_GATHER_(px, ic));
+    __m128 const by = _mm_sub_ps(AVIUTL2_VB_GATHER_(py, ib), AVIUTL2_VB_GATHER_(py, ic));
+    __m128 const bz = _mm_sub_ps(AVIUTL2_VB_GATHER_(pz, ib), AVIUTL2_VB_GATHER_(pz, ic));
+#  undef AVIUTL2_VB_GATHER_
+    float cx[4], cy[4], cz[4];
+    _mm_storeu_ps(cx, _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by)));
+    _mm_storeu_ps(cy, _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz)));
+    _mm_storeu_ps(cz, _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+    for (size_t j = 0; j < 4; ++j) {
+      uint32_t const *q = idx + (f + j) * prim;
+      for (size_t k = 0; k < prim; ++k) {
+        if (k == 3 && q[3] == q[2]) {
+          break;
+        }
+        vb->nx[q[k]] += cx[j];
+        vb->ny[q[k]] += cy[j];
+        vb->nz[q[k]] += cz[j];
+      }
+    }
+  }
+#endif
+  for (; f < faces; ++f) {
+    uint32_t const *q = idx + f * prim;
+    uint32_t const p0 = q[0], pa = prim == 4 ? q[2] : q[1], pb = prim == 4 ? q[3] : q[2], pc = prim == 4 ? q[1] : q[0];
+    float const ax = px[pa] - px[p0], ay = py[pa] - py[p0], az = pz[pa] - pz[p0];
+    float const bx = px[pb] - px[pc], by = py[pb] - py[pc], bz = pz[pb] - pz[pc];
+    float const cx = ay * bz - az * by, cy = az * bx - ax * bz, cz = ax * by - ay * bx;
+    for (size_t k = 0; k < prim; ++k) {
+      if (k == 3 && q[3] == q[2]) {
+        break;
+      }
+      vb->nx[q[k]] += cx;
+      vb->ny[q[k]] += cy;
+      vb->nz[q[k]] += cz;
+    }
+  }
+  aviutl2_vertex_builder_normalize(vb);
+}
+
+/**
+ * Get the size of one vertex in the layout of the specified vertex type
+ * @param type Vertex list type
+ * @return Size in bytes, or 0 if type is unknown
+ */
+static inline size_t aviutl2_vertex_type_size(enum aviutl2_vertex_type type) {
+  switch (type) {
+  case aviutl2_vertex_type_triangle_color:
+  case aviutl2_vertex_type_quad_color:
+    return sizeof(struct aviutl2_vertex_color);
+  case aviutl2_vertex_type_triangle_color_norm:
+  case aviutl2_vertex_type_quad_color_norm:
+    return sizeof(struct aviutl2_vertex_color_norm);
+  case aviutl2_vertex_type_triangle_texture:
+  case aviutl2_vertex_type_quad_texture:
+    return sizeof(struct aviutl2_vertex_texture);
+  case aviutl2_vertex_type_triangle_texture_norm:
+  case aviutl2_vertex_type_quad_texture_norm:
+    return sizeof(struct aviutl2_vertex_texture_norm);
+  }
+  return 0;
+}
+
+/**
+ * Convert the mesh into the vertex list layout of the specified type
+ * The returned buffer is owned by the builder and stays valid until the next pack or destroy
+ * @param vb Builder
+ * @param type Vertex list type (triangle types for a triangle list builder, quad types for a quad list builder)
+ * @param vertex_num Pointer to storage for the number of vertices in the list
+ * @return Pointer to the vertex list, or NULL if type does not match the primitive type or memory allocation failed
+ */
+static inline void const *
+aviutl2_vertex_builder_pack(struct aviutl2_vertex_builder *vb, enum aviutl2_vertex_type type, int *vertex_num) {
+  size_t const size = aviutl2_vertex_type_size(type);
+  bool const quad = type >= aviutl2_vertex_type_quad_color;
+  if (!size || quad != (vb->primitive == 4) || vb->index_num > INT32_MAX) {
+    return NULL;
+  }
+  size_t const n = vb->index_num;
+  if (n * size > vb->packed_cap) {
+    void *p = realloc(vb->packed, n * size);
+    if (!p) {
+      return NULL;
+    }
+    vb->packed = p;
+    vb->packed_cap = n * size;
+  }
+  uint32_t const *idx = vb->indices;
+  switch (type) {
+  case aviutl2_vertex_type_triangle_color:
+  case aviutl2_vertex_type_quad_color: {
+    struct aviutl2_vertex_color *o = (struct aviutl2_vertex_color *)vb->packed;
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t const j = idx[i];
+      o[i] = (struct aviutl2_vertex_color){vb->x[j], vb->y[j], vb->z[j], vb->r[j], vb->g[j], vb->b[j], vb->a[j]};
+    }
+  } break;
+  case aviutl2_vertex_type_triangle_color_norm:
+  case aviutl2_vertex_type_quad_color_norm: {
+    struct aviutl2_vertex_color_norm *o = (struct aviutl2_vertex_color_norm *)vb->packed;
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t const j = idx[i];
+      o[i] = (struct aviutl2_vertex_color_norm){
+          vb->x[j], vb->y[j], vb->z[j], vb->r[j], vb->g[j], vb->b[j], vb->a[j], vb->nx[j], vb->ny[j], vb->nz[j]};
+    }
+  } break;
+  case aviutl2_vertex_type_triangle_texture:
+  case aviutl2_vertex_type_quad_texture: {
+    struct aviutl2_vertex_texture *o = (struct aviutl2_vertex_texture *)vb->packed;
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t const j = idx[i];
+      o[i] = (struct aviutl2_vertex_texture){vb->x[j], vb->y[j], vb->z[j], vb->u[j], vb->v[j], vb->a[j]};
+    }
+  } break;
+  case aviutl2_vertex_type_triangle_texture_norm:
+  case aviutl2_vertex_type_quad_texture_norm: {
+    struct aviutl2_vertex_texture_norm *o = (struct aviutl2_vertex_texture_norm *)vb->packed;
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t const j = idx[i];
+      o[i] = (struct aviutl2_vertex_texture_norm){
+          vb->x[j], vb->y[j], vb->z[j], vb->u[j], vb->v[j], vb->a[j], vb->nx[j], vb->ny[j], vb->nz[j]};
+    }
+  } break;
+  }
+  *vertex_num = (int)n;
+  return vb->packed;
+}
+
+/**
+ * Pack the mesh and draw it with draw_poly()
+ * @param vb Builder
+ * @param video Video filter processing structure
+ * @param type Vertex list type
+ * @param resource Texture image resource name (NULL for color vertex types)
+ * @return false on failure
+ */
+static inline bool aviutl2_vertex_builder_draw(struct aviutl2_vertex_builder *vb,
+                                               struct aviutl2_filter_proc_video *video,
+                                               enum aviutl2_vertex_type type,
+                                               wchar_t const *resource) {
+  int n = 0;
+  void const *list = aviutl2_vertex_builder_pack(vb, type, &n);
+  if (!list) {
+    return false;
+  }
+  return n == 0 || video->draw_poly(type, list, n, resource);
+}
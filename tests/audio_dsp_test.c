@@ -0,0 +1,331 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+
+// Tests for aviutl2_audio_dsp.h
+//
+// Every kernel is run on lengths that are not multiples of 4 and on misaligned buffers, and compared bit for bit with
+// plain scalar references written from the documented formulas. The SSE2 build covers the vector loops together with
+// their scalar tails; the _scalar build covers the fallback.
+
+#include "../include/aviutl2_audio_dsp.h"
+
+#include <stdlib.h>
+
+#include "test.h"
+
+enum {
+  max_len = 67,
+  max_offset = 3,
+};
+
+static void ref_gain_ramp(float *buffer, int n, float from, float to) {
+  if (from == to) {
+    for (int i = 0; i < n; ++i) {
+      buffer[i] = to == 1.f ? buffer[i] : buffer[i] * to;
+    }
+    return;
+  }
+  float const step = (to - from) / (float)n;
+  for (int i = 0; i < n; ++i) {
+    buffer[i] *= from + step * (float)(i + 1);
+  }
+}
+
+static void ref_mix(float *dst, float const *src, int n, float gain) {
+  for (int i = 0; i < n; ++i) {
+    dst[i] += src[i] * gain;
+  }
+}
+
+static void ref_mixdown(float *const *buffers, int channel_num, int n) {
+  float const scale = 1.f / (float)channel_num;
+  for (int i = 0; i < n; ++i) {
+    float sum = buffers[0][i];
+    for (int c = 1; c < channel_num; ++c) {
+      sum += buffers[c][i];
+    }
+    for (int c = 0; c < channel_num; ++c) {
+      buffers[c][i] = sum * scale;
+    }
+  }
+}
+
+static void ref_soft_clip(float *buffer, int n, float ceiling) {
+  float const in_scale = 1.f / ceiling;
+  for (int i = 0; i < n; ++i) {
+    float x = buffer[i] * in_scale;
+    x = x < -3.f ? -3.f : (x > 3.f ? 3.f : x);
+    float const x2 = x * x;
+    buffer[i] = (x * (27.f + x2)) / (27.f + 9.f * x2) * ceiling;
+  }
+}
+
+static void ref_dc_blocker(float r, float *x1, float *y1, float *p, int n) {
+  for (int i = 0; i < n; ++i) {
+    float const x = p[i];
+    *y1 = x - *x1 + r * *y1;
+    *x1 = x;
+    p[i] = *y1;
+  }
+}
+
+static void fill(uint32_t *state, float *p, int n, float lo, float hi) {
+  for (int i = 0; i < n; ++i) {
+    p[i] = test_randf(state, lo, hi);
+  }
+}
+
+#define CHECK_SAME(name, got, want, n)                                                                                 \
+  do {                                                                                                                 \
+    for (int i_ = 0; i_ < (n); ++i_) {                                                                                 \
+      if (memcmp((got) + i_, (want) + i_, sizeof(float)) != 0) {                                                       \
+        TEST_CHECKF(false, "%s n=%d: [%d] %.9g, want %.9g", name, (n), i_, (double)(got)[i_], (double)(want)[i_]);   \
+        break;                                                                                                         \
+      }                                                                                                                \
+    }                                                                                                                  \
+  } while (0)
+
+static void test_gain_ramp(void) {
+  static float const gains[][2] = {{0.f, 1.f}, {1.f, 0.f}, {0.5f, 0.5f}, {1.f, 1.f}, {0.3f, 1.7f}, {-1.f, 2.f}};
+  uint32_t state = 1;
+  float buf[max_len + max_offset], want[max_len + max_offset];
+  for (int n = 0; n <= max_len; ++n) {
+    for (int off = 0; off <= max_offset; ++off) {
+      for (size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); ++g) {
+        fill(&state, buf, n + off, -2.f, 2.f);
+        memcpy(want, buf, sizeof(buf));
+        aviutl2_audio_gain_ramp(buf + off, n, gains[g][0], gains[g][1]);
+        ref_gain_ramp(want + off, n, gains[g][0], gains[g][1]);
+        CHECK_SAME("gain_ramp", buf, want, n + off);
+      }
+    }
+  }
+  // The last sample reaches the target gain.
+  for (int n = 1; n <= max_len; ++n) {
+    for (int i = 0; i < n; ++i) {
+      buf[i] = 1.f;
+    }
+    aviutl2_audio_gain_ramp(buf, n, 0.25f, 0.75f);
+    TEST_CHECKF(buf[n - 1] == 0.75f, "n=%d: %.9g", n, (double)buf[n - 1]);
+  }
+}
+
+static void test_pan(void) {
+  uint32_t state = 2;
+  float l[max_len + max_offset], r[max_len + max_offset], wl[max_len + max_offset], wr[max_len + max_offset];
+  for (int n = 0; n <= max_len; ++n) {
+    for (int off = 0; off <= max_offset; ++off) {
+      float const from = test_randf(&state, -1.2f, 1.2f), to = test_randf(&state, -1.2f, 1.2f);
+      fill(&state, l, n + off, -1.f, 1.f);
+      fill(&state, r, n + off, -1.f, 1.f);
+      memcpy(wl, l, sizeof(l));
+      memcpy(wr, r, sizeof(r));
+      aviutl2_audio_pan(l + off, r + off, n, from, to);
+      float l0, r0, l1, r1;
+      aviutl2_audio_pan_gains(from, &l0, &r0);
+      aviutl2_audio_pan_gains(to, &l1, &r1);
+      ref_gain_ramp(wl + off, n, l0, l1);
+      ref_gain_ramp(wr + off, n, r0, r1);
+      CHECK_SAME("pan left", l, wl, n + off);
+      CHECK_SAME("pan right", r, wr, n + off);
+    }
+  }
+  float pl, pr;
+  aviutl2_audio_pan_gains(0.f, &pl, &pr);
+  TEST_CHECK(fabsf(pl - 1.f) < 1e-6f && fabsf(pr - 1.f) < 1e-6f);
+  aviutl2_audio_pan_gains(-1.f, &pl, &pr);
+  TEST_CHECK(fabsf(pl - 1.41421356f) < 1e-6f && fabsf(pr) < 1e-6f);
+}
+
+static void test_mix(void) {
+  uint32_t state = 3;
+  float dst[max_len + max_offset], src[max_len + max_offset], want[max_len + max_offset];
+  for (int n = 0; n <= max_len; ++n) {
+    for (int off = 0; off <= max_offset; ++off) {
+      float const gain = test_randf(&state, -2.f, 2.f);
+      fill(&state, dst, n + off, -1.f, 1.f);
+      fill(&state, src, n + off, -1.f, 1.f);
+      memcpy(want, dst, sizeof(dst));
+      // Source and destination are misaligned differently.
+      aviutl2_audio_mix(dst + off, src + max_offset - off, n, gain);
+      ref_mix(want + off, src + max_offset - off, n, gain);
+      CHECK_SAME("mix", dst, want, n + off);
+    }
+  }
+}
+
+static void test_mixdown(void) {
+  uint32_t state = 4;
+  float bufs[aviutl2_audio_max_channels + 1][max_len + max_offset];
+  float wants[aviutl2_audio_max_channels + 1][max_len + max_offset];
+  for (int ch = 1; ch <= aviutl2_audio_max_channels + 1; ++ch) {
+    for (int n = 0; n <= max_len; ++n) {
+      int const off = n % (max_offset + 1);
+      float *b[aviutl2_audio_max_channels + 1], *w[aviutl2_audio_max_channels + 1];
+      for (int c = 0; c < ch; ++c) {
+        fill(&state, bufs[c], n + off, -1.f, 1.f);
+        memcpy(wants[c], bufs[c], sizeof(bufs[c]));
+        b[c] = bufs[c] + off;
+        w[c] = wants[c] + off;
+      }
+      aviutl2_audio_mixdown(b, ch, n);
+      if (ch > 1) {
+        ref_mixdown(w, ch, n);
+      }
+      for (int c = 0; c < ch; ++c) {
+        CHECK_SAME("mixdown", bufs[c], wants[c], n + off);
+      }
+    }
+  }
+}
+
+static void test_soft_clip(void) {
+  uint32_t state = 5;
+  float buf[max_len + max_offset], want[max_len + max_offset];
+  for (int n = 0; n <= max_len; ++n) {
+    for (int off = 0; off <= max_offset; ++off) {
+      float const ceiling = test_randf(&state, 0.1f, 1.f);
+      fill(&state, buf, n + off, -4.f, 4.f);
+      memcpy(want, buf, sizeof(buf));
+      aviutl2_audio_soft_clip(buf + off, n, ceiling);
+      ref_soft_clip(want + off, n, ceiling);
+      CHECK_SAME("soft_clip", buf, want, n + off);
+      for (int i = 0; i < n; ++i) {
+        TEST_CHECKF(fabsf(buf[off + i]) <= ceiling * 1.000001f, "%.9g > %.9g", (double)buf[off + i], (double)ceiling);
+      }
+    }
+  }
+}
+
+static void test_dc_blocker(void) {
+  uint32_t state = 6;
+  float l[max_len * 3], r[max_len * 3], wl[max_len * 3], wr[max_len * 3];
+  for (int n = 0; n <= max_len; ++n) {
+    struct aviutl2_audio_dc_blocker dc;
+    aviutl2_audio_dc_blocker_init(&dc, 20.f, 48000);
+    float x1[2] = {0}, y1[2] = {0};
+    // Three consecutive buffers of n samples each must continue the same filter.
+    fill(&state, l, n * 3, 0.f, 1.f);
+    fill(&state, r, n * 3, -1.f, 0.f);
+    memcpy(wl, l, sizeof(l));
+    memcpy(wr, r, sizeof(r));
+    for (int k = 0; k < 3; ++k) {
+      float *const b[2] = {l + k * n, r + k * n};
+      aviutl2_audio_dc_blocker_process(&dc, b, 2, n);
+      ref_dc_blocker(dc.r, x1, y1, wl + k * n, n);
+      ref_dc_blocker(dc.r, x1 + 1, y1 + 1, wr + k * n, n);
+    }
+    CHECK_SAME("dc_blocker left", l, wl, n * 3);
+    CHECK_SAME("dc_blocker right", r, wr, n * 3);
+  }
+  // A constant offset decays towards zero.
+  static float dcbuf[48000];
+  for (size_t i = 0; i < sizeof(dcbuf) / sizeof(dcbuf[0]); ++i) {
+    dcbuf[i] = 0.5f;
+  }
+  struct aviutl2_audio_dc_blocker dc;
+  aviutl2_audio_dc_blocker_init(&dc, 20.f, 48000);
+  float *const b[1] = {dcbuf};
+  aviutl2_audio_dc_blocker_process(&dc, b, 1, (int)(sizeof(dcbuf) / sizeof(dcbuf[0])));
+  TEST_CHECKF(fabsf(dcbuf[47999]) < 1e-3f, "%.9g", (double)dcbuf[47999]);
+}
+
+static void test_gain_process(void) {
+  enum { n = 37 };
+  float l[n * 2], r[n * 2];
+  for (int i = 0; i < n * 2; ++i) {
+    l[i] = r[i] = 1.f;
+  }
+  struct aviutl2_audio_gain g = {0};
+  struct aviutl2_object_audio_param param = {.vol_l = 0.5f, .vol_r = 0.25f};
+  float *b[2] = {l, r};
+  // The first buffer has no previous gain and uses the target throughout.
+  aviutl2_audio_gain_process_param(&g, b, 2, n, 1000, &param);
+  TEST_CHECK(l[0] == 0.5f && l[n - 1] == 0.5f && r[0] == 0.25f && r[n - 1] == 0.25f);
+  TEST_CHECK(param.vol_l == 1.f && param.vol_r == 1.f);
+  // A contiguous buffer ramps from the previous gain.
+  param.vol_l = 1.f;
+  param.vol_r = 0.75f;
+  b[0] = l + n;
+  b[1] = r + n;
+  aviutl2_audio_gain_process_param(&g, b, 2, n, 1000 + n, &param);
+  TEST_CHECK(l[n] > 0.5f && l[n] < 1.f && l[n * 2 - 1] == 1.f);
+  TEST_CHECK(r[n] > 0.25f && r[n] < 0.75f && r[n * 2 - 1] == 0.75f);
+  // A seek skips the ramp.
+  for (int i = 0; i < n; ++i) {
+    l[i] = r[i] = 1.f;
+  }
+  param.vol_l = 0.125f;
+  param.vol_r = 0.125f;
+  b[0] = l;
+  b[1] = r;
+  aviutl2_audio_gain_process_param(&g, b, 2, n, 0, &param);
+  TEST_CHECK(l[0] == 0.125f && r[0] == 0.125f);
+}
+
+static void bench(void) {
+  enum { len = 1 << 16, rounds = 2000 };
+  float *l = (float *)malloc(len * sizeof(float));
+  float *r = (float *)malloc(len * sizeof(float));
+  if (!l || !r) {
+    free(l);
+    free(r);
+    return;
+  }
+  uint32_t state = 7;
+  fill(&state, l, len, -1.f, 1.f);
+  fill(&state, r, len, -1.f, 1.f);
+  float *const b[2] = {l, r};
+  double const samples = (double)len * rounds * 1e-6;
+  double t0 = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    aviutl2_audio_gain_ramp(l, len, i & 1 ? 0.999f : 1.001f, i & 1 ? 1.001f : 0.999f);
+  }
+  printf("gain_ramp: %.0f Msamples/s\n", samples / (test_now() - t0));
+  t0 = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    aviutl2_audio_pan(l, r, len, i & 1 ? -0.01f : 0.01f, i & 1 ? 0.01f : -0.01f);
+  }
+  printf("pan: %.0f Msamples/s (stereo)\n", samples / (test_now() - t0));
+  t0 = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    aviutl2_audio_mix(l, r, len, i & 1 ? 0.5f : -0.5f);
+  }
+  printf("mix: %.0f Msamples/s\n", samples / (test_now() - t0));
+  t0 = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    aviutl2_audio_mixdown(b, 2, len);
+  }
+  printf("mixdown: %.0f Msamples/s (stereo)\n", samples / (test_now() - t0));
+  t0 = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    aviutl2_audio_soft_clip(l, len, 0.9f);
+  }
+  printf("soft_clip: %.0f Msamples/s\n", samples / (test_now() - t0));
+  struct aviutl2_audio_dc_blocker dc;
+  aviutl2_audio_dc_blocker_init(&dc, 20.f, 48000);
+  unsigned const csr = aviutl2_audio_denormals_begin();
+  t0 = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    aviutl2_audio_dc_blocker_process(&dc, b, 2, len);
+  }
+  printf("dc_blocker: %.0f Msamples/s (stereo)\n", samples / (test_now() - t0));
+  aviutl2_audio_denormals_end(csr);
+  free(l);
+  free(r);
+}
+
+int main(int argc, char **argv) {
+  if (test_is_bench(argc, argv)) {
+    bench();
+    return 0;
+  }
+  test_gain_ramp();
+  test_pan();
+  test_mix();
+  test_mixdown();
+  test_soft_clip();
+  test_dc_blocker();
+  test_gain_process();
+  return test_result(argv[0]);
+}
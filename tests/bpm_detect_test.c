@@ -0,0 +1,267 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+
+// Tests for aviutl2_bpm_detect.h
+//
+// Detection runs on a synthetic drum track (kick on every beat, snare on 2 and 4, hi-hat on eighths over a pad) with
+// known tempo changes. The background job is driven through a mock aviutl2_cache_handle. The benchmark reports the
+// analysis time per hour of 48 kHz audio.
+
+#include "../include/aviutl2_bpm_detect.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#include "test.h"
+
+struct track {
+  int rate;
+  double first_beat;
+  int seg_num;
+  struct {
+    double tempo;
+    double seconds;
+  } segs[4];
+};
+
+static struct track const *g_track;
+
+static int64_t track_samples(struct track const *t) {
+  int64_t n = 0;
+  for (int s = 0; s < t->seg_num; ++s) {
+    n += (int64_t)(t->segs[s].seconds * t->rate);
+  }
+  return n;
+}
+
+/**
+ * Find the beat at or before time t
+ * @return Beat number; tempo and the time since the beat are stored in tempo and phase
+ */
+static double track_beat(struct track const *tr, double t, double *tempo, double *phase) {
+  double start = 0.0, beat0 = tr->first_beat;
+  for (int s = 0; s < tr->seg_num; ++s) {
+    double const end = start + tr->segs[s].seconds;
+    double const period = 60.0 / tr->segs[s].tempo;
+    if (t < end || s == tr->seg_num - 1) {
+      double const k = floor((t - beat0) / period);
+      *tempo = tr->segs[s].tempo;
+      *phase = t - (beat0 + k * period);
+      return k;
+    }
+    // The first beat of the next range falls on the grid of the previous one
+    beat0 += ceil((end - beat0) / period) * period;
+    start = end;
+  }
+  return 0.0;
+}
+
+static float noise(uint32_t *state) { return (float)(int32_t)test_rand(state) * (1.f / 2147483648.f); }
+
+static void track_render(struct track const *tr, int64_t pos, int n, float *out) {
+  uint32_t state = (uint32_t)pos * 2654435761u + 1u;
+  for (int i = 0; i < n; ++i) {
+    double const t = (double)(pos + i) / tr->rate;
+    if (t < tr->first_beat) {
+      out[i] = 0.01f * noise(&state);
+      continue;
+    }
+    double tempo, phase;
+    double const k = track_beat(tr, t, &tempo, &phase);
+    double const period = 60.0 / tempo;
+    double v = 0.6 * sin(2.0 * 3.14159265358979323846 * 55.0 * phase) * exp(-phase * 18.0);
+    v += 0.15 * noise(&state) * exp(-fmod(phase, period / 2.0) * 60.0);
+    if ((long long)k % 2 == 1) {
+      v += 0.3 * noise(&state) * exp(-phase * 25.0);
+    }
+    v += 0.05 * sin(2.0 * 3.14159265358979323846 * 220.0 * t + 3.0 * sin(t));
+    out[i] = (float)v;
+  }
+}
+
+static int detect(struct track const *tr, struct aviutl2_bpm_info *list, int cap) {
+  struct aviutl2_bpm_detect d;
+  if (!aviutl2_bpm_detect_init(&d, tr->rate, 60.f, 200.f)) {
+    return -1;
+  }
+  enum { chunk = 4096 };
+  float buf[chunk];
+  int64_t const total = track_samples(tr);
+  for (int64_t pos = 0; pos < total; pos += chunk) {
+    int const n = total - pos < chunk ? (int)(total - pos) : chunk;
+    track_render(tr, pos, n, buf);
+    aviutl2_bpm_detect_process(&d, buf, NULL, n);
+  }
+  int const n = aviutl2_bpm_detect_finish(&d, 4, list, cap);
+  aviutl2_bpm_detect_exit(&d);
+  return n;
+}
+
+/**
+ * Check the tempo of an entry and how far its beat grid is from the real beats a few beats into the entry
+ */
+static void check_entry(struct track const *tr, struct aviutl2_bpm_info const *e, double want_tempo) {
+  TEST_CHECKF(fabs(e->tempo - want_tempo) < 0.5, "tempo %f, want %f", (double)e->tempo, want_tempo);
+  double const period = 60.0 / e->tempo;
+  double t = e->start + e->offset;
+  while (t < e->start + 1.5) {
+    t += period;
+  }
+  t += 8.0 * period;
+  double tempo, phase;
+  track_beat(tr, t + 1e-9, &tempo, &phase);
+  if (phase > 30.0 / tempo) {
+    phase -= 60.0 / tempo;
+  }
+  TEST_CHECKF(fabs(phase) < 0.02, "tempo %f: beat is %+.1f ms off", want_tempo, phase * 1000.0);
+}
+
+static void test_detect(void) {
+  struct aviutl2_bpm_info list[8];
+  {
+    struct track const tr = {48000, 0.25, 1, {{128.0, 60.0}}};
+    int const n = detect(&tr, list, 8);
+    TEST_CHECKF(n == 1, "%d entries", n);
+    if (n >= 1) {
+      TEST_CHECK(list[0].beat == 4 && list[0].start == 0.0);
+      check_entry(&tr, list + 0, 128.0);
+    }
+  }
+  {
+    struct track const tr = {48000, 0.5, 2, {{128.0, 60.0}, {100.0, 60.0}}};
+    int const n = detect(&tr, list, 8);
+    TEST_CHECKF(n == 2, "%d entries", n);
+    if (n >= 2) {
+      check_entry(&tr, list + 0, 128.0);
+      check_entry(&tr, list + 1, 100.0);
+      TEST_CHECKF(fabs(list[1].start - 60.0) < 4.0, "change at %f", list[1].start);
+    }
+  }
+  {
+    struct track const tr = {44100, 0.33, 1, {{120.5, 30.0}}};
+    int const n = detect(&tr, list, 8);
+    TEST_CHECKF(n == 1, "%d entries", n);
+    if (n >= 1) {
+      check_entry(&tr, list + 0, 120.5);
+    }
+  }
+  {
+    // Silence has no tempo
+    struct aviutl2_bpm_detect d;
+    TEST_CHECK(aviutl2_bpm_detect_init(&d, 48000, 60.f, 200.f));
+    float zero[4800] = {0};
+    for (int i = 0; i < 200; ++i) {
+      aviutl2_bpm_detect_process(&d, zero, zero, 4800);
+    }
+    TEST_CHECK(aviutl2_bpm_detect_finish(&d, 4, NULL, 0) == 0);
+    aviutl2_bpm_detect_exit(&d);
+  }
+}
+
+static LONG g_reads;
+static struct aviutl2_bpm_info g_applied[8];
+static int g_applied_num;
+
+static bool mock_audio_info(wchar_t const *file, struct aviutl2_audio_info *info, int info_size) {
+  (void)file;
+  (void)info_size;
+  info->rate = g_track->rate;
+  info->sample_num = track_samples(g_track);
+  info->channel = 2;
+  return true;
+}
+
+static int mock_audio_data(wchar_t const *file, int track, int64_t start, int length, float *left, float *right) {
+  (void)file;
+  (void)track;
+  InterlockedIncrement(&g_reads);
+  track_render(g_track, start, length, left);
+  memcpy(right, left, (size_t)length * sizeof(float));
+  return length;
+}
+
+static void mock_set_grid_bpm_list(struct aviutl2_bpm_info *bpm_list, int bpm_num, int bpm_size) {
+  (void)bpm_size;
+  g_applied_num = bpm_num;
+  memcpy(g_applied, bpm_list, (size_t)(bpm_num < 8 ? bpm_num : 8) * sizeof(*bpm_list));
+}
+
+static void test_job(void) {
+  struct track const tr = {48000, 0.5, 2, {{128.0, 30.0}, {100.0, 30.0}}};
+  g_track = &tr;
+  struct aviutl2_cache_handle cache = {0};
+  cache.get_audio_file_info = mock_audio_info;
+  cache.get_audio_file_data = mock_audio_data;
+  struct aviutl2_bpm_detect_job *job = aviutl2_bpm_detect_job_start(&cache, L"track.wav", 0, 60.f, 200.f, 4);
+  TEST_CHECK(job != NULL);
+  if (!job) {
+    return;
+  }
+  struct timespec const wait = {0, 10 * 1000 * 1000};
+  while (aviutl2_bpm_detect_job_state(job) == aviutl2_bpm_detect_state_running) {
+    nanosleep(&wait, NULL);
+  }
+  TEST_CHECK(aviutl2_bpm_detect_job_state(job) == aviutl2_bpm_detect_state_done);
+  TEST_CHECK(aviutl2_bpm_detect_job_progress(job) == 1.f);
+  struct aviutl2_edit_section edit = {0};
+  edit.set_grid_bpm_list = mock_set_grid_bpm_list;
+  aviutl2_bpm_detect_job_apply(job, &edit);
+  TEST_CHECKF(g_applied_num == 2, "%d entries", g_applied_num);
+  if (g_applied_num >= 2) {
+    check_entry(&tr, g_applied + 0, 128.0);
+    check_entry(&tr, g_applied + 1, 100.0);
+  }
+  aviutl2_bpm_detect_job_destroy(job);
+
+  // Destroying a running job waits for its thread, so nothing reads audio afterwards
+  job = aviutl2_bpm_detect_job_start(&cache, L"track.wav", 0, 60.f, 200.f, 4);
+  TEST_CHECK(job != NULL);
+  if (job) {
+    aviutl2_bpm_detect_job_destroy(job);
+    InterlockedExchange(&g_reads, 0);
+    nanosleep(&wait, NULL);
+    TEST_CHECK(InterlockedExchange(&g_reads, 0) == 0);
+  }
+}
+
+static void bench(void) {
+  enum { minutes = 10, rate = 48000 };
+  struct track const tr = {rate, 0.25, 1, {{128.0, minutes * 60.0}}};
+  int64_t const total = track_samples(&tr);
+  float *const samples = (float *)malloc((size_t)total * sizeof(float));
+  if (!samples) {
+    return;
+  }
+  track_render(&tr, 0, (int)total, samples);
+  struct aviutl2_bpm_detect d;
+  if (!aviutl2_bpm_detect_init(&d, rate, 60.f, 200.f)) {
+    free(samples);
+    return;
+  }
+  double const t0 = test_now();
+  for (int64_t pos = 0; pos < total; pos += aviutl2_bpm_detect_read_chunk) {
+    int const n = total - pos < aviutl2_bpm_detect_read_chunk ? (int)(total - pos) : aviutl2_bpm_detect_read_chunk;
+    aviutl2_bpm_detect_process(&d, samples + pos, samples + pos, n);
+  }
+  double const t1 = test_now();
+  int const n = aviutl2_bpm_detect_finish(&d, 4, NULL, 0);
+  double const t2 = test_now();
+  double const per_hour = 60.0 / minutes;
+  printf("bpm_detect: %.2f s per audio hour (process %.2f s, finish %.3f s; 48 kHz stereo, %d entries)\n",
+         (t2 - t0) * per_hour,
+         (t1 - t0) * per_hour,
+         (t2 - t1) * per_hour,
+         n);
+  aviutl2_bpm_detect_exit(&d);
+  free(samples);
+}
+
+int main(int argc, char **argv) {
+  if (test_is_bench(argc, argv)) {
+    bench();
+    return 0;
+  }
+  test_detect();
+  test_job();
+  return test_result(argv[0]);
+}
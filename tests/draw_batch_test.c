@@ -0,0 +1,286 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+
+// Tests for aviutl2_draw_batch.h
+//
+// Quads produced by aviutl2_draw_batch_expand() (SSE2 groups of four plus the scalar tail) and by
+// aviutl2_draw_batch_expand_scalar() are compared with a reference transform computed in double precision from the
+// sprite parameters: corners of the drawn region, moved by the center, scaled, rotated around Z and translated.
+// The batch itself is driven through a mock aviutl2_filter_proc_video to check flushing and the draw_image()
+// fallback.
+
+#include "../include/aviutl2_draw_batch.h"
+
+#include "test.h"
+
+#include <stdlib.h>
+
+static struct aviutl2_draw_sprite random_sprite(uint32_t *rng) {
+  struct aviutl2_draw_sprite sp = {
+      .x = test_randf(rng, -2000.f, 2000.f),
+      .y = test_randf(rng, -2000.f, 2000.f),
+      .z = test_randf(rng, -100.f, 100.f),
+      .rz = test_randf(rng, -720.f, 720.f),
+      .sx = test_randf(rng, -3.f, 3.f),
+      .sy = test_randf(rng, -3.f, 3.f),
+      .cx = test_randf(rng, -50.f, 50.f),
+      .cy = test_randf(rng, -50.f, 50.f),
+      .alpha = test_randf(rng, 0.f, 1.f),
+      .width = test_randf(rng, 1.f, 512.f),
+      .height = test_randf(rng, 1.f, 512.f),
+      .u0 = test_randf(rng, 0.f, 0.5f),
+      .v0 = test_randf(rng, 0.f, 0.5f),
+      .u1 = test_randf(rng, 0.5f, 1.f),
+      .v1 = test_randf(rng, 0.5f, 1.f),
+  };
+  return sp;
+}
+
+// Checks the four vertices of one sprite against the reference transform
+static bool check_quad(struct aviutl2_draw_sprite const *sp, struct aviutl2_vertex_texture const *v) {
+  static double const corner_x[4] = {-0.5, 0.5, 0.5, -0.5};
+  static double const corner_y[4] = {-0.5, -0.5, 0.5, 0.5};
+  double const rad = (double)sp->rz * 3.14159265358979323846 / 180.0;
+  double const c = cos(rad), s = sin(rad);
+  float const us[4] = {sp->u0, sp->u1, sp->u1, sp->u0};
+  float const vs[4] = {sp->v0, sp->v0, sp->v1, sp->v1};
+  bool ok = true;
+  for (int k = 0; k < 4; ++k) {
+    double const px = (corner_x[k] * sp->width - sp->cx) * sp->sx;
+    double const py = (corner_y[k] * sp->height - sp->cy) * sp->sy;
+    double const x = sp->x + px * c - py * s;
+    double const y = sp->y + px * s + py * c;
+    // Single precision rotation of coordinates up to a few thousand pixels
+    double const tolerance = 1e-3 + 4e-7 * (fabs(sp->x) + fabs(sp->y) + fabs(px) + fabs(py));
+    if (fabs(v[k].x - x) > tolerance || fabs(v[k].y - y) > tolerance) {
+      fprintf(stderr, "corner %d: got (%f, %f) expect (%f, %f)\n", k, (double)v[k].x, (double)v[k].y, x, y);
+      ok = false;
+    }
+    ok = ok && v[k].z == sp->z && v[k].u == us[k] && v[k].v == vs[k] && v[k].a == sp->alpha;
+  }
+  return ok;
+}
+
+static struct aviutl2_vertex_texture captured[4 * 4096];
+static int captured_num;
+static int poly_calls, image_calls;
+static enum aviutl2_blend_mode blend_now;
+static enum aviutl2_sampler_mode sampler_now;
+static enum aviutl2_blend_mode poly_blend, image_blend;
+static enum aviutl2_sampler_mode poly_sampler, image_sampler;
+
+static bool
+mock_draw_poly(enum aviutl2_vertex_type type, void const *vertex_list, int vertex_num, wchar_t const *resource) {
+  (void)resource;
+  TEST_CHECK(type == aviutl2_vertex_type_quad_texture);
+  TEST_CHECK(vertex_num % 4 == 0 && vertex_num <= (int)(sizeof(captured) / sizeof(captured[0])));
+  memcpy(captured, vertex_list, (size_t)vertex_num * sizeof(captured[0]));
+  captured_num = vertex_num;
+  poly_blend = blend_now;
+  poly_sampler = sampler_now;
+  ++poly_calls;
+  return true;
+}
+
+static bool mock_draw_image(wchar_t const *resource,
+                            float x,
+                            float y,
+                            float z,
+                            float rx,
+                            float ry,
+                            float rz,
+                            float sx,
+                            float sy,
+                            float sz,
+                            float alpha) {
+  (void)resource, (void)x, (void)y, (void)z, (void)rx, (void)ry, (void)rz, (void)sx, (void)sy, (void)sz, (void)alpha;
+  image_blend = blend_now;
+  image_sampler = sampler_now;
+  ++image_calls;
+  return true;
+}
+
+static void mock_set_blend_mode(enum aviutl2_blend_mode blend) { blend_now = blend; }
+static void mock_set_sampler_mode(enum aviutl2_sampler_mode sampler) { sampler_now = sampler; }
+
+static bool mock_get_image_resource_size(wchar_t const *resource, int *width, int *height) {
+  (void)resource;
+  *width = 64;
+  *height = 32;
+  return true;
+}
+
+static struct aviutl2_filter_proc_video mock_video(void) {
+  struct aviutl2_filter_proc_video video = {0};
+  video.draw_poly = mock_draw_poly;
+  video.draw_image = mock_draw_image;
+  video.set_blend_mode = mock_set_blend_mode;
+  video.set_sampler_mode = mock_set_sampler_mode;
+  video.get_image_resource_size = mock_get_image_resource_size;
+  return video;
+}
+
+static void test_expand(void) {
+  uint32_t rng = 7;
+  static struct aviutl2_draw_sprite sprites[64];
+  static struct aviutl2_vertex_texture simd[64 * 4], scalar[64 * 4];
+  struct aviutl2_filter_proc_video video = mock_video();
+  // Every count up to 64 covers empty input, scalar-only input and every tail length after the SIMD groups
+  for (size_t num = 0; num <= 64; ++num) {
+    struct aviutl2_draw_batch b = {0};
+    TEST_CHECK(aviutl2_draw_batch_begin(&b, &video, L"obj", aviutl2_blend_mode_none, aviutl2_sampler_mode_clip));
+    for (size_t i = 0; i < num; ++i) {
+      sprites[i] = random_sprite(&rng);
+      TEST_CHECK(aviutl2_draw_batch_add_sprite(&b, &sprites[i]));
+    }
+    aviutl2_draw_batch_expand(&b.s, num, simd);
+    aviutl2_draw_batch_expand_scalar(&b.s, 0, num, scalar);
+    for (size_t i = 0; i < num; ++i) {
+      TEST_CHECKF(check_quad(&sprites[i], simd + i * 4), "expand num=%zu sprite=%zu", num, i);
+      TEST_CHECKF(check_quad(&sprites[i], scalar + i * 4), "expand_scalar num=%zu sprite=%zu", num, i);
+    }
+    aviutl2_draw_batch_destroy(&b);
+  }
+}
+
+static void test_flush(void) {
+  uint32_t rng = 11;
+  struct aviutl2_filter_proc_video video = mock_video();
+  struct aviutl2_draw_batch b = {0};
+  static size_t const counts[] = {1, 3, 5, 7, 257, 1001};
+  for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+    size_t const num = counts[c];
+    float *const params = (float *)malloc(num * 7 * sizeof(float));
+    poly_calls = 0;
+    TEST_CHECK(aviutl2_draw_batch_begin(&b, &video, L"obj", aviutl2_blend_mode_add, aviutl2_sampler_mode_loop));
+    for (size_t i = 0; i < num; ++i) {
+      float *p = params + i * 7;
+      p[0] = test_randf(&rng, -500.f, 500.f);
+      p[1] = test_randf(&rng, -500.f, 500.f);
+      p[2] = test_randf(&rng, -10.f, 10.f);
+      p[3] = test_randf(&rng, -180.f, 180.f);
+      p[4] = test_randf(&rng, 0.1f, 2.f);
+      p[5] = test_randf(&rng, 0.1f, 2.f);
+      p[6] = test_randf(&rng, 0.f, 1.f);
+      TEST_CHECK(aviutl2_draw_batch_add(&b, p[0], p[1], p[2], p[3], p[4], p[5], p[6]));
+    }
+    TEST_CHECK(aviutl2_draw_batch_end(&b));
+    TEST_CHECK(poly_calls == 1 && captured_num == (int)num * 4);
+    TEST_CHECK(poly_blend == aviutl2_blend_mode_add && poly_sampler == aviutl2_sampler_mode_loop);
+    for (size_t i = 0; i < num && captured_num == (int)num * 4; ++i) {
+      float const *p = params + i * 7;
+      struct aviutl2_draw_sprite const sp = {
+          .x = p[0],
+          .y = p[1],
+          .z = p[2],
+          .rz = p[3],
+          .sx = p[4],
+          .sy = p[5],
+          .alpha = p[6],
+          .width = 64.f,
+          .height = 32.f,
+          .u1 = 1.f,
+          .v1 = 1.f,
+      };
+      TEST_CHECKF(check_quad(&sp, captured + i * 4), "flush num=%zu sprite=%zu", num, i);
+    }
+    free(params);
+  }
+  aviutl2_draw_batch_destroy(&b);
+}
+
+static bool draw(struct aviutl2_draw_batch *b,
+                 struct aviutl2_filter_proc_video *video,
+                 enum aviutl2_blend_mode blend,
+                 enum aviutl2_sampler_mode sampler,
+                 float rx,
+                 float sz) {
+  return aviutl2_draw_batch_draw_image(
+      b, video, L"obj", blend, sampler, 10.f, 20.f, 0.f, rx, 0.f, 30.f, 1.f, 1.f, sz, 1.f);
+}
+
+static void test_draw_image(void) {
+  struct aviutl2_filter_proc_video video = mock_video();
+  struct aviutl2_draw_batch b = {0};
+  poly_calls = image_calls = 0;
+  for (int i = 0; i < 5; ++i) {
+    TEST_CHECK(draw(&b, &video, aviutl2_blend_mode_add, aviutl2_sampler_mode_loop, 0.f, 1.f));
+  }
+  TEST_CHECK(poly_calls == 0 && image_calls == 0);
+
+  // Z scaling is not batched: pending sprites are flushed first and the modes are applied to draw_image()
+  TEST_CHECK(draw(&b, &video, aviutl2_blend_mode_add, aviutl2_sampler_mode_loop, 0.f, 2.f));
+  TEST_CHECK(poly_calls == 1 && captured_num == 20 && image_calls == 1);
+  TEST_CHECK(image_blend == aviutl2_blend_mode_add && image_sampler == aviutl2_sampler_mode_loop);
+
+  // Rotation around X is not batched either
+  TEST_CHECK(draw(&b, &video, aviutl2_blend_mode_mul, aviutl2_sampler_mode_clamp, 30.f, 1.f));
+  TEST_CHECK(poly_calls == 1 && image_calls == 2);
+  TEST_CHECK(image_blend == aviutl2_blend_mode_mul && image_sampler == aviutl2_sampler_mode_clamp);
+
+  // A mode change splits the batch
+  TEST_CHECK(draw(&b, &video, aviutl2_blend_mode_mul, aviutl2_sampler_mode_clip, 0.f, 1.f));
+  TEST_CHECK(draw(&b, &video, aviutl2_blend_mode_screen, aviutl2_sampler_mode_clip, 0.f, 1.f));
+  TEST_CHECK(poly_calls == 2 && poly_blend == aviutl2_blend_mode_mul);
+  TEST_CHECK(aviutl2_draw_batch_end(&b));
+  TEST_CHECK(poly_calls == 3 && poly_blend == aviutl2_blend_mode_screen);
+  aviutl2_draw_batch_destroy(&b);
+}
+
+static bool
+bench_draw_poly(enum aviutl2_vertex_type type, void const *vertex_list, int vertex_num, wchar_t const *resource) {
+  (void)type, (void)vertex_list, (void)resource;
+  captured_num = vertex_num;
+  return true;
+}
+
+static void bench(void) {
+  uint32_t rng = 3;
+  size_t const num = 10000;
+  struct aviutl2_filter_proc_video video = mock_video();
+  video.draw_poly = bench_draw_poly;
+  struct aviutl2_draw_batch b = {0};
+  aviutl2_draw_batch_begin(&b, &video, L"obj", aviutl2_blend_mode_none, aviutl2_sampler_mode_clip);
+  for (size_t i = 0; i < num; ++i) {
+    struct aviutl2_draw_sprite const sp = random_sprite(&rng);
+    aviutl2_draw_batch_add_sprite(&b, &sp);
+  }
+  struct aviutl2_vertex_texture *const out =
+      (struct aviutl2_vertex_texture *)malloc(num * 4 * sizeof(struct aviutl2_vertex_texture));
+  int const rounds = 500;
+  double t = test_now();
+  for (int r = 0; r < rounds; ++r) {
+    aviutl2_draw_batch_expand(&b.s, num, out);
+  }
+  double const expand = test_now() - t;
+  t = test_now();
+  for (int r = 0; r < rounds; ++r) {
+    aviutl2_draw_batch_expand_scalar(&b.s, 0, num, out);
+  }
+  double const scalar = test_now() - t;
+  printf("expand        %7.1f Mvertices/s\n", (double)num * 4 * rounds / expand / 1e6);
+  printf("expand_scalar %7.1f Mvertices/s\n", (double)num * 4 * rounds / scalar / 1e6);
+  // add() + flush() per frame as used from func_proc_video()
+  b.num = 0;
+  t = test_now();
+  for (int r = 0; r < rounds; ++r) {
+    for (size_t i = 0; i < num; ++i) {
+      aviutl2_draw_batch_add(&b, (float)i, (float)r, 0.f, (float)i, 1.f, 1.f, 1.f);
+    }
+    aviutl2_draw_batch_flush(&b);
+  }
+  printf("add + flush   %7.1f Mvertices/s\n", (double)num * 4 * rounds / (test_now() - t) / 1e6);
+  free(out);
+  aviutl2_draw_batch_destroy(&b);
+}
+
+int main(int argc, char **argv) {
+  if (test_is_bench(argc, argv)) {
+    bench();
+    return 0;
+  }
+  test_expand();
+  test_flush();
+  test_draw_image();
+  return test_result(argv[0]);
+}
@@ -0,0 +1,207 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+
+// Tests for aviutl2_file_writer.h
+//
+// Files are written to the current directory through the Win32 shim in win32/, which rejects unaligned writes and
+// seeks on unbuffered handles and can make WriteFile() fail after a given number of bytes. The benchmark compares the
+// writer with fwrite() for small and medium write sizes.
+
+#include "../include/aviutl2_file_writer.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include "test.h"
+
+#define TEST_PATH "file_writer_test.tmp"
+#define TEST_PATH_W L"file_writer_test.tmp"
+
+static uint8_t pattern(size_t i) { return (uint8_t)(i * 7 + (i >> 13)); }
+
+static long long file_size(char const *path) {
+  struct stat st;
+  return stat(path, &st) == 0 ? (long long)st.st_size : -1;
+}
+
+static uint8_t *read_file(char const *path, size_t *size) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    return NULL;
+  }
+  long long const n = file_size(path);
+  uint8_t *buf = (uint8_t *)malloc(n > 0 ? (size_t)n : 1);
+  if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  *size = (size_t)n;
+  return buf;
+}
+
+/**
+ * Write total bytes of the pattern in pieces of pseudo random size, patch the first 4 bytes twice and close
+ * @return true if the file on disk has the expected size and content
+ */
+static bool write_and_verify(int flags, size_t total, uint64_t expected_size, char const *name) {
+  struct aviutl2_file_writer *w = aviutl2_file_writer_create(TEST_PATH_W, 0, expected_size, flags);
+  TEST_CHECKF(w != NULL, "%s: create", name);
+  if (!w) {
+    return false;
+  }
+  if (expected_size > 0) {
+    TEST_CHECKF(file_size(TEST_PATH) == (long long)expected_size, "%s: preallocated %lld", name, file_size(TEST_PATH));
+  }
+  uint8_t buf[70000];
+  uint32_t state = 1;
+  size_t pos = 0;
+  while (pos < total) {
+    size_t n = test_rand(&state) % sizeof(buf) + 1;
+    if (n > total - pos) {
+      n = total - pos;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      buf[i] = pattern(pos + i);
+    }
+    if (!aviutl2_file_writer_write(w, buf, n)) {
+      TEST_CHECKF(false, "%s: write at %zu", name, pos);
+      aviutl2_file_writer_close(w);
+      return false;
+    }
+    pos += n;
+  }
+  TEST_CHECKF(aviutl2_file_writer_tell(w) == total, "%s: tell", name);
+  uint32_t const first = 0x11111111, second = 0xdeadbeef;
+  size_t const patch_size = total < 4 ? total : 4;
+  TEST_CHECK(aviutl2_file_writer_patch(w, 0, &first, patch_size));
+  TEST_CHECK(aviutl2_file_writer_patch(w, 0, &second, patch_size));
+  bool const closed = aviutl2_file_writer_close(w);
+  TEST_CHECKF(closed, "%s: close", name);
+
+  size_t size = 0;
+  uint8_t *data = read_file(TEST_PATH, &size);
+  bool ok = closed && data && size == total;
+  TEST_CHECKF(data && size == total, "%s: size %zu, want %zu", name, size, total);
+  if (ok) {
+    // Later patches win
+    ok = memcmp(data, &second, patch_size) == 0;
+    TEST_CHECKF(ok, "%s: patch", name);
+    for (size_t i = patch_size; ok && i < total; ++i) {
+      if (data[i] != pattern(i)) {
+        TEST_CHECKF(false, "%s: mismatch at %zu", name, i);
+        ok = false;
+      }
+    }
+  }
+  free(data);
+  remove(TEST_PATH);
+  return ok;
+}
+
+static void test_write(void) {
+  size_t const block = aviutl2_file_writer_default_block_size;
+  write_and_verify(0, 20 * 1000 * 1000 + 123, 0, "buffered");
+  write_and_verify(0, 9 * 1000 * 1000 + 1, 30 * 1000 * 1000, "buffered, smaller than preallocated");
+  // The final partial block is padded to whole sectors and cut back to position
+  write_and_verify(aviutl2_file_writer_flag_unbuffered, 20 * 1000 * 1000 + 123, 0, "unbuffered");
+  write_and_verify(aviutl2_file_writer_flag_unbuffered, 1000 * 1000 + 7, 30000001, "unbuffered, preallocated");
+  write_and_verify(aviutl2_file_writer_flag_unbuffered, 3 * 1000 * 1000, 1000 * 1000 + 1, "unbuffered, larger");
+  write_and_verify(aviutl2_file_writer_flag_unbuffered, block * 2, 0, "unbuffered, whole blocks");
+  write_and_verify(aviutl2_file_writer_flag_unbuffered, 4, 0, "unbuffered, tiny");
+  write_and_verify(aviutl2_file_writer_flag_unbuffered | aviutl2_file_writer_flag_write_through,
+                   block + 4097,
+                   0,
+                   "unbuffered, write through");
+  write_and_verify(0, 0, 0, "empty");
+}
+
+static void test_failure(void) {
+  for (int flags = 0; flags <= aviutl2_file_writer_flag_unbuffered; flags += aviutl2_file_writer_flag_unbuffered) {
+    // The disk fills up in the middle of the second block
+    win32_shim_set_write_budget(aviutl2_file_writer_default_block_size + 12345);
+    struct aviutl2_file_writer *w = aviutl2_file_writer_create(TEST_PATH_W, 0, 0, flags);
+    TEST_CHECK(w != NULL);
+    if (!w) {
+      continue;
+    }
+    static uint8_t buf[65536];
+    size_t pos = 0;
+    bool failed = false;
+    for (int i = 0; i < 1000 && !failed; ++i) {
+      failed = !aviutl2_file_writer_write(w, buf, sizeof(buf));
+      pos += sizeof(buf);
+    }
+    TEST_CHECKF(failed, "flags %d: no failure after %zu bytes", flags, pos);
+    // The error is sticky even after the disk has room again
+    win32_shim_set_write_budget(-1);
+    TEST_CHECK(!aviutl2_file_writer_write(w, buf, 1));
+    TEST_CHECK(!aviutl2_file_writer_write(w, buf, sizeof(buf)));
+    TEST_CHECK(!aviutl2_file_writer_close(w));
+    remove(TEST_PATH);
+  }
+
+  // A patch past the end fails the close
+  struct aviutl2_file_writer *w = aviutl2_file_writer_create(TEST_PATH_W, 0, 0, 0);
+  TEST_CHECK(w != NULL);
+  if (w) {
+    TEST_CHECK(aviutl2_file_writer_write(w, "abcd", 4));
+    TEST_CHECK(aviutl2_file_writer_patch(w, 2, "xyz", 3));
+    TEST_CHECK(!aviutl2_file_writer_close(w));
+    remove(TEST_PATH);
+  }
+
+  TEST_CHECK(aviutl2_file_writer_create(L"no_such_directory/file_writer_test.tmp", 0, 0, 0) == NULL);
+  TEST_CHECK(aviutl2_file_writer_create(L"", 0, 0, 0) == NULL);
+  TEST_CHECK(!aviutl2_file_writer_close(NULL));
+}
+
+static void bench(void) {
+  enum { total = 512 * 1024 * 1024 };
+  static uint8_t chunk[65536];
+  for (size_t i = 0; i < sizeof(chunk); ++i) {
+    chunk[i] = pattern(i);
+  }
+  static size_t const sizes[] = {188, 4096, 65536};
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k) {
+    size_t const n = sizes[k];
+    double t0 = test_now();
+    FILE *f = fopen(TEST_PATH, "wb");
+    if (!f) {
+      return;
+    }
+    for (size_t pos = 0; pos < total; pos += n) {
+      fwrite(chunk, 1, n, f);
+    }
+    fclose(f);
+    double const stdio = test_now() - t0;
+    remove(TEST_PATH);
+
+    t0 = test_now();
+    struct aviutl2_file_writer *w = aviutl2_file_writer_create(TEST_PATH_W, 0, total, 0);
+    if (!w) {
+      return;
+    }
+    for (size_t pos = 0; pos < total; pos += n) {
+      aviutl2_file_writer_write(w, chunk, n);
+    }
+    bool const ok = aviutl2_file_writer_close(w);
+    double const writer = test_now() - t0;
+    remove(TEST_PATH);
+    printf("%zu byte writes: fwrite %.0f MB/s, file_writer %.0f MB/s%s\n",
+           n,
+           total / stdio * 1e-6,
+           total / writer * 1e-6,
+           ok ? "" : " (failed)");
+  }
+}
+
+int main(int argc, char **argv) {
+  if (test_is_bench(argc, argv)) {
+    bench();
+    return 0;
+  }
+  test_write();
+  test_failure();
+  return test_result(argv[0]);
+}
@@ -0,0 +1,144 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+
+// Tests for aviutl2_image_blend() in aviutl2_image_ops.h
+//
+// Results are compared with a double precision straight alpha "over" reference. Every pixel is also blended alone,
+// which always takes the scalar path, and inside rows whose leading pixels take the SSE2 path; both must match.
+
+#include "../include/aviutl2_image_ops.h"
+
+#include <stdlib.h>
+
+#include "test.h"
+
+static int const modes[] = {
+    aviutl2_image_blend_normal,
+    aviutl2_image_blend_add,
+    aviutl2_image_blend_subtract,
+    aviutl2_image_blend_multiply,
+    aviutl2_image_blend_screen,
+};
+
+static void reference(uint8_t const *d, uint8_t const *s, int mode, int opacity, double out[4]) {
+  // The effective source alpha is rounded to 8 bits before compositing, the same as the implementation.
+  double const a = (double)aviutl2_image_ops_div255((uint32_t)(s[3] * opacity)) / 255.0;
+  double const da = d[3] / 255.0;
+  double const oa = a + da * (1.0 - a);
+  for (int c = 0; c < 3; ++c) {
+    double const b = aviutl2_image_blend_channel(d[c], s[c], (enum aviutl2_image_blend_mode)mode);
+    double const m = s[c] * (1.0 - da) + b * da;
+    out[c] = oa > 0.0 ? (m * a + d[c] * da * (1.0 - a)) / oa : 0.0;
+  }
+  out[3] = oa * 255.0;
+}
+
+static void random_pixel(uint32_t *state, uint8_t *p) {
+  uint32_t const r = test_rand(state);
+  for (int c = 0; c < 4; ++c) {
+    p[c] = (uint8_t)(r >> (c * 8));
+  }
+  // Make fully transparent and fully opaque pixels common.
+  switch (test_rand(state) % 4) {
+  case 0:
+    p[3] = 0;
+    break;
+  case 1:
+    p[3] = 255;
+    break;
+  }
+}
+
+static void test_example(void) {
+  // Half transparent red over a transparent destination keeps its color.
+  uint8_t d[4] = {0, 0, 0, 0};
+  uint8_t const s[4] = {255, 0, 0, 128};
+  aviutl2_image_blend(d, 0, s, 0, 1, 1, aviutl2_image_blend_normal, 255);
+  TEST_CHECKF(d[0] == 255 && d[1] == 0 && d[2] == 0 && d[3] == 128, "%d %d %d %d", d[0], d[1], d[2], d[3]);
+}
+
+static void test_reference(void) {
+  enum { row = 19 };
+  uint32_t state = 0x1234567;
+  for (int iter = 0; iter < 20000; ++iter) {
+    int const mode = modes[iter % (sizeof(modes) / sizeof(modes[0]))];
+    int const opacity = iter % 3 == 0 ? 255 : (int)(test_rand(&state) % 256);
+    uint8_t src[row * 4], dst[row * 4], orig[row * 4];
+    for (int x = 0; x < row; ++x) {
+      random_pixel(&state, src + x * 4);
+      random_pixel(&state, orig + x * 4);
+    }
+    memcpy(dst, orig, sizeof(dst));
+    aviutl2_image_blend(dst, 0, src, 0, row, 1, (enum aviutl2_image_blend_mode)mode, opacity);
+    for (int x = 0; x < row; ++x) {
+      uint8_t one[4];
+      memcpy(one, orig + x * 4, 4);
+      aviutl2_image_blend(one, 0, src + x * 4, 0, 1, 1, (enum aviutl2_image_blend_mode)mode, opacity);
+      TEST_CHECKF(memcmp(one, dst + x * 4, 4) == 0,
+                  "mode %d x %d: row %d,%d,%d,%d single %d,%d,%d,%d",
+                  mode,
+                  x,
+                  dst[x * 4],
+                  dst[x * 4 + 1],
+                  dst[x * 4 + 2],
+                  dst[x * 4 + 3],
+                  one[0],
+                  one[1],
+                  one[2],
+                  one[3]);
+      double ref[4];
+      reference(orig + x * 4, src + x * 4, mode, opacity, ref);
+      // The 8-bit result alpha can be off by half a step, which moves the divided colors by up to 128 / alpha.
+      double const tol = 1.0 + (ref[3] > 0.0 ? 128.0 / ref[3] : 0.0);
+      for (int c = 0; c < 4; ++c) {
+        TEST_CHECKF(fabs(one[c] - ref[c]) <= (c == 3 ? 1.0 : tol),
+                    "mode %d opacity %d channel %d: %d, want %f",
+                    mode,
+                    opacity,
+                    c,
+                    one[c],
+                    ref[c]);
+      }
+      if ((src[x * 4 + 3] == 0 || opacity == 0) && orig[x * 4 + 3] != 0) {
+        // A transparent source leaves the destination as is; a fully transparent result has no color to keep.
+        TEST_CHECK(memcmp(one, orig + x * 4, 4) == 0);
+      }
+    }
+  }
+}
+
+static void bench(void) {
+  enum { width = 1920, height = 1080, rounds = 50 };
+  uint8_t *dst = (uint8_t *)malloc((size_t)width * height * 4);
+  uint8_t *src = (uint8_t *)malloc((size_t)width * height * 4);
+  if (!dst || !src) {
+    free(dst);
+    free(src);
+    return;
+  }
+  uint32_t state = 1;
+  for (size_t i = 0; i < (size_t)width * height; ++i) {
+    random_pixel(&state, dst + i * 4);
+    random_pixel(&state, src + i * 4);
+  }
+  for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+    double const t0 = test_now();
+    for (int r = 0; r < rounds; ++r) {
+      aviutl2_image_blend(dst, width * 4, src, width * 4, width, height, (enum aviutl2_image_blend_mode)modes[m], 200);
+    }
+    double const t = test_now() - t0;
+    printf("blend mode %d: %.1f Mpixels/s\n", modes[m], (double)width * height * rounds / t * 1e-6);
+  }
+  free(dst);
+  free(src);
+}
+
+int main(int argc, char **argv) {
+  if (test_is_bench(argc, argv)) {
+    bench();
+    return 0;
+  }
+  test_example();
+  test_reference();
+  return test_result(argv[0]);
+}
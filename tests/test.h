@@ -0,0 +1,67 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Minimal test helpers shared by the test drivers
+//
+// Each driver is a standalone program that returns a non-zero exit code when a check fails. Running it with the
+// argument "bench" runs the benchmarks instead of the tests.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static int test_failures = 0;
+
+#define TEST_CHECK(cond)                                                                                               \
+  do {                                                                                                                 \
+    if (!(cond)) {                                                                                                     \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                                         \
+      ++test_failures;                                                                                                 \
+    }                                                                                                                  \
+  } while (0)
+
+#define TEST_CHECKF(cond, ...)                                                                                         \
+  do {                                                                                                                 \
+    if (!(cond)) {                                                                                                     \
+      fprintf(stderr, "%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond);                                        \
+      fprintf(stderr, __VA_ARGS__);                                                                                    \
+      fputc('\n', stderr);                                                                                             \
+      ++test_failures;                                                                                                 \
+    }                                                                                                                  \
+  } while (0)
+
+static inline bool test_is_bench(int argc, char **argv) { return argc > 1 && strcmp(argv[1], "bench") == 0; }
+
+static inline int test_result(char const *name) {
+  if (test_failures) {
+    fprintf(stderr, "%s: %d check(s) failed\n", name, test_failures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+static inline double test_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Deterministic pseudo random numbers (xorshift32)
+ */
+static inline uint32_t test_rand(uint32_t *state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+static inline float test_randf(uint32_t *state, float lo, float hi) {
+  return lo + (hi - lo) * (float)(test_rand(state) >> 8) * (1.f / 16777216.f);
+}
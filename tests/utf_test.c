@@ -0,0 +1,430 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+
+// Tests for aviutl2_utf.h
+//
+// The converters are compared against a reference decoder written directly from table 3-7 of the Unicode standard
+// ("well-formed UTF-8 byte sequences"), with ill-formed input replaced by U+FFFD per maximal subpart. All sequences of
+// up to three bytes are checked exhaustively, and longer inputs are fuzzed with a mix of ASCII runs (which take the
+// SSE2 path), valid characters, truncated and overlong sequences, encoded surrogates and random bytes.
+// Build with -fshort-wchar so that the wchar_t wrappers are compiled as on Windows.
+
+#include "../include/aviutl2_utf.h"
+
+#include "test.h"
+
+#include <stdlib.h>
+
+struct ref_row {
+  uint8_t first_lo, first_hi;
+  int len;
+  uint8_t lo[3], hi[3];
+};
+
+static struct ref_row const ref_table[] = {
+    {0x00, 0x7f, 1, {0}, {0}},
+    {0xc2, 0xdf, 2, {0x80}, {0xbf}},
+    {0xe0, 0xe0, 3, {0xa0, 0x80}, {0xbf, 0xbf}},
+    {0xe1, 0xec, 3, {0x80, 0x80}, {0xbf, 0xbf}},
+    {0xed, 0xed, 3, {0x80, 0x80}, {0x9f, 0xbf}},
+    {0xee, 0xef, 3, {0x80, 0x80}, {0xbf, 0xbf}},
+    {0xf0, 0xf0, 4, {0x90, 0x80, 0x80}, {0xbf, 0xbf, 0xbf}},
+    {0xf1, 0xf3, 4, {0x80, 0x80, 0x80}, {0xbf, 0xbf, 0xbf}},
+    {0xf4, 0xf4, 4, {0x80, 0x80, 0x80}, {0x8f, 0xbf, 0xbf}},
+};
+
+// Decodes src into code points; returns the count and sets *valid
+static size_t ref_decode(uint8_t const *src, size_t len, uint32_t *out, bool *valid) {
+  size_t n = 0;
+  *valid = true;
+  for (size_t i = 0; i < len;) {
+    struct ref_row const *row = NULL;
+    for (size_t r = 0; r < sizeof(ref_table) / sizeof(ref_table[0]); ++r) {
+      if (src[i] >= ref_table[r].first_lo && src[i] <= ref_table[r].first_hi) {
+        row = &ref_table[r];
+        break;
+      }
+    }
+    if (!row) {
+      out[n++] = 0xfffd;
+      *valid = false;
+      ++i;
+      continue;
+    }
+    int k = 1;
+    while (k < row->len && i + (size_t)k < len && src[i + k] >= row->lo[k - 1] && src[i + k] <= row->hi[k - 1]) {
+      ++k;
+    }
+    if (k < row->len) {
+      out[n++] = 0xfffd;
+      *valid = false;
+      i += (size_t)k;
+      continue;
+    }
+    static uint8_t const lead_mask[5] = {0, 0x7f, 0x1f, 0x0f, 0x07};
+    uint32_t cp = src[i] & lead_mask[row->len];
+    for (int j = 1; j < row->len; ++j) {
+      cp = (cp << 6) | (src[i + j] & 0x3f);
+    }
+    out[n++] = cp;
+    i += (size_t)row->len;
+  }
+  return n;
+}
+
+static size_t ref_to_utf16(uint32_t const *cps, size_t n, uint16_t *out) {
+  size_t o = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (cps[i] >= 0x10000) {
+      out[o++] = (uint16_t)(0xd800 + ((cps[i] - 0x10000) >> 10));
+      out[o++] = (uint16_t)(0xdc00 + ((cps[i] - 0x10000) & 0x3ff));
+    } else {
+      out[o++] = (uint16_t)cps[i];
+    }
+  }
+  return o;
+}
+
+static size_t ref_utf16_decode(uint16_t const *src, size_t len, uint32_t *out) {
+  size_t n = 0;
+  for (size_t i = 0; i < len; ++i) {
+    uint32_t c = src[i];
+    if (c >= 0xd800 && c <= 0xdbff && i + 1 < len && src[i + 1] >= 0xdc00 && src[i + 1] <= 0xdfff) {
+      c = 0x10000 + ((c - 0xd800) << 10) + (src[++i] - 0xdc00u);
+    } else if (c >= 0xd800 && c <= 0xdfff) {
+      c = 0xfffd;
+    }
+    out[n++] = c;
+  }
+  return n;
+}
+
+static size_t ref_to_utf8(uint32_t const *cps, size_t n, uint8_t *out) {
+  size_t o = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t const c = cps[i];
+    if (c < 0x80) {
+      out[o++] = (uint8_t)c;
+    } else if (c < 0x800) {
+      out[o++] = (uint8_t)(0xc0 | (c >> 6));
+      out[o++] = (uint8_t)(0x80 | (c & 0x3f));
+    } else if (c < 0x10000) {
+      out[o++] = (uint8_t)(0xe0 | (c >> 12));
+      out[o++] = (uint8_t)(0x80 | ((c >> 6) & 0x3f));
+      out[o++] = (uint8_t)(0x80 | (c & 0x3f));
+    } else {
+      out[o++] = (uint8_t)(0xf0 | (c >> 18));
+      out[o++] = (uint8_t)(0x80 | ((c >> 12) & 0x3f));
+      out[o++] = (uint8_t)(0x80 | ((c >> 6) & 0x3f));
+      out[o++] = (uint8_t)(0x80 | (c & 0x3f));
+    }
+  }
+  return o;
+}
+
+enum {
+  max_input = 512,
+  guard = 0x5a5a,
+};
+
+static void check_utf8(uint8_t const *src, size_t len, uint32_t *rng) {
+  static uint32_t cps[max_input];
+  static uint16_t expect[max_input * 2];
+  static uint16_t got[max_input * 2 + 16];
+  bool valid;
+  size_t const cp_num = ref_decode(src, len, cps, &valid);
+  size_t const n = ref_to_utf16(cps, cp_num, expect);
+
+  TEST_CHECKF(aviutl2_utf8_validate((char const *)src, len) == valid, "len=%zu", len);
+  size_t const need = aviutl2_utf8_to_utf16(NULL, 0, (char const *)src, len);
+  TEST_CHECKF(need == n, "len=%zu need=%zu expect=%zu", len, need, n);
+  if (need != n) {
+    return;
+  }
+  size_t const caps[2] = {n, rng && n ? test_rand(rng) % n : 0};
+  for (int c = 0; c < (rng ? 2 : 1); ++c) {
+    size_t const cap = caps[c];
+    for (size_t i = 0; i < n + 16; ++i) {
+      got[i] = guard;
+    }
+    TEST_CHECK(aviutl2_utf8_to_utf16(got, cap, (char const *)src, len) == n);
+    TEST_CHECKF(memcmp(got, expect, cap * sizeof(uint16_t)) == 0, "len=%zu cap=%zu", len, cap);
+    bool untouched = true;
+    for (size_t i = cap; i < n + 16; ++i) {
+      untouched = untouched && got[i] == guard;
+    }
+    TEST_CHECKF(untouched, "len=%zu wrote beyond cap=%zu", len, cap);
+  }
+  if (valid) {
+    static char back[max_input + 16];
+    TEST_CHECK(aviutl2_utf16_to_utf8(back, sizeof(back), expect, n) == len);
+    TEST_CHECKF(memcmp(back, src, len) == 0, "round trip len=%zu", len);
+  }
+}
+
+static void check_utf16(uint16_t const *src, size_t len, uint32_t *rng) {
+  static uint32_t cps[max_input];
+  static uint8_t expect[max_input * 3];
+  static uint8_t got[max_input * 3 + 16];
+  size_t const cp_num = ref_utf16_decode(src, len, cps);
+  size_t const n = ref_to_utf8(cps, cp_num, expect);
+
+  size_t const need = aviutl2_utf16_to_utf8(NULL, 0, src, len);
+  TEST_CHECKF(need == n, "len=%zu need=%zu expect=%zu", len, need, n);
+  if (need != n) {
+    return;
+  }
+  size_t const caps[2] = {n, n ? test_rand(rng) % n : 0};
+  for (int c = 0; c < 2; ++c) {
+    size_t const cap = caps[c];
+    memset(got, 0xa5, n + 16);
+    TEST_CHECK(aviutl2_utf16_to_utf8((char *)got, cap, src, len) == n);
+    TEST_CHECKF(memcmp(got, expect, cap) == 0, "len=%zu cap=%zu", len, cap);
+    bool untouched = true;
+    for (size_t i = cap; i < n + 16; ++i) {
+      untouched = untouched && got[i] == 0xa5;
+    }
+    TEST_CHECKF(untouched, "len=%zu wrote beyond cap=%zu", len, cap);
+  }
+  TEST_CHECK(aviutl2_utf8_validate((char const *)expect, n));
+}
+
+static void test_exhaustive(void) {
+  uint8_t b[4];
+  for (uint32_t v = 0; v < 0x100; ++v) {
+    b[0] = (uint8_t)v;
+    check_utf8(b, 1, NULL);
+  }
+  for (uint32_t v = 0; v < 0x10000; ++v) {
+    b[0] = (uint8_t)(v >> 8);
+    b[1] = (uint8_t)v;
+    check_utf8(b, 2, NULL);
+  }
+  for (uint32_t v = 0; v < 0x1000000 && !test_failures; ++v) {
+    b[0] = (uint8_t)(v >> 16);
+    b[1] = (uint8_t)(v >> 8);
+    b[2] = (uint8_t)v;
+    check_utf8(b, 3, NULL);
+  }
+  // Every four-byte lead with continuation bytes around the boundaries of table 3-7
+  static uint8_t const edges[] = {0x00, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf, 0xc0, 0xff};
+  for (uint32_t lead = 0xf0; lead < 0x100; ++lead) {
+    for (size_t i = 0; i < sizeof(edges); ++i) {
+      for (size_t j = 0; j < sizeof(edges); ++j) {
+        for (size_t k = 0; k < sizeof(edges); ++k) {
+          b[0] = (uint8_t)lead;
+          b[1] = edges[i];
+          b[2] = edges[j];
+          b[3] = edges[k];
+          check_utf8(b, 4, NULL);
+        }
+      }
+    }
+  }
+  uint16_t u[2];
+  uint32_t rng = 1;
+  for (uint32_t v = 0; v < 0x10000; ++v) {
+    u[0] = (uint16_t)v;
+    check_utf16(u, 1, &rng);
+  }
+  for (uint32_t hi = 0xd700; hi < 0xe100; hi += 0x3f) {
+    for (uint32_t lo = 0xd700; lo < 0xe100; ++lo) {
+      u[0] = (uint16_t)hi;
+      u[1] = (uint16_t)lo;
+      check_utf16(u, 2, &rng);
+    }
+  }
+}
+
+static size_t gen_utf8(uint8_t *buf, uint32_t *rng) {
+  size_t const target = test_rand(rng) % max_input;
+  size_t n = 0;
+  while (n + 4 <= target) {
+    switch (test_rand(rng) % 8) {
+    case 0:
+    case 1: {
+      size_t run = test_rand(rng) % 40;
+      while (run-- && n < target) {
+        buf[n++] = (uint8_t)(0x20 + test_rand(rng) % 0x5f);
+      }
+      break;
+    }
+    case 2:
+    case 3: {
+      static uint32_t const bases[] = {0x80, 0x800, 0x3040, 0xe000, 0x10000, 0x10fff0};
+      uint32_t const cp = bases[test_rand(rng) % 6] + test_rand(rng) % 16;
+      n += ref_to_utf8(&cp, 1, buf + n);
+      break;
+    }
+    case 4: {
+      // Truncated sequence: a valid character with its tail cut off
+      uint8_t tmp[4];
+      uint32_t const cp = 0x800 + test_rand(rng) % 0x10f000;
+      size_t const len = ref_to_utf8(&cp, 1, tmp);
+      size_t const keep = 1 + test_rand(rng) % (len - 1);
+      memcpy(buf + n, tmp, keep);
+      n += keep;
+      break;
+    }
+    case 5: {
+      static uint8_t const bad[][4] = {
+          {0xc0, 0x80}, {0xc1, 0xbf}, {0xe0, 0x80, 0x80}, {0xed, 0xa0, 0x80}, {0xed, 0xbf, 0xbf},
+          {0xf0, 0x80, 0x80, 0x80}, {0xf4, 0x90, 0x80, 0x80}, {0xf5, 0x80}, {0xff}, {0xef, 0xbf, 0xbd},
+      };
+      size_t const k = test_rand(rng) % 10;
+      size_t len = 4;
+      while (len > 1 && bad[k][len - 1] == 0) {
+        --len;
+      }
+      memcpy(buf + n, bad[k], len);
+      n += len;
+      break;
+    }
+    default:
+      buf[n++] = (uint8_t)test_rand(rng);
+      break;
+    }
+  }
+  return n;
+}
+
+static size_t gen_utf16(uint16_t *buf, uint32_t *rng) {
+  size_t const target = test_rand(rng) % max_input;
+  size_t n = 0;
+  while (n + 2 <= target) {
+    switch (test_rand(rng) % 6) {
+    case 0:
+    case 1: {
+      size_t run = test_rand(rng) % 24;
+      while (run-- && n < target) {
+        buf[n++] = (uint16_t)(0x20 + test_rand(rng) % 0x5f);
+      }
+      break;
+    }
+    case 2: {
+      uint32_t const cp = 0x10000 + test_rand(rng) % 0x100000;
+      n += ref_to_utf16(&cp, 1, buf + n);
+      break;
+    }
+    case 3:
+      buf[n++] = (uint16_t)(0xd800 + test_rand(rng) % 0x800);
+      break;
+    case 4:
+      buf[n++] = (uint16_t)(0x80 + test_rand(rng) % 0x780);
+      break;
+    default:
+      buf[n++] = (uint16_t)test_rand(rng);
+      break;
+    }
+  }
+  return n;
+}
+
+static void test_fuzz(int iterations) {
+  uint32_t rng = 0x12345678;
+  static uint8_t b8[max_input];
+  static uint16_t b16[max_input];
+  for (int i = 0; i < iterations && !test_failures; ++i) {
+    check_utf8(b8, gen_utf8(b8, &rng), &rng);
+    check_utf16(b16, gen_utf16(b16, &rng), &rng);
+  }
+}
+
+#if WCHAR_MAX == 0xffff
+static void test_wstr(void) {
+  struct aviutl2_wstr w = {0};
+  struct aviutl2_u8str u = {0};
+  // "あいう" in UTF-8
+  static char const jp[] = "\xe3\x81\x82\xe3\x81\x84\xe3\x81\x86";
+  wchar_t const *p = aviutl2_wstr_from_utf8(&w, jp, SIZE_MAX);
+  TEST_CHECK(p == w.small && w.len == 3 && p[0] == 0x3042 && p[2] == 0x3046 && p[3] == 0);
+  TEST_CHECK(aviutl2_wstr_from_utf8(&w, NULL, 0) == w.small && w.len == 0 && w.ptr[0] == 0);
+
+  // Longer than the small buffer: moves to the heap, and the heap is reused by the next long conversion
+  static char long_src[AVIUTL2_WSTR_SMALL * 2];
+  memset(long_src, 'a', sizeof(long_src) - 1);
+  long_src[sizeof(long_src) - 1] = '\0';
+  p = aviutl2_wstr_from_utf8(&w, long_src, SIZE_MAX);
+  TEST_CHECK(p && p == w.heap && w.len == sizeof(long_src) - 1 && p[w.len] == 0);
+  wchar_t *const heap = w.heap;
+  TEST_CHECK(aviutl2_wstr_from_utf8(&w, long_src, sizeof(long_src) - 2) == heap);
+
+  char const *s = aviutl2_u8str_from_wstr(&u, w.ptr, w.len);
+  TEST_CHECK(s && u.len == w.len && memcmp(s, long_src, u.len) == 0 && s[u.len] == '\0');
+  wchar_t const lone[] = {0x41, 0xd800, 0x42};
+  s = aviutl2_u8str_from_wstr(&u, lone, 3);
+  TEST_CHECK(s == u.small && u.len == 5 && memcmp(s, "A\xef\xbf\xbd" "B", 6) == 0);
+  aviutl2_wstr_free(&w);
+  aviutl2_u8str_free(&u);
+  TEST_CHECK(w.heap == NULL && u.heap == NULL);
+}
+#endif
+
+static void bench_case(char const *name, uint8_t const *src, size_t len) {
+  size_t const n16 = aviutl2_utf8_to_utf16(NULL, 0, (char const *)src, len);
+  uint16_t *const u16 = (uint16_t *)malloc(n16 * sizeof(uint16_t));
+  char *const u8 = (char *)malloc(len);
+  int const rounds = 200;
+  size_t sink = 0;
+  double t = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    sink += aviutl2_utf8_validate((char const *)src, len);
+  }
+  double const validate = test_now() - t;
+  t = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    sink += aviutl2_utf8_to_utf16(u16, n16, (char const *)src, len);
+  }
+  double const to16 = test_now() - t;
+  t = test_now();
+  for (int i = 0; i < rounds; ++i) {
+    sink += aviutl2_utf16_to_utf8(u8, len, u16, n16);
+  }
+  double const to8 = test_now() - t;
+  double const mb = (double)len * rounds / 1e6;
+  printf("%-8s validate %7.0f MB/s  utf8->utf16 %7.0f MB/s  utf16->utf8 %7.0f MB/s (%zu)\n",
+         name,
+         mb / validate,
+         mb / to16,
+         mb / to8,
+         sink & 1);
+  free(u16);
+  free(u8);
+}
+
+static void bench(void) {
+  size_t const len = 1 << 20;
+  uint8_t *const buf = (uint8_t *)malloc(len + 4);
+  uint32_t rng = 1;
+  for (size_t i = 0; i < len; ++i) {
+    buf[i] = (uint8_t)(0x20 + test_rand(&rng) % 0x5f);
+  }
+  bench_case("ascii", buf, len);
+  // Japanese text with ASCII punctuation and paths mixed in
+  size_t n = 0;
+  while (n < len) {
+    if (test_rand(&rng) % 4 == 0) {
+      for (int i = 0; i < 12 && n < len; ++i) {
+        buf[n++] = (uint8_t)('a' + test_rand(&rng) % 26);
+      }
+    } else {
+      uint32_t const cp = 0x3040 + test_rand(&rng) % 0x60;
+      n += ref_to_utf8(&cp, 1, buf + n);
+    }
+  }
+  bench_case("mixed", buf, n);
+  free(buf);
+}
+
+int main(int argc, char **argv) {
+  if (test_is_bench(argc, argv)) {
+    bench();
+    return 0;
+  }
+  test_exhaustive();
+  test_fuzz(200000);
+#if WCHAR_MAX == 0xffff
+  test_wstr();
+#endif
+  return test_result(argv[0]);
+}
@@ -0,0 +1,368 @@
+// https://github.com/oov/aviutl2_plugin_sdk_for_c
+// The MIT License / Copyright (c) 2025 oov
+#pragma once
+
+// Minimal Win32 API shim for building the test drivers on Linux
+//
+// Declares only the types and functions used by the headers under test, implemented with POSIX calls and GCC atomic
+// builtins. File paths are converted to narrow strings and must be ASCII. Handles opened with
+// FILE_FLAG_NO_BUFFERING reject writes and seeks that are not sector aligned, as Windows does, so the test drivers
+// catch alignment mistakes without depending on O_DIRECT support of the file system.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define WINAPI
+#define INFINITE 0xffffffffu
+#define WAIT_OBJECT_0 0u
+#define WAIT_FAILED 0xffffffffu
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+#ifndef FALSE
+#  define FALSE 0
+#  define TRUE 1
+#endif
+
+#define GENERIC_WRITE 0x40000000u
+#define FILE_SHARE_READ 0x00000001u
+#define CREATE_ALWAYS 2u
+#define OPEN_EXISTING 3u
+#define FILE_ATTRIBUTE_NORMAL 0x00000080u
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000u
+#define FILE_FLAG_NO_BUFFERING 0x20000000u
+#define FILE_FLAG_WRITE_THROUGH 0x80000000u
+#define FILE_BEGIN 0u
+#define MEM_COMMIT 0x00001000u
+#define MEM_RESERVE 0x00002000u
+#define MEM_RELEASE 0x00008000u
+#define PAGE_READWRITE 0x04u
+
+typedef int BOOL;
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef int32_t LONG;
+typedef int64_t LONGLONG;
+typedef uint64_t ULONGLONG;
+typedef void *LPVOID;
+typedef void *HANDLE;
+typedef void *HWND;
+typedef void *HINSTANCE;
+typedef void *HMODULE;
+typedef DWORD(WINAPI *LPTHREAD_START_ROUTINE)(void *param);
+
+typedef union {
+  struct {
+    DWORD LowPart;
+    LONG HighPart;
+  };
+  LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef struct {
+  LARGE_INTEGER EndOfFile;
+} FILE_END_OF_FILE_INFO;
+
+typedef enum {
+  FileEndOfFileInfo = 6,
+} FILE_INFO_BY_HANDLE_CLASS;
+
+typedef struct {
+  int dummy;
+} BITMAPINFOHEADER;
+
+typedef struct {
+  int dummy;
+} WAVEFORMATEX;
+
+typedef struct {
+  pthread_rwlock_t lock;
+} SRWLOCK;
+
+static inline void InitializeSRWLock(SRWLOCK *l) { pthread_rwlock_init(&l->lock, NULL); }
+static inline void AcquireSRWLockExclusive(SRWLOCK *l) { pthread_rwlock_wrlock(&l->lock); }
+static inline void ReleaseSRWLockExclusive(SRWLOCK *l) { pthread_rwlock_unlock(&l->lock); }
+static inline void AcquireSRWLockShared(SRWLOCK *l) { pthread_rwlock_rdlock(&l->lock); }
+static inline void ReleaseSRWLockShared(SRWLOCK *l) { pthread_rwlock_unlock(&l->lock); }
+
+static inline LONG InterlockedIncrement(LONG volatile *p) { return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST); }
+static inline LONG InterlockedDecrement(LONG volatile *p) { return __atomic_sub_fetch(p, 1, __ATOMIC_SEQ_CST); }
+static inline LONG InterlockedExchange(LONG volatile *p, LONG v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+static inline LONG InterlockedCompareExchange(LONG volatile *p, LONG v, LONG comparand) {
+  __atomic_compare_exchange_n(p, &comparand, v, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+  return comparand;
+}
+
+enum {
+  win32_shim_sector_size = 512,
+};
+
+enum win32_shim_kind {
+  win32_shim_kind_file,
+  win32_shim_kind_event,
+  win32_shim_kind_thread,
+};
+
+struct win32_shim_handle {
+  enum win32_shim_kind kind;
+  int fd;                /**< File */
+  bool unbuffered;       /**< File opened with FILE_FLAG_NO_BUFFERING */
+  pthread_mutex_t mutex; /**< Event */
+  pthread_cond_t cond;   /**< Event */
+  bool manual_reset;     /**< Event */
+  bool signaled;         /**< Event */
+  pthread_t thread;      /**< Thread */
+  bool joined;           /**< Thread */
+};
+
+struct win32_shim_thread_start {
+  LPTHREAD_START_ROUTINE proc;
+  void *param;
+};
+
+/**
+ * Number of bytes WriteFile() still accepts before it fails, or a negative value for no limit
+ */
+static LONGLONG win32_shim_write_budget = -1;
+
+/**
+ * Make WriteFile() fail after the specified number of bytes to simulate a full disk
+ * @param bytes Number of bytes, or a negative value to remove the limit
+ */
+static inline void win32_shim_set_write_budget(LONGLONG bytes) {
+  __atomic_store_n(&win32_shim_write_budget, bytes, __ATOMIC_SEQ_CST);
+}
+
+static inline HANDLE CreateFileW(wchar_t const *path,
+                                 DWORD access,
+                                 DWORD share,
+                                 void *security,
+                                 DWORD disposition,
+                                 DWORD attributes,
+                                 HANDLE t) {
+  (void)access;
+  (void)share;
+  (void)security;
+  (void)t;
+  char narrow[1024];
+  size_t i = 0;
+  for (; path[i] && i < sizeof(narrow) - 1; ++i) {
+    narrow[i] = (char)path[i];
+  }
+  narrow[i] = '\0';
+  int flags = O_WRONLY | O_CLOEXEC;
+  if (disposition == CREATE_ALWAYS) {
+    flags |= O_CREAT | O_TRUNC;
+  }
+  if (attributes & FILE_FLAG_WRITE_THROUGH) {
+    flags |= O_DSYNC;
+  }
+  int const fd = open(narrow, flags, 0644);
+  if (fd < 0) {
+    return INVALID_HANDLE_VALUE;
+  }
+  struct win32_shim_handle *h = (struct win32_shim_handle *)calloc(1, sizeof(*h));
+  if (!h) {
+    close(fd);
+    return INVALID_HANDLE_VALUE;
+  }
+  h->kind = win32_shim_kind_file;
+  h->fd = fd;
+  h->unbuffered = (attributes & FILE_FLAG_NO_BUFFERING) != 0;
+  return h;
+}
+
+static inline BOOL WriteFile(HANDLE file, void const *data, DWORD size, DWORD *written, void *overlapped) {
+  (void)overlapped;
+  struct win32_shim_handle *h = (struct win32_shim_handle *)file;
+  *written = 0;
+  if (h->unbuffered) {
+    off_t const pos = lseek(h->fd, 0, SEEK_CUR);
+    if (size % win32_shim_sector_size || pos % win32_shim_sector_size ||
+        (uintptr_t)data % win32_shim_sector_size) {
+      return FALSE;
+    }
+  }
+  LONGLONG const budget = __atomic_load_n(&win32_shim_write_budget, __ATOMIC_SEQ_CST);
+  if (budget >= 0 && (LONGLONG)size > budget) {
+    __atomic_store_n(&win32_shim_write_budget, 0, __ATOMIC_SEQ_CST);
+    return FALSE;
+  }
+  if (budget >= 0) {
+    __atomic_sub_fetch(&win32_shim_write_budget, (LONGLONG)size, __ATOMIC_SEQ_CST);
+  }
+  ssize_t const n = write(h->fd, data, size);
+  if (n < 0) {
+    return FALSE;
+  }
+  *written = (DWORD)n;
+  return TRUE;
+}
+
+static inline BOOL SetFilePointerEx(HANDLE file, LARGE_INTEGER distance, LARGE_INTEGER *new_pos, DWORD method) {
+  struct win32_shim_handle *h = (struct win32_shim_handle *)file;
+  if (method != FILE_BEGIN || (h->unbuffered && distance.QuadPart % win32_shim_sector_size)) {
+    return FALSE;
+  }
+  off_t const pos = lseek(h->fd, (off_t)distance.QuadPart, SEEK_SET);
+  if (pos < 0) {
+    return FALSE;
+  }
+  if (new_pos) {
+    new_pos->QuadPart = (LONGLONG)pos;
+  }
+  return TRUE;
+}
+
+static inline BOOL
+SetFileInformationByHandle(HANDLE file, FILE_INFO_BY_HANDLE_CLASS info_class, void *info, DWORD info_size) {
+  struct win32_shim_handle *h = (struct win32_shim_handle *)file;
+  if (info_class != FileEndOfFileInfo || info_size < sizeof(FILE_END_OF_FILE_INFO)) {
+    return FALSE;
+  }
+  return ftruncate(h->fd, (off_t)((FILE_END_OF_FILE_INFO *)info)->EndOfFile.QuadPart) == 0;
+}
+
+static inline HANDLE CreateEventW(void *security, BOOL manual_reset, BOOL initial_state, wchar_t const *name) {
+  (void)security;
+  (void)name;
+  struct win32_shim_handle *h = (struct win32_shim_handle *)calloc(1, sizeof(*h));
+  if (!h) {
+    return NULL;
+  }
+  h->kind = win32_shim_kind_event;
+  pthread_mutex_init(&h->mutex, NULL);
+  pthread_cond_init(&h->cond, NULL);
+  h->manual_reset = manual_reset != FALSE;
+  h->signaled = initial_state != FALSE;
+  return h;
+}
+
+static inline BOOL SetEvent(HANDLE event) {
+  struct win32_shim_handle *h = (struct win32_shim_handle *)event;
+  pthread_mutex_lock(&h->mutex);
+  h->signaled = true;
+  pthread_cond_broadcast(&h->cond);
+  pthread_mutex_unlock(&h->mutex);
+  return TRUE;
+}
+
+static inline void *win32_shim_thread_proc(void *param) {
+  // The start parameters are owned by the thread, which may outlive its handle
+  struct win32_shim_thread_start const start = *(struct win32_shim_thread_start *)param;
+  free(param);
+  start.proc(start.param);
+  return NULL;
+}
+
+static inline HANDLE CreateThread(void *security,
+                                  size_t stack_size,
+                                  LPTHREAD_START_ROUTINE proc,
+                                  void *param,
+                                  DWORD flags,
+                                  DWORD *thread_id) {
+  (void)security;
+  (void)stack_size;
+  (void)flags;
+  struct win32_shim_handle *h = (struct win32_shim_handle *)calloc(1, sizeof(*h));
+  struct win32_shim_thread_start *start = (struct win32_shim_thread_start *)malloc(sizeof(*start));
+  if (!h || !start) {
+    free(start);
+    free(h);
+    return NULL;
+  }
+  h->kind = win32_shim_kind_thread;
+  start->proc = proc;
+  start->param = param;
+  if (pthread_create(&h->thread, NULL, win32_shim_thread_proc, start) != 0) {
+    free(start);
+    free(h);
+    return NULL;
+  }
+  if (thread_id) {
+    *thread_id = 0;
+  }
+  return h;
+}
+
+/**
+ * Wait for an event or a thread
+ * Only waiting without a timeout is supported.
+ */
+static inline DWORD WaitForSingleObject(HANDLE handle, DWORD ms) {
+  struct win32_shim_handle *h = (struct win32_shim_handle *)handle;
+  if (!h || ms != INFINITE) {
+    return WAIT_FAILED;
+  }
+  switch (h->kind) {
+  case win32_shim_kind_event:
+    pthread_mutex_lock(&h->mutex);
+    while (!h->signaled) {
+      pthread_cond_wait(&h->cond, &h->mutex);
+    }
+    if (!h->manual_reset) {
+      h->signaled = false;
+    }
+    pthread_mutex_unlock(&h->mutex);
+    return WAIT_OBJECT_0;
+  case win32_shim_kind_thread:
+    if (!h->joined) {
+      if (pthread_join(h->thread, NULL) != 0) {
+        return WAIT_FAILED;
+      }
+      h->joined = true;
+    }
+    return WAIT_OBJECT_0;
+  case win32_shim_kind_file:
+    break;
+  }
+  return WAIT_FAILED;
+}
+
+static inline BOOL CloseHandle(HANDLE handle) {
+  struct win32_shim_handle *h = (struct win32_shim_handle *)handle;
+  if (!h || handle == INVALID_HANDLE_VALUE) {
+    return FALSE;
+  }
+  switch (h->kind) {
+  case win32_shim_kind_file:
+    close(h->fd);
+    break;
+  case win32_shim_kind_event:
+    pthread_cond_destroy(&h->cond);
+    pthread_mutex_destroy(&h->mutex);
+    break;
+  case win32_shim_kind_thread:
+    if (!h->joined) {
+      pthread_detach(h->thread);
+    }
+    break;
+  }
+  free(h);
+  return TRUE;
+}
+
+static inline LPVOID VirtualAlloc(LPVOID address, size_t size, DWORD type, DWORD protect) {
+  (void)address;
+  (void)type;
+  (void)protect;
+  size_t const page = 4096;
+  void *p = aligned_alloc(page, (size + page - 1) & ~(page - 1));
+  if (p) {
+    memset(p, 0, size);
+  }
+  return p;
+}
+
+static inline BOOL VirtualFree(LPVOID address, size_t size, DWORD type) {
+  (void)size;
+  (void)type;
+  free(address);
+  return TRUE;
+}